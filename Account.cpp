@@ -12,6 +12,7 @@
 #include "Account.h"
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 
 using namespace std;
 /**
@@ -25,9 +26,9 @@ using namespace std;
 /**
  * @brief Default constructor for the Account class.
  *
- * Initializes the account number to 0, description to an empty string, and balance to 0.0.
+ * Initializes the account number to 0, description to an empty string, and balance to 0.00.
  */
-Account::Account() : accountNumber(0), description(""), balance(0.0) {}
+Account::Account() : accountNumber(0), description(""), balance() {}
 
 /**
  * @brief Parameterized constructor for the Account class.
@@ -36,31 +37,19 @@ Account::Account() : accountNumber(0), description(""), balance(0.0) {}
  * @param desc The description of the account.
  * @param bal The initial balance of the account.
  */
-Account::Account(int num, const string &desc, double bal) {
-    accountNumber = num;
-    description = desc;
-    balance = bal;
-}
+Account::Account(int num, string desc, Money bal) : accountNumber(num), description(move(desc)), balance(bal) {}
 
 /**
- * @brief Copy constructor for the Account class.
+ * @brief Takes a read-only copy of the account, as frozen in a `ForestView`.
  *
- * @param acc The account object to be copied.
+ * @return The copy, sharing the transaction history of this account
  */
-Account::Account(const Account &acc) {
-    accountNumber = acc.accountNumber;
-    description = acc.description;
-    balance = acc.balance;
-    transactions = acc.transactions;
+Account Account::snapshot() const {
+    Account copy(accountNumber, description, balance);
+    copy.transactions = transactions.snapshot();
+    return copy;
 }
 
-/**
- * @brief Destructor for the Account class.
- *
- * Cleans up resources used by the Account object, if any.
- */
-Account::~Account() {}
-
 /**
  * @brief Retrieves the account number.
  *
@@ -75,17 +64,17 @@ int Account::getAccountNumber() const {
  *
  * @return The account balance.
  */
-double Account::getBalance() const {
+Money Account::getBalance() const {
     return balance;
 }
 
 /**
  * @brief Retrieves the list of transactions associated with the account.
  *
- * @return A constant reference to the vector of transactions.
+ * @return A view over the transaction columns.
  */
-const vector<Transaction> &Account::getTransactions() const {
-    return transactions;
+TransactionView Account::getTransactions() const {
+    return TransactionView(transactions);
 }
 
 /**
@@ -106,7 +95,7 @@ int Account::getTransactionCount() const {
  */
 Transaction Account::getTransaction(int index) const {
     if (index >= 0 && index < transactions.size()) {
-        return transactions[index];
+        return transactions.get(transactions.slotOf(index));
     }
     throw out_of_range("Transaction index out of range :)");
 }
@@ -117,7 +106,7 @@ Transaction Account::getTransaction(int index) const {
  * @return The account description.
  */
 
-string Account::getDescription() const {
+const string &Account::getDescription() const {
     return description;
 }
 
@@ -135,8 +124,8 @@ void Account::setAccountNumber(int num) {
  *
  * @param desc The new description of the account.
  */
-void Account::setDescription(const string &desc) {
-    description = desc;
+void Account::setDescription(string desc) {
+    description = move(desc);
 }
 
 /**
@@ -144,7 +133,7 @@ void Account::setDescription(const string &desc) {
  *
  * @param bal The new balance of the account.
  */
-void Account::setBalance(double bal) {
+void Account::setBalance(Money bal) {
     balance = bal;
 }
 
@@ -157,13 +146,13 @@ void Account::setBalance(double bal) {
  */
 void Account::setTransaction(int index, const Transaction &t) {
     if (index >= 0 && index < transactions.size()) {
-        Transaction oldT = transactions[index];
-        if (oldT.getDebitCredit() == 'D') {
-            balance -= oldT.getAmount();
+        size_t slot = transactions.slotOf(index);
+        if (transactions.getDebitCredit(slot) == 'D') {
+            balance -= transactions.getAmount(slot);
         } else {
-            balance += oldT.getAmount();
+            balance += transactions.getAmount(slot);
         }
-        transactions[index] = t;
+        transactions.set(slot, t);
         updateBalance(t);
     } else {
         throw out_of_range("Transaction out of range :)");
@@ -176,7 +165,29 @@ void Account::setTransaction(int index, const Transaction &t) {
  * @param t The transaction to add.
  */
 void Account::addTransaction(const Transaction &t) {
-    transactions.push_back(t);
+    transactions.push(t);
+}
+
+/**
+ * @brief Adds a transaction given by its fields to the account.
+ *
+ * @param id The transaction ID.
+ * @param amount The amount; a negative amount is replaced by 0.
+ * @param type The type; anything but 'D' or 'C' is replaced by 'D'.
+ * @param description The description.
+ * @param date The date.
+ */
+void Account::emplaceTransaction(string_view id, Money amount, char type, string_view description, string_view date) {
+    transactions.emplace(id, Transaction::checkedAmount(amount), Transaction::checkedType(type), description, date);
+}
+
+/**
+ * @brief Makes room for the given number of additional transactions.
+ *
+ * @param count The number of transactions about to be added.
+ */
+void Account::reserveTransactions(size_t count) {
+    transactions.reserve(transactions.slotCount() + count);
 }
 
 /**
@@ -187,11 +198,28 @@ void Account::addTransaction(const Transaction &t) {
  */
 void Account::removeTransaction(int index) {
     if (index >= 0 && index < transactions.size()) {
-        Transaction t = transactions[index];
-        transactions.erase(transactions.begin() + index);
+        transactions.remove(transactions.slotOf(index));
     }
 }
 
+/**
+ * @brief Removes the transaction in a slot of the transaction store.
+ *
+ * @param slot The slot of the transaction to remove.
+ */
+void Account::removeTransactionSlot(size_t slot) {
+    if (slot < transactions.slotCount()) {
+        transactions.remove(slot);
+    }
+}
+
+/**
+ * @brief Drops the slots of removed transactions from the transaction store.
+ */
+void Account::compactTransactions() {
+    transactions.compact();
+}
+
 /**
  * @brief Updates the account balance based on a transaction.
  *
@@ -234,7 +262,7 @@ string Account::getShortDescription() const {
 ostream &operator<<(ostream &os, const Account &account) {
     os << account.getAccountNumber() << " "
        << account.getShortDescription() << " "
-       << fixed << std::setprecision(2) << account.getBalance();
+       << account.getBalance();
     return os;
 }
 
@@ -247,7 +275,7 @@ istream &operator>>(istream &is, Account &account) {
     is >> ws;
 
     string desc;
-    double bal;
+    Money bal;
 
     // Read the entire line into a string
     string line;
@@ -268,10 +296,10 @@ istream &operator>>(istream &is, Account &account) {
     if (!words.empty()) {
         // Last word should be the balance
         try {
-            bal = stod(words.back());
+            bal = Money::parse(words.back());
             words.pop_back();  // Remove balance from words
         } catch (...) {
-            bal = 0.0;  // Default balance if not found
+            bal = Money();  // Default balance if not found
         }
 
         // Join remaining words for description
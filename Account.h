@@ -6,9 +6,12 @@
 #define ACCOUNT_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <iostream>
 #include "Transaction.h"
+#include "TransactionColumns.h"
+#include "Money.h"
 using namespace std;
 
 /**
@@ -17,14 +20,15 @@ using namespace std;
  *
  * @details The `Account` class models a financial account, which includes an account number, a description, a balance,
  * and a list of transactions. It provides methods for adding, removing, and updating transactions, as well as managing
- * the balance. The class also supports input and output operations for account data.
+ * the balance. The class also supports input and output operations for account data. Transactions are kept in a
+ * columnar `TransactionColumns` store and exposed through a `TransactionView`.
  */
 class Account {
 private:
     int accountNumber;               ///< The account number
     string description;              ///< The description of the account
-    double balance;                  ///< The current balance of the account
-    vector<Transaction> transactions;///< The list of transactions associated with the account
+    Money balance;                   ///< The current balance of the account
+    TransactionColumns transactions; ///< The transactions associated with the account, stored by column
 
 public:
     // Constructors & Destructor
@@ -32,36 +36,72 @@ public:
     /**
      * @brief Default constructor for Account class.
      *
-     * Initializes the account with default values: account number 0, empty description, and balance 0.0.
+     * Initializes the account with default values: account number 0, empty description, and balance 0.00.
      */
     Account();
 
     /**
      * @brief Parameterized constructor for Account class.
      *
-     * Initializes the account with a given account number, description, and balance.
+     * Initializes the account with a given account number, description, and balance. The description is taken by
+     * value, so callers can move it in.
      *
      * @param num The account number
      * @param desc The account description
      * @param bal The account balance
      */
-    Account(int num, const string& desc, double bal);
+    Account(int num, string desc, Money bal);
 
     /**
      * @brief Copy constructor for Account class.
      *
-     * Creates a copy of the provided `Account` object.
+     * Creates a copy of the provided `Account` object, including its transactions.
      *
      * @param acc The account to copy
      */
-    Account(const Account& acc);
+    Account(const Account& acc) = default;
+
+    /**
+     * @brief Move constructor for Account class.
+     *
+     * Takes over the description and the transaction columns of the provided account without copying them.
+     *
+     * @param acc The account to move from
+     */
+    Account(Account&& acc) = default;
+
+    /**
+     * @brief Copy assignment operator for Account class.
+     *
+     * @param acc The account to copy
+     * @return This account
+     */
+    Account& operator=(const Account& acc) = default;
+
+    /**
+     * @brief Move assignment operator for Account class.
+     *
+     * @param acc The account to move from
+     * @return This account
+     */
+    Account& operator=(Account&& acc) = default;
+
+    /**
+     * @brief Takes a read-only copy of the account, as frozen in a `ForestView`.
+     *
+     * The number, description and balance are copied, while the transactions are a `TransactionColumns::snapshot`
+     * that shares their history with this account instead of copying it.
+     *
+     * @return The copy
+     */
+    Account snapshot() const;
 
     /**
      * @brief Destructor for Account class.
      *
      * Destructor that does not require specific cleanup as no dynamic memory is used.
      */
-    ~Account();
+    ~Account() = default;
 
     // Getters
 
@@ -75,23 +115,23 @@ public:
     /**
      * @brief Returns the account description.
      *
-     * @return The description of the account
+     * @return The description of the account, valid while the account is not modified
      */
-    string getDescription() const;
+    const string& getDescription() const;
 
     /**
      * @brief Returns the current balance of the account.
      *
      * @return The balance of the account
      */
-    double getBalance() const;
+    Money getBalance() const;
 
     /**
-     * @brief Returns a reference to the list of transactions.
+     * @brief Returns a view of the list of transactions.
      *
-     * @return The list of transactions associated with the account
+     * @return A view over the transaction columns of the account, valid until the transactions change
      */
-    const vector<Transaction>& getTransactions() const;
+    TransactionView getTransactions() const;
 
     /**
      * @brief Returns the number of transactions in the account.
@@ -123,14 +163,14 @@ public:
      *
      * @param desc The account description to set
      */
-    void setDescription(const string& desc);
+    void setDescription(string desc);
 
     /**
      * @brief Sets the account balance.
      *
      * @param bal The balance to set
      */
-    void setBalance(double bal);
+    void setBalance(Money bal);
 
     /**
      * @brief Sets the transaction at the specified index.
@@ -154,6 +194,31 @@ public:
      */
     void addTransaction(const Transaction& t);
 
+    /**
+     * @brief Adds a transaction given by its fields to the account.
+     *
+     * Works like `addTransaction`, including the checks of the `Transaction` constructor on the amount and type, but
+     * copies the fields straight into the transaction columns, so loading code can pass views of its input buffer
+     * and nothing is allocated per transaction.
+     *
+     * @param id The transaction ID
+     * @param amount The amount
+     * @param type The type ('D' for debit, 'C' for credit)
+     * @param description The description
+     * @param date The date
+     */
+    void emplaceTransaction(string_view id, Money amount, char type, string_view description, string_view date);
+
+    /**
+     * @brief Makes room for the given number of additional transactions.
+     *
+     * Loaders that know how many transactions an account is about to receive call this first, so the columns are
+     * allocated once instead of growing step by step.
+     *
+     * @param count The number of transactions about to be added
+     */
+    void reserveTransactions(size_t count);
+
     /**
      * @brief Removes the transaction at the specified index.
      *
@@ -163,6 +228,21 @@ public:
      */
     void removeTransaction(int index);
 
+    /**
+     * @brief Removes the transaction in a slot of the transaction store.
+     *
+     * The slot is only marked as deleted, so the slots of the other transactions stay valid until
+     * `compactTransactions` is called.
+     *
+     * @param slot The slot of the transaction to remove, as used by `TransactionColumns`
+     */
+    void removeTransactionSlot(size_t slot);
+
+    /**
+     * @brief Drops the slots of removed transactions from the transaction store.
+     */
+    void compactTransactions();
+
     /**
      * @brief Updates the balance of the account based on a transaction.
      *
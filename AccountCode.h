@@ -0,0 +1,143 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_ACCOUNTCODE_H
+#define ADS_MIDTERM_PROJECT_ACCOUNTCODE_H
+
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * @brief Decimal arithmetic on account numbers, which encode their place in the hierarchy.
+ *
+ * The parent of an account is its number without the last digit, so every question about the hierarchy is a division
+ * by a power of ten. Every function is `constexpr`, builds no string and allocates nothing, so it can be used on every
+ * insert and posting. Numbers below 10, including 0 and negative numbers, are roots.
+ */
+namespace AccountCode {
+
+/**
+ * @brief The parent number of a root account.
+ */
+constexpr int NO_PARENT = -1;
+
+/**
+ * @brief The largest number of decimal digits of a positive int.
+ */
+constexpr size_t MAX_DIGITS = 10;
+
+/**
+ * @brief The powers of ten up to 10^MAX_DIGITS, so POWERS_OF_TEN[k] is the smallest number with k + 1 digits.
+ */
+constexpr long long POWERS_OF_TEN[MAX_DIGITS + 1] = {
+        1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL, 1000000000LL, 10000000000LL
+};
+
+/**
+ * @brief Returns the number of decimal digits of an account number.
+ *
+ * @param accountNumber The account number
+ * @return The number of digits, 1 for numbers below 10
+ */
+constexpr size_t digits(int accountNumber) {
+    size_t count = 1;
+    while (count < MAX_DIGITS && accountNumber >= POWERS_OF_TEN[count]) {
+        ++count;
+    }
+    return count;
+}
+
+/**
+ * @brief Returns the depth of an account below its root, which is one less than its number of digits.
+ *
+ * @param accountNumber The account number
+ * @return 0 for a root, 1 for its children and so on
+ */
+constexpr size_t depth(int accountNumber) {
+    return digits(accountNumber) - 1;
+}
+
+/**
+ * @brief Checks whether an account number names a root account.
+ *
+ * @param accountNumber The account number
+ * @return True if the number has a single digit
+ */
+constexpr bool isRoot(int accountNumber) {
+    return accountNumber < 10;
+}
+
+/**
+ * @brief Returns the parent number of an account.
+ *
+ * @param accountNumber The account number
+ * @return The number without its last digit, or `NO_PARENT` for a root
+ */
+constexpr int parent(int accountNumber) {
+    return isRoot(accountNumber) ? NO_PARENT : accountNumber / 10;
+}
+
+/**
+ * @brief Returns the leading digit of an account number, which names its root tree.
+ *
+ * @param accountNumber The account number
+ * @return The leading digit, or 0 for numbers below 1
+ */
+constexpr size_t leadingDigit(int accountNumber) {
+    if (accountNumber < 1) {
+        return 0;
+    }
+    return static_cast<size_t>(accountNumber / POWERS_OF_TEN[digits(accountNumber) - 1]);
+}
+
+/**
+ * @brief Returns the ancestor of an account at a given depth.
+ *
+ * @param accountNumber The account number
+ * @param ancestorDepth The depth of the ancestor, at most `depth(accountNumber)`
+ * @return The first `ancestorDepth + 1` digits of the number
+ */
+constexpr int ancestorAt(int accountNumber, size_t ancestorDepth) {
+    return static_cast<int>(accountNumber / POWERS_OF_TEN[depth(accountNumber) - ancestorDepth]);
+}
+
+/**
+ * @brief Checks whether an account lies in the subtree of another, itself included.
+ *
+ * @param ancestor The account number of the subtree root
+ * @param accountNumber The account number to check
+ * @return True if the digits of ancestor start the digits of accountNumber
+ */
+constexpr bool isPrefix(int ancestor, int accountNumber) {
+    if (ancestor < 0 || accountNumber < 0) {
+        return false;
+    }
+    size_t ancestorDigits = digits(ancestor);
+    size_t accountDigits = digits(accountNumber);
+    return ancestorDigits <= accountDigits &&
+           accountNumber / POWERS_OF_TEN[accountDigits - ancestorDigits] == ancestor;
+}
+
+/**
+ * @brief Checks whether an account is a proper descendant of another.
+ *
+ * @param ancestor The account number of the subtree root
+ * @param accountNumber The account number to check
+ * @return True if accountNumber is longer than ancestor and starts with its digits
+ */
+constexpr bool isDescendant(int ancestor, int accountNumber) {
+    return accountNumber != ancestor && isPrefix(ancestor, accountNumber);
+}
+
+static_assert(digits(0) == 1 && digits(9) == 1 && digits(10) == 2 && digits(2147483647) == 10, "digits");
+static_assert(parent(7) == NO_PARENT && parent(1234) == 123, "parent");
+static_assert(leadingDigit(0) == 0 && leadingDigit(5) == 5 && leadingDigit(987654321) == 9, "leadingDigit");
+static_assert(ancestorAt(1234, 0) == 1 && ancestorAt(1234, 2) == 123 && ancestorAt(1234, 3) == 1234, "ancestorAt");
+static_assert(isPrefix(12, 1234) && isPrefix(12, 12) && !isPrefix(12, 1324) && !isPrefix(123, 12), "isPrefix");
+static_assert(isDescendant(1, 10) && !isDescendant(1, 1) && !isDescendant(10, 1), "isDescendant");
+
+} // namespace AccountCode
+
+#endif //ADS_MIDTERM_PROJECT_ACCOUNTCODE_H
@@ -0,0 +1,223 @@
+//
+// Created on 10/14/2026.
+//
+
+/**
+ * @file AccountSearchIndex.cpp
+ * @brief Implements `AccountSearchIndex`, the prefix and keyword index over account numbers and descriptions.
+ */
+
+#include "AccountSearchIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <utility>
+
+using namespace std;
+
+AccountSearchIndex::AccountSearchIndex() {}
+
+/**
+ * @brief Indexes every account of a forest, replacing the current contents.
+ *
+ * @param index The account index of the forest
+ *
+ * Every list is sorted once, and the word lists are built from one sorted array of (word, account) pairs, so the
+ * build takes O(n log n) without any sorted insert.
+ */
+void AccountSearchIndex::build(const AccountIndex &index) {
+    clear();
+    vector<pair<string, int>> entries;
+    for (const pair<const int, NodePtr> &entry: index) {
+        int accountNumber = entry.first;
+        codes[AccountCode::depth(accountNumber)].push_back(accountNumber);
+        for (string &word: tokenize(entry.second->getData().getDescription())) {
+            entries.emplace_back(move(word), accountNumber);
+        }
+    }
+    for (vector<int> &list: codes) {
+        sort(list.begin(), list.end());
+    }
+
+    sort(entries.begin(), entries.end());
+    map<string, vector<int>>::iterator last = words.end();
+    for (pair<string, int> &entry: entries) {
+        if (last == words.end() || last->first != entry.first) {
+            last = words.emplace_hint(words.end(), move(entry.first), vector<int>());
+        }
+        if (last->second.empty() || last->second.back() != entry.second) {
+            last->second.push_back(entry.second);
+        }
+    }
+}
+
+/**
+ * @brief Drops every account.
+ */
+void AccountSearchIndex::clear() {
+    for (vector<int> &list: codes) {
+        list.clear();
+    }
+    words.clear();
+}
+
+/**
+ * @brief Indexes a new account.
+ *
+ * @param accountNumber The account number, not indexed yet
+ * @param description The description of the account
+ */
+void AccountSearchIndex::add(int accountNumber, string_view description) {
+    vector<int> &list = codes[AccountCode::depth(accountNumber)];
+    list.insert(lower_bound(list.begin(), list.end(), accountNumber), accountNumber);
+    indexWords(accountNumber, description, true);
+}
+
+/**
+ * @brief Replaces the description words of an indexed account.
+ *
+ * @param accountNumber The account number
+ * @param oldDescription The description the account was indexed with
+ * @param newDescription The new description
+ */
+void AccountSearchIndex::updateDescription(int accountNumber, string_view oldDescription,
+                                           string_view newDescription) {
+    indexWords(accountNumber, oldDescription, false);
+    indexWords(accountNumber, newDescription, true);
+}
+
+/**
+ * @brief Adds or removes the description words of an account.
+ *
+ * @param accountNumber The account number
+ * @param description The description
+ * @param add True to add the words, false to remove them
+ *
+ * Words that no account uses any more are dropped from the map.
+ */
+void AccountSearchIndex::indexWords(int accountNumber, string_view description, bool add) {
+    for (string &word: tokenize(description)) {
+        if (add) {
+            vector<int> &accounts = words[move(word)];
+            vector<int>::iterator position = lower_bound(accounts.begin(), accounts.end(), accountNumber);
+            if (position == accounts.end() || *position != accountNumber) {
+                accounts.insert(position, accountNumber);
+            }
+            continue;
+        }
+
+        map<string, vector<int>>::iterator found = words.find(word);
+        if (found == words.end()) {
+            continue;
+        }
+        vector<int> &accounts = found->second;
+        vector<int>::iterator position = lower_bound(accounts.begin(), accounts.end(), accountNumber);
+        if (position != accounts.end() && *position == accountNumber) {
+            accounts.erase(position);
+        }
+        if (accounts.empty()) {
+            words.erase(found);
+        }
+    }
+}
+
+/**
+ * @brief Finds the accounts whose number starts with the digits of a prefix.
+ *
+ * @param prefix The leading digits, a positive number
+ * @return The matching account numbers in chart order
+ */
+vector<int> AccountSearchIndex::findByPrefix(int prefix) const {
+    vector<int> result;
+    if (prefix <= 0) {
+        return result;
+    }
+    size_t prefixDigits = AccountCode::digits(prefix);
+    for (size_t digits = prefixDigits; digits <= AccountCode::MAX_DIGITS; ++digits) {
+        long long scale = AccountCode::POWERS_OF_TEN[digits - prefixDigits];
+        const vector<int> &list = codes[digits - 1];
+        vector<int>::const_iterator first = lower_bound(list.begin(), list.end(), prefix * scale);
+        vector<int>::const_iterator last = lower_bound(first, list.end(), (prefix + 1LL) * scale);
+        result.insert(result.end(), first, last);
+    }
+    sortInChartOrder(result);
+    return result;
+}
+
+/**
+ * @brief Finds the accounts whose description has a word starting with every keyword of a query.
+ *
+ * @param query The keywords
+ * @return The matching account numbers in chart order
+ *
+ * The accounts of every keyword are merged from the range of words it starts, then the keywords are intersected.
+ */
+vector<int> AccountSearchIndex::findByKeywords(string_view query) const {
+    vector<int> result;
+    bool first = true;
+    for (const string &keyword: tokenize(query)) {
+        vector<int> matches;
+        for (map<string, vector<int>>::const_iterator it = words.lower_bound(keyword);
+             it != words.end() && it->first.compare(0, keyword.size(), keyword) == 0; ++it) {
+            vector<int> merged;
+            merged.reserve(matches.size() + it->second.size());
+            set_union(matches.begin(), matches.end(), it->second.begin(), it->second.end(), back_inserter(merged));
+            matches.swap(merged);
+        }
+
+        if (first) {
+            result.swap(matches);
+            first = false;
+        } else {
+            vector<int> common;
+            set_intersection(result.begin(), result.end(), matches.begin(), matches.end(), back_inserter(common));
+            result.swap(common);
+        }
+        if (result.empty()) {
+            break;
+        }
+    }
+    sortInChartOrder(result);
+    return result;
+}
+
+/**
+ * @brief Splits a text into lowercase words of letters and digits.
+ *
+ * @param text The text
+ * @return The words, in text order, duplicates included
+ */
+vector<string> AccountSearchIndex::tokenize(string_view text) {
+    vector<string> tokens;
+    string current;
+    for (char c: text) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (isalnum(byte)) {
+            current += static_cast<char>(tolower(byte));
+        } else if (!current.empty()) {
+            tokens.push_back(move(current));
+            current.clear();
+        }
+    }
+    if (!current.empty()) {
+        tokens.push_back(move(current));
+    }
+    return tokens;
+}
+
+/**
+ * @brief Orders account numbers as the chart lists them.
+ *
+ * @param accounts The account numbers to sort
+ *
+ * Chart order is the order of the numbers as digit strings: every number is padded with zeros to the largest length,
+ * and a parent, being shorter, comes before the children that pad to the same value.
+ */
+void AccountSearchIndex::sortInChartOrder(vector<int> &accounts) {
+    sort(accounts.begin(), accounts.end(), [](int a, int b) {
+        size_t digitsA = AccountCode::digits(a);
+        size_t digitsB = AccountCode::digits(b);
+        long long paddedA = a * AccountCode::POWERS_OF_TEN[AccountCode::MAX_DIGITS - digitsA];
+        long long paddedB = b * AccountCode::POWERS_OF_TEN[AccountCode::MAX_DIGITS - digitsB];
+        return paddedA != paddedB ? paddedA < paddedB : digitsA < digitsB;
+    });
+}
@@ -0,0 +1,114 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_ACCOUNTSEARCHINDEX_H
+#define ADS_MIDTERM_PROJECT_ACCOUNTSEARCHINDEX_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "AccountCode.h"
+#include "TreeNode.h"
+
+using namespace std;
+
+/**
+ * @class AccountSearchIndex
+ * @brief Finds accounts by the leading digits of their number or by words of their description.
+ *
+ * Account numbers are kept sorted in one list per number of digits. The numbers starting with a prefix form one
+ * contiguous range of every list, `[prefix * 10^k, (prefix + 1) * 10^k)` for k extra digits, so a prefix query is one
+ * binary search per length. Descriptions are split into lowercase words of letters and digits, and an inverted index
+ * maps every word, in sorted order, to the sorted numbers of the accounts using it; a keyword matches every word it
+ * starts, so all matching words are one range of the map.
+ *
+ * Results come in chart order, each parent before its children and children by ascending number. Neither query
+ * walks the forest.
+ */
+class AccountSearchIndex {
+private:
+    vector<int> codes[AccountCode::MAX_DIGITS]; ///< The account numbers with k + 1 digits, sorted, at index k
+    map<string, vector<int>> words;             ///< Every description word and the sorted accounts using it
+
+    /**
+     * @brief Adds or removes the description words of an account.
+     *
+     * @param accountNumber The account number
+     * @param description The description
+     * @param add True to add the words, false to remove them
+     */
+    void indexWords(int accountNumber, string_view description, bool add);
+
+public:
+    /**
+     * @brief Default constructor for the `AccountSearchIndex` class.
+     *
+     * Creates an empty index.
+     */
+    AccountSearchIndex();
+
+    /**
+     * @brief Indexes every account of a forest, replacing the current contents.
+     *
+     * @param index The account index of the forest
+     */
+    void build(const AccountIndex &index);
+
+    /**
+     * @brief Drops every account.
+     */
+    void clear();
+
+    /**
+     * @brief Indexes a new account.
+     *
+     * @param accountNumber The account number, not indexed yet
+     * @param description The description of the account
+     */
+    void add(int accountNumber, string_view description);
+
+    /**
+     * @brief Replaces the description words of an indexed account.
+     *
+     * @param accountNumber The account number
+     * @param oldDescription The description the account was indexed with
+     * @param newDescription The new description
+     */
+    void updateDescription(int accountNumber, string_view oldDescription, string_view newDescription);
+
+    /**
+     * @brief Finds the accounts whose number starts with the digits of a prefix.
+     *
+     * @param prefix The leading digits, a positive number
+     * @return The matching account numbers in chart order, the prefix itself included if it is an account
+     */
+    vector<int> findByPrefix(int prefix) const;
+
+    /**
+     * @brief Finds the accounts whose description has a word starting with every keyword of a query.
+     *
+     * @param query The keywords, split like descriptions and compared without case
+     * @return The matching account numbers in chart order, none if the query has no keyword
+     */
+    vector<int> findByKeywords(string_view query) const;
+
+    /**
+     * @brief Splits a text into lowercase words of letters and digits.
+     *
+     * @param text The text
+     * @return The words, in text order, duplicates included
+     */
+    static vector<string> tokenize(string_view text);
+
+    /**
+     * @brief Orders account numbers as the chart lists them.
+     *
+     * @param accounts The account numbers to sort
+     */
+    static void sortInChartOrder(vector<int> &accounts);
+};
+
+#endif //ADS_MIDTERM_PROJECT_ACCOUNTSEARCHINDEX_H
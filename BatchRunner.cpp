@@ -0,0 +1,326 @@
+//
+// Created on 10/14/2026.
+//
+
+/**
+ * @file BatchRunner.cpp
+ * @brief Implements `BatchRunner`, which runs command and transaction streams against a forest without prompting.
+ */
+
+#include "BatchRunner.h"
+#include "ForestMetrics.h"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief The largest number of fields of a record; fields after it are ignored.
+ */
+const size_t MAX_FIELDS = 7;
+
+/**
+ * @brief Splits a record into its `|`-separated fields.
+ *
+ * @param line The record
+ * @param fields Receives views of the fields in the record
+ * @return The number of fields
+ */
+size_t splitFields(string_view line, string_view *fields) {
+    size_t count = 0;
+    size_t start = 0;
+    while (count < MAX_FIELDS) {
+        size_t bar = line.find('|', start);
+        fields[count++] = line.substr(start, bar == string_view::npos ? string_view::npos : bar - start);
+        if (bar == string_view::npos) break;
+        start = bar + 1;
+    }
+    return count;
+}
+
+/**
+ * @brief Checks that a command has the fields it needs.
+ *
+ * @param command The command name
+ * @param count The number of fields, the command included
+ * @param expected The number of fields the command needs
+ * @throws invalid_argument If fields are missing
+ */
+void requireFields(string_view command, size_t count, size_t expected) {
+    if (count < expected) {
+        throw invalid_argument("Command " + string(command) + " needs " + to_string(expected - 1) + " field(s)");
+    }
+}
+
+/**
+ * @brief Reads an optional report format field.
+ *
+ * @param fields The fields of the command
+ * @param count The number of fields
+ * @param position The position of the format field
+ * @return The format, text if the field is missing or empty
+ */
+ReportFormat reportFormat(const string_view *fields, size_t count, size_t position) {
+    return count > position && !fields[position].empty() ? ReportGenerator::parseFormat(fields[position])
+                                                         : ReportFormat::TEXT;
+}
+
+/**
+ * @brief Opens a report file.
+ *
+ * @param filename The file name
+ * @param file The stream to open
+ * @throws runtime_error If the file cannot be opened
+ */
+void openReport(const string &filename, ofstream &file) {
+    file.open(filename, ios::binary);
+    if (!file.is_open()) {
+        throw runtime_error("Could not open file for writing: " + filename);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Creates a runner for a loaded forest.
+ *
+ * @param tree The forest
+ * @param chartFile The chart file the forest was loaded from
+ * @param out The stream that receives the results and errors
+ */
+BatchRunner::BatchRunner(ForestTree &tree, string chartFile, ostream &out)
+        : tree(tree), chartFile(move(chartFile)), out(out), batchSize(DEFAULT_BATCH_SIZE) {}
+
+/**
+ * @brief Sets how many postings are queued before they are posted together.
+ *
+ * @param size The batch size
+ */
+void BatchRunner::setBatchSize(size_t size) {
+    batchSize = size == 0 ? 1 : size;
+}
+
+/**
+ * @brief Runs every record of an input stream, then saves the balances and compacts the journal.
+ *
+ * @param in The input stream
+ * @return What the run did
+ * @throws runtime_error If the forest cannot be saved
+ */
+BatchSummary BatchRunner::run(istream &in) {
+    summary = BatchSummary();
+    queue.clear();
+    queue.reserve(batchSize);
+
+    string line;
+    size_t lineNumber = 0;
+    while (getline(in, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        try {
+            execute(line);
+        } catch (const exception &e) {
+            fail(lineNumber, e.what());
+        }
+    }
+    postQueue();
+    summary.lines = lineNumber;
+
+    tree.saveToFile(chartFile);
+    tree.compactJournal();
+
+    out << "summary|" << summary.lines << '|' << summary.posted << '|' << summary.deleted << '|' << summary.failed
+        << '\n';
+    out.flush();
+    return summary;
+}
+
+/**
+ * @brief Runs one input record.
+ *
+ * @param line The record
+ */
+void BatchRunner::execute(string_view line) {
+    string_view fields[MAX_FIELDS];
+    size_t count = splitFields(line, fields);
+
+    // Bare transaction lines are the bulk of a stream and are only queued
+    if (isdigit(static_cast<unsigned char>(line[0]))) {
+        queuePosting(fields, count);
+        return;
+    }
+    string_view command = fields[0];
+    if (command == "post") {
+        queuePosting(fields + 1, count - 1);
+        return;
+    }
+
+    // Every other command sees all earlier postings
+    postQueue();
+
+    if (command == "delete") {
+        requireFields(command, count, 3);
+        int accountNumber = parseAccount(fields[1]);
+        int index = stoi(string(fields[2]));
+        if (!tree.deleteTransaction(accountNumber, index)) {
+            throw runtime_error("No transaction " + string(fields[2]) + " in account " + to_string(accountNumber));
+        }
+        ++summary.deleted;
+    } else if (command == "delete-id") {
+        requireFields(command, count, 2);
+        if (!tree.deleteTransactionById(string(fields[1]))) {
+            throw runtime_error("No transaction with ID " + string(fields[1]));
+        }
+        ++summary.deleted;
+    } else if (command == "account") {
+        requireFields(command, count, 4);
+        int accountNumber = parseAccount(fields[1]);
+        if (!tree.addAccountWithFile(accountNumber, string(fields[2]), Money::parse(fields[3]), chartFile)) {
+            throw runtime_error("Account " + to_string(accountNumber) + " could not be added");
+        }
+    } else if (command == "balance") {
+        requireFields(command, count, 2);
+        int accountNumber = parseAccount(fields[1]);
+        Money balance;
+        if (!tree.readAccount(accountNumber, [&balance](const Account &account) {
+            balance = account.getBalance();
+        })) {
+            throw invalid_argument("Account not found: " + to_string(accountNumber));
+        }
+        out << "balance|" << accountNumber << '|' << balance << '\n';
+    } else if (command == "balance-as-of") {
+        requireFields(command, count, 3);
+        int accountNumber = parseAccount(fields[1]);
+        out << "balance-as-of|" << accountNumber << '|' << fields[2] << '|'
+            << tree.balanceAsOf(accountNumber, string(fields[2])) << '\n';
+    } else if (command == "search-prefix" || command == "search") {
+        requireFields(command, count, 2);
+        vector<int> matches = command == "search" ? tree.findAccountsByKeywords(string(fields[1]))
+                                                  : tree.findAccountsByPrefix(parseAccount(fields[1]));
+        for (int accountNumber: matches) {
+            tree.readAccount(accountNumber, [this](const Account &account) {
+                out << "match|" << account.getAccountNumber() << '|' << account.getDescription() << '\n';
+            });
+        }
+    } else if (command == "report") {
+        requireFields(command, count, 3);
+        tree.printDetailedReport(parseAccount(fields[1]), string(fields[2]));
+    } else if (command == "report-accounts") {
+        requireFields(command, count, 4);
+        vector<int> accounts;
+        for (size_t start = 0; start <= fields[3].size();) {
+            size_t comma = min(fields[3].find(',', start), fields[3].size());
+            accounts.push_back(parseAccount(fields[3].substr(start, comma - start)));
+            start = comma + 1;
+        }
+        ReportGenerator generator(tree.view(), reportFormat(fields, count, 2));
+        ofstream file;
+        openReport(string(fields[1]), file);
+        generator.writeAccounts(accounts, file);
+    } else if (command == "report-subtree") {
+        requireFields(command, count, 3);
+        int accountNumber = parseAccount(fields[1]);
+        ReportGenerator generator(tree.view(), reportFormat(fields, count, 3));
+        ofstream file;
+        openReport(string(fields[2]), file);
+        if (generator.writeSubtree(accountNumber, file) == 0) {
+            throw invalid_argument("Account not found: " + to_string(accountNumber));
+        }
+    } else if (command == "report-roots") {
+        requireFields(command, count, 2);
+        ReportGenerator(tree.view(), reportFormat(fields, count, 2)).writeRootReports(string(fields[1]));
+    } else if (command == "check") {
+        for (const BalanceMismatch &mismatch: tree.recomputeAllBalances()) {
+            out << "mismatch|" << mismatch.accountNumber << '|' << mismatch.storedBalance << '|'
+                << mismatch.recomputedBalance << '\n';
+        }
+    } else if (command == "metrics") {
+        ForestMetrics::snapshot().write(out);
+    } else if (command == "save") {
+        tree.saveToFile(chartFile);
+        tree.flushJournal();
+    } else if (command == "snapshot") {
+        requireFields(command, count, 2);
+        tree.saveSnapshot(string(fields[1]));
+    } else if (command == "export") {
+        requireFields(command, count, 2);
+        tree.exportText(string(fields[1]));
+    } else {
+        throw invalid_argument("Unknown command: " + string(command));
+    }
+}
+
+/**
+ * @brief Queues a transaction, posting the queue once it is full.
+ *
+ * @param fields The fields `account|id|amount|type|date|description`
+ * @param count The number of fields
+ * @throws invalid_argument If the transaction cannot be read or the account does not exist
+ */
+void BatchRunner::queuePosting(const string_view *fields, size_t count) {
+    if (count < 4) {
+        throw invalid_argument("A transaction needs at least account, ID, amount and type");
+    }
+    int accountNumber = parseAccount(fields[0]);
+    if (!tree.findAccount(accountNumber)) {
+        throw invalid_argument("Account not found: " + to_string(accountNumber));
+    }
+
+    queue.emplace_back(accountNumber, Transaction::parse(fields[1], fields[2], fields[3],
+                                                         count > 4 ? fields[4] : string_view(),
+                                                         count > 5 ? fields[5] : string_view()));
+    if (queue.size() >= batchSize) {
+        postQueue();
+    }
+}
+
+/**
+ * @brief Posts every queued transaction with a single rollup.
+ */
+void BatchRunner::postQueue() {
+    if (queue.empty()) {
+        return;
+    }
+    size_t posted = tree.postBatch(queue);
+    summary.posted += posted;
+    summary.failed += queue.size() - posted;
+    queue.clear();
+}
+
+/**
+ * @brief Reports a failed record and counts it.
+ *
+ * @param lineNumber The line number of the record
+ * @param message What went wrong
+ */
+void BatchRunner::fail(size_t lineNumber, const string &message) {
+    out << "error|" << lineNumber << '|' << message << '\n';
+    ++summary.failed;
+}
+
+/**
+ * @brief Reads an account number field.
+ *
+ * @param field The field
+ * @return The account number
+ * @throws invalid_argument If the field is not a positive number
+ */
+int BatchRunner::parseAccount(string_view field) {
+    if (field.empty() || field.size() > 9 || field.find_first_not_of("0123456789") != string_view::npos) {
+        throw invalid_argument("Invalid account number: " + string(field));
+    }
+    int accountNumber = stoi(string(field));
+    if (accountNumber <= 0) {
+        throw invalid_argument("Invalid account number: " + string(field));
+    }
+    return accountNumber;
+}
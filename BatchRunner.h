@@ -0,0 +1,144 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_BATCHRUNNER_H
+#define ADS_MIDTERM_PROJECT_BATCHRUNNER_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "ForestTree.h"
+#include "ReportGenerator.h"
+#include "Transaction.h"
+
+using namespace std;
+
+/**
+ * @brief Counts of what a batch run did, as returned by `BatchRunner::run`.
+ */
+struct BatchSummary {
+    size_t lines = 0;    ///< Lines read, including blank and comment lines
+    size_t posted = 0;   ///< Transactions posted
+    size_t deleted = 0;  ///< Transactions deleted
+    size_t failed = 0;   ///< Commands that failed and were skipped
+};
+
+/**
+ * @class BatchRunner
+ * @brief Runs a stream of commands and transactions against a forest without any prompt.
+ *
+ * Every line of the input is one record with `|`-separated fields. A line starting with an account number is a
+ * transaction in the format of the transactions file, `account|id|amount|type|date|description`; an empty ID or date
+ * is filled in as for a transaction entered by hand. Any other line is a command:
+ * - `post|account|id|amount|type|date|description` posts a transaction, like a bare transaction line
+ * - `delete|account|index` deletes the transaction at an index of an account
+ * - `delete-id|id` deletes a transaction by its ID
+ * - `account|number|description|balance` adds an account to the forest and its chart file
+ * - `balance|account` writes `balance|account|amount`
+ * - `balance-as-of|account|date` writes `balance-as-of|account|date|amount`
+ * - `search-prefix|digits` writes `match|account|description` for every account whose number starts with the digits
+ * - `search|keywords` writes `match|account|description` for every account whose description holds the keywords
+ * - `report|account|file` writes the detailed report of an account
+ * - `report-accounts|file|format|account,account,...` writes the reports of a list of accounts into one file
+ * - `report-subtree|account|file|format` writes the reports of every account of a subtree into one file
+ * - `report-roots|directory|format` writes one subtree report per root tree into a directory
+ * - `check` writes `mismatch|account|stored|recomputed` for every balance that disagrees with its transactions
+ * - `metrics` writes the current `ForestMetrics` snapshot, see `MetricsSnapshot::write`
+ * - `save`, `snapshot|file` and `export|file` save the chart, a binary snapshot or the text files
+ *
+ * Blank lines and lines starting with `#` are skipped. Consecutive postings are queued and posted together through
+ * `ForestTree::postBatch`, so a long stream of transactions costs one rollup and one journal flush per batch instead
+ * of one per transaction; the queue is posted before any other command runs, so commands always see every earlier
+ * posting. A failed record is reported as `error|line|message` and the run goes on. Once the input ends, the
+ * balances are saved to the chart and the journal is folded into the transactions file. Reports are written from a
+ * `ForestTree::view`, so each one shows a single point in time. Report formats are `text`, `csv` or `json`, see
+ * `ReportGenerator`; an empty format means `text`.
+ */
+class BatchRunner {
+private:
+    ForestTree &tree;                     ///< The forest the commands run against
+    string chartFile;                     ///< The chart file the forest was loaded from, saved at the end
+    ostream &out;                         ///< Receives the results and errors
+    size_t batchSize;                     ///< The number of postings queued before they are posted
+    vector<pair<int, Transaction>> queue; ///< Postings not posted yet
+    BatchSummary summary;                 ///< Counts of the current run
+
+public:
+    /**
+     * @brief Default number of postings posted together.
+     */
+    static const size_t DEFAULT_BATCH_SIZE = 65536;
+
+    /**
+     * @brief Creates a runner for a loaded forest.
+     *
+     * @param tree The forest, already loaded from the chart file
+     * @param chartFile The chart file the forest was loaded from
+     * @param out The stream that receives the results and errors
+     */
+    BatchRunner(ForestTree &tree, string chartFile, ostream &out);
+
+    /**
+     * @brief Sets how many postings are queued before they are posted together.
+     *
+     * @param size The batch size; 0 and 1 both post every transaction on its own
+     */
+    void setBatchSize(size_t size);
+
+    /**
+     * @brief Runs every record of an input stream, then saves the forest.
+     *
+     * Writes `summary|lines|posted|deleted|failed` once the input ends.
+     *
+     * @param in The input stream
+     * @return What the run did
+     * @throws runtime_error If the forest cannot be saved at the end
+     */
+    BatchSummary run(istream &in);
+
+private:
+    /**
+     * @brief Runs one input record.
+     *
+     * @param line The record
+     * @throws invalid_argument If the record cannot be read
+     * @throws runtime_error If the command fails
+     */
+    void execute(string_view line);
+
+    /**
+     * @brief Queues a transaction, posting the queue once it is full.
+     *
+     * @param fields The fields `account|id|amount|type|date|description`
+     * @param count The number of fields
+     * @throws invalid_argument If the transaction cannot be read or the account does not exist
+     */
+    void queuePosting(const string_view *fields, size_t count);
+
+    /**
+     * @brief Posts every queued transaction.
+     */
+    void postQueue();
+
+    /**
+     * @brief Reports a failed record and counts it.
+     *
+     * @param lineNumber The line number of the record
+     * @param message What went wrong
+     */
+    void fail(size_t lineNumber, const string &message);
+
+    /**
+     * @brief Reads an account number field.
+     *
+     * @param field The field
+     * @return The account number
+     * @throws invalid_argument If the field is not a positive number
+     */
+    static int parseAccount(string_view field);
+};
+
+#endif //ADS_MIDTERM_PROJECT_BATCHRUNNER_H
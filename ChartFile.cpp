@@ -0,0 +1,356 @@
+//
+// Created on 10/14/2026.
+//
+
+/**
+ * @file ChartFile.cpp
+ * @brief Implements the `ChartFile` class, which parses chart of accounts files and saves their balances.
+ *
+ * Parsing works on the whole file held in memory in a single pass. Saving overwrites only the fixed-width balance
+ * fields of the accounts that changed, and falls back to an atomic rewrite of the whole file when that is not possible.
+ */
+
+#include "ChartFile.h"
+#include "DurableFile.h"
+#include "ForestMetrics.h"
+#include <fstream>
+#include <cctype>
+#include <cstdlib>
+#include <climits>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Default constructor for the `ChartFile` class.
+ */
+ChartFile::ChartFile() {}
+
+/**
+ * @brief Reads a whole file into memory with a single read.
+ *
+ * The file is read in binary mode, so the offsets of the parsed records are byte offsets in the file.
+ *
+ * @param filename The file to read
+ * @param buffer The string receiving the contents of the file
+ * @return True if the file could be opened, false otherwise
+ */
+bool ChartFile::readAll(const string &filename, string &buffer) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    buffer.clear();
+    file.seekg(0, ios::end);
+    streamoff size = file.tellg();
+    file.seekg(0, ios::beg);
+    if (size > 0) {
+        buffer.resize(static_cast<size_t>(size));
+        file.read(&buffer[0], size);
+        buffer.resize(static_cast<size_t>(file.gcount()));
+    }
+    return true;
+}
+
+/**
+ * @brief Atomically replaces the contents of a file.
+ *
+ * @param filename The file to replace
+ * @param contents The new contents of the file
+ * @throws runtime_error If the file cannot be written or replaced
+ *
+ * The contents are written to `filename.tmp`, which is then renamed over `filename`; see `DurableFile::replace`.
+ */
+void ChartFile::replaceFile(const string &filename, const string &contents) {
+    DurableFile::replace(filename, contents);
+}
+
+/**
+ * @brief Parses a whole chart file held in memory into account records.
+ *
+ * @param buffer The contents of the chart file
+ * @param records The vector the parsed records are appended to
+ * @param reportErrors Whether lines that cannot be parsed are reported on `cerr`
+ *
+ * Every line is scanned in place: the account number is read first, then the remaining whitespace-separated words are
+ * walked once. The last word is the balance if it starts with a number, in which case the words before it form the
+ * description; otherwise the balance is 0 and every word belongs to the description, as with the `Account` extraction
+ * operator.
+ */
+void ChartFile::parseRecords(const string &buffer, vector<ChartRecord> &records, bool reportErrors) {
+    const char *data = buffer.c_str();
+    size_t length = buffer.size();
+    size_t lineStart = 0;
+
+    while (lineStart < length) {
+        size_t lineEnd = buffer.find('\n', lineStart);
+        if (lineEnd == string::npos) {
+            lineEnd = length;
+        }
+        size_t nextLine = lineEnd + 1;
+        if (lineEnd > lineStart && data[lineEnd - 1] == '\r') {
+            --lineEnd;
+        }
+
+        size_t pos = lineStart;
+        while (pos < lineEnd && isspace(static_cast<unsigned char>(data[pos]))) {
+            ++pos;
+        }
+
+        // Skip empty lines
+        if (pos < lineEnd) {
+            char *numberEnd = nullptr;
+            long accNum = strtol(data + pos, &numberEnd, 10);
+            size_t numberLength = numberEnd - (data + pos);
+
+            if (numberLength == 0 || pos + numberLength > lineEnd || accNum <= 0 || accNum > INT_MAX) {
+                if (reportErrors) {
+                    cerr << "Error processing line: " << buffer.substr(lineStart, lineEnd - lineStart) << endl;
+                    cerr << "Error details: invalid account number" << endl;
+                }
+            } else {
+                pos += numberLength;
+                size_t fieldStart = pos + 1;
+
+                // Walk the remaining words, remembering where the description and the last word are
+                size_t descStart = string::npos, descEnd = string::npos;
+                size_t lastStart = string::npos, lastEnd = string::npos;
+                while (pos < lineEnd) {
+                    while (pos < lineEnd && isspace(static_cast<unsigned char>(data[pos]))) {
+                        ++pos;
+                    }
+                    if (pos == lineEnd) {
+                        break;
+                    }
+                    size_t wordStart = pos;
+                    while (pos < lineEnd && !isspace(static_cast<unsigned char>(data[pos]))) {
+                        ++pos;
+                    }
+                    if (lastStart != string::npos) {
+                        if (descStart == string::npos) {
+                            descStart = lastStart;
+                        }
+                        descEnd = lastEnd;
+                    }
+                    lastStart = wordStart;
+                    lastEnd = pos;
+                }
+
+                ChartRecord record;
+                record.accountNumber = static_cast<int>(accNum);
+                record.balance = Money();
+                record.lineStart = lineStart;
+                record.lineEnd = lineEnd;
+                record.balanceOffset = 0;
+                record.balanceWidth = 0;
+
+                if (lastStart != string::npos) {
+                    char *balanceEnd = nullptr;
+                    double partial = strtod(data + lastStart, &balanceEnd);
+                    Money bal;
+                    if (Money::parse(data + lastStart, data + lastEnd, bal)) {
+                        // The field runs from the separator after the description to the end of the line
+                        record.balance = bal;
+                        record.balanceOffset = descEnd != string::npos ? descEnd + 1 : fieldStart;
+                        record.balanceWidth = lastEnd - record.balanceOffset;
+                    } else if (balanceEnd != data + lastStart) {
+                        // Only the start of the word is a number, keep it as the balance
+                        record.balance = Money::fromDouble(partial);
+                    } else {
+                        // Not a balance: the last word is part of the description
+                        if (descStart == string::npos) {
+                            descStart = lastStart;
+                        }
+                        descEnd = lastEnd;
+                    }
+                }
+
+                // Join the description words with single spaces
+                if (descStart != string::npos) {
+                    record.description.reserve(descEnd - descStart);
+                    bool pendingSpace = false;
+                    for (size_t i = descStart; i < descEnd; ++i) {
+                        if (isspace(static_cast<unsigned char>(data[i]))) {
+                            pendingSpace = true;
+                            continue;
+                        }
+                        if (pendingSpace) {
+                            record.description += ' ';
+                            pendingSpace = false;
+                        }
+                        record.description += data[i];
+                    }
+                }
+
+                records.push_back(record);
+            }
+        }
+
+        lineStart = nextLine;
+    }
+}
+
+/**
+ * @brief Formats a balance right-aligned in a field of the given width.
+ *
+ * @param balance The balance to format
+ * @param width The width of the field
+ * @return The formatted field
+ */
+string ChartFile::formatBalance(Money balance, size_t width) {
+    string text = balance.toString();
+    if (text.size() < width) {
+        text.insert(0, width - text.size(), ' ');
+    }
+    return text;
+}
+
+/**
+ * @brief Starts tracking the balance fields of a chart file.
+ *
+ * @param filename The chart file the following `track` calls refer to
+ */
+void ChartFile::reset(const string &filename) {
+    path = filename;
+    fields.clear();
+}
+
+/**
+ * @brief Returns the chart file whose balance fields are tracked.
+ *
+ * @return The path of the tracked file
+ */
+const string &ChartFile::getPath() const {
+    return path;
+}
+
+/**
+ * @brief Remembers where the balance of an account is stored in the tracked file.
+ *
+ * @param record The parsed line of the account
+ */
+void ChartFile::track(const ChartRecord &record) {
+    BalanceField field = {record.balanceOffset, record.balanceWidth};
+    pair<unordered_map<int, BalanceField>::iterator, bool> inserted = fields.insert(
+            make_pair(record.accountNumber, field));
+    if (!inserted.second) {
+        inserted.first->second.width = 0;  // Duplicate line, always rewrite
+    }
+}
+
+/**
+ * @brief Overwrites the balance fields of the given accounts in the tracked file.
+ *
+ * @param balances The accounts to save, with their current balances
+ * @return True if the balances were written in place, false if a full rewrite is needed
+ * @throws runtime_error If the tracked file cannot be written
+ */
+bool ChartFile::writeInPlace(const vector<pair<int, Money>> &balances) {
+    if (path.empty()) {
+        return false;
+    }
+
+    // Check every field first, so either all balances are written or none
+    vector<pair<size_t, string>> writes;
+    writes.reserve(balances.size());
+    for (const auto &balance: balances) {
+        unordered_map<int, BalanceField>::const_iterator field = fields.find(balance.first);
+        if (field == fields.end() || field->second.width == 0) {
+            return false;
+        }
+        string text = formatBalance(balance.second, field->second.width);
+        if (text.size() != field->second.width) {
+            return false;
+        }
+        writes.push_back(make_pair(field->second.offset, text));
+    }
+
+    if (writes.empty()) {
+        return true;
+    }
+
+    fstream file(path, ios::in | ios::out | ios::binary);
+    if (!file.is_open()) {
+        throw runtime_error("Unable to open file for writing: " + path);
+    }
+    for (const auto &write: writes) {
+        file.seekp(static_cast<streamoff>(write.first));
+        file.write(write.second.data(), static_cast<streamsize>(write.second.size()));
+        ADS_METRICS_BYTES(write.second.size());
+    }
+    file.close();
+    if (!file) {
+        throw runtime_error("Unable to write balances to file: " + path);
+    }
+    DurableFile::syncPath(path);
+    return true;
+}
+
+/**
+ * @brief Rewrites a chart file with the current descriptions and balances of the forest.
+ *
+ * @param filename The chart file to write
+ * @param buffer The lines of the chart, separated by line breaks
+ * @param index The account index giving the current descriptions and balances
+ * @throws runtime_error If the file cannot be written or replaced
+ *
+ * The new contents are built in memory and written with `replaceFile`, so a failure never leaves a partially
+ * written chart behind. The field of every rebuilt line is tracked for later in-place saves.
+ */
+void ChartFile::rewrite(const string &filename, const string &buffer, const AccountIndex &index) {
+    vector<ChartRecord> records;
+    parseRecords(buffer, records, false);
+
+    string output;
+    output.reserve(buffer.size() + buffer.size() / 4);
+    vector<ChartRecord> written;
+    written.reserve(records.size());
+
+    size_t lineStart = 0;
+    size_t next = 0;
+    while (lineStart < buffer.size()) {
+        size_t lineEnd = buffer.find('\n', lineStart);
+        if (lineEnd == string::npos) {
+            lineEnd = buffer.size();
+        }
+
+        if (next < records.size() && records[next].lineStart == lineStart) {
+            const ChartRecord &record = records[next++];
+            AccountIndex::const_iterator node = index.find(record.accountNumber);
+            if (node != index.end()) {
+                // Rebuild the line with the current description and balance, the balance in a fixed-width field
+                const string &description = node->second->getData().getDescription();
+                ChartRecord line = record;
+                line.lineStart = output.size();
+                output += to_string(record.accountNumber);
+                output += ' ';
+                if (!description.empty()) {
+                    output += description;
+                    output += ' ';
+                }
+                line.balanceOffset = output.size();
+                string balance = formatBalance(node->second->getData().getBalance());
+                line.balanceWidth = balance.size();
+                output += balance;
+                line.lineEnd = output.size();
+                output += '\n';
+                written.push_back(line);
+                lineStart = lineEnd + 1;
+                continue;
+            }
+        }
+
+        // Keep lines that do not belong to the forest as they are
+        output.append(buffer, lineStart, lineEnd - lineStart);
+        output += '\n';
+        lineStart = lineEnd + 1;
+    }
+
+    replaceFile(filename, output);
+
+    reset(filename);
+    for (const ChartRecord &line: written) {
+        track(line);
+    }
+}
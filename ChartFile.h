@@ -0,0 +1,157 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_CHARTFILE_H
+#define ADS_MIDTERM_PROJECT_CHARTFILE_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "TreeNode.h"
+#include "Money.h"
+
+using namespace std;
+
+/**
+ * @brief One account line of a chart file, as parsed by `ChartFile::parseRecords`.
+ */
+struct ChartRecord {
+    int accountNumber;    ///< The account number
+    string description;   ///< The account description, words joined by single spaces
+    Money balance;        ///< The balance stored in the file
+    size_t lineStart;     ///< Offset of the first character of the line in the file
+    size_t lineEnd;       ///< Offset one past the last character of the line, before any line break
+    size_t balanceOffset; ///< Offset of the balance field, including the padding in front of the number
+    size_t balanceWidth;  ///< Width of the balance field, or 0 if the line has no balance
+};
+
+/**
+ * @class ChartFile
+ * @brief Reads and writes the whitespace-separated chart of accounts file.
+ *
+ * Every line of a chart file holds an account number, a description and the balance as the last word. Balances are
+ * written right-aligned in a fixed-width field, so `ChartFile` can remember where each balance lives in the file and
+ * overwrite only the balances that changed. When a balance does not fit its field, or an account has no known field,
+ * the file is rewritten as a whole into a temporary file that then replaces the chart.
+ */
+class ChartFile {
+public:
+    /**
+     * @brief The minimal width of a balance field written by `ChartFile`.
+     */
+    static const size_t BALANCE_WIDTH = 15;
+
+    /**
+     * @brief Default constructor for the `ChartFile` class.
+     *
+     * Creates a writer that does not track any file yet.
+     */
+    ChartFile();
+
+    /**
+     * @brief Reads a whole file into memory with a single read.
+     *
+     * @param filename The file to read
+     * @param buffer The string receiving the contents of the file
+     * @return True if the file could be opened, false otherwise
+     */
+    static bool readAll(const string &filename, string &buffer);
+
+    /**
+     * @brief Atomically replaces the contents of a file.
+     *
+     * The contents are written to a temporary file next to `filename`, which is synced and then renamed over it, so
+     * neither readers nor a crash ever leave a partially written file.
+     *
+     * @param filename The file to replace
+     * @param contents The new contents of the file
+     * @throws runtime_error If the file cannot be written or replaced
+     */
+    static void replaceFile(const string &filename, const string &contents);
+
+    /**
+     * @brief Parses a whole chart file held in memory into account records.
+     *
+     * The buffer is scanned once, line by line, without creating a stream or splitting a line into a vector. Each line
+     * follows the format read by `operator>>(istream&, Account&)`. Lines that do not start with a valid account number
+     * are skipped, and reported if requested.
+     *
+     * @param buffer The contents of the chart file
+     * @param records The vector the parsed records are appended to
+     * @param reportErrors Whether lines that cannot be parsed are reported on `cerr`
+     */
+    static void parseRecords(const string &buffer, vector<ChartRecord> &records, bool reportErrors = true);
+
+    /**
+     * @brief Formats a balance right-aligned in a field of the given width.
+     *
+     * @param balance The balance to format
+     * @param width The width of the field
+     * @return The formatted field, or a longer string if the balance does not fit
+     */
+    static string formatBalance(Money balance, size_t width = BALANCE_WIDTH);
+
+    /**
+     * @brief Starts tracking the balance fields of a chart file.
+     *
+     * @param filename The chart file the following `track` calls refer to
+     */
+    void reset(const string &filename);
+
+    /**
+     * @brief Returns the chart file whose balance fields are tracked.
+     *
+     * @return The path of the tracked file, or an empty string
+     */
+    const string &getPath() const;
+
+    /**
+     * @brief Remembers where the balance of an account is stored in the tracked file.
+     *
+     * An account that appears on several lines is marked as untracked, so it is always saved with a full rewrite.
+     *
+     * @param record The parsed line of the account
+     */
+    void track(const ChartRecord &record);
+
+    /**
+     * @brief Overwrites the balance fields of the given accounts in the tracked file.
+     *
+     * Nothing is written unless every balance has a known field wide enough for it.
+     *
+     * @param balances The accounts to save, with their current balances
+     * @return True if the balances were written in place, false if a full rewrite is needed
+     * @throws runtime_error If the tracked file cannot be written
+     */
+    bool writeInPlace(const vector<pair<int, Money>> &balances);
+
+    /**
+     * @brief Rewrites a chart file with the current descriptions and balances of the forest.
+     *
+     * Every line that belongs to an account of the forest is rebuilt with its current description and its balance in
+     * a fixed-width field, other lines are kept as they are. The result is written to a temporary file that then
+     * replaces `filename`, and `filename` becomes the tracked file.
+     *
+     * @param filename The chart file to write
+     * @param buffer The lines of the chart, separated by line breaks
+     * @param index The account index giving the current descriptions and balances
+     * @throws runtime_error If the file cannot be written or replaced
+     */
+    void rewrite(const string &filename, const string &buffer, const AccountIndex &index);
+
+private:
+    /**
+     * @brief Position of one balance field in the tracked file.
+     */
+    struct BalanceField {
+        size_t offset; ///< Offset of the field in the file
+        size_t width;  ///< Width of the field, or 0 if the account must be rewritten
+    };
+
+    string path;                               ///< The tracked chart file
+    unordered_map<int, BalanceField> fields;   ///< Balance field of every account of the tracked file
+};
+
+#endif //ADS_MIDTERM_PROJECT_CHARTFILE_H
@@ -0,0 +1,273 @@
+//
+// Created on 10/14/2026.
+//
+
+/**
+ * @file DateBalanceIndex.cpp
+ * @brief Implements the `DateBalanceIndex` class, the date-ordered prefix sums of an account's balance changes.
+ */
+
+#include "DateBalanceIndex.h"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Default constructor for the `DateBalanceIndex` class.
+ */
+DateBalanceIndex::DateBalanceIndex() : root(NONE), seed(0x9E3779B9u) {}
+
+/**
+ * @brief Adds a balance change on a date.
+ *
+ * @param date The date as `yyyymmdd`; 0 is ignored
+ * @param delta The signed balance change
+ *
+ * The change is added to the sums along the search path. A new date becomes a leaf and is rotated up while its
+ * priority is higher than its parent's, so every change, backdated or not, costs expected logarithmic time.
+ */
+void DateBalanceIndex::add(int32_t date, Money delta) {
+    if (date == 0) {
+        return;
+    }
+    root = insert(root, date, delta.getUnits());
+}
+
+/**
+ * @brief Replaces the contents of the index.
+ *
+ * @param entries The dates and balance changes in `Money` units; sorted in place
+ *
+ * Entries dated 0 are dropped and entries of the same date are added up. The treap is then built from the sorted
+ * dates in linear time with a stack holding its right spine: a new date takes the popped nodes of lower priority as
+ * its left subtree. A node is popped once its subtree is complete, which is when its sum is computed.
+ */
+void DateBalanceIndex::assign(vector<pair<int32_t, long long>> &entries) {
+    clear();
+    sort(entries.begin(), entries.end());
+    for (const pair<int32_t, long long> &entry: entries) {
+        if (entry.first == 0) {
+            continue;
+        }
+        if (!nodes.empty() && nodes.back().date == entry.first) {
+            nodes.back().change += entry.second;
+        } else {
+            create(entry.first, entry.second);
+        }
+    }
+
+    vector<int32_t> spine;
+    for (int32_t at = 0; at < static_cast<int32_t>(nodes.size()); ++at) {
+        int32_t last = NONE;
+        while (!spine.empty() && nodes[spine.back()].priority < nodes[at].priority) {
+            last = spine.back();
+            spine.pop_back();
+            update(last);
+        }
+        nodes[at].left = last;
+        if (!spine.empty()) {
+            nodes[spine.back()].right = at;
+        }
+        spine.push_back(at);
+    }
+    while (!spine.empty()) {
+        update(spine.back());
+        root = spine.back();
+        spine.pop_back();
+    }
+}
+
+/**
+ * @brief Appends the net change of every indexed date.
+ *
+ * @param entries Receives the dates, in ascending order, and their net change in `Money` units
+ *
+ * The treap is walked in order with an explicit stack.
+ */
+void DateBalanceIndex::collect(vector<pair<int32_t, long long>> &entries) const {
+    entries.reserve(entries.size() + nodes.size());
+    vector<int32_t> path;
+    int32_t at = root;
+    while (at != NONE || !path.empty()) {
+        while (at != NONE) {
+            path.push_back(at);
+            at = nodes[at].left;
+        }
+        at = path.back();
+        path.pop_back();
+        entries.push_back(make_pair(nodes[at].date, nodes[at].change));
+        at = nodes[at].right;
+    }
+}
+
+/**
+ * @brief Returns the total change dated on or before a date.
+ *
+ * @param date The last date included, as `yyyymmdd`
+ * @return The sum of the changes up to that date
+ */
+Money DateBalanceIndex::sumThrough(int32_t date) const {
+    return Money::fromUnits(prefix(date, true));
+}
+
+/**
+ * @brief Returns the total change dated within a range.
+ *
+ * @param fromDate The first date included, as `yyyymmdd`
+ * @param toDate The last date included, as `yyyymmdd`
+ * @return The sum of the changes in the range, or zero if the range is empty
+ */
+Money DateBalanceIndex::sumBetween(int32_t fromDate, int32_t toDate) const {
+    if (fromDate > toDate) {
+        return Money();
+    }
+    return Money::fromUnits(prefix(toDate, true) - prefix(fromDate, false));
+}
+
+/**
+ * @brief Returns the total change of all indexed dates.
+ *
+ * @return The sum of all changes
+ */
+Money DateBalanceIndex::total() const {
+    return Money::fromUnits(sumOf(root));
+}
+
+/**
+ * @brief Returns the number of distinct dates in the index.
+ *
+ * @return The number of dates
+ */
+size_t DateBalanceIndex::size() const {
+    return nodes.size();
+}
+
+/**
+ * @brief Removes every date.
+ */
+void DateBalanceIndex::clear() {
+    nodes.clear();
+    root = NONE;
+}
+
+/**
+ * @brief Returns the sum of the changes dated before a date, or on or before it.
+ *
+ * @param date The date
+ * @param inclusive True to include the changes of the date itself
+ * @return The sum in `Money` units
+ *
+ * Whenever the search goes right, the node and its left subtree are all dated before the date and are counted.
+ */
+long long DateBalanceIndex::prefix(int32_t date, bool inclusive) const {
+    long long sum = 0;
+    int32_t at = root;
+    while (at != NONE) {
+        const Node &node = nodes[at];
+        if (node.date < date || (inclusive && node.date == date)) {
+            sum += sumOf(node.left) + node.change;
+            at = node.right;
+        } else {
+            at = node.left;
+        }
+    }
+    return sum;
+}
+
+/**
+ * @brief Adds a change to a subtree, creating the date if needed, and rebalances it.
+ *
+ * @param at The position of the subtree root, or `NONE`
+ * @param date The date
+ * @param units The change in `Money` units
+ * @return The position of the new subtree root
+ *
+ * The recursion follows the search path, whose expected length is logarithmic. Nodes are referred to by position,
+ * since creating a node may move the others.
+ */
+int32_t DateBalanceIndex::insert(int32_t at, int32_t date, long long units) {
+    if (at == NONE) {
+        return create(date, units);
+    }
+    nodes[at].sum += units;
+    if (date == nodes[at].date) {
+        nodes[at].change += units;
+        return at;
+    }
+
+    if (date < nodes[at].date) {
+        int32_t child = insert(nodes[at].left, date, units);
+        nodes[at].left = child;
+        if (nodes[child].priority > nodes[at].priority) {
+            // Rotate right: the child becomes the root of the subtree
+            nodes[at].left = nodes[child].right;
+            nodes[child].right = at;
+            update(at);
+            update(child);
+            return child;
+        }
+    } else {
+        int32_t child = insert(nodes[at].right, date, units);
+        nodes[at].right = child;
+        if (nodes[child].priority > nodes[at].priority) {
+            // Rotate left: the child becomes the root of the subtree
+            nodes[at].right = nodes[child].left;
+            nodes[child].left = at;
+            update(at);
+            update(child);
+            return child;
+        }
+    }
+    return at;
+}
+
+/**
+ * @brief Appends a node for a new date.
+ *
+ * @param date The date
+ * @param units The change in `Money` units
+ * @return The position of the node
+ */
+int32_t DateBalanceIndex::create(int32_t date, long long units) {
+    Node node;
+    node.date = date;
+    node.priority = nextPriority();
+    node.left = NONE;
+    node.right = NONE;
+    node.change = units;
+    node.sum = units;
+    nodes.push_back(node);
+    return static_cast<int32_t>(nodes.size() - 1);
+}
+
+/**
+ * @brief Returns the total change of a subtree.
+ *
+ * @param at The position of the subtree root, or `NONE`
+ * @return The sum in `Money` units
+ */
+long long DateBalanceIndex::sumOf(int32_t at) const {
+    return at == NONE ? 0 : nodes[at].sum;
+}
+
+/**
+ * @brief Recomputes the total change of a node from its children.
+ *
+ * @param at The position of the node
+ */
+void DateBalanceIndex::update(int32_t at) {
+    nodes[at].sum = sumOf(nodes[at].left) + nodes[at].change + sumOf(nodes[at].right);
+}
+
+/**
+ * @brief Draws the next priority.
+ *
+ * @return A pseudo-random priority from a xorshift generator; balance only needs priorities that do not follow the
+ * order of the dates
+ */
+uint32_t DateBalanceIndex::nextPriority() {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
@@ -0,0 +1,168 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_DATEBALANCEINDEX_H
+#define ADS_MIDTERM_PROJECT_DATEBALANCEINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Money.h"
+
+using namespace std;
+
+/**
+ * @class DateBalanceIndex
+ * @brief Prefix sums of balance changes ordered by date.
+ *
+ * Holds the net balance change of every distinct date in a treap, a binary search tree balanced by random priorities,
+ * whose nodes also hold the total change of their subtree. The total change up to a date, or between two dates, is
+ * answered in logarithmic time, and so is every change, whether its date is known, after the last date or backdated
+ * before it. Dates are `yyyymmdd` integers as produced by `TransactionColumns::parseDateKey`; the unknown date 0 is
+ * never indexed. The nodes live in one vector and link to each other by position, so an index costs one allocation and
+ * 32 bytes per distinct date. Since every account indexes the dates of its whole subtree, a forest holds one entry
+ * per distinct date and ancestor of a posting, which is up to the number of distinct dates times the depth of the tree.
+ */
+class DateBalanceIndex {
+public:
+    /**
+     * @brief Default constructor for the `DateBalanceIndex` class.
+     *
+     * Creates an empty index.
+     */
+    DateBalanceIndex();
+
+    /**
+     * @brief Adds a balance change on a date.
+     *
+     * @param date The date as `yyyymmdd`; 0 is ignored
+     * @param delta The signed balance change
+     */
+    void add(int32_t date, Money delta);
+
+    /**
+     * @brief Replaces the contents of the index.
+     *
+     * @param entries The dates and balance changes in `Money` units, in any order and possibly repeated; sorted in place
+     */
+    void assign(vector<pair<int32_t, long long>> &entries);
+
+    /**
+     * @brief Appends the net change of every indexed date.
+     *
+     * @param entries Receives the dates, in ascending order, and their net change in `Money` units
+     */
+    void collect(vector<pair<int32_t, long long>> &entries) const;
+
+    /**
+     * @brief Returns the total change dated on or before a date.
+     *
+     * @param date The last date included, as `yyyymmdd`
+     * @return The sum of the changes up to that date
+     */
+    Money sumThrough(int32_t date) const;
+
+    /**
+     * @brief Returns the total change dated within a range.
+     *
+     * @param fromDate The first date included, as `yyyymmdd`
+     * @param toDate The last date included, as `yyyymmdd`
+     * @return The sum of the changes in the range, or zero if the range is empty
+     */
+    Money sumBetween(int32_t fromDate, int32_t toDate) const;
+
+    /**
+     * @brief Returns the total change of all indexed dates.
+     *
+     * @return The sum of all changes
+     */
+    Money total() const;
+
+    /**
+     * @brief Returns the number of distinct dates in the index.
+     *
+     * @return The number of dates
+     */
+    size_t size() const;
+
+    /**
+     * @brief Removes every date.
+     */
+    void clear();
+
+private:
+    /**
+     * @brief The position of a missing child.
+     */
+    static const int32_t NONE = -1;
+
+    /**
+     * @brief One date of the treap.
+     */
+    struct Node {
+        int32_t date;       ///< The date, as `yyyymmdd`
+        uint32_t priority;  ///< The random priority; no child has a higher one
+        int32_t left;       ///< The position of the subtree of earlier dates, or `NONE`
+        int32_t right;      ///< The position of the subtree of later dates, or `NONE`
+        long long change;   ///< The net change of the date, in `Money` units
+        long long sum;      ///< The net change of every date of the subtree, in `Money` units
+    };
+
+    vector<Node> nodes; ///< Every date, in no particular order
+    int32_t root;       ///< The position of the root, or `NONE` when empty
+    uint32_t seed;      ///< The state of the priority generator
+
+    /**
+     * @brief Returns the sum of the changes dated before a date, or on or before it.
+     *
+     * @param date The date
+     * @param inclusive True to include the changes of the date itself
+     * @return The sum in `Money` units
+     */
+    long long prefix(int32_t date, bool inclusive) const;
+
+    /**
+     * @brief Adds a change to a subtree, creating the date if needed, and rebalances it.
+     *
+     * @param at The position of the subtree root, or `NONE`
+     * @param date The date
+     * @param units The change in `Money` units
+     * @return The position of the new subtree root
+     */
+    int32_t insert(int32_t at, int32_t date, long long units);
+
+    /**
+     * @brief Appends a node for a new date.
+     *
+     * @param date The date
+     * @param units The change in `Money` units
+     * @return The position of the node
+     */
+    int32_t create(int32_t date, long long units);
+
+    /**
+     * @brief Returns the total change of a subtree.
+     *
+     * @param at The position of the subtree root, or `NONE`
+     * @return The sum in `Money` units, 0 for no subtree
+     */
+    long long sumOf(int32_t at) const;
+
+    /**
+     * @brief Recomputes the total change of a node from its children.
+     *
+     * @param at The position of the node
+     */
+    void update(int32_t at);
+
+    /**
+     * @brief Draws the next priority.
+     *
+     * @return A pseudo-random priority
+     */
+    uint32_t nextPriority();
+};
+
+#endif //ADS_MIDTERM_PROJECT_DATEBALANCEINDEX_H
@@ -0,0 +1,247 @@
+//
+// Created on 10/14/2026.
+//
+
+/**
+ * @file DurableFile.cpp
+ * @brief Implements `DurableFile`, appends and whole-file replacements that reach stable storage.
+ *
+ * POSIX systems use `open`, `write` and `fsync`; Windows uses the equivalent CRT calls and `_commit`, and has no
+ * directory sync.
+ */
+
+#include "DurableFile.h"
+#include "ForestMetrics.h"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief Describes the last error of a system call.
+ *
+ * @return The message of `errno`
+ */
+string lastError() {
+    return strerror(errno);
+}
+
+/**
+ * @brief Forces the data of an open file descriptor to stable storage.
+ *
+ * @param fd The file descriptor
+ * @return True on success, false otherwise
+ */
+bool syncDescriptor(int fd) {
+#ifdef _WIN32
+    return _commit(fd) == 0;
+#else
+    return fsync(fd) == 0;
+#endif
+}
+
+} // namespace
+
+/**
+ * @brief Default constructor for the `DurableFile` class.
+ */
+DurableFile::DurableFile() : fd(-1) {}
+
+/**
+ * @brief Destructor for the `DurableFile` class.
+ */
+DurableFile::~DurableFile() {
+    close();
+}
+
+/**
+ * @brief Opens a file for appending, creating it if needed.
+ *
+ * Any previously opened file is closed first.
+ *
+ * @param filename The path of the file
+ * @return True if the file was opened, false otherwise
+ */
+bool DurableFile::open(const string &filename) {
+    close();
+#ifdef _WIN32
+    fd = _open(filename.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+#endif
+    if (fd < 0) {
+        return false;
+    }
+    path = filename;
+    return true;
+}
+
+/**
+ * @brief Closes the file.
+ */
+void DurableFile::close() {
+    if (fd >= 0) {
+#ifdef _WIN32
+        _close(fd);
+#else
+        ::close(fd);
+#endif
+    }
+    fd = -1;
+    path.clear();
+}
+
+/**
+ * @brief Exchanges the open files of two objects.
+ *
+ * @param other The other file
+ */
+void DurableFile::swap(DurableFile &other) {
+    std::swap(fd, other.fd);
+}
+
+/**
+ * @brief Checks whether the file is open.
+ *
+ * @return True if the file is open, false otherwise
+ */
+bool DurableFile::isOpen() const {
+    return fd >= 0;
+}
+
+/**
+ * @brief Appends data at the end of the file.
+ *
+ * Short writes are retried until every byte is written.
+ *
+ * @param data The bytes to append
+ * @throws runtime_error If the data cannot be written completely
+ */
+void DurableFile::append(const string &data) {
+    size_t written = 0;
+    while (written < data.size()) {
+#ifdef _WIN32
+        int count = _write(fd, data.data() + written, static_cast<unsigned>(data.size() - written));
+#else
+        ssize_t count = ::write(fd, data.data() + written, data.size() - written);
+#endif
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            throw runtime_error("Unable to write " + path + ": " + lastError());
+        }
+        written += static_cast<size_t>(count);
+    }
+    ADS_METRICS_BYTES(data.size());
+}
+
+/**
+ * @brief Forces everything appended so far to stable storage.
+ *
+ * @throws runtime_error If the file cannot be synced
+ */
+void DurableFile::sync() {
+    if (!syncDescriptor(fd)) {
+        throw runtime_error("Unable to sync " + path + ": " + lastError());
+    }
+}
+
+/**
+ * @brief Forces the contents of a closed file to stable storage.
+ *
+ * @param filename The file
+ * @throws runtime_error If the file cannot be opened or synced
+ */
+void DurableFile::syncPath(const string &filename) {
+#ifdef _WIN32
+    int descriptor = _open(filename.c_str(), _O_RDWR | _O_BINARY);
+#else
+    int descriptor = ::open(filename.c_str(), O_RDONLY);
+#endif
+    if (descriptor < 0) {
+        throw runtime_error("Unable to open " + filename + " to sync it: " + lastError());
+    }
+    bool synced = syncDescriptor(descriptor);
+    string error = synced ? string() : lastError();
+#ifdef _WIN32
+    _close(descriptor);
+#else
+    ::close(descriptor);
+#endif
+    if (!synced) {
+        throw runtime_error("Unable to sync " + filename + ": " + error);
+    }
+}
+
+/**
+ * @brief Makes the creation, removal and renaming of the entries of a file's directory durable.
+ *
+ * @param filename A file of the directory
+ *
+ * Some file systems refuse to sync directories; that is not treated as an error, since the entries are then durable
+ * by other means.
+ */
+void DurableFile::syncDirectory(const string &filename) {
+#ifndef _WIN32
+    filesystem::path directory = filesystem::path(filename).parent_path();
+    string name = directory.empty() ? string(".") : directory.string();
+    int descriptor = ::open(name.c_str(), O_RDONLY);
+    if (descriptor >= 0) {
+        fsync(descriptor);
+        ::close(descriptor);
+    }
+#else
+    (void) filename;
+#endif
+}
+
+/**
+ * @brief Atomically and durably replaces the contents of a file.
+ *
+ * The contents are written to `<filename>.tmp` and synced, the temporary file is renamed over `filename`, and the
+ * directory is synced so the rename itself survives a crash.
+ *
+ * @param filename The file to replace
+ * @param contents The new contents
+ * @throws runtime_error If the file cannot be written or replaced
+ */
+void DurableFile::replace(const string &filename, const string &contents) {
+    string tempName = filename + ".tmp";
+    {
+        ofstream outFile(tempName, ios::binary | ios::trunc);
+        if (!outFile) {
+            throw runtime_error("Unable to open file for writing: " + tempName);
+        }
+        outFile.write(contents.data(), static_cast<streamsize>(contents.size()));
+        outFile.flush();
+        if (!outFile) {
+            throw runtime_error("Unable to write file: " + tempName);
+        }
+    }
+    syncPath(tempName);
+    ADS_METRICS_BYTES(contents.size());
+
+    error_code error;
+    filesystem::rename(tempName, filename, error);
+    if (error) {
+        throw runtime_error("Unable to replace " + filename + ": " + error.message());
+    }
+    syncDirectory(filename);
+}
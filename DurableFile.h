@@ -0,0 +1,114 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_DURABLEFILE_H
+#define ADS_MIDTERM_PROJECT_DURABLEFILE_H
+
+#include <string>
+
+using namespace std;
+
+/**
+ * @class DurableFile
+ * @brief An append-only file whose writes can be forced to stable storage, and helpers that sync whole files.
+ *
+ * Streams only hand their data to the operating system, so a crash of the machine can still lose or tear what they
+ * wrote. `DurableFile` writes through the file descriptor and makes the data durable with `fsync` (`_commit` on
+ * Windows). `replace` writes a file the way every save of the project should: into a temporary file that is synced,
+ * renamed over the target, and made durable by syncing the directory, so a crash leaves either the old or the new
+ * file in place.
+ */
+class DurableFile {
+private:
+    string path; ///< The path of the open file, empty while closed
+    int fd;      ///< The file descriptor, -1 while closed
+
+public:
+    /**
+     * @brief Default constructor for the `DurableFile` class.
+     *
+     * Creates a closed file.
+     */
+    DurableFile();
+
+    /**
+     * @brief Destructor for the `DurableFile` class.
+     *
+     * Closes the file without syncing it.
+     */
+    ~DurableFile();
+
+    DurableFile(const DurableFile &) = delete;
+    DurableFile &operator=(const DurableFile &) = delete;
+
+    /**
+     * @brief Opens a file for appending, creating it if needed.
+     *
+     * @param filename The path of the file
+     * @return True if the file was opened, false otherwise
+     */
+    bool open(const string &filename);
+
+    /**
+     * @brief Closes the file.
+     */
+    void close();
+
+    /**
+     * @brief Exchanges the open files of two objects.
+     *
+     * @param other The other file
+     */
+    void swap(DurableFile &other);
+
+    /**
+     * @brief Checks whether the file is open.
+     *
+     * @return True if data can be appended, false otherwise
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Appends data at the end of the file.
+     *
+     * @param data The bytes to append
+     * @throws runtime_error If the data cannot be written completely
+     */
+    void append(const string &data);
+
+    /**
+     * @brief Forces everything appended so far to stable storage.
+     *
+     * @throws runtime_error If the file cannot be synced
+     */
+    void sync();
+
+    /**
+     * @brief Forces the contents of a closed file to stable storage.
+     *
+     * @param filename The file
+     * @throws runtime_error If the file cannot be opened or synced
+     */
+    static void syncPath(const string &filename);
+
+    /**
+     * @brief Makes the creation, removal and renaming of the entries of a file's directory durable.
+     *
+     * @param filename A file of the directory
+     *
+     * Does nothing where directories cannot be synced.
+     */
+    static void syncDirectory(const string &filename);
+
+    /**
+     * @brief Atomically and durably replaces the contents of a file.
+     *
+     * @param filename The file to replace
+     * @param contents The new contents
+     * @throws runtime_error If the file cannot be written or replaced
+     */
+    static void replace(const string &filename, const string &contents);
+};
+
+#endif //ADS_MIDTERM_PROJECT_DURABLEFILE_H
@@ -0,0 +1,196 @@
+//
+// Created on 10/14/2026.
+//
+
+/**
+ * @file EulerTour.cpp
+ * @brief Implements `EulerTour`, the pre-order flattening of a forest with per-root Fenwick trees of transaction totals.
+ */
+
+#include "EulerTour.h"
+#include "TreeTraversal.h"
+
+using namespace std;
+
+EulerTour::EulerTour() {}
+
+/**
+ * @brief Flattens a forest and sums the transactions of every account.
+ *
+ * @param roots The root accounts, in forest order
+ *
+ * Every tree is walked once with `PreOrderIterator`. The positions still open at every depth are closed when the walk
+ * comes back to that depth, which gives every exit index without a second pass. The Fenwick tree of every root range
+ * is then built in linear time from the own totals.
+ */
+void EulerTour::build(const vector<NodePtr> &roots) {
+    clear();
+    vector<uint32_t> open;
+    for (NodePtr root: roots) {
+        uint32_t start = static_cast<uint32_t>(order.size());
+        for (PreOrderIterator it(root), end; it != end; ++it) {
+            uint32_t index = static_cast<uint32_t>(order.size());
+            while (open.size() > it.depth()) {
+                exits[open.back()] = index;
+                open.pop_back();
+            }
+            open.push_back(index);
+
+            (*it)->setTourIndex(index);
+            order.push_back(*it);
+            exits.push_back(0);
+            depths.push_back(static_cast<uint32_t>(it.depth()));
+            rootStart.push_back(start);
+            sums.push_back((*it)->getData().getTransactions().getColumns().netAmount().getUnits());
+        }
+        for (uint32_t index: open) {
+            exits[index] = static_cast<uint32_t>(order.size());
+        }
+        open.clear();
+
+        // Fenwick tree over [start, end): position start + i - 1 holds the sum of local range (i - lowbit(i), i]
+        size_t count = order.size() - start;
+        for (size_t i = 1; i <= count; ++i) {
+            size_t parent = i + (i & (~i + 1));
+            if (parent <= count) {
+                sums[start + parent - 1] += sums[start + i - 1];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Drops the tour.
+ */
+void EulerTour::clear() {
+    order.clear();
+    exits.clear();
+    depths.clear();
+    rootStart.clear();
+    sums.clear();
+}
+
+/**
+ * @brief Returns the number of accounts in the tour.
+ *
+ * @return The number of accounts
+ */
+size_t EulerTour::size() const {
+    return order.size();
+}
+
+/**
+ * @brief Returns the node at a position.
+ *
+ * @param index The position
+ * @return The node
+ */
+NodePtr EulerTour::at(size_t index) const {
+    return order[index];
+}
+
+/**
+ * @brief Returns the position of a node.
+ *
+ * @param node A node of the toured forest
+ * @return The enter index
+ */
+size_t EulerTour::enter(NodePtr node) const {
+    return node->getTourIndex();
+}
+
+/**
+ * @brief Returns one past the position of the last descendant of a node.
+ *
+ * @param node A node of the toured forest
+ * @return The exit index
+ */
+size_t EulerTour::exit(NodePtr node) const {
+    return exits[node->getTourIndex()];
+}
+
+/**
+ * @brief Returns the depth of a node below its root.
+ *
+ * @param node A node of the toured forest
+ * @return The depth
+ */
+size_t EulerTour::depth(NodePtr node) const {
+    return depths[node->getTourIndex()];
+}
+
+/**
+ * @brief Checks whether a node lies in the subtree of another, itself included.
+ *
+ * @param ancestor A node of the toured forest
+ * @param node A node of the toured forest
+ * @return True if node is ancestor or one of its descendants
+ */
+bool EulerTour::contains(NodePtr ancestor, NodePtr node) const {
+    size_t index = node->getTourIndex();
+    return ancestor->getTourIndex() <= index && index < exits[ancestor->getTourIndex()];
+}
+
+/**
+ * @brief Returns the first node of the subtree of a node.
+ *
+ * @param node A node of the toured forest
+ * @return A pointer into the pre-order array
+ */
+const NodePtr *EulerTour::subtreeBegin(NodePtr node) const {
+    return order.data() + node->getTourIndex();
+}
+
+/**
+ * @brief Returns one past the last node of the subtree of a node.
+ *
+ * @param node A node of the toured forest
+ * @return A pointer into the pre-order array
+ */
+const NodePtr *EulerTour::subtreeEnd(NodePtr node) const {
+    return order.data() + exits[node->getTourIndex()];
+}
+
+/**
+ * @brief Records a change of the own transaction total of an account.
+ *
+ * @param node A node of the toured forest
+ * @param delta The signed change
+ *
+ * Only the Fenwick tree of the node's root is touched.
+ */
+void EulerTour::addAmount(NodePtr node, Money delta) {
+    size_t index = node->getTourIndex();
+    size_t start = rootStart[index];
+    size_t count = exits[start] - start;
+    for (size_t i = index - start + 1; i <= count; i += i & (~i + 1)) {
+        sums[start + i - 1] += delta.getUnits();
+    }
+}
+
+/**
+ * @brief Returns the net amount of all transactions of a subtree.
+ *
+ * @param node A node of the toured forest
+ * @return The range sum over [enter, exit)
+ */
+Money EulerTour::subtreeAmount(NodePtr node) const {
+    size_t index = node->getTourIndex();
+    size_t start = rootStart[index];
+    return Money::fromUnits(prefixSum(start, exits[index]) - prefixSum(start, index));
+}
+
+/**
+ * @brief Returns the sum of the own transaction totals from the root of a tree up to a position.
+ *
+ * @param start The enter index of the root of the tree
+ * @param end One past the last position summed
+ * @return The sum in `Money` units
+ */
+long long EulerTour::prefixSum(size_t start, size_t end) const {
+    long long total = 0;
+    for (size_t i = end - start; i > 0; i -= i & (~i + 1)) {
+        total += sums[start + i - 1];
+    }
+    return total;
+}
@@ -0,0 +1,151 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_EULERTOUR_H
+#define ADS_MIDTERM_PROJECT_EULERTOUR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Money.h"
+#include "TreeNode.h"
+
+using namespace std;
+
+/**
+ * @class EulerTour
+ * @brief The accounts of a forest flattened in pre-order, so every subtree is a contiguous range.
+ *
+ * A node's enter index is its position in the pre-order array and its exit index is one past its last descendant,
+ * so the subtree of a node is exactly the range [enter, exit): membership is two comparisons and subtree scans read
+ * contiguous memory. Each node stores its enter index, see `TreeNode::getTourIndex`.
+ *
+ * Over the same positions the tour keeps a Fenwick tree of the net amount of every account's own transactions, one
+ * tree per root, so the transaction total of any subtree is a range sum in logarithmic time and postings update it in
+ * logarithmic time. A root tree's sums only touch its own range, so different roots can be updated in parallel.
+ *
+ * The tour describes the forest as it was when `build` ran; it must be rebuilt after accounts are added.
+ */
+class EulerTour {
+private:
+    vector<NodePtr> order;      ///< Every node in pre-order
+    vector<uint32_t> exits;     ///< One past the last descendant, by enter index
+    vector<uint32_t> depths;    ///< Depth below the root, by enter index
+    vector<uint32_t> rootStart; ///< Enter index of the root of the tree holding each position
+    vector<long long> sums;     ///< Fenwick trees over own transaction totals in `Money` units, one per root range
+
+public:
+    /**
+     * @brief Default constructor for the `EulerTour` class.
+     *
+     * Creates an empty tour.
+     */
+    EulerTour();
+
+    /**
+     * @brief Flattens a forest and sums the transactions of every account.
+     *
+     * Sets the tour index of every node.
+     *
+     * @param roots The root accounts, in forest order
+     */
+    void build(const vector<NodePtr> &roots);
+
+    /**
+     * @brief Drops the tour.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the number of accounts in the tour.
+     *
+     * @return The number of accounts
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the node at a position.
+     *
+     * @param index The position, below `size()`
+     * @return The node
+     */
+    NodePtr at(size_t index) const;
+
+    /**
+     * @brief Returns the position of a node.
+     *
+     * @param node A node of the toured forest
+     * @return The enter index
+     */
+    size_t enter(NodePtr node) const;
+
+    /**
+     * @brief Returns one past the position of the last descendant of a node.
+     *
+     * @param node A node of the toured forest
+     * @return The exit index
+     */
+    size_t exit(NodePtr node) const;
+
+    /**
+     * @brief Returns the depth of a node below its root.
+     *
+     * @param node A node of the toured forest
+     * @return 0 for a root, 1 for its children and so on
+     */
+    size_t depth(NodePtr node) const;
+
+    /**
+     * @brief Checks whether a node lies in the subtree of another, itself included.
+     *
+     * @param ancestor A node of the toured forest
+     * @param node A node of the toured forest
+     * @return True if the enter index of node lies within the range of ancestor
+     */
+    bool contains(NodePtr ancestor, NodePtr node) const;
+
+    /**
+     * @brief Returns the first node of the subtree of a node, which is the node itself.
+     *
+     * @param node A node of the toured forest
+     * @return A pointer into the pre-order array
+     */
+    const NodePtr *subtreeBegin(NodePtr node) const;
+
+    /**
+     * @brief Returns one past the last node of the subtree of a node.
+     *
+     * @param node A node of the toured forest
+     * @return A pointer into the pre-order array
+     */
+    const NodePtr *subtreeEnd(NodePtr node) const;
+
+    /**
+     * @brief Records a change of the own transaction total of an account.
+     *
+     * @param node A node of the toured forest
+     * @param delta The signed change
+     */
+    void addAmount(NodePtr node, Money delta);
+
+    /**
+     * @brief Returns the net amount of all transactions of a subtree.
+     *
+     * @param node A node of the toured forest
+     * @return The debits minus the credits of the account and all its descendants
+     */
+    Money subtreeAmount(NodePtr node) const;
+
+private:
+    /**
+     * @brief Returns the sum of the own transaction totals from the root of a tree up to a position.
+     *
+     * @param start The enter index of the root of the tree
+     * @param end One past the last position summed, within the range of the tree
+     * @return The sum in `Money` units
+     */
+    long long prefixSum(size_t start, size_t end) const;
+};
+
+#endif //ADS_MIDTERM_PROJECT_EULERTOUR_H
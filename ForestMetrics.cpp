@@ -0,0 +1,379 @@
+//
+// Created on 10/14/2026.
+//
+
+/**
+ * @file ForestMetrics.cpp
+ * @brief Implements `ForestMetrics`, the latency histograms and event counters of the forest.
+ *
+ * All measurements live in fixed arrays of atomics, written with relaxed ordering: a snapshot is not a consistent cut
+ * across counters, but no recording thread ever takes a lock.
+ */
+
+#include "ForestMetrics.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+const size_t OPERATION_COUNT = static_cast<size_t>(MetricOperation::COUNT);
+const size_t COUNTER_COUNT = static_cast<size_t>(MetricCounter::COUNT);
+
+/**
+ * @brief The live measurements of one operation.
+ */
+struct OperationCounters {
+    atomic<uint64_t> calls;                                       ///< Completed calls
+    atomic<uint64_t> totalNanos;                                  ///< Sum of the latencies
+    atomic<uint64_t> maxNanos;                                    ///< Longest latency
+    atomic<uint64_t> nodeVisits;                                  ///< Nodes visited during the operation
+    atomic<uint64_t> bytesWritten;                                ///< Bytes written during the operation
+    atomic<uint64_t> histogram[ForestMetrics::HISTOGRAM_BUCKETS]; ///< Calls per latency bucket
+};
+
+OperationCounters operations[OPERATION_COUNT];
+atomic<uint64_t> counters[COUNTER_COUNT];
+atomic<int64_t> startedAt(chrono::steady_clock::now().time_since_epoch().count());
+
+/**
+ * @brief The operation timed by the innermost `ScopedTimer` of this thread, -1 if none.
+ */
+thread_local int currentOperation = -1;
+
+/**
+ * @brief Finds the histogram bucket of a latency.
+ *
+ * @param nanos The latency, in nanoseconds
+ * @return The index of the highest set bit of `nanos`, capped by the last bucket; 0 for 0 and 1
+ */
+size_t bucketOf(uint64_t nanos) {
+    size_t bucket = 0;
+#if defined(__GNUC__) || defined(__clang__)
+    if (nanos > 1) {
+        bucket = static_cast<size_t>(63 - __builtin_clzll(nanos));
+    }
+#else
+    for (; nanos > 1; nanos >>= 1) {
+        ++bucket;
+    }
+#endif
+    return min(bucket, ForestMetrics::HISTOGRAM_BUCKETS - 1);
+}
+
+/**
+ * @brief The background thread of the periodic dump.
+ */
+struct MetricsDump {
+    mutex lock;                    ///< Guards every member below
+    condition_variable wake;       ///< Signalled when the dump is stopped
+    thread worker;                 ///< Writes the snapshots, not joinable while no dump runs
+    bool stopping = false;         ///< True once the worker should write its last snapshot and end
+    string path;                   ///< The file the snapshots are appended to
+    chrono::milliseconds interval; ///< The time between two snapshots
+
+    /**
+     * @brief Stops a dump still running when the program exits.
+     */
+    ~MetricsDump() {
+        ForestMetrics::stopDump();
+    }
+};
+
+MetricsDump dump;
+
+/**
+ * @brief Appends a snapshot to a file.
+ *
+ * @param path The file
+ */
+void appendSnapshot(const string &path) {
+    ofstream out(path, ios::app);
+    ForestMetrics::snapshot().write(out);
+}
+
+} // namespace
+
+/**
+ * @brief Estimates a latency percentile from the histogram.
+ *
+ * @param fraction The share of calls at or below the result
+ * @return The upper bound of the bucket holding the percentile, capped by the longest call
+ */
+uint64_t OperationMetrics::percentile(double fraction) const {
+    if (calls == 0) {
+        return 0;
+    }
+    uint64_t rank = max(uint64_t(1), static_cast<uint64_t>(fraction * static_cast<double>(calls) + 0.5));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < histogram.size(); ++bucket) {
+        seen += histogram[bucket];
+        if (seen >= rank) {
+            uint64_t upper = bucket + 1 < 64 ? (uint64_t(1) << (bucket + 1)) - 1 : UINT64_MAX;
+            return min(upper, maxNanos);
+        }
+    }
+    return maxNanos;
+}
+
+/**
+ * @brief Writes the snapshot as `|`-separated records.
+ *
+ * @param out The stream to write to
+ */
+void MetricsSnapshot::write(ostream &out) const {
+    out << "metrics|" << (enabled ? "enabled" : "disabled") << '|' << elapsedMillis << '\n';
+    for (const OperationMetrics &operation: operations) {
+        out << "operation|" << operation.name << '|' << operation.calls << '|' << operation.totalNanos / 1000 << '|'
+            << (operation.calls ? operation.totalNanos / operation.calls : 0) << '|' << operation.percentile(0.5)
+            << '|' << operation.percentile(0.99) << '|' << operation.maxNanos << '|' << operation.nodeVisits << '|'
+            << operation.bytesWritten << '\n';
+    }
+    for (const pair<string, uint64_t> &counter: counters) {
+        out << "counter|" << counter.first << '|' << counter.second << '\n';
+    }
+    out.flush();
+}
+
+/**
+ * @brief Starts timing an operation.
+ *
+ * @param operation The operation
+ */
+ForestMetrics::ScopedTimer::ScopedTimer(MetricOperation operation)
+        : operation(operation), previous(currentOperation), started(chrono::steady_clock::now()) {
+    currentOperation = static_cast<int>(operation);
+}
+
+/**
+ * @brief Records the elapsed time and restores the enclosing operation.
+ */
+ForestMetrics::ScopedTimer::~ScopedTimer() {
+    chrono::nanoseconds elapsed = chrono::steady_clock::now() - started;
+    record(operation, static_cast<uint64_t>(elapsed.count()));
+    currentOperation = previous;
+}
+
+/**
+ * @brief Checks whether the build collects metrics.
+ *
+ * @return True if built with `ADS_ENABLE_METRICS`
+ */
+bool ForestMetrics::isEnabled() {
+#ifdef ADS_ENABLE_METRICS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Records one call of an operation.
+ *
+ * @param operation The operation
+ * @param nanos The latency of the call, in nanoseconds
+ */
+void ForestMetrics::record(MetricOperation operation, uint64_t nanos) {
+    OperationCounters &live = operations[static_cast<size_t>(operation)];
+    live.calls.fetch_add(1, memory_order_relaxed);
+    live.totalNanos.fetch_add(nanos, memory_order_relaxed);
+    live.histogram[bucketOf(nanos)].fetch_add(1, memory_order_relaxed);
+    uint64_t longest = live.maxNanos.load(memory_order_relaxed);
+    while (nanos > longest && !live.maxNanos.compare_exchange_weak(longest, nanos, memory_order_relaxed)) {
+    }
+}
+
+/**
+ * @brief Adds to a counter.
+ *
+ * @param counter The counter
+ * @param amount The amount to add
+ */
+void ForestMetrics::add(MetricCounter counter, uint64_t amount) {
+    counters[static_cast<size_t>(counter)].fetch_add(amount, memory_order_relaxed);
+}
+
+/**
+ * @brief Counts visited nodes.
+ *
+ * @param nodes The number of nodes visited
+ */
+void ForestMetrics::addVisits(uint64_t nodes) {
+    add(MetricCounter::NODE_VISITS, nodes);
+    if (currentOperation >= 0) {
+        operations[currentOperation].nodeVisits.fetch_add(nodes, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Counts written bytes.
+ *
+ * @param bytes The number of bytes written
+ */
+void ForestMetrics::addBytes(uint64_t bytes) {
+    add(MetricCounter::BYTES_WRITTEN, bytes);
+    if (currentOperation >= 0) {
+        operations[currentOperation].bytesWritten.fetch_add(bytes, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Reads every measurement.
+ *
+ * @return The current values
+ */
+MetricsSnapshot ForestMetrics::snapshot() {
+    MetricsSnapshot result;
+    result.enabled = isEnabled();
+    chrono::steady_clock::duration elapsed = chrono::steady_clock::now().time_since_epoch() -
+                                             chrono::steady_clock::duration(startedAt.load(memory_order_relaxed));
+    result.elapsedMillis = static_cast<uint64_t>(chrono::duration_cast<chrono::milliseconds>(elapsed).count());
+
+    result.operations.resize(OPERATION_COUNT);
+    for (size_t i = 0; i < OPERATION_COUNT; ++i) {
+        const OperationCounters &live = operations[i];
+        OperationMetrics &operation = result.operations[i];
+        operation.name = name(static_cast<MetricOperation>(i));
+        operation.calls = live.calls.load(memory_order_relaxed);
+        operation.totalNanos = live.totalNanos.load(memory_order_relaxed);
+        operation.maxNanos = live.maxNanos.load(memory_order_relaxed);
+        operation.nodeVisits = live.nodeVisits.load(memory_order_relaxed);
+        operation.bytesWritten = live.bytesWritten.load(memory_order_relaxed);
+        operation.histogram.resize(HISTOGRAM_BUCKETS);
+        for (size_t bucket = 0; bucket < HISTOGRAM_BUCKETS; ++bucket) {
+            operation.histogram[bucket] = live.histogram[bucket].load(memory_order_relaxed);
+        }
+    }
+
+    result.counters.reserve(COUNTER_COUNT);
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        result.counters.push_back(make_pair(string(name(static_cast<MetricCounter>(i))),
+                                            counters[i].load(memory_order_relaxed)));
+    }
+    return result;
+}
+
+/**
+ * @brief Sets every measurement back to 0 and restarts the elapsed time.
+ */
+void ForestMetrics::reset() {
+    for (OperationCounters &live: operations) {
+        live.calls.store(0, memory_order_relaxed);
+        live.totalNanos.store(0, memory_order_relaxed);
+        live.maxNanos.store(0, memory_order_relaxed);
+        live.nodeVisits.store(0, memory_order_relaxed);
+        live.bytesWritten.store(0, memory_order_relaxed);
+        for (atomic<uint64_t> &bucket: live.histogram) {
+            bucket.store(0, memory_order_relaxed);
+        }
+    }
+    for (atomic<uint64_t> &counter: counters) {
+        counter.store(0, memory_order_relaxed);
+    }
+    startedAt.store(chrono::steady_clock::now().time_since_epoch().count(), memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the name of an operation.
+ *
+ * @param operation The operation
+ * @return The name
+ */
+const char *ForestMetrics::name(MetricOperation operation) {
+    switch (operation) {
+        case MetricOperation::FIND_ACCOUNT:
+            return "find_account";
+        case MetricOperation::ADD_TRANSACTION:
+            return "add_transaction";
+        case MetricOperation::POST_BATCH:
+            return "post_batch";
+        case MetricOperation::BALANCE_ROLLUP:
+            return "balance_rollup";
+        case MetricOperation::JOURNAL_COMMIT:
+            return "journal_commit";
+        case MetricOperation::SAVE_TO_FILE:
+            return "save_to_file";
+        case MetricOperation::SAVE_TRANSACTIONS:
+            return "save_transactions";
+        case MetricOperation::LOAD_TRANSACTIONS:
+            return "load_transactions";
+        default:
+            return "unknown";
+    }
+}
+
+/**
+ * @brief Returns the name of a counter.
+ *
+ * @param counter The counter
+ * @return The name
+ */
+const char *ForestMetrics::name(MetricCounter counter) {
+    switch (counter) {
+        case MetricCounter::NODE_VISITS:
+            return "node_visits";
+        case MetricCounter::BYTES_WRITTEN:
+            return "bytes_written";
+        case MetricCounter::NODE_ALLOCATIONS:
+            return "node_allocations";
+        case MetricCounter::BLOCK_ALLOCATIONS:
+            return "block_allocations";
+        case MetricCounter::COLUMN_GROWTHS:
+            return "column_growths";
+        case MetricCounter::JOURNAL_RECORDS:
+            return "journal_records";
+        case MetricCounter::JOURNAL_SYNCS:
+            return "journal_syncs";
+        default:
+            return "unknown";
+    }
+}
+
+/**
+ * @brief Starts appending a snapshot to a file at a fixed interval.
+ *
+ * @param filename The file to append to
+ * @param interval The time between two snapshots
+ * @return True if the file could be opened
+ */
+bool ForestMetrics::startDump(const string &filename, chrono::milliseconds interval) {
+    stopDump();
+    if (!ofstream(filename, ios::app)) {
+        return false;
+    }
+
+    lock_guard<mutex> guard(dump.lock);
+    dump.stopping = false;
+    dump.path = filename;
+    dump.interval = interval;
+    dump.worker = thread([]() {
+        unique_lock<mutex> guard(dump.lock);
+        while (!dump.wake.wait_for(guard, dump.interval, []() { return dump.stopping; })) {
+            appendSnapshot(dump.path);
+        }
+        appendSnapshot(dump.path);
+    });
+    return true;
+}
+
+/**
+ * @brief Writes a last snapshot and stops the periodic dump.
+ */
+void ForestMetrics::stopDump() {
+    thread worker;
+    {
+        lock_guard<mutex> guard(dump.lock);
+        if (!dump.worker.joinable()) {
+            return;
+        }
+        dump.stopping = true;
+        worker.swap(dump.worker);
+    }
+    dump.wake.notify_all();
+    worker.join();
+}
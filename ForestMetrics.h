@@ -0,0 +1,239 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_FORESTMETRICS_H
+#define ADS_MIDTERM_PROJECT_FORESTMETRICS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief The operations whose latency is measured by `ForestMetrics`.
+ */
+enum class MetricOperation {
+    FIND_ACCOUNT,      ///< `ForestTree::findAccount`
+    ADD_TRANSACTION,   ///< `ForestTree::addTransaction`, including the journal commit
+    POST_BATCH,        ///< `ForestTree::postBatch`, including the journal commit
+    BALANCE_ROLLUP,    ///< Bringing the balances of an account and its ancestors up to date after postings
+    JOURNAL_COMMIT,    ///< Waiting for a journal record to be written, or synced with durable commits
+    SAVE_TO_FILE,      ///< `ForestTree::saveToFile`
+    SAVE_TRANSACTIONS, ///< Writing a transactions file, also during `ForestTree::compactJournal`
+    LOAD_TRANSACTIONS, ///< Reading a transactions file, also during `ForestTree::buildFromFile`
+    COUNT              ///< The number of operations, not an operation
+};
+
+/**
+ * @brief The event counters kept by `ForestMetrics`, independent of any operation.
+ */
+enum class MetricCounter {
+    NODE_VISITS,       ///< Nodes visited by account lookups and balance rollups
+    BYTES_WRITTEN,     ///< Bytes written to the chart, snapshot, transactions and journal files
+    NODE_ALLOCATIONS,  ///< Tree nodes created in a `NodeArena`
+    BLOCK_ALLOCATIONS, ///< Node blocks allocated by a `NodeArena`
+    COLUMN_GROWTHS,    ///< Reallocations of the transaction columns of an account
+    JOURNAL_RECORDS,   ///< Records appended to the transaction journal
+    JOURNAL_SYNCS,     ///< Writes of the journal that ended with a sync, each covering a group of records
+    COUNT              ///< The number of counters, not a counter
+};
+
+/**
+ * @brief The measurements of one operation, as taken by `ForestMetrics::snapshot`.
+ */
+struct OperationMetrics {
+    string name;                ///< The name of the operation, as written by `MetricsSnapshot::write`
+    uint64_t calls = 0;         ///< The number of completed calls
+    uint64_t totalNanos = 0;    ///< The sum of the latencies of all calls, in nanoseconds
+    uint64_t maxNanos = 0;      ///< The longest call, in nanoseconds
+    uint64_t nodeVisits = 0;    ///< Nodes visited while the operation ran on the visiting thread
+    uint64_t bytesWritten = 0;  ///< Bytes written while the operation ran on the writing thread
+    vector<uint64_t> histogram; ///< Calls per latency bucket; bucket `i > 0` holds `[2^i, 2^(i+1))` nanoseconds
+
+    /**
+     * @brief Estimates a latency percentile from the histogram.
+     *
+     * @param fraction The share of calls at or below the result, between 0 and 1
+     * @return The upper bound of the bucket holding the percentile, in nanoseconds, capped by `maxNanos`; 0 if the
+     * operation was never called
+     */
+    uint64_t percentile(double fraction) const;
+};
+
+/**
+ * @brief The values of every measurement at one point in time.
+ */
+struct MetricsSnapshot {
+    bool enabled = false;                    ///< False if the build collects no metrics, in which case all are 0
+    uint64_t elapsedMillis = 0;              ///< Time since the metrics were started or last reset
+    vector<OperationMetrics> operations;     ///< One entry per `MetricOperation`, in declaration order
+    vector<pair<string, uint64_t>> counters; ///< The name and value of every `MetricCounter`, in declaration order
+
+    /**
+     * @brief Writes the snapshot as `|`-separated records.
+     *
+     * The first record is `metrics|enabled|elapsed_ms`. Every operation follows as
+     * `operation|name|calls|total_us|mean_ns|p50_ns|p99_ns|max_ns|node_visits|bytes_written`, then every counter as
+     * `counter|name|value`.
+     *
+     * @param out The stream to write to
+     */
+    void write(ostream &out) const;
+};
+
+/**
+ * @class ForestMetrics
+ * @brief Process-wide latency histograms and event counters of the forest's hot paths.
+ *
+ * Metrics are only collected when the project is built with `ADS_ENABLE_METRICS` defined (the CMake option of the
+ * same name). The code is instrumented through the `ADS_METRICS_*` macros below, which expand to nothing otherwise,
+ * so a regular build pays nothing for them. Every measurement is a relaxed atomic, so threads never wait on each
+ * other to record one.
+ *
+ * An operation is timed from construction to destruction of its `ScopedTimer`. Node visits and bytes written are
+ * added to their global counter and to the innermost operation timed on the same thread, so the cost of one save or
+ * one lookup can be read as `bytesWritten / calls` or `nodeVisits / calls`. Operations nest: a posting includes its
+ * rollup and its journal commit.
+ *
+ * `snapshot` reads all values at once, and `startDump` writes a snapshot to a file at a fixed interval from a
+ * background thread.
+ */
+class ForestMetrics {
+public:
+    /**
+     * @brief The number of latency buckets per operation; the last one also holds every longer call.
+     */
+    static const size_t HISTOGRAM_BUCKETS = 40;
+
+    /**
+     * @brief Times an operation for the duration of a scope.
+     */
+    class ScopedTimer {
+    private:
+        MetricOperation operation;                ///< The timed operation
+        int previous;                             ///< The operation timed by the enclosing timer, -1 if none
+        chrono::steady_clock::time_point started; ///< When the timer was created
+
+    public:
+        /**
+         * @brief Starts timing an operation and makes it the current operation of the thread.
+         *
+         * @param operation The operation
+         */
+        explicit ScopedTimer(MetricOperation operation);
+
+        /**
+         * @brief Records the elapsed time and restores the enclosing operation.
+         */
+        ~ScopedTimer();
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+    };
+
+    /**
+     * @brief Checks whether the build collects metrics.
+     *
+     * @return True if built with `ADS_ENABLE_METRICS`, false otherwise
+     */
+    static bool isEnabled();
+
+    /**
+     * @brief Records one call of an operation.
+     *
+     * @param operation The operation
+     * @param nanos The latency of the call, in nanoseconds
+     */
+    static void record(MetricOperation operation, uint64_t nanos);
+
+    /**
+     * @brief Adds to a counter.
+     *
+     * @param counter The counter
+     * @param amount The amount to add
+     */
+    static void add(MetricCounter counter, uint64_t amount);
+
+    /**
+     * @brief Counts visited nodes, for the visit counter and the current operation of the thread.
+     *
+     * @param nodes The number of nodes visited
+     */
+    static void addVisits(uint64_t nodes);
+
+    /**
+     * @brief Counts written bytes, for the byte counter and the current operation of the thread.
+     *
+     * @param bytes The number of bytes written
+     */
+    static void addBytes(uint64_t bytes);
+
+    /**
+     * @brief Reads every measurement.
+     *
+     * @return The current values; values recorded while the snapshot is taken may or may not be included
+     */
+    static MetricsSnapshot snapshot();
+
+    /**
+     * @brief Sets every measurement back to 0 and restarts the elapsed time.
+     */
+    static void reset();
+
+    /**
+     * @brief Returns the name of an operation.
+     *
+     * @param operation The operation
+     * @return The name, in lower case with underscores
+     */
+    static const char *name(MetricOperation operation);
+
+    /**
+     * @brief Returns the name of a counter.
+     *
+     * @param counter The counter
+     * @return The name, in lower case with underscores
+     */
+    static const char *name(MetricCounter counter);
+
+    /**
+     * @brief Starts appending a snapshot to a file at a fixed interval.
+     *
+     * Any running dump is stopped first. The dump writes one last snapshot when it is stopped, or when the program
+     * exits.
+     *
+     * @param filename The file to append to
+     * @param interval The time between two snapshots
+     * @return True if the file could be opened, false otherwise
+     */
+    static bool startDump(const string &filename, chrono::milliseconds interval);
+
+    /**
+     * @brief Writes a last snapshot and stops the periodic dump, if one runs.
+     */
+    static void stopDump();
+};
+
+#ifdef ADS_ENABLE_METRICS
+/// Times the rest of the enclosing scope as one call of a `MetricOperation`
+#define ADS_METRICS_TIME(operation) ForestMetrics::ScopedTimer metricsTimer(MetricOperation::operation)
+/// Adds to a `MetricCounter`
+#define ADS_METRICS_COUNT(counter, amount) ForestMetrics::add(MetricCounter::counter, (amount))
+/// Counts visited nodes for the current operation
+#define ADS_METRICS_VISITS(nodes) ForestMetrics::addVisits(nodes)
+/// Counts written bytes for the current operation
+#define ADS_METRICS_BYTES(bytes) ForestMetrics::addBytes(bytes)
+#else
+#define ADS_METRICS_TIME(operation) ((void) 0)
+#define ADS_METRICS_COUNT(counter, amount) ((void) 0)
+#define ADS_METRICS_VISITS(nodes) ((void) 0)
+#define ADS_METRICS_BYTES(bytes) ((void) 0)
+#endif
+
+#endif //ADS_MIDTERM_PROJECT_FORESTMETRICS_H
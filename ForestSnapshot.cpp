@@ -0,0 +1,473 @@
+//
+// Created on 10/14/2026.
+//
+
+/**
+ * @file ForestSnapshot.cpp
+ * @brief Implements the binary snapshot format of a forest and its transactions.
+ *
+ * Snapshots are written in the byte order of the host and read back with `memcpy`, so loading one is a matter of
+ * validating the offsets once and copying fixed-size records, without any tokenizing or number parsing.
+ */
+
+#include "ForestSnapshot.h"
+#include "DurableFile.h"
+#include "ForestMetrics.h"
+#include "TreeTraversal.h"
+#include <cstring>
+#include <climits>
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+const char ForestSnapshot::MAGIC[8] = {'A', 'D', 'S', 'F', 'O', 'R', 'S', 'T'};
+
+namespace {
+
+    /**
+     * @brief Checks that a string range lies inside a string pool.
+     *
+     * @param offset The offset of the string
+     * @param length The length of the string
+     * @param poolSize The size of the pool
+     * @return True if the range is inside the pool, false otherwise
+     */
+    bool inPool(uint32_t offset, uint32_t length, uint64_t poolSize) {
+        return static_cast<uint64_t>(offset) + length <= poolSize;
+    }
+
+    /**
+     * @brief Collects the strings of a snapshot, storing every distinct string once.
+     */
+    class StringPoolWriter {
+    public:
+        /**
+         * @brief Adds a string to the pool.
+         *
+         * @param text The string to add
+         * @param offset Receives the offset of the string
+         * @param length Receives the length of the string
+         * @throws runtime_error If the pool grows beyond the format limit
+         */
+        void add(const string &text, uint32_t &offset, uint32_t &length) {
+            if (text.size() > UINT32_MAX) {
+                throw runtime_error("String too long for snapshot");
+            }
+            length = static_cast<uint32_t>(text.size());
+            if (text.empty()) {
+                offset = 0;
+                return;
+            }
+            unordered_map<string, uint32_t>::const_iterator found = offsets.find(text);
+            if (found != offsets.end()) {
+                offset = found->second;
+                return;
+            }
+            if (pool.size() + text.size() > UINT32_MAX) {
+                throw runtime_error("Too much text for snapshot");
+            }
+            offset = static_cast<uint32_t>(pool.size());
+            pool += text;
+            offsets.emplace(text, offset);
+        }
+
+        /**
+         * @brief Returns the bytes of the pool.
+         *
+         * @return The pool
+         */
+        const string &getPool() const {
+            return pool;
+        }
+
+    private:
+        string pool;                              ///< The strings, back to back
+        unordered_map<string, uint32_t> offsets;  ///< Offset of every string already in the pool
+    };
+
+    /**
+     * @brief Appends the bytes of a record to a buffer.
+     *
+     * @param buffer The buffer to append to
+     * @param record The record to append
+     */
+    template<typename Record>
+    void appendRecord(string &buffer, const Record &record) {
+        buffer.append(reinterpret_cast<const char *>(&record), sizeof(Record));
+    }
+}
+
+/**
+ * @brief Default constructor for the `SnapshotView` class.
+ */
+SnapshotView::SnapshotView() : data(nullptr), header(), accountsStart(0), transactionsStart(0), stringsStart(0) {}
+
+/**
+ * @brief Validates a snapshot and makes it available through the accessors.
+ *
+ * @param bytes The first byte of the snapshot
+ * @param size The size of the snapshot in bytes
+ * @param error Receives the reason when the snapshot is rejected
+ * @return True if the snapshot is valid, false otherwise
+ *
+ * Besides the header and the section sizes, every account is checked to be linked exactly once as the first child of
+ * its parent, as the next sibling of the previous child or as a root, with indices that only point forward, so the
+ * accounts always describe a forest. Transaction ranges must follow each other in account order.
+ */
+bool SnapshotView::open(const char *bytes, size_t size, string &error) {
+    data = nullptr;
+    if (size < ForestSnapshot::VERSION_1_HEADER_SIZE) {
+        error = "file is too short";
+        return false;
+    }
+    memset(&header, 0, sizeof(header));
+    memcpy(&header, bytes, ForestSnapshot::VERSION_1_HEADER_SIZE);
+    if (memcmp(header.magic, ForestSnapshot::MAGIC, sizeof(header.magic)) != 0) {
+        error = "not a snapshot file";
+        return false;
+    }
+    if (header.byteOrder != ForestSnapshot::BYTE_ORDER_MARK) {
+        error = "snapshot was saved with another byte order";
+        return false;
+    }
+    if (header.version != 1 && header.version != ForestSnapshot::VERSION) {
+        error = "unsupported snapshot version " + to_string(header.version);
+        return false;
+    }
+    size_t headerSize = header.version == 1 ? ForestSnapshot::VERSION_1_HEADER_SIZE : sizeof(SnapshotHeader);
+    if (size < headerSize) {
+        error = "file is too short";
+        return false;
+    }
+    memcpy(&header, bytes, headerSize);
+    if (header.moneyDecimals != Money::DECIMALS) {
+        error = "snapshot amounts use " + to_string(header.moneyDecimals) + " decimals instead of " +
+                to_string(Money::DECIMALS);
+        return false;
+    }
+
+    // Check the section sizes without overflowing
+    uint64_t remaining = size - headerSize;
+    if (header.accountCount > INT32_MAX || header.accountCount > remaining / sizeof(SnapshotAccount)) {
+        error = "truncated accounts array";
+        return false;
+    }
+    remaining -= header.accountCount * sizeof(SnapshotAccount);
+    if (header.transactionCount > remaining / sizeof(SnapshotTransaction)) {
+        error = "truncated transactions array";
+        return false;
+    }
+    remaining -= header.transactionCount * sizeof(SnapshotTransaction);
+    if (header.stringPoolSize != remaining) {
+        error = "string pool size does not match the file size";
+        return false;
+    }
+
+    data = bytes;
+    accountsStart = headerSize;
+    transactionsStart = accountsStart + header.accountCount * sizeof(SnapshotAccount);
+    stringsStart = transactionsStart + header.transactionCount * sizeof(SnapshotTransaction);
+
+    int32_t count = static_cast<int32_t>(header.accountCount);
+    vector<char> linked(header.accountCount, 0);
+    if (count > 0) {
+        linked[0] = 1;  // The first root
+    }
+    uint64_t nextTransaction = 0;
+
+    for (int32_t i = 0; i < count; ++i) {
+        SnapshotAccount account = getAccount(i);
+        bool valid = (account.parent >= -1 && account.parent < i) &&
+                     inPool(account.descriptionOffset, account.descriptionLength, header.stringPoolSize) &&
+                     account.firstTransaction == nextTransaction &&
+                     account.transactionCount <= header.transactionCount - nextTransaction;
+        if (valid && account.firstChild != -1) {
+            valid = account.firstChild > i && account.firstChild < count && !linked[account.firstChild] &&
+                    getAccount(account.firstChild).parent == i;
+            if (valid) {
+                linked[account.firstChild] = 1;
+            }
+        }
+        if (valid && account.nextSibling != -1) {
+            valid = account.nextSibling > i && account.nextSibling < count && !linked[account.nextSibling] &&
+                    getAccount(account.nextSibling).parent == account.parent;
+            if (valid) {
+                linked[account.nextSibling] = 1;
+            }
+        }
+        if (!valid || !linked[i]) {
+            data = nullptr;
+            error = "invalid account record " + to_string(i);
+            return false;
+        }
+        nextTransaction += account.transactionCount;
+    }
+    if (nextTransaction != header.transactionCount) {
+        data = nullptr;
+        error = "transactions do not belong to the accounts";
+        return false;
+    }
+
+    for (uint64_t i = 0; i < header.transactionCount; ++i) {
+        SnapshotTransaction t = getTransaction(i);
+        if (!inPool(t.idOffset, t.idLength, header.stringPoolSize) ||
+            !inPool(t.dateOffset, t.dateLength, header.stringPoolSize) ||
+            !inPool(t.descriptionOffset, t.descriptionLength, header.stringPoolSize)) {
+            data = nullptr;
+            error = "invalid transaction record " + to_string(i);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the header of the snapshot.
+ *
+ * @return The header
+ */
+const SnapshotHeader &SnapshotView::getHeader() const {
+    return header;
+}
+
+/**
+ * @brief Returns an account of the snapshot.
+ *
+ * @param index The index of the account
+ * @return The account record
+ */
+SnapshotAccount SnapshotView::getAccount(size_t index) const {
+    SnapshotAccount account;
+    memcpy(&account, data + accountsStart + index * sizeof(SnapshotAccount), sizeof(SnapshotAccount));
+    return account;
+}
+
+/**
+ * @brief Returns where the balance of an account is stored in the snapshot.
+ *
+ * @param index The index of the account
+ * @return The offset of the balance from the first byte of the snapshot
+ */
+size_t SnapshotView::getBalanceOffset(size_t index) const {
+    return accountsStart + index * sizeof(SnapshotAccount) + offsetof(SnapshotAccount, balance);
+}
+
+/**
+ * @brief Returns a transaction of the snapshot.
+ *
+ * @param index The index of the transaction
+ * @return The transaction record
+ */
+SnapshotTransaction SnapshotView::getTransaction(size_t index) const {
+    SnapshotTransaction t;
+    memcpy(&t, data + transactionsStart + index * sizeof(SnapshotTransaction), sizeof(SnapshotTransaction));
+    return t;
+}
+
+/**
+ * @brief Returns a string of the string pool.
+ *
+ * @param offset The offset of the string in the pool
+ * @param length The length of the string
+ * @return A view of the string in the snapshot bytes
+ */
+string_view SnapshotView::getString(uint32_t offset, uint32_t length) const {
+    return string_view(data + stringsStart + offset, length);
+}
+
+/**
+ * @brief Default constructor for the `ForestSnapshot` class.
+ */
+ForestSnapshot::ForestSnapshot() {}
+
+/**
+ * @brief Checks whether a buffer holds a snapshot rather than a text chart.
+ *
+ * @param buffer The contents of a file
+ * @return True if the buffer starts with the snapshot magic bytes, false otherwise
+ */
+bool ForestSnapshot::isSnapshot(const string &buffer) {
+    return buffer.size() >= sizeof(MAGIC) && memcmp(buffer.data(), MAGIC, sizeof(MAGIC)) == 0;
+}
+
+/**
+ * @brief Encodes a forest and all its transactions as a snapshot.
+ *
+ * @param roots The root accounts of the forest
+ * @param checkpoint The sequence number of the last journal record the forest holds, 0 if none
+ * @return The snapshot bytes
+ * @throws runtime_error If the forest is too large for the format
+ *
+ * The forest is walked with `PreOrderIterator`, so deep charts and long sibling lists do not recurse. The last
+ * account written at every depth is remembered: it is the parent of the next deeper account and the previous
+ * sibling of the next account at the same depth, whose index is only known once the subtree in between is written.
+ */
+string ForestSnapshot::encode(const vector<NodePtr> &roots, uint64_t checkpoint) {
+    vector<SnapshotAccount> accounts;
+    vector<SnapshotTransaction> transactions;
+    StringPoolWriter strings;
+
+    // path[d] is the last account written at depth d of the current tree
+    vector<int32_t> path;
+
+    for (NodePtr root: roots) {
+        for (PreOrderIterator it(root), end; it != end; ++it) {
+            if (accounts.size() >= INT32_MAX) {
+                throw runtime_error("Too many accounts for snapshot");
+            }
+            size_t depth = it.depth();
+            int32_t index = static_cast<int32_t>(accounts.size());
+            int32_t parent = depth == 0 ? -1 : path[depth - 1];
+            if (depth > 0 && path.size() > depth) {
+                accounts[path[depth]].nextSibling = index;
+            } else if (parent != -1) {
+                accounts[parent].firstChild = index;
+            }
+            path.resize(depth);
+            path.push_back(index);
+
+            const Account &account = (*it)->getData();
+            SnapshotAccount record;
+            memset(&record, 0, sizeof(record));
+            record.accountNumber = account.getAccountNumber();
+            record.parent = parent;
+            record.firstChild = -1;
+            record.nextSibling = -1;
+            record.balance = account.getBalance().getUnits();
+            strings.add(account.getDescription(), record.descriptionOffset, record.descriptionLength);
+            record.firstTransaction = transactions.size();
+            record.transactionCount = account.getTransactions().size();
+            accounts.push_back(record);
+
+            const TransactionColumns &columns = account.getTransactions().getColumns();
+            for (size_t i = 0; i < columns.slotCount(); ++i) {
+                if (columns.isDeleted(i)) {
+                    continue;
+                }
+                SnapshotTransaction packed;
+                memset(&packed, 0, sizeof(packed));
+                packed.amount = columns.getAmount(i).getUnits();
+                strings.add(columns.getTransactionID(i), packed.idOffset, packed.idLength);
+                strings.add(columns.getDate(i), packed.dateOffset, packed.dateLength);
+                strings.add(columns.getDescription(i), packed.descriptionOffset, packed.descriptionLength);
+                packed.debitCredit = columns.getDebitCredit(i);
+                transactions.push_back(packed);
+            }
+        }
+    }
+
+    // Link the roots to each other
+    int32_t lastRoot = -1;
+    for (size_t i = 0; i < accounts.size(); ++i) {
+        if (accounts[i].parent == -1) {
+            if (lastRoot != -1) {
+                accounts[lastRoot].nextSibling = static_cast<int32_t>(i);
+            }
+            lastRoot = static_cast<int32_t>(i);
+        }
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.version = VERSION;
+    header.moneyDecimals = Money::DECIMALS;
+    header.accountCount = accounts.size();
+    header.transactionCount = transactions.size();
+    header.stringPoolSize = strings.getPool().size();
+    header.checkpoint = checkpoint;
+
+    string output;
+    output.reserve(sizeof(header) + accounts.size() * sizeof(SnapshotAccount) +
+                   transactions.size() * sizeof(SnapshotTransaction) + strings.getPool().size());
+    appendRecord(output, header);
+    for (const SnapshotAccount &record: accounts) {
+        appendRecord(output, record);
+    }
+    for (const SnapshotTransaction &record: transactions) {
+        appendRecord(output, record);
+    }
+    output += strings.getPool();
+    return output;
+}
+
+/**
+ * @brief Starts tracking the balances of a snapshot file.
+ *
+ * @param filename The snapshot file
+ * @param snapshot A view of the contents of that file
+ */
+void ForestSnapshot::reset(const string &filename, const SnapshotView &snapshot) {
+    path = filename;
+    balanceOffsets.clear();
+    size_t count = static_cast<size_t>(snapshot.getHeader().accountCount);
+    balanceOffsets.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        balanceOffsets.emplace(snapshot.getAccount(i).accountNumber, snapshot.getBalanceOffset(i));
+    }
+}
+
+/**
+ * @brief Tracks a snapshot file without knowing where its balances are.
+ *
+ * @param filename The snapshot file, or an empty string to stop tracking
+ */
+void ForestSnapshot::reset(const string &filename) {
+    path = filename;
+    balanceOffsets.clear();
+}
+
+/**
+ * @brief Returns the snapshot file whose balances are tracked.
+ *
+ * @return The path of the tracked file
+ */
+const string &ForestSnapshot::getPath() const {
+    return path;
+}
+
+/**
+ * @brief Overwrites the balances of the given accounts in the tracked file.
+ *
+ * @param balances The accounts to save, with their current balances
+ * @return True if the balances were written in place, false if the snapshot must be rewritten
+ * @throws runtime_error If the tracked file cannot be written
+ */
+bool ForestSnapshot::writeBalances(const vector<pair<int, Money>> &balances) {
+    if (path.empty()) {
+        return false;
+    }
+
+    // Check every account first, so either all balances are written or none
+    vector<pair<size_t, int64_t>> writes;
+    writes.reserve(balances.size());
+    for (const auto &balance: balances) {
+        unordered_map<int, size_t>::const_iterator offset = balanceOffsets.find(balance.first);
+        if (offset == balanceOffsets.end()) {
+            return false;
+        }
+        writes.push_back(make_pair(offset->second, static_cast<int64_t>(balance.second.getUnits())));
+    }
+
+    if (writes.empty()) {
+        return true;
+    }
+
+    fstream file(path, ios::in | ios::out | ios::binary);
+    if (!file.is_open()) {
+        throw runtime_error("Unable to open file for writing: " + path);
+    }
+    for (const auto &write: writes) {
+        file.seekp(static_cast<streamoff>(write.first));
+        file.write(reinterpret_cast<const char *>(&write.second), sizeof(write.second));
+    }
+    ADS_METRICS_BYTES(writes.size() * sizeof(int64_t));
+    file.close();
+    if (!file) {
+        throw runtime_error("Unable to write balances to file: " + path);
+    }
+    DurableFile::syncPath(path);
+    return true;
+}
@@ -0,0 +1,242 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_FORESTSNAPSHOT_H
+#define ADS_MIDTERM_PROJECT_FORESTSNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+#include "TreeNode.h"
+#include "Money.h"
+
+using namespace std;
+
+/**
+ * @brief Fixed-size header at the start of a snapshot file.
+ *
+ * The header is followed by the accounts array, the transactions array and the string pool, in that order. Version 1
+ * headers end before `checkpoint`.
+ */
+struct SnapshotHeader {
+    char magic[8];             ///< Always `ForestSnapshot::MAGIC`
+    uint32_t byteOrder;        ///< `ForestSnapshot::BYTE_ORDER_MARK` as written by the host that saved the file
+    uint16_t version;          ///< Format version, `ForestSnapshot::VERSION`
+    uint16_t moneyDecimals;    ///< `Money::DECIMALS` of the program that saved the file
+    uint64_t accountCount;     ///< Number of entries in the accounts array
+    uint64_t transactionCount; ///< Number of entries in the transactions array
+    uint64_t stringPoolSize;   ///< Size of the string pool in bytes
+    uint64_t checkpoint;       ///< Sequence number of the last journal record the snapshot holds, 0 if none
+};
+
+/**
+ * @brief One account of a snapshot. Accounts are stored in pre-order, so a parent always comes before its children.
+ */
+struct SnapshotAccount {
+    int32_t accountNumber;       ///< The account number
+    int32_t parent;              ///< Index of the parent account, or -1 for a root
+    int32_t firstChild;          ///< Index of the first child, or -1 for a leaf
+    int32_t nextSibling;         ///< Index of the next sibling (or next root), or -1 for the last one
+    int64_t balance;             ///< The balance, in `Money` units
+    uint32_t descriptionOffset;  ///< Offset of the description in the string pool
+    uint32_t descriptionLength;  ///< Length of the description
+    uint64_t firstTransaction;   ///< Index of the first transaction of the account
+    uint64_t transactionCount;   ///< Number of transactions of the account
+};
+
+/**
+ * @brief One transaction of a snapshot. Transactions are grouped by account, in the order of the accounts array.
+ */
+struct SnapshotTransaction {
+    int64_t amount;              ///< The amount, in `Money` units
+    uint32_t idOffset;           ///< Offset of the transaction ID in the string pool
+    uint32_t idLength;           ///< Length of the transaction ID
+    uint32_t dateOffset;         ///< Offset of the date in the string pool
+    uint32_t dateLength;         ///< Length of the date
+    uint32_t descriptionOffset;  ///< Offset of the description in the string pool
+    uint32_t descriptionLength;  ///< Length of the description
+    char debitCredit;            ///< 'D' for debit, 'C' for credit
+    char reserved[7];            ///< Padding, always zero
+};
+
+static_assert(sizeof(SnapshotHeader) == 48, "unexpected snapshot header layout");
+static_assert(sizeof(SnapshotAccount) == 48, "unexpected snapshot account layout");
+static_assert(sizeof(SnapshotTransaction) == 40, "unexpected snapshot transaction layout");
+
+/**
+ * @class SnapshotView
+ * @brief Read-only view of a snapshot held in memory.
+ *
+ * The view does not copy or tokenize anything: the records are read straight from the bytes of the file, which may be
+ * a buffer filled by one read or a memory-mapped region. `open` checks every count, index and string range once, so
+ * the accessors can be used without further checks.
+ */
+class SnapshotView {
+public:
+    /**
+     * @brief Default constructor for the `SnapshotView` class.
+     *
+     * The view is empty until `open` succeeds.
+     */
+    SnapshotView();
+
+    /**
+     * @brief Validates a snapshot and makes it available through the accessors.
+     *
+     * @param data The first byte of the snapshot; it must outlive the view
+     * @param size The size of the snapshot in bytes
+     * @param error Receives the reason when the snapshot is rejected
+     * @return True if the snapshot is valid, false otherwise
+     */
+    bool open(const char *data, size_t size, string &error);
+
+    /**
+     * @brief Returns the header of the snapshot.
+     *
+     * @return The header
+     */
+    const SnapshotHeader &getHeader() const;
+
+    /**
+     * @brief Returns an account of the snapshot.
+     *
+     * @param index The index of the account, in pre-order
+     * @return The account record
+     */
+    SnapshotAccount getAccount(size_t index) const;
+
+    /**
+     * @brief Returns a transaction of the snapshot.
+     *
+     * @param index The index of the transaction
+     * @return The transaction record
+     */
+    SnapshotTransaction getTransaction(size_t index) const;
+
+    /**
+     * @brief Returns a string of the string pool.
+     *
+     * @param offset The offset of the string in the pool
+     * @param length The length of the string
+     * @return A view of the string, valid as long as the snapshot bytes
+     */
+    string_view getString(uint32_t offset, uint32_t length) const;
+
+    /**
+     * @brief Returns where the balance of an account is stored in the snapshot.
+     *
+     * @param index The index of the account, in pre-order
+     * @return The offset of the balance from the first byte of the snapshot
+     */
+    size_t getBalanceOffset(size_t index) const;
+
+private:
+    const char *data;       ///< The snapshot bytes
+    SnapshotHeader header;  ///< Copy of the validated header
+    size_t accountsStart;   ///< Offset of the accounts array
+    size_t transactionsStart; ///< Offset of the transactions array
+    size_t stringsStart;    ///< Offset of the string pool
+};
+
+/**
+ * @class ForestSnapshot
+ * @brief Writes versioned binary snapshots of a forest and its transactions, and saves their balances in place.
+ *
+ * A snapshot holds the same information as a chart file and its transactions file, but can be loaded without parsing
+ * text: a header, the accounts in pre-order with the indices of their parent, first child and next sibling, the packed
+ * transactions and a pool with every string. Balances are fixed-size integers, so once a snapshot is loaded
+ * `ForestSnapshot` can overwrite the balances that changed directly in the file.
+ */
+class ForestSnapshot {
+public:
+    /**
+     * @brief The magic bytes at the start of every snapshot file.
+     */
+    static const char MAGIC[8];
+
+    /**
+     * @brief The version of the snapshot format written by this program.
+     */
+    static const uint16_t VERSION = 2;
+
+    /**
+     * @brief The size of the header of version 1 snapshots, which have no checkpoint.
+     */
+    static const size_t VERSION_1_HEADER_SIZE = 40;
+
+    /**
+     * @brief Value written in the header to detect snapshots saved on a host with another byte order.
+     */
+    static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    /**
+     * @brief Default constructor for the `ForestSnapshot` class.
+     *
+     * Creates a writer that does not track any file yet.
+     */
+    ForestSnapshot();
+
+    /**
+     * @brief Checks whether a buffer holds a snapshot rather than a text chart.
+     *
+     * @param buffer The contents of a file
+     * @return True if the buffer starts with the snapshot magic bytes, false otherwise
+     */
+    static bool isSnapshot(const string &buffer);
+
+    /**
+     * @brief Encodes a forest and all its transactions as a snapshot.
+     *
+     * @param roots The root accounts of the forest
+     * @param checkpoint The sequence number of the last journal record the forest holds, 0 if none
+     * @return The snapshot bytes
+     * @throws runtime_error If the forest is too large for the format
+     */
+    static string encode(const vector<NodePtr> &roots, uint64_t checkpoint = 0);
+
+    /**
+     * @brief Starts tracking the balances of a snapshot file.
+     *
+     * Every account of the snapshot becomes known, so its balance can be overwritten by `writeBalances`.
+     *
+     * @param filename The snapshot file
+     * @param snapshot A view of the contents of that file
+     */
+    void reset(const string &filename, const SnapshotView &snapshot);
+
+    /**
+     * @brief Tracks a snapshot file without knowing where its balances are.
+     *
+     * Any later `writeBalances` with changes fails, so the snapshot is rewritten as a whole.
+     *
+     * @param filename The snapshot file, or an empty string to stop tracking
+     */
+    void reset(const string &filename);
+
+    /**
+     * @brief Returns the snapshot file whose balances are tracked.
+     *
+     * @return The path of the tracked file, or an empty string
+     */
+    const string &getPath() const;
+
+    /**
+     * @brief Overwrites the balances of the given accounts in the tracked file.
+     *
+     * Nothing is written unless every account is stored in the tracked file.
+     *
+     * @param balances The accounts to save, with their current balances
+     * @return True if the balances were written in place, false if the snapshot must be rewritten
+     * @throws runtime_error If the tracked file cannot be written
+     */
+    bool writeBalances(const vector<pair<int, Money>> &balances);
+
+private:
+    string path;                              ///< The tracked snapshot file
+    unordered_map<int, size_t> balanceOffsets; ///< Offset of the balance of every account of the tracked file
+};
+
+#endif //ADS_MIDTERM_PROJECT_FORESTSNAPSHOT_H
@@ -12,13 +12,26 @@
  * of accounts and subaccounts.
  */
 #include "ForestTree.h"
+#include "TreeTraversal.h"
+#include "AccountCode.h"
+#include "ReportGenerator.h"
+#include "ForestMetrics.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <string>
 #include <iomanip>
 #include <stdexcept>
-#include <queue>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <filesystem>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 using namespace std;
 
@@ -27,7 +40,8 @@ using namespace std;
  * @brief Default constructor for the ForestTree class.
  * Initializes the tree but does not allocate any nodes.
  */
-ForestTree::ForestTree() {}
+ForestTree::ForestTree()
+        : lazyBalances(false), dateIndexReady(false), tourReady(false), searchReady(false), viewReady(false) {}
 
 // Destructor
 /**
@@ -39,14 +53,22 @@ ForestTree::~ForestTree() {
 }
 
 /**
- * @brief Helper function to recursively delete all nodes in the tree.
- * Cleans up all dynamically allocated memory for the tree nodes.
+ * @brief Helper function to delete all nodes in the tree.
+ * Releases the node arena, which frees every node of the forest at once without walking the trees.
  */
 void ForestTree::cleanupTree() {
-    for (NodePtr root: rootAccounts) {
-        delete root;
-    }
     rootAccounts.clear();
+    arena.release();
+    accountIndex.clear();
+    for (TransactionIdIndex &ids: transactionIds) {
+        ids.clear();
+    }
+    dateIndexReady = false;
+    tourReady = false;
+    viewReady = false;
+    searchReady = false;
+    lastView = ForestView();
+    viewChanges.clear();
 }
 
 /**
@@ -56,6 +78,7 @@ void ForestTree::cleanupTree() {
  * @details After calling this function, the tree will be reinitialized with no accounts.
  */
 void ForestTree::initialize() {
+    unique_lock<shared_mutex> structure(structureLock);
     cleanupTree();
     cout << "Forest tree initialized successfully." << endl;
 }
@@ -63,176 +86,1083 @@ void ForestTree::initialize() {
 /**
  * @brief Builds a chart of accounts from a specified file.
  * The file should contain account details, one per line. Each line is parsed, and accounts are added to the tree.
- * If an account's parent is not found, it is treated as a root account.
+ * Accounts with a single-digit number are treated as root accounts.
  *
  * @param filename The name of the file containing the chart of accounts data.
  *
- * @details The file is expected to contain account information in a specific format. Each line should represent one account, with details such as account number and name.
- * Accounts are parsed using the `Account` class's extraction operator (operator>>), and are added to the tree structure.
- * In case of errors during file processing, the method catches exceptions and continues with the next line.
+ * @details The file is expected to contain account information in a specific format. Each line should represent one account,
+ * with the account number, its description and its balance. The whole file is read with one read and parsed in a single
+ * pass by `ChartFile::parseRecords`. If the forest is still empty, the records are handed to `bulkBuild`, which builds every tree
+ * bottom-up; otherwise each account goes through `addAccount`. Lines that cannot be parsed are reported and skipped.
+ *
+ * @throws runtime_error If the journal has a gap in its sequence numbers; the journal is then left closed.
  */
 void ForestTree::buildFromFile(const string &filename) {
-    ifstream file(filename);
-    if (!file.is_open()) {
+    unique_lock<shared_mutex> structure(structureLock);
+
+    // Read the whole file with a single read
+    string buffer;
+    if (!ChartFile::readAll(filename, buffer)) {
         cerr << "Error opening file: " << filename << endl;
         return;
     }
 
-    string line;
-    while (getline(file, line)) {
-        // Skip empty lines
-        if (line.empty()) {
+    // Binary snapshots hold the transactions too, only the journal is replayed on top of them
+    vector<int> recovered;
+    if (ForestSnapshot::isSnapshot(buffer)) {
+        uint64_t checkpoint = 0;
+        if (!loadSnapshot(filename, buffer, checkpoint)) {
+            return;
+        }
+        cout << "Chart of accounts loaded from snapshot successfully." << endl;
+        chartFile.reset("");
+        openJournal(filename, replayJournal(getJournalFilename(filename), checkpoint, checkpoint, recovered));
+        indexAllTransactions();
+        dateIndexReady = false;
+        tourReady = false;
+        viewReady = false;
+        searchReady = false;
+        return;
+    }
+
+    vector<ChartRecord> records;
+    ChartFile::parseRecords(buffer, records);
+    snapshotFile.reset("");
+
+    // Remember where every balance lives, for in-place saves
+    chartFile.reset(filename);
+    for (const ChartRecord &record: records) {
+        chartFile.track(record);
+    }
+
+    if (rootAccounts.empty()) {
+        bulkBuild(records);
+    } else {
+        for (const ChartRecord &record: records) {
+            Account newAccount(record.accountNumber, record.description, record.balance);
+            addAccountUnlocked(newAccount, AccountCode::parent(record.accountNumber));
+        }
+    }
+
+    cout << "Chart of accounts built from file successfully." << endl;
+    uint64_t checkpoint = loadTransactionsUnlocked(getTransactionFilename(filename));
+    openJournal(filename, replayJournal(getJournalFilename(filename), checkpoint, 0, recovered));
+
+    // Accounts journaled by addAccountWithFile while the chart was being rewritten go back into the chart
+    for (int accountNumber: recovered) {
+        const Account &account = lookup(accountNumber)->getData();
+        insertChartLine(filename, accountNumber, account.getDescription(), account.getBalance());
+    }
+    indexAllTransactions();
+    dateIndexReady = false;
+    tourReady = false;
+    viewReady = false;
+    searchReady = false;
+}
+
+/**
+ * @brief Makes a chart the source of the forest and opens its transaction journal.
+ *
+ * @param filename The chart file or snapshot the forest was built from.
+ * @param sequence The sequence number of the last record of the journal or the data files.
+ */
+void ForestTree::openJournal(const string &filename, uint64_t sequence) {
+    accountsFile = filename;
+    if (!journal.open(getJournalFilename(filename), sequence)) {
+        cerr << "Warning: Could not open transaction journal: " << getJournalFilename(filename) << endl;
+    }
+}
+
+/**
+ * @brief Builds the forest from a binary snapshot.
+ *
+ * @param filename The name of the snapshot file.
+ * @param buffer The contents of the snapshot file.
+ * @param checkpoint Receives the last journal record the snapshot holds, 0 if none.
+ *
+ * @return bool True if the snapshot was loaded, false if it is invalid.
+ *
+ * @details The snapshot is validated as a whole before any node is created. The accounts are stored in pre-order with
+ * the indices of their relatives, so an empty forest is linked directly from those indices and every transaction is
+ * appended to its account as it is read. When the forest already holds accounts, the snapshot accounts are merged in
+ * through `addAccount` instead, parents first.
+ */
+bool ForestTree::loadSnapshot(const string &filename, const string &buffer, uint64_t &checkpoint) {
+    SnapshotView snapshot;
+    string error;
+    if (!snapshot.open(buffer.data(), buffer.size(), error)) {
+        cerr << "Error loading snapshot " << filename << ": " << error << endl;
+        return false;
+    }
+
+    const SnapshotHeader &header = snapshot.getHeader();
+    size_t count = static_cast<size_t>(header.accountCount);
+    checkpoint = header.checkpoint;
+    bool linkDirectly = rootAccounts.empty();
+
+    // Duplicate account numbers cannot be linked directly
+    if (linkDirectly) {
+        accountIndex.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (!accountIndex.emplace(snapshot.getAccount(i).accountNumber, nullptr).second) {
+                accountIndex.clear();
+                cerr << "Error loading snapshot " << filename << ": duplicate account "
+                     << snapshot.getAccount(i).accountNumber << endl;
+                return false;
+            }
+        }
+    }
+
+    vector<NodePtr> nodes(count, nullptr);
+    if (linkDirectly) {
+        arena.reserve(count);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        SnapshotAccount record = snapshot.getAccount(i);
+        Account account(record.accountNumber,
+                        string(snapshot.getString(record.descriptionOffset, record.descriptionLength)),
+                        Money::fromUnits(record.balance));
+
+        NodePtr node = nullptr;
+        if (linkDirectly) {
+            node = arena.create(move(account));
+            accountIndex[record.accountNumber] = node;
+            if (record.parent == -1) {
+                rootAccounts.push_back(node);
+            } else {
+                NodePtr parentNode = nodes[record.parent];
+                node->setParent(parentNode);
+                if (snapshot.getAccount(record.parent).firstChild == static_cast<int32_t>(i)) {
+                    parentNode->setLeftChild(node);
+                }
+            }
+        } else {
+            addAccountUnlocked(account, AccountCode::parent(record.accountNumber));
+            node = lookup(record.accountNumber);
+        }
+        nodes[i] = node;
+
+        if (!node) {
             continue;
         }
+        Account &target = node->getData();
+        target.reserveTransactions(record.transactionCount);
+        for (uint64_t j = 0; j < record.transactionCount; ++j) {
+            SnapshotTransaction t = snapshot.getTransaction(record.firstTransaction + j);
+            target.emplaceTransaction(snapshot.getString(t.idOffset, t.idLength),
+                                      Money::fromUnits(t.amount),
+                                      t.debitCredit,
+                                      snapshot.getString(t.descriptionOffset, t.descriptionLength),
+                                      snapshot.getString(t.dateOffset, t.dateLength));
+        }
+    }
 
-        // Create a string stream from the line
-        istringstream lineStream(line);
-        Account newAccount;
+    // Sibling links point forward, so they are set once every node exists
+    if (linkDirectly) {
+        for (size_t i = 0; i < count; ++i) {
+            SnapshotAccount record = snapshot.getAccount(i);
+            if (record.parent != -1 && record.nextSibling != -1) {
+                nodes[i]->setRightSibling(nodes[record.nextSibling]);
+            }
+        }
+        snapshotFile.reset(filename, snapshot);
+    } else {
+        snapshotFile.reset(filename);
+    }
+    return true;
+}
 
-        try {
-            // Use Account's operator>> to read the account details
-            lineStream >> newAccount;
+namespace {
 
-            // Calculate parent number based on account number string
-            string accStr = to_string(newAccount.getAccountNumber());
-            int parentNumber = accStr.length() > 1 ?
-                               stoi(accStr.substr(0, accStr.length() - 1)) : -1;
+/**
+ * @brief The first line of a transactions file that names the last journal record it holds.
+ */
+const char CHECKPOINT_PREFIX[] = "#checkpoint|";
 
-            // Add account to tree
-            addAccount(newAccount, parentNumber);
+/**
+ * @brief Builds one root tree from its chart records.
+ *
+ * @param records All parsed records; the descriptions of the accounts built are moved out of them.
+ * @param shard The positions in `records` of the accounts of this tree.
+ * @param arena The arena receiving the nodes of this tree.
+ * @param index The index receiving the nodes of this tree.
+ * @param roots Receives the root nodes built.
+ *
+ * @details Sorting by (number of digits, account number) puts every parent before its children and keeps the children
+ * of each parent adjacent and in ascending order. A node is therefore either the first child of its parent or the right
+ * sibling of the node built just before it, so no sibling list is ever searched. Only the given arena, index and root
+ * list are written, so trees can be built on separate threads.
+ */
+void buildTree(vector<ChartRecord> &records, const vector<size_t> &shard, NodeArena &arena,
+               AccountIndex &index, vector<NodePtr> &roots) {
+    // Precompute the magnitude so the sort compares plain integers
+    vector<pair<pair<int, int>, size_t>> order;
+    order.reserve(shard.size());
+    for (size_t i: shard) {
+        int digits = static_cast<int>(AccountCode::digits(records[i].accountNumber));
+        order.push_back(make_pair(make_pair(digits, records[i].accountNumber), i));
+    }
+    // The index breaks ties, so duplicates stay in file order and the first one wins
+    sort(order.begin(), order.end());
 
-        } catch (const exception &e) {
-            cerr << "Error processing line: " << line << endl;
-            cerr << "Error details: " << e.what() << endl;
-            continue;  // Skip this line and continue with the next one
+    index.reserve(shard.size());
+    arena.reserve(shard.size());
+    NodePtr previous = nullptr;
+
+    for (const auto &entry: order) {
+        ChartRecord &record = records[entry.second];
+        int accNum = record.accountNumber;
+
+        if (index.find(accNum) != index.end()) {
+            continue;  // Account already exists
+        }
+
+        NodePtr parentNode = nullptr;
+        if (!AccountCode::isRoot(accNum)) {
+            AccountIndex::const_iterator parentIt = index.find(AccountCode::parent(accNum));
+            if (parentIt == index.end()) {
+                continue;  // Parent doesn't exist
+            }
+            parentNode = parentIt->second;
+        }
+
+        NodePtr newNode = arena.create(Account(accNum, move(record.description), record.balance));
+        newNode->setParent(parentNode);
+
+        if (!parentNode) {
+            roots.push_back(newNode);
+        } else if (previous && previous->getParent() == parentNode) {
+            previous->setRightSibling(newNode);
+        } else {
+            parentNode->setLeftChild(newNode);
+        }
+
+        index[accNum] = newNode;
+        previous = newNode;
+    }
+}
+
+/**
+ * @brief Returns the balance change a transaction makes to its account and every ancestor.
+ *
+ * @param t The transaction.
+ *
+ * @return Money The amount of a debit, minus the amount of a credit, and zero for any other type.
+ */
+Money postingDelta(const Transaction &t) {
+    if (t.getDebitCredit() == 'D') {
+        return t.getAmount();
+    }
+    return t.getDebitCredit() == 'C' ? -t.getAmount() : Money();
+}
+
+/**
+ * @brief One line of a transactions file that was parsed by a loading worker.
+ */
+struct ParsedTransaction {
+    NodePtr node;            ///< The account the transaction belongs to
+    string_view id;          ///< The transaction ID, in the file buffer
+    Money amount;            ///< The amount
+    char debitCredit;        ///< The debit/credit type
+    string_view description; ///< The description, in the file buffer
+    string_view date;        ///< The date, in the file buffer
+};
+
+} // namespace
+
+/**
+ * @brief Builds an empty forest from parsed chart records, one root tree per worker.
+ *
+ * @param records The parsed records.
+ *
+ * @details The parent of an account always has the same leading digit, so the records are first split by that digit
+ * and every tree is built independently by `buildTree`, with its own arena and index. Large charts build their trees on
+ * separate threads. The arenas, indexes and roots are then merged in digit order, which gives the same forest as a
+ * single-threaded build.
+ */
+void ForestTree::bulkBuild(vector<ChartRecord> &records) {
+    vector<vector<size_t>> shards(ROOT_LOCK_COUNT);
+    for (size_t i = 0; i < records.size(); ++i) {
+        shards[rootDigit(records[i].accountNumber)].push_back(i);
+    }
+
+    vector<NodeArena> arenas(ROOT_LOCK_COUNT);
+    vector<AccountIndex> indexes(ROOT_LOCK_COUNT);
+    vector<vector<NodePtr>> roots(ROOT_LOCK_COUNT);
+    size_t threads = records.size() >= PARALLEL_THRESHOLD ? ROOT_LOCK_COUNT : 1;
+    runParallel(ROOT_LOCK_COUNT, threads, [&](size_t digit) {
+        if (!shards[digit].empty()) {
+            buildTree(records, shards[digit], arenas[digit], indexes[digit], roots[digit]);
+        }
+    });
+
+    accountIndex.reserve(accountIndex.size() + records.size());
+    for (size_t digit = 0; digit < ROOT_LOCK_COUNT; ++digit) {
+        arena.adopt(arenas[digit]);
+        accountIndex.insert(indexes[digit].begin(), indexes[digit].end());
+        rootAccounts.insert(rootAccounts.end(), roots[digit].begin(), roots[digit].end());
+    }
+}
+
+/**
+ * @brief Runs a number of independent tasks on a pool of threads.
+ *
+ * @param taskCount The number of tasks; task i is called with i.
+ * @param maxThreads The largest number of threads to use.
+ * @param task The task to run.
+ *
+ * @throws exception The first exception thrown by a task, once every thread has finished.
+ *
+ * @details Threads pick the next task from a shared counter, so long tasks do not hold up short ones. When a single
+ * thread would be used, the tasks run on the calling thread.
+ */
+void ForestTree::runParallel(size_t taskCount, size_t maxThreads, const function<void(size_t)> &task) {
+    size_t threads = thread::hardware_concurrency();
+    threads = min(min(taskCount, maxThreads), threads > 0 ? threads : size_t(1));
+    if (threads <= 1) {
+        for (size_t i = 0; i < taskCount; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    atomic<size_t> next(0);
+    exception_ptr failure;
+    mutex failureLock;
+    auto worker = [&]() {
+        for (size_t i = next++; i < taskCount; i = next++) {
+            try {
+                task(i);
+            } catch (...) {
+                lock_guard<mutex> guard(failureLock);
+                if (!failure) {
+                    failure = current_exception();
+                }
+            }
+        }
+    };
+
+    vector<thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t i = 1; i < threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (thread &t: pool) {
+        t.join();
+    }
+    if (failure) {
+        rethrow_exception(failure);
+    }
+}
+
+/**
+ * @brief Prints a detailed report of an account and its transaction history to a file.
+ *
+ * @param accountNumber The account number to generate the report for.
+ * @param filename The name of the file where the report should be saved.
+ *
+ * @throws runtime_error If the file cannot be opened for writing.
+ *
+ * @details The report includes account details and all transactions associated with the account.
+ * If no transactions are found, a message indicating no transactions will be written. The report is the text format
+ * of `ReportGenerator`, which also writes many accounts or whole subtrees into one file. Only the account itself is
+ * frozen, under the lock of its tree, into a one-account view; its history is shared rather than copied, and the file
+ * is written without holding any lock.
+ */
+void ForestTree::printDetailedReport(int accountNumber, const string &filename) const {
+    ofstream file(filename);
+    if (!file.is_open()) {
+        throw runtime_error("Could not open file for writing: " + filename);
+    }
+    ForestView single;
+    readAccount(accountNumber, [&single, this](const Account &account) {
+        single = ForestView::of(account, journal.getLastSequence());
+    });
+    ReportGenerator(single).writeAccounts(vector<int>(1, accountNumber), file);
+}
+
+/**
+ * @brief Prints the entire chart of accounts (the forest tree) to the console.
+ * This method traverses the tree and prints each account and its children.
+ *
+ * @details Each account is printed in a hierarchical format, with indentation to represent the tree structure.
+ * If the tree is empty, a message indicating that will be printed instead. The chart is formatted from a view, so the
+ * trees are held only while the view is derived, and postings wait neither for the formatting nor for the console.
+ */
+void ForestTree::printForestTree() const {
+    ForestView v = view();
+    if (v.size() == 0) {
+        cout << "Tree is empty." << endl;
+        return;
+    }
+
+    // An account numbered 0 is not printed, and neither are its descendants
+    ostringstream chart;
+    size_t skippedDepth = SIZE_MAX;
+    v.forEach([&chart, &skippedDepth](const Account &account, size_t depth) {
+        if (depth > skippedDepth) {
+            return;
+        }
+        skippedDepth = SIZE_MAX;
+        if (!account.getAccountNumber()) {
+            skippedDepth = depth;
+            return;
+        }
+
+        // Print indentation based on the level
+        for (size_t i = 0; i < depth; ++i) {
+            chart << "  ";
+        }
+
+        // Print account details
+        chart << account.getAccountNumber() << " - "
+              << account.getDescription()
+              << " (Balance: " << account.getBalance() << ")" << '\n';
+    });
+
+    cout << "\nChart of Accounts:\n==================\n" << chart.str();
+    cout << "==================\n";
+}
+
+/**
+ * @brief Finds an account by its account number.
+ *
+ * @param accountNumber The account number to search for.
+ *
+ * @return NodePtr A pointer to the node containing the account if found, or nullptr if not found.
+ *
+ * @details This method resolves the account number through the account index in constant time.
+ * If the account is not found, nullptr is returned.
+ */
+NodePtr ForestTree::findAccount(int accountNumber) const {
+    ADS_METRICS_TIME(FIND_ACCOUNT);
+    shared_lock<shared_mutex> structure(structureLock);
+    if (lazyBalances) {
+        shared_lock<shared_mutex> root;
+        unique_lock<shared_mutex> settling;
+        lockForRead(accountNumber, root, settling);
+    }
+    return lookup(accountNumber);
+}
+
+/**
+ * @brief Reads an account while no posting can change it.
+ *
+ * @param accountNumber The account number to read.
+ * @param reader The function called with the account.
+ *
+ * @return bool True if the account exists and was read, false otherwise.
+ *
+ * @details The reader runs under the shared lock of the account's root tree. Postings lock that tree exclusively for
+ * their whole rollup, so the reader sees either all or none of the balance changes of any posting.
+ */
+bool ForestTree::readAccount(int accountNumber, const function<void(const Account &)> &reader) const {
+    shared_lock<shared_mutex> structure(structureLock);
+    shared_lock<shared_mutex> root;
+    unique_lock<shared_mutex> settling;
+    lockForRead(accountNumber, root, settling);
+
+    NodePtr accountNode = lookup(accountNumber);
+    if (!accountNode) {
+        return false;
+    }
+    reader(accountNode->getData());
+    return true;
+}
+
+/**
+ * @brief Finds the accounts whose number starts with some digits.
+ *
+ * @param prefix The leading digits.
+ *
+ * @return vector<int> The matching account numbers in chart order, or none if the prefix is not positive.
+ */
+vector<int> ForestTree::findAccountsByPrefix(int prefix) const {
+    shared_lock<shared_mutex> structure = lockWithSearchIndex();
+    return searchIndex.findByPrefix(prefix);
+}
+
+/**
+ * @brief Finds the accounts whose description holds every keyword of a query.
+ *
+ * @param query The keywords.
+ *
+ * @return vector<int> The matching account numbers in chart order.
+ */
+vector<int> ForestTree::findAccountsByKeywords(const string &query) const {
+    shared_lock<shared_mutex> structure = lockWithSearchIndex();
+    return searchIndex.findByKeywords(query);
+}
+
+/**
+ * @brief Changes the description of an account.
+ *
+ * @param accountNumber The account number.
+ * @param description The new description.
+ *
+ * @return bool True if the account exists and the description has no line break, false otherwise.
+ *
+ * @details In-place saves only overwrite balances, so the saved files are marked as needing a full rewrite and the
+ * account is marked as changed.
+ */
+bool ForestTree::renameAccount(int accountNumber, const string &description) {
+    if (description.find_first_of("\r\n") != string::npos) {
+        return false;
+    }
+    unique_lock<shared_mutex> structure(structureLock);
+    NodePtr accountNode = lookup(accountNumber);
+    if (!accountNode) {
+        return false;
+    }
+
+    Account &account = accountNode->getData();
+    if (searchReady) {
+        searchIndex.updateDescription(accountNumber, account.getDescription(), description);
+    }
+    account.setDescription(description);
+
+    chartFile.reset("");
+    snapshotFile.reset(snapshotFile.getPath());
+    lock_guard<mutex> dirtyGuard(dirtyLock);
+    recordChange(accountNumber);
+    return true;
+}
+
+/**
+ * @brief Finds an account by its account number without taking any lock.
+ *
+ * @param accountNumber The account number to search for.
+ *
+ * @return NodePtr A pointer to the node containing the account if found, or nullptr if not found.
+ */
+NodePtr ForestTree::lookup(int accountNumber) const {
+    ADS_METRICS_VISITS(accountIndex.bucket_size(accountIndex.bucket(accountNumber)));
+    AccountIndex::const_iterator found = accountIndex.find(accountNumber);
+    return found != accountIndex.end() ? found->second : nullptr;
+}
+
+/**
+ * @brief Returns the lock guarding the tree an account belongs to.
+ *
+ * @param accountNumber The account number.
+ *
+ * @return shared_mutex& The lock of the root tree named by the leading digit of the account number.
+ */
+shared_mutex &ForestTree::rootLock(int accountNumber) const {
+    return rootLocks[rootDigit(accountNumber)];
+}
+
+/**
+ * @brief Returns the root tree an account belongs to.
+ *
+ * @param accountNumber The account number.
+ *
+ * @return size_t The leading digit of the account number, or 0 for numbers below 1.
+ */
+size_t ForestTree::rootDigit(int accountNumber) {
+    return AccountCode::leadingDigit(accountNumber);
+}
+
+/**
+ * @brief Locks every root tree for reading.
+ *
+ * @return vector<shared_lock<shared_mutex>> The held locks, taken in ascending digit order.
+ */
+vector<shared_lock<shared_mutex>> ForestTree::lockAllRoots() const {
+    vector<shared_lock<shared_mutex>> locks;
+    locks.reserve(ROOT_LOCK_COUNT);
+    for (shared_mutex &lock: rootLocks) {
+        locks.emplace_back(lock);
+    }
+    return locks;
+}
+
+/**
+ * @brief Locks every root tree for reading, settling every balance first when balances are lazy.
+ *
+ * @param shared Receives the shared locks of the trees when balances are eager.
+ * @param exclusive Receives the exclusive locks of the trees when balances are lazy.
+ *
+ * @details The caller holds the structure lock, which keeps the balance mode fixed.
+ */
+void ForestTree::lockAllForRead(vector<shared_lock<shared_mutex>> &shared,
+                                vector<unique_lock<shared_mutex>> &exclusive) const {
+    if (!lazyBalances) {
+        shared = lockAllRoots();
+        return;
+    }
+    exclusive.reserve(ROOT_LOCK_COUNT);
+    for (shared_mutex &lock: rootLocks) {
+        exclusive.emplace_back(lock);
+    }
+    settleAllBalances();
+}
+
+/**
+ * @brief Locks the tree of an account for reading.
+ *
+ * @param accountNumber The account number about to be read.
+ * @param shared Receives the shared lock of the tree when balances are eager.
+ * @param exclusive Receives the exclusive lock of the tree when balances are lazy.
+ *
+ * @details With lazy balances a read may have to settle the account, so the tree is locked exclusively and the
+ * account is settled before the lock is handed back.
+ */
+void ForestTree::lockForRead(int accountNumber, shared_lock<shared_mutex> &shared,
+                             unique_lock<shared_mutex> &exclusive) const {
+    shared_mutex &lock = rootLock(accountNumber);
+    if (!lazyBalances) {
+        shared = shared_lock<shared_mutex>(lock);
+        return;
+    }
+    exclusive = unique_lock<shared_mutex>(lock);
+    NodePtr node = lookup(accountNumber);
+    if (node) {
+        settleNode(node);
+    }
+}
+
+/**
+ * @brief Enables or disables lazy aggregated balances.
+ *
+ * @param enabled True to defer ancestor balance updates until they are read, false to update them on every posting.
+ *
+ * @details Disabling lazy balances settles every account first, so eager postings start from exact balances.
+ */
+void ForestTree::setLazyBalances(bool enabled) {
+    unique_lock<shared_mutex> structure(structureLock);
+    if (lazyBalances && !enabled) {
+        settleAllBalances();
+    }
+    lazyBalances = enabled;
+}
+
+/**
+ * @brief Checks whether ancestor balances are updated lazily.
+ *
+ * @return bool True if lazy balances are enabled, false otherwise.
+ */
+bool ForestTree::isLazyBalances() const {
+    shared_lock<shared_mutex> structure(structureLock);
+    return lazyBalances;
+}
+
+/**
+ * @brief Applies the balance change of a posting to an account and its ancestors.
+ *
+ * @param node The posted account.
+ * @param delta The signed balance change.
+ *
+ * @details Eager balances add the change to every account up to the root. Lazy balances add it to the posted account
+ * only and leave it pending for the ancestors; see `TreeNode::postDeferred`. The caller holds the tree's lock
+ * exclusively.
+ */
+void ForestTree::applyDelta(NodePtr node, Money delta) {
+    ADS_METRICS_TIME(BALANCE_ROLLUP);
+    if (lazyBalances) {
+        ADS_METRICS_VISITS(1);
+        node->postDeferred(delta);
+        lock_guard<mutex> dirtyGuard(dirtyLock);
+        recordChange(node->getData().getAccountNumber());
+        return;
+    }
+    // The parent of an account drops its last digit, so the rollup visits one node per digit
+    ADS_METRICS_VISITS(AccountCode::digits(node->getData().getAccountNumber()));
+    for (NodePtr current = node; current != nullptr; current = current->getParent()) {
+        Account &account = current->getData();
+        account.setBalance(account.getBalance() + delta);
+    }
+    markDirty(node);
+}
+
+/**
+ * @brief Brings the balance of an account up to date with the postings below it.
+ *
+ * @param node The account to settle; the caller holds its tree's lock exclusively.
+ */
+void ForestTree::settleNode(NodePtr node) const {
+    if (!node->isBalanceDirty()) {
+        return;
+    }
+    ADS_METRICS_TIME(BALANCE_ROLLUP);
+    vector<int> changed;
+    node->settleBalance(changed);
+    ADS_METRICS_VISITS(changed.size());
+    if (!node->getParent()) {
+        node->clearPendingDelta();
+    }
+    lock_guard<mutex> dirtyGuard(dirtyLock);
+    for (int accountNumber: changed) {
+        recordChange(accountNumber);
+    }
+}
+
+/**
+ * @brief Brings every balance of the forest up to date.
+ *
+ * @details The caller holds the structure lock exclusively or every root lock exclusively. Does nothing when
+ * balances are eager.
+ */
+void ForestTree::settleAllBalances() const {
+    if (!lazyBalances) {
+        return;
+    }
+    for (NodePtr root: rootAccounts) {
+        settleNode(root);
+        root->clearPendingDelta();
+    }
+}
+
+/**
+ * @brief Returns the balance an account and its subtree had at the end of a date.
+ *
+ * @param accountNumber The account number.
+ * @param date The date, as `YYYY-MM-DD`, `DD-MM-YYYY` or `DD-MM-YY`.
+ *
+ * @return Money The current balance minus every change dated after the date.
+ *
+ * @throws invalid_argument If the date cannot be read or the account does not exist.
+ *
+ * @details The date index of the account holds the dated changes of its whole subtree, so the answer takes two prefix
+ * sums. Transactions without a readable date are treated as dated before any date.
+ */
+Money ForestTree::balanceAsOf(int accountNumber, const string &date) const {
+    int32_t key = parseDateArgument(date);
+    shared_lock<shared_mutex> structure = lockWithDateIndex();
+    shared_lock<shared_mutex> root;
+    unique_lock<shared_mutex> settling;
+    lockForRead(accountNumber, root, settling);
+
+    NodePtr accountNode = lookup(accountNumber);
+    if (!accountNode) {
+        throw invalid_argument("Account not found: " + to_string(accountNumber));
+    }
+    const DateBalanceIndex &index = accountNode->getDateIndex();
+    return accountNode->getData().getBalance() - (index.total() - index.sumThrough(key));
+}
+
+/**
+ * @brief Returns the net change of an account and its subtree between two dates.
+ *
+ * @param accountNumber The account number.
+ * @param fromDate The first date included.
+ * @param toDate The last date included.
+ *
+ * @return Money The debits minus the credits dated within the range, or zero if the range is empty.
+ *
+ * @throws invalid_argument If a date cannot be read or the account does not exist.
+ */
+Money ForestTree::netChange(int accountNumber, const string &fromDate, const string &toDate) const {
+    int32_t fromKey = parseDateArgument(fromDate);
+    int32_t toKey = parseDateArgument(toDate);
+    shared_lock<shared_mutex> structure = lockWithDateIndex();
+    shared_lock<shared_mutex> root(rootLock(accountNumber));
+
+    NodePtr accountNode = lookup(accountNumber);
+    if (!accountNode) {
+        throw invalid_argument("Account not found: " + to_string(accountNumber));
+    }
+    return accountNode->getDateIndex().sumBetween(fromKey, toKey);
+}
+
+/**
+ * @brief Checks whether an account lies in the subtree of another.
+ *
+ * @param ancestorNumber The account number of the subtree root.
+ * @param accountNumber The account number to check.
+ *
+ * @return bool True if both accounts exist and the second is the first or one of its descendants.
+ *
+ * @details Tour indexes only change while the structure lock is held exclusively, so no root lock is needed.
+ */
+bool ForestTree::isInSubtree(int ancestorNumber, int accountNumber) const {
+    shared_lock<shared_mutex> structure = lockWithTour();
+    NodePtr ancestorNode = lookup(ancestorNumber);
+    NodePtr accountNode = lookup(accountNumber);
+    return ancestorNode && accountNode && tour.contains(ancestorNode, accountNode);
+}
+
+/**
+ * @brief Returns the number of accounts in the subtree of an account.
+ *
+ * @param accountNumber The account number of the subtree root.
+ *
+ * @return size_t The number of accounts, the root included, or 0 if the account does not exist.
+ */
+size_t ForestTree::subtreeSize(int accountNumber) const {
+    shared_lock<shared_mutex> structure = lockWithTour();
+    NodePtr accountNode = lookup(accountNumber);
+    return accountNode ? tour.exit(accountNode) - tour.enter(accountNode) : 0;
+}
+
+/**
+ * @brief Reads every account of a subtree, parents first.
+ *
+ * @param accountNumber The account number of the subtree root.
+ * @param reader The function called with each account and its depth below the subtree root.
+ *
+ * @return bool True if the account exists and its subtree was read, false otherwise.
+ *
+ * @details The subtree is one contiguous range of the tour, so it is read without following child and sibling links.
+ * With lazy balances every account is settled as it is read, under the exclusive lock of the root tree.
+ */
+bool ForestTree::readSubtree(int accountNumber, const function<void(const Account &, size_t)> &reader) const {
+    shared_lock<shared_mutex> structure = lockWithTour();
+    shared_lock<shared_mutex> root;
+    unique_lock<shared_mutex> settling;
+    lockForRead(accountNumber, root, settling);
+
+    NodePtr accountNode = lookup(accountNumber);
+    if (!accountNode) {
+        return false;
+    }
+    size_t baseDepth = tour.depth(accountNode);
+    for (const NodePtr *it = tour.subtreeBegin(accountNode), *end = tour.subtreeEnd(accountNode); it != end; ++it) {
+        if (lazyBalances) {
+            settleNode(*it);
+        }
+        reader((*it)->getData(), tour.depth(*it) - baseDepth);
+    }
+    return true;
+}
+
+/**
+ * @brief Takes an immutable view of the whole forest.
+ *
+ * @return ForestView The view.
+ *
+ * @details All trees are held at once, so no posting is half-applied in the view. Lazy balances are settled first.
+ * The accounts added since the last view, or whose balance, description or transactions changed, are frozen into the
+ * new one; all other accounts are shared with it.
+ */
+ForestView ForestTree::view() const {
+    shared_lock<shared_mutex> structure(structureLock);
+    vector<shared_lock<shared_mutex>> roots;
+    vector<unique_lock<shared_mutex>> settling;
+    lockAllForRead(roots, settling);
+
+    lock_guard<mutex> dirtyGuard(dirtyLock);
+    uint64_t sequence = journal.getLastSequence();
+    if (!viewReady) {
+        lastView = ForestView::build(rootAccounts, sequence);
+        viewReady = true;
+    } else if (!viewChanges.empty() || sequence != lastView.getSequence()) {
+        vector<NodePtr> changed;
+        changed.reserve(viewChanges.size());
+        for (int accountNumber: viewChanges) {
+            NodePtr accountNode = lookup(accountNumber);
+            if (accountNode) {
+                changed.push_back(accountNode);
+            }
         }
+        lastView = lastView.update(rootAccounts, changed, sequence);
     }
-
-    file.close();
-    cout << "Chart of accounts built from file successfully." << endl;
-    loadTransactions(getTransactionFilename(filename));
+    viewChanges.clear();
+    return lastView;
 }
 
 /**
- * @brief Prints a detailed report of an account and its transaction history to a file.
+ * @brief Returns the net amount of every transaction posted to an account or below it.
  *
- * @param accountNumber The account number to generate the report for.
- * @param filename The name of the file where the report should be saved.
+ * @param accountNumber The account number of the subtree root.
  *
- * @throws runtime_error If the file cannot be opened for writing.
+ * @return Money The debits minus the credits of the subtree.
  *
- * @details The report includes account details and all transactions associated with the account.
- * If no transactions are found, a message indicating no transactions will be written.
+ * @throws invalid_argument If the account does not exist.
  */
-void ForestTree::printDetailedReport(int accountNumber, const string &filename) const {
-    ofstream file(filename);
-    if (!file.is_open()) {
-        throw runtime_error("Could not open file for writing: " + filename);
-    }
+Money ForestTree::subtreeTransactionTotal(int accountNumber) const {
+    shared_lock<shared_mutex> structure = lockWithTour();
+    shared_lock<shared_mutex> root(rootLock(accountNumber));
 
-    NodePtr accountNode = findAccount(accountNumber);
+    NodePtr accountNode = lookup(accountNumber);
     if (!accountNode) {
-        file << "Account not found: " << accountNumber << endl;
-        return;
+        throw invalid_argument("Account not found: " + to_string(accountNumber));
     }
+    return tour.subtreeAmount(accountNode);
+}
 
-    const Account &account = accountNode->getData();
-
-    // Print account header and information
-    file << "Account Details:\n";
-    file << "================\n";
-    file << account << "\n\n";  // Using Account's operator<<
-
-    // Print transactions
-    file << "Transaction History:\n";
-    file << "===================\n";
-    const vector<Transaction> &transactions = account.getTransactions();
+/**
+ * @brief Rebuilds every balance from the transaction history and reports the accounts that disagree.
+ *
+ * @param apply True to replace every disagreeing balance by the rebuilt one.
+ *
+ * @return vector<BalanceMismatch> The disagreeing accounts.
+ *
+ * @details Deferred balances are settled first. Each root tree is walked once in post-order, so every node comes
+ * right after the subtrees of its children; the totals of the children are summed into one slot per depth, which the
+ * node takes over and adds to the slot of its own depth, and no total is computed twice.
+ */
+vector<BalanceMismatch> ForestTree::recomputeAllBalances(bool apply) {
+    unique_lock<shared_mutex> structure(structureLock);
+    settleAllBalances();
+
+    vector<vector<BalanceMismatch>> mismatches(rootAccounts.size());
+    size_t threads = accountIndex.size() >= PARALLEL_THRESHOLD ? rootAccounts.size() : 1;
+    runParallel(rootAccounts.size(), threads, [&](size_t i) {
+        // childTotals[d] sums the finished totals of the nodes at depth d whose parent is still to come
+        vector<Money> childTotals;
+        forEachPostOrder(rootAccounts[i], [&](NodePtr node, size_t depth) {
+            if (childTotals.size() < depth + 2) {
+                childTotals.resize(depth + 2);
+            }
+            Money total = childTotals[depth + 1] + node->getData().getTransactions().getColumns().netAmount();
+            childTotals[depth + 1] = Money();
+            childTotals[depth] += total;
+
+            Account &account = node->getData();
+            if (account.getBalance() != total) {
+                mismatches[i].push_back(BalanceMismatch{account.getAccountNumber(), account.getBalance(), total});
+                if (apply) {
+                    account.setBalance(total);
+                }
+            }
+        });
+    });
 
-    if (transactions.empty()) {
-        file << "No transactions recorded.\n";
-    } else {
-        for (const Transaction &t: transactions) {
-            file << t << "\n\n";  // Using Transaction's operator<<
+    vector<BalanceMismatch> result;
+    for (const vector<BalanceMismatch> &rootMismatches: mismatches) {
+        result.insert(result.end(), rootMismatches.begin(), rootMismatches.end());
+    }
+    if (apply && !result.empty()) {
+        lock_guard<mutex> dirtyGuard(dirtyLock);
+        for (const BalanceMismatch &mismatch: result) {
+            recordChange(mismatch.accountNumber);
         }
     }
-
-    file.close();
+    return result;
 }
 
 /**
- * @brief Prints the entire chart of accounts (the forest tree) to the console.
- * This method traverses the tree and prints each account and its children.
+ * @brief Converts a date given to a point-in-time query.
  *
- * @details Each account is printed in a hierarchical format, with indentation to represent the tree structure.
- * If the tree is empty, a message indicating that will be printed instead.
+ * @param date The date text.
+ *
+ * @return int32_t The date as `yyyymmdd`.
+ *
+ * @throws invalid_argument If the text is not a date.
  */
-void ForestTree::printForestTree() const {
-    if (rootAccounts.empty()) {
-        cout << "Tree is empty." << endl;
-        return;
+int32_t ForestTree::parseDateArgument(const string &date) {
+    int32_t key = TransactionColumns::parseDateKey(date);
+    if (key == 0) {
+        throw invalid_argument("Invalid date: " + date);
     }
+    return key;
+}
 
-    cout << "\nChart of Accounts:\n==================\n";
-    for (NodePtr root: rootAccounts) {
-        if (root) {
-            printTreeHelper(root, 0);
+/**
+ * @brief Takes the structure lock shared, preparing a lazily built structure first if it is not ready.
+ *
+ * @param ready The flag telling whether the structure is ready, set once it is prepared.
+ * @param prepare Builds the structure; called with the structure lock held exclusively.
+ *
+ * @return shared_lock<shared_mutex> The held structure lock.
+ *
+ * @details Building needs the structure lock exclusively, so the shared lock is released for the build and taken
+ * again afterwards; a load in between invalidates the structure and the build is retried.
+ */
+shared_lock<shared_mutex> ForestTree::lockPrepared(bool &ready, const function<void()> &prepare) const {
+    shared_lock<shared_mutex> structure(structureLock);
+    while (!ready) {
+        structure.unlock();
+        {
+            unique_lock<shared_mutex> exclusive(structureLock);
+            if (!ready) {
+                prepare();
+                ready = true;
+            }
         }
+        structure.lock();
     }
-    cout << "==================\n";
+    return structure;
 }
 
 /**
- * @brief Finds an account by its account number.
+ * @brief Takes the structure lock shared, building the date indexes first if they are not up to date.
  *
- * @param accountNumber The account number to search for.
+ * @return shared_lock<shared_mutex> The held structure lock.
+ */
+shared_lock<shared_mutex> ForestTree::lockWithDateIndex() const {
+    return lockPrepared(dateIndexReady, [this]() { buildDateIndex(); });
+}
+
+/**
+ * @brief Takes the structure lock shared, rebuilding the Euler tour first if it is not up to date.
  *
- * @return NodePtr A pointer to the node containing the account if found, or nullptr if not found.
+ * @return shared_lock<shared_mutex> The held structure lock.
  *
- * @details This method traverses the forest tree and searches for the account with the specified account number.
- * If the account is not found, nullptr is returned.
+ * @details The tour is rebuilt under the exclusive structure lock, so no posting can change a total while it is
+ * summed.
  */
-NodePtr ForestTree::findAccount(int accountNumber) const {
-    for (NodePtr root: rootAccounts) {
-        if (root) {
-            NodePtr found = root->findNode(root, accountNumber);
-            if (found) return found;
-        }
-    }
-    return nullptr;
+shared_lock<shared_mutex> ForestTree::lockWithTour() const {
+    return lockPrepared(tourReady, [this]() { tour.build(rootAccounts); });
+}
+
+/**
+ * @brief Takes the structure lock shared, building the search index first if it is not up to date.
+ *
+ * @return shared_lock<shared_mutex> The held structure lock.
+ */
+shared_lock<shared_mutex> ForestTree::lockWithSearchIndex() const {
+    return lockPrepared(searchReady, [this]() { searchIndex.build(accountIndex); });
 }
 
 /**
- * @brief Recursively prints the tree structure starting from a given node.
+ * @brief Builds the date index of every account from the transactions of its subtree.
  *
- * @param node A pointer to the node to start printing from.
- * @param level The current level of indentation for the node being printed.
+ * @details Each root tree is built on its own worker. Within a tree, nodes are visited in post-order, and every
+ * node's index is assigned from its own dated transactions plus the per-date totals of its children's indexes, so
+ * every index is built in one sort of its distinct dates. The caller holds the structure lock exclusively.
+ */
+void ForestTree::buildDateIndex() const {
+    size_t threads = accountIndex.size() >= PARALLEL_THRESHOLD ? rootAccounts.size() : 1;
+    runParallel(rootAccounts.size(), threads, [&](size_t i) {
+        vector<pair<int32_t, long long>> entries;
+        for (NodePtr node: postOrder(rootAccounts[i])) {
+            const TransactionColumns &transactions = node->getData().getTransactions().getColumns();
+
+            entries.clear();
+            for (size_t k = 0; k < transactions.slotCount(); ++k) {
+                char type = transactions.getDebitCredit(k);
+                int32_t date = transactions.getDateKey(k);
+                if (date != 0 && type != '?') {
+                    long long amount = transactions.getAmount(k).getUnits();
+                    entries.push_back(make_pair(date, type == 'D' ? amount : -amount));
+                }
+            }
+            for (NodePtr child = node->getLeftChild(); child != nullptr; child = child->getRightSibling()) {
+                child->getDateIndex().collect(entries);
+            }
+            node->getDateIndex().assign(entries);
+        }
+    });
+}
+
+/**
+ * @brief Records a dated balance change in the date indexes of an account and its ancestors.
  *
- * @return void
+ * @param node The posted account; the caller holds its tree's lock exclusively.
+ * @param date The date of the transaction.
+ * @param delta The signed balance change.
  *
- * @details This helper function prints the details of each node in the tree recursively. The output includes
- * the account number, description, and balance. The level parameter is used to determine the indentation
- * for each node based on its depth in the tree.
+ * @details Does nothing until a query has built the indexes, or for transactions without a readable date. The subtree
+ * totals of the Euler tour take every change, dated or not, once the tour is built; they only touch the range of the
+ * account's own root tree, which the held lock covers.
  */
-void ForestTree::printTreeHelper(NodePtr node, int level) const {
-    if (!node || !node->getData().getAccountNumber()) {
+void ForestTree::indexPosting(NodePtr node, const string &date, Money delta) {
+    if (tourReady) {
+        tour.addAmount(node, delta);
+    }
+    if (!dateIndexReady) {
         return;
     }
-
-    // Print indentation based on the level
-    for (int i = 0; i < level; ++i) {
-        cout << "  ";
+    int32_t key = TransactionColumns::parseDateKey(date);
+    if (key == 0 || delta == Money()) {
+        return;
+    }
+    for (NodePtr current = node; current != nullptr; current = current->getParent()) {
+        current->getDateIndex().add(key, delta);
     }
-
-    // Print account details
-    cout << node->getData().getAccountNumber() << " - "
-         << node->getData().getDescription()
-         << " (Balance: " << node->getData().getBalance() << ")" << endl;
-
-    // Recur for child nodes
-    printTreeHelper(node->getLeftChild(), level + 1);
-
-    // Recur for sibling nodes
-    printTreeHelper(node->getRightSibling(), level);
 }
 
 /**
@@ -249,27 +1179,44 @@ void ForestTree::printTreeHelper(NodePtr node, int level) const {
  * already exists before adding it, and if the parent is not found, it will search for an ancestor to add the account to.
  */
 bool ForestTree::addAccount(const Account &newAccount, int parentNumber) {
+    unique_lock<shared_mutex> structure(structureLock);
+    return addAccountUnlocked(newAccount, parentNumber);
+}
+
+/**
+ * @brief Adds a new account to the tree structure; the caller holds the structure lock exclusively.
+ *
+ * @param newAccount The new account to be added.
+ * @param parentNumber The account number of the parent, or -1 for a root account.
+ *
+ * @return bool Returns true if the account was successfully added, false otherwise.
+ */
+bool ForestTree::addAccountUnlocked(const Account &newAccount, int parentNumber) {
     int accNum = newAccount.getAccountNumber();
 
     // Handle root accounts (single digit)
     if (parentNumber == -1) {
-        if (findAccount(accNum)) {
+        if (lookup(accNum)) {
             return false;  // Account already exists
         }
-        NodePtr newNode = new TreeNode(newAccount);
+        NodePtr newNode = arena.create(newAccount);
         rootAccounts.push_back(newNode);
+        accountIndex[accNum] = newNode;
+        tourReady = false;
+        recordAddition(accNum);
+        if (searchReady) {
+            searchIndex.add(accNum, newAccount.getDescription());
+        }
         return true;
     }
 
     // Find parent node for non-root accounts
-    NodePtr parentNode = findAccount(parentNumber);
+    NodePtr parentNode = lookup(parentNumber);
     if (!parentNode) {
         // If parent doesn't exist, try to find a suitable ancestor
-        string accStr = to_string(accNum);
-        string parentStr = accStr;
-        while (parentStr.length() > 1 && !parentNode) {
-            parentStr = parentStr.substr(0, parentStr.length() - 1);
-            parentNode = findAccount(stoi(parentStr));
+        for (int ancestor = AccountCode::parent(accNum);
+             ancestor != AccountCode::NO_PARENT && !parentNode; ancestor = AccountCode::parent(ancestor)) {
+            parentNode = lookup(ancestor);
         }
 
         if (!parentNode) {
@@ -278,20 +1225,20 @@ bool ForestTree::addAccount(const Account &newAccount, int parentNumber) {
     }
 
     // Check if account already exists
-    if (findAccount(accNum)) {
+    if (lookup(accNum)) {
         return false;
     }
 
-    // Add the account under its parent
-    bool success = false;
-    for (NodePtr root: rootAccounts) {
-        if (root->addAccountNode(root, newAccount)) {
-            success = true;
-            break;
-        }
+    // Add the account under its parent; the next subtree query rebuilds the tour, the next view only freezes it
+    if (!parentNode->addAccountNode(arena, accountIndex, newAccount)) {
+        return false;
     }
-
-    return success;
+    tourReady = false;
+    recordAddition(accNum);
+    if (searchReady) {
+        searchIndex.add(accNum, newAccount.getDescription());
+    }
+    return true;
 }
 
 /**
@@ -303,56 +1250,165 @@ bool ForestTree::addAccount(const Account &newAccount, int parentNumber) {
  * @return bool Returns true if the transaction was successfully added, false if the account is not found or an error occurs.
  *
  * @details This method adds a transaction to the specified account's history and updates the account balance accordingly.
- * If the transaction is successfully added, the method attempts to save the transaction history to a file.
+ * If the transaction is successfully added, it is appended to the transaction journal; the rest of the history is not
+ * rewritten. The journal record is committed after the locks are released, so postings to other trees go on while
+ * this one waits for the sync.
  */
 bool ForestTree::addTransaction(int accountNumber, Transaction &transaction) {
-    // Find the account node and its root
-    NodePtr accountNode = nullptr;
-    NodePtr rootNode = nullptr;
+    ADS_METRICS_TIME(ADD_TRANSACTION);
+    uint64_t sequence = 0;
+    {
+        shared_lock<shared_mutex> structure(structureLock);
+        unique_lock<shared_mutex> root(rootLock(accountNumber));
 
-    // Search through all root nodes to find both the account and its root
-    for (NodePtr root: rootAccounts) {
-        accountNode = root->findNode(root, accountNumber);
-        if (accountNode) {
-            rootNode = root;
-            // Keep searching until we find the top-most root
-            while (rootNode->getRightSibling() &&
-                   to_string(rootNode->getRightSibling()->getData().getAccountNumber())[0] ==
-                   to_string(accountNode->getData().getAccountNumber())[0]) {
-                rootNode = rootNode->getRightSibling();
+        NodePtr accountNode = lookup(accountNumber);
+
+        if (!accountNode) {
+            cout << "Error: Account not found for account number: " << accountNumber << endl;
+            return false;
+        }
+
+        try {
+            // Every posted transaction is indexed and journaled by its ID, so a missing one is drawn here
+            if (transaction.getTransactionID().empty()) {
+                transaction.setTransactionID("");
             }
-            break;
+
+            // First add the transaction to the account
+            accountNode->getData().addTransaction(transaction);
+            indexLastTransaction(accountNode);
+
+            // Then update the balances of the account and its ancestors
+            applyDelta(accountNode, postingDelta(transaction));
+            indexPosting(accountNode, transaction.getDate(), postingDelta(transaction));
+            sequence = journal.appendTransaction(accountNumber, transaction);
+        } catch (const exception &e) {
+            cerr << "Error: " << e.what() << endl;
+            return false;
         }
     }
 
-    if (!accountNode) {
-        cout << "Error: Account not found for account number: " << accountNumber << endl;
-        return false;
-    }
+    commitJournal(sequence);
+    return true;
+}
 
-    try {
-        // First add the transaction to the account
-        accountNode->getData().addTransaction(transaction);
+/**
+ * @brief Posts a batch of transactions with a single balance rollup and a single journal commit.
+ *
+ * @param postings The account numbers and transactions to post, in posting order.
+ *
+ * @return size_t The number of transactions that were posted.
+ *
+ * @details The transactions are appended to their accounts and journaled in order, while their amounts are netted per
+ * account, a debit adding to the balance and a credit subtracting from it as in `Account::updateBalance`. The net deltas
+ * are then rolled up by `rollupDeltas`, and the journal is committed once, after the locks are released.
+ */
+size_t ForestTree::postBatch(const vector<pair<int, Transaction>> &postings) {
+    ADS_METRICS_TIME(POST_BATCH);
+    uint64_t sequence = 0;
+    size_t posted = 0;
+    {
+        shared_lock<shared_mutex> structure(structureLock);
+
+        // Lock every root tree the batch touches, in ascending digit order so batches never deadlock
+        bool touched[ROOT_LOCK_COUNT] = {};
+        for (const pair<int, Transaction> &posting: postings) {
+            touched[&rootLock(posting.first) - rootLocks] = true;
+        }
+        vector<unique_lock<shared_mutex>> roots;
+        for (size_t i = 0; i < ROOT_LOCK_COUNT; ++i) {
+            if (touched[i]) {
+                roots.emplace_back(rootLocks[i]);
+            }
+        }
+
+        unordered_map<NodePtr, Money> deltas;
+
+        for (const pair<int, Transaction> &posting: postings) {
+            NodePtr accountNode = lookup(posting.first);
+            if (!accountNode) {
+                cout << "Error: Account not found for account number: " << posting.first << endl;
+                continue;
+            }
+
+            // Postings without an ID get one, like in addTransaction; the others are not copied
+            Transaction withId;
+            const Transaction *posted = &posting.second;
+            if (posted->getTransactionID().empty()) {
+                withId = *posted;
+                withId.setTransactionID("");
+                posted = &withId;
+            }
+            const Transaction &t = *posted;
+            accountNode->getData().addTransaction(t);
+            indexLastTransaction(accountNode);
+            deltas[accountNode] += postingDelta(t);
+            indexPosting(accountNode, t.getDate(), postingDelta(t));
+            uint64_t appended = journal.appendTransaction(posting.first, t);
+            sequence = appended != 0 ? appended : sequence;
+            ++posted;
+        }
 
-        // Then update balances starting from the main root of this account's tree
-        for (NodePtr root: rootAccounts) {
-            if (to_string(root->getData().getAccountNumber())[0] ==
-                to_string(accountNumber)[0]) {
-                accountNode->updateBalance(root, transaction);
-                break;
+        if (lazyBalances) {
+            for (const pair<const NodePtr, Money> &delta: deltas) {
+                applyDelta(delta.first, delta.second);
+            }
+        } else {
+            rollupDeltas(deltas);
+            // Accounts whose postings net to zero keep their balance but still have new transactions
+            lock_guard<mutex> dirtyGuard(dirtyLock);
+            for (const pair<const NodePtr, Money> &delta: deltas) {
+                if (delta.second == Money()) {
+                    recordChange(delta.first->getData().getAccountNumber());
+                }
             }
         }
+    }
 
-        try {
-            saveTransactions(getTransactionFilename("accountswithspace.txt"));
-        } catch (const exception &e) {
-            cerr << "Warning: Failed to save transactions: " << e.what() << endl;
+    commitJournal(sequence);
+    return posted;
+}
+
+/**
+ * @brief Applies net balance deltas to their accounts and all their ancestors in one bottom-up pass.
+ *
+ * @param deltas The net balance change of each posted node.
+ *
+ * @details The posted nodes are bucketed by depth. Walking the buckets from the deepest level up, every node applies
+ * its accumulated delta and adds it to its parent's entry in the bucket above, so every affected account is visited
+ * exactly once. Updated accounts are marked dirty for the next save.
+ */
+void ForestTree::rollupDeltas(const unordered_map<NodePtr, Money> &deltas) {
+    ADS_METRICS_TIME(BALANCE_ROLLUP);
+    vector<unordered_map<NodePtr, Money>> levels;
+    lock_guard<mutex> dirtyGuard(dirtyLock);
+
+    for (const pair<const NodePtr, Money> &delta: deltas) {
+        size_t depth = 0;
+        for (NodePtr parent = delta.first->getParent(); parent != nullptr; parent = parent->getParent()) {
+            ++depth;
         }
+        if (levels.size() <= depth) {
+            levels.resize(depth + 1);
+        }
+        levels[depth][delta.first] += delta.second;
+    }
 
-        return true;
-    } catch (const exception &e) {
-        cerr << "Error: " << e.what() << endl;
-        return false;
+    for (size_t depth = levels.size(); depth-- > 0;) {
+        ADS_METRICS_VISITS(levels[depth].size());
+        for (const pair<const NodePtr, Money> &pending: levels[depth]) {
+            if (pending.second == Money()) {
+                continue;
+            }
+            Account &account = pending.first->getData();
+            account.setBalance(account.getBalance() + pending.second);
+            recordChange(account.getAccountNumber());
+
+            NodePtr parent = pending.first->getParent();
+            if (parent && depth > 0) {
+                levels[depth - 1][parent] += pending.second;
+            }
+        }
     }
 }
 
@@ -365,154 +1421,387 @@ bool ForestTree::addTransaction(int accountNumber, Transaction &transaction) {
  * @return bool Returns true if the transaction was successfully deleted, false if the account or transaction is not found or an error occurs.
  *
  * @details This method removes a transaction from the specified account's history and updates the account balance accordingly.
- * If the transaction is successfully deleted, the method attempts to save the updated transaction history to a file.
+ * If the transaction is successfully deleted, a tombstone for it is appended to the transaction journal.
  */
 bool ForestTree::deleteTransaction(int accountNumber, int transactionIndex) {
-    // Find the account node and its root
-    NodePtr accountNode = nullptr;
-    NodePtr rootNode = nullptr;
+    uint64_t sequence = 0;
+    bool deleted;
+    {
+        shared_lock<shared_mutex> structure(structureLock);
+        unique_lock<shared_mutex> root(rootLock(accountNumber));
 
-    // Search through all root nodes to find both the account and its root
-    for (NodePtr root: rootAccounts) {
-        accountNode = root->findNode(root, accountNumber);
-        if (accountNode) {
-            rootNode = root;
-            while (rootNode->getRightSibling() &&
-                   to_string(rootNode->getRightSibling()->getData().getAccountNumber())[0] ==
-                   to_string(accountNode->getData().getAccountNumber())[0]) {
-                rootNode = rootNode->getRightSibling();
+        NodePtr accountNode = lookup(accountNumber);
+
+        if (!accountNode) {
+            cout << "Error: Account not found for account number: " << accountNumber << endl;
+            return false;
+        }
+
+        Account &account = accountNode->getData();
+        TransactionView transactions = account.getTransactions();
+
+        // Validate transaction index
+        if (transactionIndex < 0 || transactionIndex >= transactions.size()) {
+            cout << "Error: Invalid transaction index. Please enter a number between 0 and "
+                 << transactions.size() - 1 << endl;
+            return false;
+        }
+
+        deleted = removeTransactionAt(accountNode, transactions.getColumns().slotOf(transactionIndex), sequence);
+    }
+
+    commitJournal(sequence);
+    return deleted;
+}
+
+/**
+ * @brief Deletes a transaction identified by its transaction ID.
+ *
+ * @param transactionID The ID of the transaction to delete.
+ *
+ * @return bool True if the transaction was found and deleted, false otherwise.
+ *
+ * @details The ID index of each root tree is probed under that tree's lock, so the transaction is found without
+ * scanning any history, and its slot is marked as deleted instead of shifting the history.
+ */
+bool ForestTree::deleteTransactionById(const string &transactionID) {
+    uint64_t sequence = 0;
+    bool deleted = false;
+    bool found = false;
+    {
+        shared_lock<shared_mutex> structure(structureLock);
+        for (size_t digit = 0; digit < ROOT_LOCK_COUNT && !found; ++digit) {
+            unique_lock<shared_mutex> root(rootLocks[digit]);
+            TransactionLocation location;
+            if (transactionIds[digit].find(transactionID, location)) {
+                found = true;
+                deleted = removeTransactionAt(location.node, location.slot, sequence);
             }
-            break;
         }
     }
 
-    if (!accountNode) {
-        cout << "Error: Account not found for account number: " << accountNumber << endl;
+    if (!found) {
+        cout << "Error: Transaction not found: " << transactionID << endl;
         return false;
     }
+    commitJournal(sequence);
+    return deleted;
+}
+
+/**
+ * @brief Finds a transaction by its transaction ID.
+ *
+ * @param transactionID The ID to search for.
+ * @param accountNumber Receives the number of the account holding the transaction.
+ * @param transaction Receives the transaction.
+ *
+ * @return bool True if a transaction with the ID exists, false otherwise.
+ */
+bool ForestTree::findTransaction(const string &transactionID, int &accountNumber, Transaction &transaction) const {
+    shared_lock<shared_mutex> structure(structureLock);
+    for (size_t digit = 0; digit < ROOT_LOCK_COUNT; ++digit) {
+        shared_lock<shared_mutex> root(rootLocks[digit]);
+        TransactionLocation location;
+        if (transactionIds[digit].find(transactionID, location)) {
+            const Account &account = location.node->getData();
+            accountNumber = account.getAccountNumber();
+            transaction = account.getTransactions().getColumns().get(location.slot);
+            return true;
+        }
+    }
+    return false;
+}
 
+/**
+ * @brief Removes the transaction in a slot of an account and reverses its effect on the balances.
+ *
+ * @param accountNode The account holding the transaction; the caller holds its tree's lock exclusively.
+ * @param slot The slot of the transaction.
+ * @param sequence Receives the sequence number of the journal record, to commit once the locks are released.
+ *
+ * @return bool True if the transaction was deleted, false if an error occurred.
+ *
+ * @details The slot is marked as deleted and its ID index entry removed, the balances and date indexes are updated,
+ * and a tombstone with the transaction's index among the live transactions is appended to the journal. The account
+ * is compacted once deleted slots outnumber live ones, which keeps the cost of deletion amortized constant.
+ */
+bool ForestTree::removeTransactionAt(NodePtr accountNode, size_t slot, uint64_t &sequence) {
     Account &account = accountNode->getData();
-    const vector<Transaction> &transactions = account.getTransactions();
+    const TransactionColumns &columns = account.getTransactions().getColumns();
+    int accountNumber = account.getAccountNumber();
+
+    try {
+        // Get the transaction before removing it to update balances
+        Transaction deletedTransaction = columns.get(slot);
+        int transactionIndex = static_cast<int>(columns.indexOf(slot));
 
-    // Validate transaction index
-    if (transactionIndex < 0 || transactionIndex >= transactions.size()) {
-        cout << "Error: Invalid transaction index. Please enter a number between 0 and "
-             << transactions.size() - 1 << endl;
+        // Remove the transaction from the account
+        account.removeTransactionSlot(slot);
+        transactionIds[rootDigit(accountNumber)].remove(accountNode, slot);
+
+        // Reverse its effect on the balances through the hierarchy
+        applyDelta(accountNode, -postingDelta(deletedTransaction));
+        indexPosting(accountNode, deletedTransaction.getDate(), -postingDelta(deletedTransaction));
+        sequence = journal.appendTombstone(accountNumber, transactionIndex, deletedTransaction);
+
+        if (columns.deletedCount() >= COMPACTION_MIN_DELETED && columns.deletedCount() > columns.size()) {
+            compactTransactions(accountNode);
+        }
+        return true;
+    } catch (const exception &e) {
+        cerr << "Error while deleting transaction: " << e.what() << endl;
         return false;
     }
+}
 
-    try {
-        // Get the transaction before removing it to update balances
-        Transaction deletedTransaction = transactions[transactionIndex];
+/**
+ * @brief Adds the most recently appended transaction of an account to the ID index.
+ *
+ * @param accountNode The account; the caller holds its tree's lock exclusively.
+ */
+void ForestTree::indexLastTransaction(NodePtr accountNode) {
+    const TransactionColumns &columns = accountNode->getData().getTransactions().getColumns();
+    transactionIds[rootDigit(accountNode->getData().getAccountNumber())].add(accountNode, columns.slotCount() - 1);
+}
 
-        // Create an inverse transaction to update balances
-        Transaction inverseTransaction(
-                deletedTransaction.getTransactionID(),
-                deletedTransaction.getAmount(),
-                deletedTransaction.getDebitCredit() == 'D' ? 'C' : 'D'  // Invert D to C and C to D
-        );
+/**
+ * @brief Drops the deleted slots of an account and moves its ID index entries to the new slots.
+ *
+ * @param accountNode The account; the caller holds its tree's lock exclusively.
+ */
+void ForestTree::compactTransactions(NodePtr accountNode) {
+    Account &account = accountNode->getData();
+    const TransactionColumns &columns = account.getTransactions().getColumns();
+    TransactionIdIndex &ids = transactionIds[rootDigit(account.getAccountNumber())];
 
-        // Remove the transaction from the account
-        account.removeTransaction(transactionIndex);
+    for (size_t slot = 0; slot < columns.slotCount(); ++slot) {
+        if (!columns.isDeleted(slot)) {
+            ids.remove(accountNode, slot);
+        }
+    }
+    account.compactTransactions();
+    for (size_t slot = 0; slot < columns.slotCount(); ++slot) {
+        ids.add(accountNode, slot);
+    }
+}
+
+/**
+ * @brief Rebuilds the ID index of every root tree, one tree per worker.
+ *
+ * @details Accounts left with deleted slots, for instance by journal replay, are compacted first. The caller holds
+ * the structure lock exclusively.
+ */
+void ForestTree::indexAllTransactions() {
+    vector<vector<NodePtr>> roots(ROOT_LOCK_COUNT);
+    for (NodePtr root: rootAccounts) {
+        roots[rootDigit(root->getData().getAccountNumber())].push_back(root);
+    }
 
-        // Update balances through the hierarchy using the inverse transaction
-        for (NodePtr root: rootAccounts) {
-            if (to_string(root->getData().getAccountNumber())[0] ==
-                to_string(accountNumber)[0]) {
-                accountNode->updateBalance(root, inverseTransaction);
-                break;
+    size_t threads = accountIndex.size() >= PARALLEL_THRESHOLD ? ROOT_LOCK_COUNT : 1;
+    runParallel(ROOT_LOCK_COUNT, threads, [&](size_t digit) {
+        TransactionIdIndex &ids = transactionIds[digit];
+        ids.clear();
+        for (NodePtr root: roots[digit]) {
+            for (NodePtr node: preOrder(root)) {
+                node->getData().compactTransactions();
+                const TransactionColumns &columns = node->getData().getTransactions().getColumns();
+                for (size_t slot = 0; slot < columns.slotCount(); ++slot) {
+                    ids.add(node, slot);
+                }
             }
         }
+    });
+}
 
-        try {
-            saveTransactions(getTransactionFilename("accountswithspace.txt"));
-        } catch (const exception &e) {
-            cerr << "Warning: Failed to save transactions: " << e.what() << endl;
+/**
+ * @brief Saves the current state of the tree to a file, updating account balances.
+ *
+ * @param filename The name of the file to which the tree data should be saved.
+ *
+ * @return void
+ *
+ * @details Only the accounts changed since the last save are written. If `filename` is the chart the forest was loaded
+ * from and every changed balance fits the fixed-width field it occupies, those fields are overwritten in place, so the
+ * cost depends on the number of changed accounts and not on the size of the chart. Otherwise the file is read and
+ * rewritten with the balances of the tree, keeping lines of unknown accounts, and atomically replaced. The balances
+ * are logged to the journal before any of them is written, since an in-place save that is cut short leaves some
+ * fields old and some new.
+ */
+void ForestTree::saveToFile(const string &filename) {
+    ADS_METRICS_TIME(SAVE_TO_FILE);
+    unique_lock<shared_mutex> structure(structureLock);
+    settleAllBalances();
+
+    if (!snapshotFile.getPath().empty() && filename == snapshotFile.getPath()) {
+        journalBalances();
+        if (snapshotFile.writeBalances(dirtyBalances())) {
+            dirtyAccounts.clear();
+            return;
+        }
+    } else if (filename == chartFile.getPath()) {
+        journalBalances();
+        if (chartFile.writeInPlace(dirtyBalances())) {
+            dirtyAccounts.clear();
+            return;
         }
+    }
 
-        return true;
+    string buffer;
+    if (!ChartFile::readAll(filename, buffer)) {
+        throw runtime_error("Unable to open file for reading: " + filename);
+    }
+    if (ForestSnapshot::isSnapshot(buffer)) {
+        saveSnapshotUnlocked(filename);
+        return;
+    }
+    rewriteChartFile(filename, buffer);
+}
 
-        return true;
-    } catch (const exception &e) {
-        cerr << "Error while deleting transaction: " << e.what() << endl;
-        return false;
+/**
+ * @brief Collects the current balance of every account changed since the last save.
+ *
+ * @return vector<pair<int, Money>> The account numbers and balances of the changed accounts.
+ */
+vector<pair<int, Money>> ForestTree::dirtyBalances() const {
+    vector<pair<int, Money>> balances;
+    balances.reserve(dirtyAccounts.size());
+    for (int accountNumber: dirtyAccounts) {
+        NodePtr accountNode = lookup(accountNumber);
+        if (accountNode) {
+            balances.push_back(make_pair(accountNumber, accountNode->getData().getBalance()));
+        }
+    }
+    return balances;
+}
+
+/**
+ * @brief Saves the whole forest and all its transactions as a binary snapshot.
+ *
+ * @param filename The name of the snapshot file.
+ *
+ * @throws runtime_error If the snapshot cannot be written.
+ *
+ * @details The snapshot is encoded in memory and atomically replaces `filename`. When it replaces the file the forest
+ * was loaded from, it already holds every journaled change: it is stamped with the last sequence number, the journal
+ * is checkpointed and the new snapshot becomes the file whose balances are saved in place.
+ */
+void ForestTree::saveSnapshot(const string &filename) {
+    unique_lock<shared_mutex> structure(structureLock);
+    saveSnapshotUnlocked(filename);
+}
+
+/**
+ * @brief Saves the forest as a binary snapshot; the caller holds the structure lock exclusively.
+ *
+ * @param filename The name of the snapshot file.
+ *
+ * @throws runtime_error If the snapshot cannot be written.
+ */
+void ForestTree::saveSnapshotUnlocked(const string &filename) {
+    settleAllBalances();
+    bool isSource = filename == accountsFile;
+    string contents = ForestSnapshot::encode(rootAccounts, isSource ? journal.getLastSequence() : 0);
+
+    ChartFile::replaceFile(filename, contents);
+
+    if (isSource) {
+        journal.checkpoint(vector<pair<int, Money>>());
+        dirtyAccounts.clear();
+        SnapshotView snapshot;
+        string error;
+        if (snapshot.open(contents.data(), contents.size(), error)) {
+            snapshotFile.reset(filename, snapshot);
+        }
+        chartFile.reset("");
     }
 }
 
 /**
- * @brief Saves the current state of the tree to a file, updating account balances.
+ * @brief Exports the forest as a text chart and a text transactions file.
  *
- * @param filename The name of the file to which the tree data should be saved.
+ * @param filename The name of the chart file to write.
  *
- * @return void
+ * @throws runtime_error If either file cannot be written.
  *
- * @details This method reads all lines from the specified file into memory, processes each line to update account balances,
- * and then writes the updated data back to the file. Each account's balance is retrieved from the tree and updated in the file
- * accordingly. If an account is found in the tree, the balance is updated; otherwise, the original line is retained.
- * The method handles file reading, line processing, and file writing in a structured manner.
+ * @details Accounts are written in pre-order, one per line, with their balance in a fixed-width field, so the chart can
+ * be loaded again by `buildFromFile`. The transactions go to the file named by `getTransactionFilename`. Exporting
+ * over the loaded chart logs its balances to the journal first, like `saveToFile`.
  */
-void ForestTree::saveToFile(const string &filename) const {
-    // First, read all lines from the file into memory
-    ifstream inFile(filename);
-    if (!inFile) {
-        throw runtime_error("Unable to open file for reading: " + filename);
-    }
-
-    vector<string> lines;
-    string line;
-
-    while (getline(inFile, line)) {
-        lines.push_back(line);
+void ForestTree::exportText(const string &filename) const {
+    unique_lock<shared_mutex> structure(structureLock);
+    settleAllBalances();
+    if (filename == accountsFile) {
+        journalBalances();
     }
-    inFile.close();
-
-    // Update balances in the lines
-    for (auto &line: lines) {
-        istringstream iss(line);
-        int accountNum;
-        string description;
-
-        if (!(iss >> accountNum)) {
-            continue; // Skip invalid lines
-        }
-
-        // Find this account in our tree
-        NodePtr accountNode = findAccount(accountNum);
-        if (!accountNode) {
-            continue; // Account not found, keep original line
-        }
-
-        // Read until the last number (current balance)
-        string word;
-        vector<string> words;
-        while (iss >> word) {
-            words.push_back(word);
+    string output;
+    for (NodePtr root: rootAccounts) {
+        for (NodePtr current: preOrder(root)) {
+            const Account &account = current->getData();
+            output += to_string(account.getAccountNumber());
+            output += ' ';
+            if (!account.getDescription().empty()) {
+                output += account.getDescription();
+                output += ' ';
+            }
+            output += ChartFile::formatBalance(account.getBalance());
+            output += '\n';
         }
+    }
 
-        if (!words.empty()) {
-            // Remove the last word (old balance)
-            words.pop_back();
+    ChartFile::replaceFile(filename, output);
+    saveTransactionsUnlocked(getTransactionFilename(filename));
+}
 
-            // Create new line with updated balance
-            ostringstream newLine;
-            newLine << accountNum;
-            for (const auto &w: words) {
-                newLine << " " << w;
-            }
-            newLine << " " << fixed << setprecision(2) << accountNode->getData().getBalance();
+/**
+ * @brief Rewrites a chart file with the current balances and forgets all pending changes.
+ *
+ * @param filename The chart file to write.
+ * @param buffer The lines of the chart, separated by line breaks.
+ *
+ * @throws runtime_error If the file cannot be written.
+ *
+ * @details The pending balances are logged to the journal first, since they are no longer tracked once written.
+ */
+void ForestTree::rewriteChartFile(const string &filename, const string &buffer) {
+    settleAllBalances();
+    journalBalances();
+    chartFile.rewrite(filename, buffer, accountIndex);
+    dirtyAccounts.clear();
+}
 
-            line = newLine.str();
-        }
+/**
+ * @brief Marks an account and all its ancestors as changed since the last save.
+ *
+ * @param node The node whose balance changed.
+ */
+void ForestTree::markDirty(NodePtr node) {
+    lock_guard<mutex> dirtyGuard(dirtyLock);
+    for (; node != nullptr; node = node->getParent()) {
+        recordChange(node->getData().getAccountNumber());
     }
+}
 
-    // Write updated content back to file
-    ofstream outFile(filename);
-    if (!outFile) {
-        throw runtime_error("Unable to open file for writing: " + filename);
+/**
+ * @brief Records that an account changed; the caller holds the dirty set lock.
+ *
+ * @param accountNumber The account number.
+ */
+void ForestTree::recordChange(int accountNumber) const {
+    dirtyAccounts.insert(accountNumber);
+    if (viewReady) {
+        viewChanges.insert(accountNumber);
     }
+}
 
-    for (const auto &line: lines) {
-        outFile << line << endl;
+/**
+ * @brief Records that an account was added, for the next view.
+ *
+ * @param accountNumber The account number.
+ */
+void ForestTree::recordAddition(int accountNumber) {
+    lock_guard<mutex> dirtyGuard(dirtyLock);
+    if (viewReady) {
+        viewChanges.insert(accountNumber);
     }
 }
 
@@ -525,46 +1814,74 @@ void ForestTree::saveToFile(const string &filename) const {
  *
  * @details This method traverses the entire tree, saving all transactions for each account to the specified file.
  * Each transaction is saved in the format: account number, transaction ID, amount, debit/credit, date, and description.
- * The method uses a queue to traverse the tree level by level, ensuring that all accounts and their respective transactions
- * are processed and saved.
+ * The method walks every tree in pre-order, the order of the chart, ensuring that all accounts and their respective
+ * transactions are processed and saved.
  */
 void ForestTree::saveTransactions(const string &filename) const {
-    ofstream file(filename);
-    if (!file) {
-        throw runtime_error("Unable to open transaction file for writing: " + filename);
-    }
-
-    // For each account in the tree
-    for (NodePtr root: rootAccounts) {
-        if (!root) continue;
+    unique_lock<shared_mutex> structure(structureLock);
+    saveTransactionsUnlocked(filename);
+}
 
-        // Use a queue to traverse all nodes
-        queue<NodePtr> nodeQueue;
-        nodeQueue.push(root);
+/**
+ * @brief Saves all transactions to a file; the caller holds the structure lock exclusively.
+ *
+ * @param filename The name of the file to which the transaction data should be saved.
+ *
+ * @throws runtime_error If the file cannot be written.
+ *
+ * @details The file is built in memory and atomically replaces `filename`. The transactions file of the loaded chart
+ * starts with a `#checkpoint|N` line naming the last journal record it holds, so a replay of the journal after a
+ * crash between this save and the checkpoint of the journal applies no transaction twice.
+ */
+void ForestTree::saveTransactionsUnlocked(const string &filename) const {
+    ADS_METRICS_TIME(SAVE_TRANSACTIONS);
+    size_t transactionCount = 0;
+    for (const auto &entry: accountIndex) {
+        transactionCount += entry.second->getData().getTransactionCount();
+    }
 
-        while (!nodeQueue.empty()) {
-            NodePtr current = nodeQueue.front();
-            nodeQueue.pop();
+    // Every root tree is serialized into its own buffer, then the buffers are written in root order
+    vector<string> buffers(rootAccounts.size());
+    size_t threads = transactionCount >= PARALLEL_THRESHOLD ? rootAccounts.size() : 1;
+    runParallel(rootAccounts.size(), threads, [&](size_t i) {
+        ostringstream out;
 
+        // Accounts are written in chart order
+        for (NodePtr current: preOrder(rootAccounts[i])) {
             // Save transactions for current account
+            // Read the columns directly, so no transaction is materialized
             const Account &account = current->getData();
-            const vector<Transaction> &transactions = account.getTransactions();
-
-            for (const Transaction &t: transactions) {
-                file << account.getAccountNumber() << "|"
-                     << t.getTransactionID() << "|"
-                     << t.getAmount() << "|"
-                     << t.getDebitCredit() << "|"
-                     << t.getDate() << "|"
-                     << t.getDescription() << endl;
+            const TransactionColumns &transactions = account.getTransactions().getColumns();
+
+            for (size_t j = 0; j < transactions.slotCount(); ++j) {
+                if (transactions.isDeleted(j)) continue;
+                out << account.getAccountNumber() << "|"
+                    << transactions.getTransactionID(j) << "|"
+                    << transactions.getAmount(j) << "|"
+                    << transactions.getDebitCredit(j) << "|"
+                    << transactions.getDate(j) << "|"
+                    << transactions.getDescription(j) << '\n';
             }
-
-            // Add child and sibling to queue
-            if (current->getLeftChild()) nodeQueue.push(current->getLeftChild());
-            if (current->getRightSibling()) nodeQueue.push(current->getRightSibling());
         }
+        buffers[i] = out.str();
+    });
+
+    // The transactions file of the loaded chart records the last journal record it holds
+    string output;
+    if (!accountsFile.empty() && filename == getTransactionFilename(accountsFile)) {
+        output += CHECKPOINT_PREFIX;
+        output += to_string(journal.getLastSequence());
+        output += '\n';
     }
-    file.close();
+    size_t size = output.size();
+    for (const string &buffer: buffers) {
+        size += buffer.size();
+    }
+    output.reserve(size);
+    for (const string &buffer: buffers) {
+        output += buffer;
+    }
+    ChartFile::replaceFile(filename, output);
 }
 
 /**
@@ -581,46 +1898,126 @@ void ForestTree::saveTransactions(const string &filename) const {
  * with error handling for invalid lines.
  */
 void ForestTree::loadTransactions(const string &filename) {
-    ifstream file(filename);
-    if (!file) {
-        return; // It's okay if the file doesn't exist yet
+    unique_lock<shared_mutex> structure(structureLock);
+    loadTransactionsUnlocked(filename);
+    indexAllTransactions();
+    dateIndexReady = false;
+    tourReady = false;
+    viewReady = false;
+}
+
+/**
+ * @brief Loads transactions from a file; the caller holds the structure lock exclusively.
+ *
+ * @param filename The name of the file from which transaction data should be loaded.
+ *
+ * @return uint64_t The journal checkpoint stamped at the top of the file, 0 if it has none.
+ */
+uint64_t ForestTree::loadTransactionsUnlocked(const string &filename) {
+    ADS_METRICS_TIME(LOAD_TRANSACTIONS);
+    string buffer;
+    if (!ChartFile::readAll(filename, buffer)) {
+        return 0; // It's okay if the file doesn't exist yet
     }
 
-    string line;
-    while (getline(file, line)) {
-        istringstream iss(line);
-        string field;
-        vector<string> fields;
+    // The checkpoint line is not a transaction
+    uint64_t checkpoint = 0;
+    size_t start = 0;
+    if (buffer.compare(0, strlen(CHECKPOINT_PREFIX), CHECKPOINT_PREFIX) == 0) {
+        start = buffer.find('\n');
+        start = start == string::npos ? buffer.size() : start + 1;
+        try {
+            checkpoint = stoull(buffer.substr(strlen(CHECKPOINT_PREFIX), start - strlen(CHECKPOINT_PREFIX)));
+        } catch (const exception &e) {
+            cerr << "Error loading transactions checkpoint: " << e.what() << endl;
+        }
+    }
 
-        // Split line by '|'
-        while (getline(iss, field, '|')) {
-            fields.push_back(field);
+    // Split the file into chunks of whole lines, one per worker
+    size_t chunkCount = max(size_t(1), min(size_t(thread::hardware_concurrency()),
+                                           (buffer.size() - start) / PARALLEL_CHUNK_BYTES));
+    vector<size_t> bounds(1, start);
+    for (size_t i = 1; i < chunkCount; ++i) {
+        size_t cut = buffer.find('\n', max(bounds.back(), start + (buffer.size() - start) * i / chunkCount));
+        if (cut == string::npos) break;
+        bounds.push_back(cut + 1);
+    }
+    bounds.push_back(buffer.size());
+    chunkCount = bounds.size() - 1;
+
+    // Parse every chunk into per-root lists; the account index is only read
+    vector<vector<vector<ParsedTransaction>>> parsed(chunkCount, vector<vector<ParsedTransaction>>(ROOT_LOCK_COUNT));
+    vector<vector<string>> errors(chunkCount);
+    runParallel(chunkCount, chunkCount, [&](size_t chunk) {
+        size_t lineStart = bounds[chunk];
+        while (lineStart < bounds[chunk + 1]) {
+            size_t lineEnd = buffer.find('\n', lineStart);
+            if (lineEnd == string::npos || lineEnd > bounds[chunk + 1]) {
+                lineEnd = bounds[chunk + 1];
+            }
+            string_view line(buffer.data() + lineStart, lineEnd - lineStart);
+            lineStart = lineEnd + 1;
+
+            // Split line by '|'; fields after the description are ignored
+            string_view fields[6];
+            size_t fieldCount = 0;
+            size_t fieldStart = 0;
+            while (fieldCount < 6) {
+                size_t bar = line.find('|', fieldStart);
+                fields[fieldCount++] = line.substr(fieldStart, bar == string_view::npos ? string_view::npos : bar - fieldStart);
+                if (bar == string_view::npos) break;
+                fieldStart = bar + 1;
+            }
+            if (fieldCount < 6) continue; // Skip invalid lines
+
+            try {
+                int accountNum = stoi(string(fields[0]));
+                NodePtr accountNode = lookup(accountNum);
+                if (!accountNode) continue;
+
+                // The fields stay views of the buffer until they are copied into the columns
+                parsed[chunk][rootDigit(accountNum)].push_back(ParsedTransaction{
+                        accountNode,
+                        fields[1],                               // ID
+                        Money::parse(fields[2]),                 // Amount
+                        fields[3].empty() ? '\0' : fields[3][0], // Debit/Credit
+                        fields[5],                               // Description
+                        fields[4]});                             // Date
+            } catch (const exception &e) {
+                errors[chunk].push_back(e.what());
+            }
         }
+    });
 
-        if (fields.size() < 6) continue; // Skip invalid lines
+    for (const vector<string> &chunkErrors: errors) {
+        for (const string &error: chunkErrors) {
+            cerr << "Error loading transaction: " << error << endl;
+        }
+    }
 
-        try {
-            int accountNum = stoi(fields[0]);
-            NodePtr accountNode = findAccount(accountNum);
-            if (!accountNode) continue;
-
-            // Create and add transaction
-            Transaction t(fields[1],                    // ID
-                          stod(fields[2]),               // Amount
-                          fields[3][0],                  // Debit/Credit
-                          fields[5],                     // Description
-                          fields[4]);                    // Date
-
-            // Add transaction without updating file
-            accountNode->getData().addTransaction(t);
-            //accountNode->updateBalance(findRootForAccount(accountNum), t);
+    // Append the transactions of every root tree on its own worker, in file order
+    runParallel(ROOT_LOCK_COUNT, chunkCount > 1 ? ROOT_LOCK_COUNT : 1, [&](size_t digit) {
+        // Size the columns of every account once, instead of letting them grow one transaction at a time
+        unordered_map<NodePtr, size_t> counts;
+        for (const vector<vector<ParsedTransaction>> &chunk: parsed) {
+            for (const ParsedTransaction &entry: chunk[digit]) {
+                ++counts[entry.node];
+            }
+        }
+        for (const pair<const NodePtr, size_t> &count: counts) {
+            count.first->getData().reserveTransactions(count.second);
+        }
 
-        } catch (const exception &e) {
-            cerr << "Error loading transaction: " << e.what() << endl;
-            continue;
+        for (vector<vector<ParsedTransaction>> &chunk: parsed) {
+            for (ParsedTransaction &entry: chunk[digit]) {
+                // Add transaction without updating file
+                entry.node->getData().emplaceTransaction(entry.id, entry.amount, entry.debitCredit,
+                                                         entry.description, entry.date);
+            }
+            chunk[digit].clear();
         }
-    }
-    file.close();
+    });
+    return checkpoint;
 }
 
 /**
@@ -636,16 +2033,30 @@ void ForestTree::loadTransactions(const string &filename) {
  * grouped together in the forest structure.
  */
 NodePtr ForestTree::findRootForAccount(int accountNumber) const {
-    string accStr = to_string(accountNumber);
-    char firstDigit = accStr[0];
+    size_t firstDigit = AccountCode::leadingDigit(accountNumber);
     for (NodePtr root: rootAccounts) {
-        if (root && to_string(root->getData().getAccountNumber())[0] == firstDigit) {
+        if (root && AccountCode::leadingDigit(root->getData().getAccountNumber()) == firstDigit) {
             return root;
         }
     }
     return nullptr;
 }
 
+/**
+ * @brief Returns the account numbers of the root accounts.
+ *
+ * @return vector<int> The root account numbers, in forest order.
+ */
+vector<int> ForestTree::getRootAccountNumbers() const {
+    shared_lock<shared_mutex> structure(structureLock);
+    vector<int> numbers;
+    numbers.reserve(rootAccounts.size());
+    for (NodePtr root: rootAccounts) {
+        numbers.push_back(root->getData().getAccountNumber());
+    }
+    return numbers;
+}
+
 /**
  * @brief Generates a transaction filename based on the provided accounts file name.
  *
@@ -661,33 +2072,370 @@ string ForestTree::getTransactionFilename(const string &accountsFile) const {
     return accountsFile.substr(0, accountsFile.find_last_of('.')) + "_transactions.txt";
 }
 
-bool ForestTree::addAccountWithFile(int accountNumber, const string &description, double balance, string path) {
+/**
+ * @brief Generates the transaction journal filename based on the provided accounts file name.
+ *
+ * @param accountsFile The name of the accounts file.
+ *
+ * @return string The journal file name, which appends "_transactions.journal" to the accounts file name, or the
+ * file chosen with `setJournalFilename`.
+ */
+string ForestTree::getJournalFilename(const string &accountsFile) const {
+    if (!journalFile.empty()) {
+        return journalFile;
+    }
+    return accountsFile.substr(0, accountsFile.find_last_of('.')) + "_transactions.journal";
+}
+
+/**
+ * @brief Chooses the journal file used by later loads instead of the one next to the chart.
+ *
+ * @param filename The journal file, or an empty string to keep it next to the chart again.
+ */
+void ForestTree::setJournalFilename(const string &filename) {
+    unique_lock<shared_mutex> structure(structureLock);
+    journalFile = filename;
+}
+
+/**
+ * @brief Writes and syncs every journal record that is still pending.
+ *
+ * @throws runtime_error If the journal cannot be flushed.
+ */
+void ForestTree::flushJournal() {
+    journal.flush();
+}
+
+/**
+ * @brief Sets whether every change waits until its journal record is on stable storage.
+ *
+ * @param enabled True to sync the journal on every commit.
+ */
+void ForestTree::setDurableCommits(bool enabled) {
+    journal.setDurable(enabled);
+}
+
+/**
+ * @brief Checks whether every change waits until its journal record is on stable storage.
+ *
+ * @return bool True if commits are durable, false otherwise.
+ */
+bool ForestTree::isDurableCommits() const {
+    return journal.isDurable();
+}
+
+/**
+ * @brief Sets whether changes hand their journal records to a background writer thread instead of waiting.
+ *
+ * @param enabled True for asynchronous commits.
+ *
+ * @throws runtime_error If the records journaled so far cannot be written.
+ *
+ * @details The structure lock is held exclusively, so no change appends a record while the journal switches modes.
+ */
+void ForestTree::setAsyncCommits(bool enabled) {
+    unique_lock<shared_mutex> structure(structureLock);
+    journal.setAsync(enabled);
+}
+
+/**
+ * @brief Checks whether changes hand their journal records to a background writer thread.
+ *
+ * @return bool True if commits are asynchronous, false otherwise.
+ */
+bool ForestTree::isAsyncCommits() const {
+    return journal.isAsync();
+}
+
+/**
+ * @brief Returns a future that is ready once every change made so far is on stable storage.
+ *
+ * @return future<void> The future of the last journal record.
+ */
+future<void> ForestTree::whenDurable() const {
+    return journal.whenSynced(journal.getLastSequence());
+}
+
+/**
+ * @brief Waits until a journal record is durable, reporting a failure instead of throwing it.
+ *
+ * @param sequence The sequence number of the record, 0 for none.
+ *
+ * @details The change is already applied in memory, so a journal failure only costs its durability.
+ */
+void ForestTree::commitJournal(uint64_t sequence) {
+    ADS_METRICS_TIME(JOURNAL_COMMIT);
+    try {
+        journal.commit(sequence);
+    } catch (const exception &e) {
+        cerr << "Warning: Failed to save transactions: " << e.what() << endl;
+    }
+}
+
+/**
+ * @brief Logs and syncs the balances of the accounts changed since the last save, before a save writes them.
+ *
+ * @throws runtime_error If the journal cannot be written.
+ *
+ * @details The record is synced even without durable commits: once the save has written the balances, the changes
+ * journaled before it must not be applied to them again, and the record is what marks them as saved. The caller holds
+ * the structure lock exclusively and has settled every balance.
+ */
+void ForestTree::journalBalances() const {
+    if (journal.appendBalances(dirtyBalances()) != 0) {
+        journal.flush();
+    }
+}
+
+/**
+ * @brief Folds the journal into the transactions snapshot and empties it.
+ *
+ * @throws runtime_error If the snapshot cannot be written or the journal cannot be truncated.
+ *
+ * @details The snapshot is written completely, stamped with the last sequence number, before the journal is replaced
+ * by a checkpoint, so a failure leaves the previous snapshot and the full journal in place; a failed checkpoint fails
+ * every later journal commit until a compaction succeeds. The checkpoint keeps the
+ * balances not saved to the chart yet. A forest loaded from a binary snapshot is compacted by rewriting that snapshot
+ * with `saveSnapshot`.
+ */
+void ForestTree::compactJournal() {
+    unique_lock<shared_mutex> structure(structureLock);
+    if (accountsFile.empty()) {
+        return;
+    }
+    if (accountsFile == snapshotFile.getPath()) {
+        saveSnapshotUnlocked(accountsFile);
+        return;
+    }
+    saveTransactionsUnlocked(getTransactionFilename(accountsFile));
+    settleAllBalances();
+    journal.checkpoint(dirtyBalances());
+}
+
+/**
+ * @brief Replays a transaction journal on top of the loaded data files.
+ *
+ * @param filename The name of the journal file.
+ * @param checkpoint The last record whose transactions the loaded data files already hold.
+ * @param balanceCheckpoint The last record whose balances the loaded data files already hold.
+ * @param recovered Receives the accounts the replay had to add again.
+ *
+ * @return uint64_t The sequence number of the last record, or `checkpoint` if it is larger.
+ *
+ * @details Records are `P` postings, `X` tombstones, `A` added accounts, and `B` and `K` balance records; see
+ * `TransactionJournal`. Every save logs a balance record before it writes balances, so the data files hold the
+ * balances of some balance record or newer ones. Balance records are therefore applied as they are, and only the
+ * changes after the last one are applied as deltas. Records of an older journal without sequence numbers,
+ * `+|account|id|amount|type|date|description` and `-|account|index|id`, restore transactions only. Records of unknown
+ * accounts, tombstones that no longer match and malformed lines are skipped; a last line without a line break was
+ * torn by a crash and is cut from the file, so new records do not run into it. A missing or repeated sequence number
+ * is an error, checked before any record is applied.
+ *
+ * @throws runtime_error If the sequence numbers of the journal have a gap.
+ */
+uint64_t ForestTree::replayJournal(const string &filename, uint64_t checkpoint, uint64_t balanceCheckpoint,
+                                   vector<int> &recovered) {
+    string buffer;
+    if (!ChartFile::readAll(filename, buffer)) {
+        return checkpoint; // It's okay if the journal doesn't exist yet
+    }
+
+    size_t complete = buffer.rfind('\n');
+    complete = complete == string::npos ? 0 : complete + 1;
+    if (complete < buffer.size()) {
+        cerr << "Warning: Discarding a torn record at the end of the journal: " << filename << endl;
+        error_code error;
+        filesystem::resize_file(filename, complete, error);
+        buffer.resize(complete);
+    }
+
+    // Split every line by '|'
+    vector<vector<string>> records;
+    istringstream lines(buffer);
+    string line;
+    while (getline(lines, line)) {
+        istringstream iss(line);
+        string field;
+        vector<string> fields;
+        while (getline(iss, field, '|')) {
+            fields.push_back(field);
+        }
+
+        // A trailing empty description is not returned by getline
+        if (!line.empty() && line.back() == '|') {
+            fields.push_back("");
+        }
+        if (fields.size() >= 2) {
+            records.push_back(move(fields));
+        }
+    }
+
+    // Only the changes after the last balance record still have to be applied to the balances. Sequence numbers
+    // follow each other without gaps, since a change missing from the journal would silently be lost; only a
+    // checkpoint record may start further on, as the data files hold everything before it.
+    size_t lastBalances = 0;
+    bool hasBalances = false;
+    uint64_t expected = 0;
+    for (size_t i = 0; i < records.size(); ++i) {
+        const string &type = records[i][0];
+        if (type == "+" || type == "-") {
+            continue;
+        }
+        uint64_t sequence;
+        try {
+            sequence = stoull(records[i][1]);
+        } catch (const exception &) {
+            continue;
+        }
+        if (expected == 0 ? type != "K" && sequence > checkpoint + 1 : sequence != expected) {
+            throw runtime_error("Transaction journal " + filename + " has record " + to_string(sequence) +
+                                " where record " + to_string(expected == 0 ? checkpoint + 1 : expected) +
+                                " was expected");
+        }
+        expected = sequence + 1;
+        if ((type == "B" || type == "K") && sequence > balanceCheckpoint) {
+            lastBalances = i;
+            hasBalances = true;
+        }
+    }
+
+    uint64_t lastSequence = checkpoint;
+    for (size_t i = 0; i < records.size(); ++i) {
+        const vector<string> &fields = records[i];
+        const string &type = fields[0];
+        try {
+            if (type == "+" || type == "-") {
+                if (fields.size() < 4) continue;
+                NodePtr accountNode = lookup(stoi(fields[1]));
+                if (!accountNode) continue;
+                Account &account = accountNode->getData();
+                if (type == "+" && fields.size() >= 7) {
+                    account.addTransaction(Transaction(fields[2], Money::parse(fields[3]), fields[4][0], fields[6],
+                                                       fields[5]));
+                } else if (type == "-") {
+                    int index = stoi(fields[2]);
+                    if (index >= 0 && index < account.getTransactionCount() &&
+                        account.getTransaction(index).getTransactionID() == fields[3]) {
+                        account.removeTransaction(index);
+                    }
+                }
+                continue;
+            }
+
+            uint64_t sequence = stoull(fields[1]);
+            lastSequence = max(lastSequence, sequence);
+            bool newTransactions = sequence > checkpoint;
+            bool newBalances = sequence > balanceCheckpoint && (!hasBalances || i > lastBalances);
+
+            if (type == "B" || type == "K") {
+                if (sequence <= balanceCheckpoint) continue;
+                settleAllBalances();
+                lock_guard<mutex> dirtyGuard(dirtyLock);
+                for (size_t k = 2; k < fields.size(); ++k) {
+                    size_t colon = fields[k].find(':');
+                    if (colon == string::npos) continue;
+                    int accountNumber = stoi(fields[k].substr(0, colon));
+                    NodePtr accountNode = lookup(accountNumber);
+                    if (!accountNode) continue;
+                    accountNode->getData().setBalance(Money::parse(string_view(fields[k]).substr(colon + 1)));
+                    recordChange(accountNumber);
+                }
+            } else if (type == "P" && fields.size() >= 8) {
+                NodePtr accountNode = lookup(stoi(fields[2]));
+                if (!accountNode) continue;
+                Transaction t(fields[3], Money::parse(fields[4]), fields[5][0], fields[7], fields[6]);
+                if (newTransactions) {
+                    accountNode->getData().addTransaction(t);
+                }
+                if (newBalances) {
+                    applyDelta(accountNode, postingDelta(t));
+                }
+            } else if (type == "X" && fields.size() >= 7) {
+                NodePtr accountNode = lookup(stoi(fields[2]));
+                if (!accountNode) continue;
+                Account &account = accountNode->getData();
+                int index = stoi(fields[3]);
+                if (newTransactions && index >= 0 && index < account.getTransactionCount() &&
+                    account.getTransaction(index).getTransactionID() == fields[4]) {
+                    account.removeTransaction(index);
+                }
+                if (newBalances) {
+                    applyDelta(accountNode, -postingDelta(Transaction(fields[4], Money::parse(fields[5]),
+                                                                      fields[6][0], "", "")));
+                }
+            } else if (type == "A" && fields.size() >= 5) {
+                int accountNumber = stoi(fields[2]);
+                Money balance = Money::parse(fields[3]);
+                if (lookup(accountNumber)) continue;
+                int parentNumber = AccountCode::parent(accountNumber);
+                if (!addAccountUnlocked(Account(accountNumber, fields[4], balance), parentNumber)) continue;
+                recovered.push_back(accountNumber);
+                if (newBalances && balance != Money() && parentNumber != AccountCode::NO_PARENT) {
+                    applyDelta(lookup(parentNumber), balance);
+                }
+            }
+        } catch (const exception &e) {
+            cerr << "Error replaying journal record: " << e.what() << endl;
+            continue;
+        }
+    }
+    return lastSequence;
+}
+
+/**
+ * @brief Adds a new account to both the tree structure and the file.
+ *
+ * @param accountNumber The account number.
+ * @param description The account description.
+ * @param balance The initial balance.
+ * @param path The chart file that receives the new account.
+ *
+ * @return bool True if the account was added, false otherwise.
+ *
+ * @details The account is added to the forest and its opening balance to its ancestors, then it is journaled and
+ * committed, and only then inserted into the chart with `insertChartLine`.
+ */
+bool ForestTree::addAccountWithFile(int accountNumber, const string &description, Money balance, string path) {
+    unique_lock<shared_mutex> structure(structureLock);
+
     Account newAccount;
     newAccount.setAccountNumber(accountNumber);
     newAccount.setDescription(description);
     newAccount.setBalance(balance);  // Set initial balance directly
 
     // Automatically determine parent account based on account number
-    string accStr = to_string(accountNumber);
-    int parentNumber = accStr.length() > 1 ? stoi(accStr.substr(0, accStr.length() - 1)) : -1;
+    int parentNumber = AccountCode::parent(accountNumber);
 
-    if (!addAccount(newAccount, parentNumber)) {
+    if (!addAccountUnlocked(newAccount, parentNumber)) {
         return false;
     }
 
     // If this account has an initial balance and is not a root account, update all ancestor balances
-    if (balance != 0 && parentNumber != -1) {
-        string currentNum = accStr;
-        while (currentNum.length() > 1) {
-            currentNum = currentNum.substr(0, currentNum.length() - 1);
-            int ancestorNum = stoi(currentNum);
-            NodePtr ancestorNode = findAccount(ancestorNum);
-            if (ancestorNode) {
-                ancestorNode->getData().setBalance(ancestorNode->getData().getBalance() + balance);
-            }
-        }
+    if (balance != Money() && parentNumber != -1) {
+        applyDelta(lookup(parentNumber), balance);
     }
 
+    // The account must be durable before the chart changes
+    commitJournal(journal.appendAccount(accountNumber, description, balance));
+    return insertChartLine(path, accountNumber, description, balance);
+}
+
+/**
+ * @brief Inserts the line of an account into a chart file, after its parent and siblings with smaller numbers.
+ *
+ * @param path The chart file.
+ * @param accountNumber The account number.
+ * @param description The account description.
+ * @param balance The balance written on the new line.
+ *
+ * @return bool True if the chart was rewritten, false if it could not be read or written.
+ *
+ * @details The caller holds the structure lock exclusively. The chart is rewritten with the current balances of the
+ * forest by `rewriteChartFile`.
+ */
+bool ForestTree::insertChartLine(const string &path, int accountNumber, const string &description, Money balance) {
+    int parentNumber = AccountCode::parent(accountNumber);
+
     // Read all lines from the file
     vector<string> lines;
     string line;
@@ -704,8 +2452,6 @@ bool ForestTree::addAccountWithFile(int accountNumber, const string &description
 
     // Find the correct position to insert the new account
     vector<string>::iterator insertPos = lines.end();
-    string accNumStr = to_string(accountNumber);
-    string parentStr = accStr.length() > 1 ? accStr.substr(0, accStr.length() - 1) : "";
 
     // First, find the parent's position
     vector<string>::iterator parentPos = lines.begin();
@@ -724,15 +2470,12 @@ bool ForestTree::addAccountWithFile(int accountNumber, const string &description
             istringstream iss(*insertPos);
             int currentAccNum;
             if (iss >> currentAccNum) {
-                string currStr = to_string(currentAccNum);
-                if (currStr.length() > parentStr.length() &&
-                    currStr.substr(0, parentStr.length()) == parentStr) {
-                    if (currStr.length() == accNumStr.length() &&
+                if (AccountCode::isDescendant(parentNumber, currentAccNum)) {
+                    if (AccountCode::digits(currentAccNum) == AccountCode::digits(accountNumber) &&
                         currentAccNum > accountNumber) {
                         break;
                     }
-                } else if (currStr.length() <= parentStr.length() ||
-                           currStr.substr(0, parentStr.length()) != parentStr) {
+                } else {
                     break;
                 }
             }
@@ -742,56 +2485,31 @@ bool ForestTree::addAccountWithFile(int accountNumber, const string &description
             istringstream iss(*insertPos);
             int currentAccNum;
             if (iss >> currentAccNum) {
-                string currStr = to_string(currentAccNum);
-                if (currStr[0] > accNumStr[0] ||
-                    (currStr[0] == accNumStr[0] && currentAccNum > accountNumber)) {
+                size_t currentDigit = AccountCode::leadingDigit(currentAccNum);
+                size_t accountDigit = AccountCode::leadingDigit(accountNumber);
+                if (currentDigit > accountDigit || (currentDigit == accountDigit && currentAccNum > accountNumber)) {
                     break;
                 }
             }
         }
     }
 
-    // Update all balances in the lines based on the tree's current state
-    for (auto &line: lines) {
-        istringstream iss(line);
-        int lineAccNum;
-        if (iss >> lineAccNum) {
-            NodePtr accNode = findAccount(lineAccNum);
-            if (accNode) {
-                string word;
-                vector<string> words;
-                while (iss >> word) {
-                    words.push_back(word);
-                }
-                if (!words.empty()) {
-                    words.pop_back(); // Remove old balance
-                    ostringstream newLine;
-                    newLine << lineAccNum;
-                    for (const auto &w: words) {
-                        newLine << " " << w;
-                    }
-                    newLine << " " << fixed << setprecision(2) << accNode->getData().getBalance();
-                    line = newLine.str();
-                }
-            }
-        }
-    }
-
     // Create and insert the new line
     ostringstream newLine;
-    newLine << accountNumber << " " << description << " " << fixed << setprecision(2) << balance;
+    newLine << accountNumber << " " << description << " " << balance;
     lines.insert(insertPos, newLine.str());
 
-    // Write all lines back to the file
-    ofstream outFile(path);
-    if (!outFile) {
-        cerr << "Error opening file for writing" << endl;
-        return false;
-    }
-
+    // Write all lines back to the file with the tree's current balances
+    string buffer;
     for (const string &l: lines) {
-        outFile << l << endl;
+        buffer += l;
+        buffer += '\n';
+    }
+    try {
+        rewriteChartFile(path, buffer);
+    } catch (const exception &e) {
+        cerr << "Error writing file: " << e.what() << endl;
+        return false;
     }
-    outFile.close();
     return true;
 }
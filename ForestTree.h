@@ -5,15 +5,38 @@
 #ifndef FORESTTREE_H
 #define FORESTTREE_H
 
+#include <cstdint>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 #include "TreeNode.h"
 #include "Account.h"
 #include "Transaction.h"
+#include "TransactionJournal.h"
+#include "ChartFile.h"
+#include "ForestSnapshot.h"
+#include "NodeArena.h"
+#include "TransactionIdIndex.h"
+#include "EulerTour.h"
+#include "AccountSearchIndex.h"
+#include "ForestView.h"
+#include <unordered_set>
 
 using namespace std;
 
+/**
+ * @brief An account whose balance disagrees with the balance rebuilt from the transactions of its subtree.
+ */
+struct BalanceMismatch {
+    int accountNumber;       ///< The account
+    Money storedBalance;     ///< The balance held by the account
+    Money recomputedBalance; ///< The debits minus the credits of the account and all its descendants
+};
+
 /**
  * @class ForestTree
  * @brief Represents a forest tree data structure for managing accounts and transactions.
@@ -22,9 +45,65 @@ using namespace std;
  * by a node. It provides methods for adding, deleting, and updating accounts and transactions, as well as loading and
  * saving account data to and from files. The class also includes functionality to print reports and details about the tree
  * structure.
+ *
+ * All public methods are safe to call from several threads. Since the parent of an account is its number without the
+ * last digit, a posting only changes balances inside the tree named by the leading digit of the account, so every
+ * such tree has its own lock: postings to different trees run in parallel, and a posting holds its tree exclusively
+ * for the whole rollup, so readers never see it half-applied. Operations that add accounts, load or save files take
+ * the structure lock exclusively. Locks are always taken in the order structure lock, root locks by ascending digit,
+ * dirty set lock. Changes append their journal record while they hold their locks and wait for it to be durable only
+ * after releasing them, so concurrent postings share one sync of the journal. Nodes returned by `findAccount` are not protected once it returns; use
+ * `readAccount` to read an account while postings may run.
  */
 class ForestTree {
 private:
+    /**
+     * @brief The number of root trees, one per leading digit of an account number.
+     */
+    static const size_t ROOT_LOCK_COUNT = 10;
+
+    /**
+     * @brief The number of accounts or transactions from which loads and saves are spread over several threads.
+     */
+    static const size_t PARALLEL_THRESHOLD = 4096;
+
+    /**
+     * @brief The smallest share of a transactions file parsed by one loading thread, in bytes.
+     */
+    static const size_t PARALLEL_CHUNK_BYTES = 1 << 18;
+
+    /**
+     * @brief The number of deleted transaction slots an account may hold before it is compacted.
+     *
+     * @details An account is compacted once it holds at least this many deleted slots and more deleted than live ones.
+     */
+    static const size_t COMPACTION_MIN_DELETED = 64;
+
+    /**
+     * @brief Guards the shape of the forest: the trees, the account index and the source files.
+     *
+     * @details Postings and readers hold it shared, so they only exclude operations that add accounts or touch files.
+     */
+    mutable shared_mutex structureLock;
+
+    /**
+     * @brief Guards the balances and transactions of each root tree, indexed by the leading digit of its accounts.
+     */
+    mutable shared_mutex rootLocks[ROOT_LOCK_COUNT];
+
+    /**
+     * @brief Guards `dirtyAccounts` while postings to different trees run.
+     */
+    mutable mutex dirtyLock;
+
+    /**
+     * @brief Owns every node of the forest.
+     *
+     * @details Nodes are allocated from the arena in contiguous blocks with their account stored inline, and the whole
+     * forest is freed by a single `NodeArena::release`.
+     */
+    NodeArena arena;
+
     /**
      * @brief A vector of root nodes representing the forest tree.
      *
@@ -33,11 +112,128 @@ private:
      */
     vector<NodePtr> rootAccounts;
 
+    /**
+     * @brief Hash index from account number to the node holding that account.
+     *
+     * @details Every account lookup in the forest goes through this index instead of searching the trees. It is
+     * filled by `addAccount` and cleared together with the nodes by `cleanupTree`.
+     */
+    AccountIndex accountIndex;
+
+    /**
+     * @brief Hash index from transaction ID to account and slot, one per root tree.
+     *
+     * @details Each index is guarded by the lock of its root tree, so postings to different trees update them in
+     * parallel. Rebuilt after every load by `indexAllTransactions` and kept up to date by postings and deletions.
+     */
+    TransactionIdIndex transactionIds[ROOT_LOCK_COUNT];
+
+    /**
+     * @brief The chart file the forest was built from.
+     *
+     * @details The transactions snapshot and the journal live next to it; see `getTransactionFilename` and
+     * `getJournalFilename`. Empty until `buildFromFile` is called.
+     */
+    string accountsFile;
+
+    /**
+     * @brief The journal file chosen with `setJournalFilename`, or empty to keep the journal next to the chart.
+     */
+    string journalFile;
+
+    /**
+     * @brief The write-ahead log of every posting, deletion and added account since the last checkpoint.
+     *
+     * @details The journal has its own lock. It is mutable so that `exportText` can log the balances it writes.
+     */
+    mutable TransactionJournal journal;
+
+    /**
+     * @brief Tracks where the balances of the loaded chart are stored, so saves can overwrite them in place.
+     */
+    ChartFile chartFile;
+
+    /**
+     * @brief Tracks the binary snapshot the forest was loaded from, so saves can overwrite its balances in place.
+     *
+     * @details Its path is empty when the forest was built from a text chart.
+     */
+    ForestSnapshot snapshotFile;
+
+    /**
+     * @brief Account numbers whose balance changed since the chart file was last saved.
+     *
+     * @details Mutable because reads of lazy balances settle accounts, which changes their balances.
+     */
+    mutable unordered_set<int> dirtyAccounts;
+
+    /**
+     * @brief True if ancestor balances are brought up to date when read instead of on every posting.
+     */
+    bool lazyBalances;
+
+    /**
+     * @brief True if the date index of every node matches the transactions of its subtree.
+     *
+     * @details The indexes are built by the first point-in-time query and then kept up to date by every posting and
+     * deletion. Loading transactions invalidates them.
+     */
+    mutable bool dateIndexReady;
+
+    /**
+     * @brief The forest flattened in pre-order, with the transaction total of every subtree.
+     *
+     * @details Built by the first subtree query and rebuilt by the next one whenever accounts are added or loaded;
+     * postings and deletions keep its totals up to date. Guarded like the date indexes.
+     */
+    mutable EulerTour tour;
+
+    /**
+     * @brief True if `tour` matches the shape of the forest and the transactions of every account.
+     */
+    mutable bool tourReady;
+
+    /**
+     * @brief The prefix and keyword index of every account number and description.
+     *
+     * @details Built by the first search after a load and kept up to date by `addAccountUnlocked` and
+     * `renameAccount`. Guarded by the structure lock alone, as postings never touch numbers or descriptions.
+     */
+    mutable AccountSearchIndex searchIndex;
+
+    /**
+     * @brief True if `searchIndex` holds every account of the forest.
+     */
+    mutable bool searchReady;
+
+    /**
+     * @brief The last view returned by `view`, from which the next view is derived.
+     *
+     * @details Guarded by the dirty set lock. Kept only once a view was taken, so forests that are never viewed pay
+     * nothing for it.
+     */
+    mutable ForestView lastView;
+
+    /**
+     * @brief True if `lastView` matches the forest but for the accounts in `viewChanges`, so the next view only freezes
+     * those.
+     *
+     * @details Cleared whenever accounts or transactions are loaded, which rebuilds the next view from scratch.
+     */
+    mutable bool viewReady;
+
+    /**
+     * @brief Account numbers added, or whose balance, description or transactions changed, since `lastView` was taken.
+     *
+     * @details Guarded by the dirty set lock and only filled while `viewReady` is set.
+     */
+    mutable unordered_set<int> viewChanges;
+
     /**
      * @brief Cleans up the tree, deleting all nodes.
      *
      * @details This private helper method is responsible for deallocating memory and cleaning up the tree when the
-     * ForestTree object is destroyed or reset.
+     * ForestTree object is destroyed or reset. The nodes are released together with the arena, so no tree is walked.
      */
     void cleanupTree();
 
@@ -74,7 +270,11 @@ public:
      * @return void
      *
      * @details This method reads account data from the specified file and builds the forest tree structure accordingly.
-     * Each account in the file is parsed and added as a node in the tree.
+     * The file is read into memory with a single read and parsed in one pass. When the forest is empty the whole chart
+     * is built bottom-up at once by `bulkBuild`, otherwise every parsed account is inserted with `addAccount`.
+     * A binary snapshot written by `saveSnapshot` is detected by its header and loaded instead, with its transactions.
+     *
+     * @throws runtime_error If the journal has a gap in its sequence numbers; the journal is then left closed.
      */
     void buildFromFile(const string &filename);
 
@@ -95,15 +295,31 @@ public:
      * @brief Adds a transaction to an account.
      *
      * @param accountNumber The account number to which the transaction will be added.
-     * @param transaction The transaction to be added.
+     * @param transaction The transaction to be added; an empty ID is replaced by a new unique one.
      *
      * @return bool True if the transaction is successfully added, false otherwise.
      *
      * @details This method adds a transaction to the account specified by accountNumber. The transaction is appended
-     * to the list of transactions for the account.
+     * to the list of transactions for the account and a single record is appended to the transaction journal; with
+     * durable commits the call returns once that record is synced, see `setDurableCommits`.
      */
     bool addTransaction(int accountNumber, Transaction &transaction);
 
+    /**
+     * @brief Posts a batch of transactions with a single balance rollup and a single journal commit.
+     *
+     * @param postings The account numbers and transactions to post, in posting order; empty IDs are replaced by new
+     * unique ones.
+     *
+     * @return size_t The number of transactions that were posted.
+     *
+     * @details Every transaction is appended to its account and to the journal, but balances are not updated one
+     * posting at a time. The debits and credits are netted per account first, and the net deltas are then propagated
+     * up the hierarchy in one bottom-up pass, so each affected account is updated once per batch. Postings to unknown
+     * accounts are reported and skipped. The journal is committed once at the end.
+     */
+    size_t postBatch(const vector<pair<int, Transaction>> &postings);
+
     /**
      * @brief Deletes a transaction from an account.
      *
@@ -113,10 +329,37 @@ public:
      * @return bool True if the transaction is successfully deleted, false otherwise.
      *
      * @details This method removes a transaction from the account specified by accountNumber. The transaction is
-     * identified by its index in the list of transactions for the account.
+     * identified by its index in the list of transactions for the account. Its slot is marked as deleted, so no
+     * history is shifted; accounts are compacted once most of their slots are deleted. A tombstone for it is
+     * appended to the transaction journal.
      */
     bool deleteTransaction(int accountNumber, int transactionIndex);
 
+    /**
+     * @brief Deletes a transaction identified by its transaction ID.
+     *
+     * @param transactionID The ID of the transaction to delete.
+     *
+     * @return bool True if the transaction was found and deleted, false otherwise.
+     *
+     * @details The transaction is found through the transaction ID index in constant time, so reversals can be
+     * applied without scanning any history. Its slot is marked as deleted instead of being erased; see
+     * `deleteTransaction` for the balance update and the journal record. If several transactions share the ID, one
+     * of them is deleted.
+     */
+    bool deleteTransactionById(const string &transactionID);
+
+    /**
+     * @brief Finds a transaction by its transaction ID.
+     *
+     * @param transactionID The ID to search for.
+     * @param accountNumber Receives the number of the account holding the transaction.
+     * @param transaction Receives the transaction.
+     *
+     * @return bool True if a transaction with the ID exists, false otherwise.
+     */
+    bool findTransaction(const string &transactionID, int &accountNumber, Transaction &transaction) const;
+
     /**
      * @brief Prints a detailed report of an account to a file.
      *
@@ -147,11 +390,194 @@ public:
      *
      * @return NodePtr A pointer to the node containing the account if found, or nullptr if not found.
      *
-     * @details This method searches the forest tree for an account with the specified account number. If the account
-     * is found, the corresponding node is returned, otherwise, nullptr is returned.
+     * @details This method looks the account number up in the account index. If the account is found, the
+     * corresponding node is returned, otherwise, nullptr is returned.
      */
     NodePtr findAccount(int accountNumber) const;
 
+    /**
+     * @brief Finds the accounts whose number starts with some digits, such as every account starting with 41.
+     *
+     * @param prefix The leading digits.
+     *
+     * @return vector<int> The matching account numbers in chart order, or none if the prefix is not positive.
+     *
+     * @details Answered from `AccountSearchIndex` with one binary search per number length, without walking the
+     * forest. The first search after a load builds the index.
+     */
+    vector<int> findAccountsByPrefix(int prefix) const;
+
+    /**
+     * @brief Finds the accounts whose description holds every keyword of a query.
+     *
+     * @param query The keywords, such as `payroll` or `accrued tax`.
+     *
+     * @return vector<int> The matching account numbers in chart order.
+     *
+     * @details Descriptions and queries are split into words of letters and digits and compared without case; a
+     * keyword matches every word it starts, so `pay` finds `Payroll`. Answered from the inverted word index of
+     * `AccountSearchIndex`, without walking the forest.
+     */
+    vector<int> findAccountsByKeywords(const string &query) const;
+
+    /**
+     * @brief Changes the description of an account.
+     *
+     * @param accountNumber The account number.
+     * @param description The new description.
+     *
+     * @return bool True if the account exists and the description has no line break, false otherwise.
+     *
+     * @details The search index is updated in place. Descriptions are not saved in place, so the next
+     * `saveToFile` rewrites the whole chart or snapshot.
+     */
+    bool renameAccount(int accountNumber, const string &description);
+
+    /**
+     * @brief Reads an account while no posting can change it.
+     *
+     * @param accountNumber The account number to read.
+     * @param reader The function called with the account.
+     *
+     * @return bool True if the account exists and was read, false otherwise.
+     *
+     * @details The reader runs under the shared lock of the account's root tree, so it sees every balance of the tree
+     * either before or after any concurrent posting, never in between. It must not call back into the forest.
+     */
+    bool readAccount(int accountNumber, const function<void(const Account &)> &reader) const;
+
+    /**
+     * @brief Enables or disables lazy aggregated balances.
+     *
+     * @param enabled True to defer ancestor balance updates until they are read, false to update them on every posting.
+     *
+     * @return void
+     *
+     * @details By default every posting adds its amount to the balance of each ancestor. With lazy balances a posting
+     * only changes its own account and flags the path to the root as out of date, stopping at the first ancestor that
+     * is already flagged. Accounts are settled, visiting only out-of-date subtrees, when they are read through
+     * `findAccount`, `readAccount`, `printDetailedReport` or `printForestTree`, and before any save.
+     */
+    void setLazyBalances(bool enabled);
+
+    /**
+     * @brief Checks whether ancestor balances are updated lazily.
+     *
+     * @return bool True if lazy balances are enabled, false otherwise.
+     */
+    bool isLazyBalances() const;
+
+    /**
+     * @brief Returns the balance an account and its subtree had at the end of a date.
+     *
+     * @param accountNumber The account number.
+     * @param date The date, as `YYYY-MM-DD`, `DD-MM-YYYY` or `DD-MM-YY`.
+     *
+     * @return Money The current balance of the account minus every change posted to it or below it after the date.
+     *
+     * @throws invalid_argument If the date cannot be read or the account does not exist.
+     *
+     * @details Answered in logarithmic time from the date index of the account, a balanced search tree over the
+     * distinct dates of its subtree's transactions; see `DateBalanceIndex`. The first query builds every index, later
+     * postings and deletions keep them up to date in logarithmic time per ancestor, backdated ones included.
+     * Transactions without a readable date count as dated before any date.
+     */
+    Money balanceAsOf(int accountNumber, const string &date) const;
+
+    /**
+     * @brief Returns the net change of an account and its subtree between two dates.
+     *
+     * @param accountNumber The account number.
+     * @param fromDate The first date included.
+     * @param toDate The last date included.
+     *
+     * @return Money The debits minus the credits dated within the range, or zero if the range is empty.
+     *
+     * @throws invalid_argument If a date cannot be read or the account does not exist.
+     */
+    Money netChange(int accountNumber, const string &fromDate, const string &toDate) const;
+
+    /**
+     * @brief Checks whether an account lies in the subtree of another.
+     *
+     * @param ancestorNumber The account number of the subtree root.
+     * @param accountNumber The account number to check.
+     *
+     * @return bool True if both accounts exist and the second is the first or one of its descendants.
+     *
+     * @details Answered in constant time from the Euler tour of the forest, where every subtree is a contiguous range
+     * of a pre-order array; see `EulerTour`. The first subtree query after accounts are added or loaded rebuilds the
+     * tour in linear time, so a burst of insertions costs a single rebuild.
+     */
+    bool isInSubtree(int ancestorNumber, int accountNumber) const;
+
+    /**
+     * @brief Returns the number of accounts in the subtree of an account.
+     *
+     * @param accountNumber The account number of the subtree root.
+     *
+     * @return size_t The number of accounts, the root included, or 0 if the account does not exist.
+     */
+    size_t subtreeSize(int accountNumber) const;
+
+    /**
+     * @brief Reads every account of a subtree, parents first.
+     *
+     * @param accountNumber The account number of the subtree root.
+     * @param reader The function called with each account and its depth below the subtree root.
+     *
+     * @return bool True if the account exists and its subtree was read, false otherwise.
+     *
+     * @details The subtree is read as one contiguous range of the Euler tour, under the shared lock of its root tree
+     * as in `readAccount`. The reader must not call back into the forest.
+     */
+    bool readSubtree(int accountNumber, const function<void(const Account &, size_t)> &reader) const;
+
+    /**
+     * @brief Takes an immutable view of the whole forest, for reports that run while postings go on.
+     *
+     * @return The view, consistent across all trees and safe to read from any thread without a lock
+     *
+     * @details Every tree is locked only while the view is derived from the previous one: accounts changed or added
+     * since that view are frozen, all others are shared, so the cost follows the number of changed and added accounts
+     * and the depth of the forest. The first view after accounts were loaded freezes every account. A frozen account
+     * copies only its number, description and balance and shares its transaction history with the live account, so
+     * the last view, which the forest keeps, costs little memory beyond one small record per account. A report on one
+     * account does not need a view; see `printDetailedReport`.
+     */
+    ForestView view() const;
+
+    /**
+     * @brief Returns the net amount of every transaction posted to an account or below it.
+     *
+     * @param accountNumber The account number of the subtree root.
+     *
+     * @return Money The debits minus the credits of the subtree.
+     *
+     * @throws invalid_argument If the account does not exist.
+     *
+     * @details Answered in logarithmic time as a range sum of the Fenwick tree the Euler tour keeps over the own
+     * transaction totals of the accounts. Unlike the balance, it leaves out opening balances.
+     */
+    Money subtreeTransactionTotal(int accountNumber) const;
+
+    /**
+     * @brief Rebuilds every balance from the transaction history and reports the accounts that disagree.
+     *
+     * @param apply True to replace every disagreeing balance by the rebuilt one, false to only report them.
+     *
+     * @return vector<BalanceMismatch> The disagreeing accounts, in the order of their root trees and then children
+     * before parents.
+     *
+     * @details The balance of an account is rebuilt as the net amount of its own transactions plus the rebuilt
+     * balances of its children, in one children-first pass over each root tree, with the root trees on separate
+     * threads for large charts. Own transactions are summed by `TransactionColumns::netAmount`, a branch-free loop
+     * over the contiguous amount column, so the check is cheap enough to run at every start. Balances that are not
+     * backed by transactions, such as opening balances entered with an account, are reported too. Applied balances
+     * are written by the next `saveToFile`.
+     */
+    vector<BalanceMismatch> recomputeAllBalances(bool apply = false);
+
     /**
      * @brief Saves the forest tree structure to a file.
      *
@@ -159,10 +585,45 @@ public:
      *
      * @return void
      *
-     * @details This method saves the entire forest tree structure to a file. Each node in the tree is written to the
-     * file, preserving the hierarchy of accounts.
+     * @details Only the balances of the accounts changed since the last save are written. When the file is the loaded
+     * chart and every changed balance fits its fixed-width field, those fields are overwritten in place; otherwise the
+     * whole file is rewritten with fixed-width balances and atomically replaced. Balances of a loaded binary snapshot
+     * are overwritten in place too, and any other snapshot file is replaced by `saveSnapshot`. The balances are
+     * logged to the journal and synced first, so a crash in the middle of an in-place save is repaired on the next
+     * load; in-place writes and replaced files are synced too.
+     */
+    void saveToFile(const string &filename);
+
+    /**
+     * @brief Saves the forest and all its transactions as a binary snapshot.
+     *
+     * @param filename The name of the snapshot file.
+     *
+     * @return void
+     *
+     * @throws runtime_error If the snapshot cannot be written.
+     *
+     * @details The file holds a versioned header, the accounts in pre-order with the indices of their parent, first
+     * child and next sibling, the packed transactions and a string pool; see `ForestSnapshot`. It can be loaded with
+     * `buildFromFile` without parsing any text. Saving over the file the forest was loaded from stamps the snapshot
+     * with the sequence number of the last journal record and checkpoints the journal, since the snapshot then holds
+     * every change.
      */
-    void saveToFile(const string &filename) const;
+    void saveSnapshot(const string &filename);
+
+    /**
+     * @brief Exports the forest as a text chart and its transactions file.
+     *
+     * @param filename The name of the chart file to write.
+     *
+     * @return void
+     *
+     * @throws runtime_error If either file cannot be written.
+     *
+     * @details The chart lists every account in pre-order with a fixed-width balance, and the transactions are saved
+     * next to it with `saveTransactions`, so a snapshot can be turned back into the text formats.
+     */
+    void exportText(const string &filename) const;
 
     /**
      * @brief Saves all transactions to a file.
@@ -172,7 +633,8 @@ public:
      * @return void
      *
      * @details This method saves all transactions from all accounts in the forest tree to a file. Each transaction
-     * is saved with relevant details, such as transaction ID, amount, date, and description.
+     * is saved with relevant details, such as transaction ID, amount, date, and description. Every root tree is
+     * serialized on its own thread and the results are written in root order.
      */
     void saveTransactions(const string &filename) const;
 
@@ -184,7 +646,8 @@ public:
      * @return void
      *
      * @details This method reads transaction data from the specified file and adds each transaction to the corresponding
-     * account in the forest tree.
+     * account in the forest tree. Large files are parsed in chunks of whole lines on several threads, and the parsed
+     * transactions are then appended one root tree per thread, in file order.
      */
     void loadTransactions(const string &filename);
 
@@ -201,29 +664,356 @@ public:
      */
     string getTransactionFilename(const string &accountsFile) const;
 
+    /**
+     * @brief Generates the transaction journal filename based on the provided accounts file name.
+     *
+     * @param accountsFile The name of the accounts file.
+     *
+     * @return string The journal file name, which appends "_transactions.journal" to the accounts file name, or the
+     * file chosen with `setJournalFilename`.
+     */
+    string getJournalFilename(const string &accountsFile) const;
+
+    /**
+     * @brief Chooses the journal file used by later loads instead of the one next to the chart.
+     *
+     * @param filename The journal file, or an empty string to keep it next to the chart again.
+     *
+     * @return void
+     *
+     * @details The journal is replayed from and opened on this file by the next `buildFromFile`.
+     */
+    void setJournalFilename(const string &filename);
+
+    /**
+     * @brief Writes and syncs every journal record that is still pending.
+     *
+     * @return void
+     *
+     * @throws runtime_error If the journal cannot be flushed.
+     */
+    void flushJournal();
+
+    /**
+     * @brief Sets whether every change waits until its journal record is on stable storage.
+     *
+     * @param enabled True, the default, to sync the journal on every commit; false to write records in groups and
+     * sync them only on `flushJournal`, saves and compaction.
+     *
+     * @return void
+     *
+     * @details Durable commits from concurrent threads are grouped: one thread writes and syncs the records of all of
+     * them at once.
+     */
+    void setDurableCommits(bool enabled);
+
+    /**
+     * @brief Checks whether every change waits until its journal record is on stable storage.
+     *
+     * @return bool True if commits are durable, false otherwise.
+     */
+    bool isDurableCommits() const;
+
+    /**
+     * @brief Sets whether changes hand their journal records to a background writer thread instead of waiting.
+     *
+     * @param enabled True to return from every change as soon as it is applied in memory; false, the default, to
+     * commit as chosen with `setDurableCommits`.
+     *
+     * @return void
+     *
+     * @throws runtime_error If the records journaled so far cannot be written.
+     *
+     * @details The writer thread takes the records from a lock-free queue, so a posting never waits for the disk, and
+     * writes and syncs everything queued at once. The files keep their formats; `flushJournal` and `whenDurable`
+     * confirm durability, and saves and compaction wait for the writer first.
+     */
+    void setAsyncCommits(bool enabled);
+
+    /**
+     * @brief Checks whether changes hand their journal records to a background writer thread.
+     *
+     * @return bool True if commits are asynchronous, false otherwise.
+     */
+    bool isAsyncCommits() const;
+
+    /**
+     * @brief Returns a future that is ready once every change made so far is on stable storage.
+     *
+     * @return future<void> The future, which holds a runtime_error if a journal record could not be written.
+     *
+     * @details Without durable or asynchronous commits, the records are only synced by `flushJournal`, saves and
+     * compaction.
+     */
+    future<void> whenDurable() const;
+
+    /**
+     * @brief Folds the journal into the transactions snapshot.
+     *
+     * @return void
+     *
+     * @throws runtime_error If the snapshot cannot be written or the journal cannot be truncated.
+     *
+     * @details Rewrites the transactions file of the loaded chart with `saveTransactions`, stamped with the sequence
+     * number of the last journal record, and then replaces the journal with a checkpoint that keeps the balances not
+     * saved yet. This is the only operation that rewrites the whole transaction history.
+     */
+    void compactJournal();
+
     /**
      * @brief Adds a new account to both the tree structure and the file.
      *
      * @param accountNumber The account number
      * @param description The account description
      * @param balance The initial balance
+     * @param path The chart file that receives the new account
      * @return bool Returns true if the account was successfully added, false otherwise
+     *
+     * @details The account is journaled before the chart is rewritten, so a crash in between adds it again on the
+     * next `buildFromFile`.
      */
-    bool addAccountWithFile(int accountNumber, const string &description, double balance, string path);
+    bool addAccountWithFile(int accountNumber, const string &description, Money balance, string path);
+
+    /**
+     * @brief Returns the account numbers of the root accounts.
+     *
+     * @return vector<int> The root account numbers, in forest order.
+     */
+    vector<int> getRootAccountNumbers() const;
+
+    /**
+     * @brief Runs a number of independent tasks on a pool of threads.
+     *
+     * @param taskCount The number of tasks; task i is called with i.
+     * @param maxThreads The largest number of threads to use, the calling thread included.
+     * @param task The task to run.
+     *
+     * @return void
+     *
+     * @throws exception The first exception thrown by a task, once every task has finished.
+     */
+    static void runParallel(size_t taskCount, size_t maxThreads, const function<void(size_t)> &task);
 
 private:
     /**
-     * @brief Helper function to recursively print tree nodes.
+     * @brief Finds an account by its account number without taking any lock.
+     *
+     * @param accountNumber The account number to search for.
+     *
+     * @return NodePtr A pointer to the node containing the account if found, or nullptr if not found.
+     *
+     * @details Used by every method that already holds the structure lock, since the locks are not recursive.
+     */
+    NodePtr lookup(int accountNumber) const;
+
+    /**
+     * @brief Returns the lock guarding the tree an account belongs to.
+     *
+     * @param accountNumber The account number.
+     *
+     * @return shared_mutex& The lock of the root tree named by the leading digit of the account number.
+     */
+    shared_mutex &rootLock(int accountNumber) const;
+
+    /**
+     * @brief Returns the root tree an account belongs to.
+     *
+     * @param accountNumber The account number.
+     *
+     * @return size_t The leading digit of the account number, or 0 for numbers below 1.
+     */
+    static size_t rootDigit(int accountNumber);
+
+    /**
+     * @brief Locks every root tree for reading.
+     *
+     * @return vector<shared_lock<shared_mutex>> The held locks, taken in ascending digit order.
+     */
+    vector<shared_lock<shared_mutex>> lockAllRoots() const;
+
+    /**
+     * @brief Locks every root tree for reading, settling every balance first when balances are lazy.
+     *
+     * @param shared Receives the shared locks of the trees when balances are eager.
+     * @param exclusive Receives the exclusive locks of the trees when balances are lazy.
+     *
+     * @return void
+     */
+    void lockAllForRead(vector<shared_lock<shared_mutex>> &shared, vector<unique_lock<shared_mutex>> &exclusive) const;
+
+    /**
+     * @brief Locks the tree of an account for reading.
+     *
+     * @param accountNumber The account number about to be read.
+     * @param shared Receives the shared lock of the tree when balances are eager.
+     * @param exclusive Receives the exclusive lock of the tree when balances are lazy; the account is settled.
+     *
+     * @return void
+     */
+    void lockForRead(int accountNumber, shared_lock<shared_mutex> &shared, unique_lock<shared_mutex> &exclusive) const;
+
+    /**
+     * @brief Applies the balance change of a posting to an account and its ancestors, or defers it in lazy mode.
      *
-     * @param node The current node to print.
-     * @param level The current level of the tree.
+     * @param node The posted account.
+     * @param delta The signed balance change.
      *
      * @return void
+     */
+    void applyDelta(NodePtr node, Money delta);
+
+    /**
+     * @brief Brings the balance of an account up to date with the postings below it.
+     *
+     * @param node The account to settle; the caller holds its tree's lock exclusively.
      *
-     * @details This private helper method is used to recursively print the nodes of the tree, starting from the
-     * given node. It prints the structure of the tree, showing each node's account number and level in the hierarchy.
+     * @return void
      */
-    void printTreeHelper(NodePtr node, int level) const;
+    void settleNode(NodePtr node) const;
+
+    /**
+     * @brief Brings every balance of the forest up to date; does nothing when balances are eager.
+     *
+     * @return void
+     */
+    void settleAllBalances() const;
+
+    /**
+     * @brief Converts a date given to a point-in-time query.
+     *
+     * @param date The date text.
+     *
+     * @return int32_t The date as `yyyymmdd`.
+     *
+     * @throws invalid_argument If the text is not a date.
+     */
+    static int32_t parseDateArgument(const string &date);
+
+    /**
+     * @brief Takes the structure lock shared, building the date indexes first if they are not up to date.
+     *
+     * @return shared_lock<shared_mutex> The held structure lock.
+     */
+    shared_lock<shared_mutex> lockWithDateIndex() const;
+
+    /**
+     * @brief Takes the structure lock shared, rebuilding the Euler tour first if it is not up to date.
+     *
+     * @return shared_lock<shared_mutex> The held structure lock.
+     */
+    shared_lock<shared_mutex> lockWithTour() const;
+
+    /**
+     * @brief Takes the structure lock shared, building the search index first if it is not up to date.
+     *
+     * @return shared_lock<shared_mutex> The held structure lock.
+     */
+    shared_lock<shared_mutex> lockWithSearchIndex() const;
+
+    /**
+     * @brief Takes the structure lock shared, preparing a lazily built structure first if it is not ready.
+     *
+     * @param ready The flag telling whether the structure is ready, set once it is prepared.
+     * @param prepare Builds the structure; called with the structure lock held exclusively.
+     *
+     * @return shared_lock<shared_mutex> The held structure lock.
+     */
+    shared_lock<shared_mutex> lockPrepared(bool &ready, const function<void()> &prepare) const;
+
+    /**
+     * @brief Builds the date index of every account from the transactions of its subtree, one root tree per worker.
+     *
+     * @return void
+     */
+    void buildDateIndex() const;
+
+    /**
+     * @brief Records a dated balance change in the date indexes of an account and its ancestors, once they are built.
+     *
+     * @details Also updates the subtree totals of the Euler tour, once it is built.
+     *
+     * @param node The posted account.
+     * @param date The date of the transaction.
+     * @param delta The signed balance change.
+     *
+     * @return void
+     */
+    void indexPosting(NodePtr node, const string &date, Money delta);
+
+    /**
+     * @brief Removes the transaction in a slot of an account and reverses its effect on the balances.
+     *
+     * @param accountNode The account holding the transaction; the caller holds its tree's lock exclusively.
+     * @param slot The slot of the transaction.
+     * @param sequence Receives the sequence number of the journal record, to commit once the locks are released.
+     *
+     * @return bool True if the transaction was deleted, false if an error occurred.
+     */
+    bool removeTransactionAt(NodePtr accountNode, size_t slot, uint64_t &sequence);
+
+    /**
+     * @brief Adds the most recently appended transaction of an account to the ID index.
+     *
+     * @param accountNode The account; the caller holds its tree's lock exclusively.
+     *
+     * @return void
+     */
+    void indexLastTransaction(NodePtr accountNode);
+
+    /**
+     * @brief Drops the deleted slots of an account and moves its ID index entries to the new slots.
+     *
+     * @param accountNode The account; the caller holds its tree's lock exclusively.
+     *
+     * @return void
+     */
+    void compactTransactions(NodePtr accountNode);
+
+    /**
+     * @brief Compacts every account and rebuilds the ID index of every root tree, one tree per worker.
+     *
+     * @return void
+     */
+    void indexAllTransactions();
+
+    /**
+     * @brief Adds a new account to the tree structure; the caller holds the structure lock exclusively.
+     *
+     * @param newAccount The account to be added.
+     * @param parentNumber The account number of the parent account.
+     *
+     * @return bool True if the account is successfully added, false otherwise.
+     */
+    bool addAccountUnlocked(const Account &newAccount, int parentNumber);
+
+    /**
+     * @brief Saves the forest as a binary snapshot; the caller holds the structure lock exclusively.
+     *
+     * @param filename The name of the snapshot file.
+     *
+     * @return void
+     *
+     * @throws runtime_error If the snapshot cannot be written.
+     */
+    void saveSnapshotUnlocked(const string &filename);
+
+    /**
+     * @brief Saves all transactions to a file; the caller holds the structure lock exclusively.
+     *
+     * @param filename The name of the file to save the transactions.
+     *
+     * @return void
+     */
+    void saveTransactionsUnlocked(const string &filename) const;
+
+    /**
+     * @brief Loads transactions from a file; the caller holds the structure lock exclusively.
+     *
+     * @param filename The name of the file to load the transactions from.
+     *
+     * @return uint64_t The journal checkpoint stamped at the top of the file, 0 if it has none.
+     */
+    uint64_t loadTransactionsUnlocked(const string &filename);
 
     /**
      * @brief Finds the root node for an account based on the first digit of the account number.
@@ -238,6 +1028,158 @@ private:
      * grouped together in the forest structure.
      */
     NodePtr findRootForAccount(int accountNumber) const;
+
+    /**
+     * @brief Replays a transaction journal on top of the loaded data files.
+     *
+     * @param filename The name of the journal file.
+     * @param checkpoint The last record whose transactions the loaded data files already hold.
+     * @param balanceCheckpoint The last record whose balances the loaded data files already hold.
+     * @param recovered Receives the accounts the replay had to add again.
+     *
+     * @return uint64_t The sequence number of the last record, or `checkpoint` if it is larger.
+     *
+     * @details Transactions of records after `checkpoint` are applied again: postings are appended to their account
+     * and tombstones remove the transaction at the recorded index if its ID still matches. Balance records, logged by
+     * every save before it writes balances, set the balances they list; the balance changes of the records after the
+     * last of them are applied on top. Records of unknown accounts and malformed lines are skipped, a record torn by a
+     * crash is cut from the file, and a missing journal is not an error.
+     *
+     * @throws runtime_error If a sequence number is missing or repeated, before any record is applied.
+     */
+    uint64_t replayJournal(const string &filename, uint64_t checkpoint, uint64_t balanceCheckpoint,
+                           vector<int> &recovered);
+
+    /**
+     * @brief Makes a chart the source of the forest and opens its transaction journal.
+     *
+     * @param filename The chart file or snapshot the forest was built from.
+     * @param sequence The sequence number of the last record of the journal or the data files.
+     *
+     * @return void
+     */
+    void openJournal(const string &filename, uint64_t sequence);
+
+    /**
+     * @brief Waits until a journal record is durable, reporting a failure instead of throwing it.
+     *
+     * @param sequence The sequence number of the record, 0 for none.
+     *
+     * @return void
+     */
+    void commitJournal(uint64_t sequence);
+
+    /**
+     * @brief Logs and syncs the balances of the accounts changed since the last save, before a save writes them.
+     *
+     * @return void
+     *
+     * @throws runtime_error If the journal cannot be written; the save must not go on then.
+     */
+    void journalBalances() const;
+
+    /**
+     * @brief Inserts the line of an account into a chart file, after its parent and siblings with smaller numbers.
+     *
+     * @param path The chart file.
+     * @param accountNumber The account number.
+     * @param description The account description.
+     * @param balance The balance written on the new line.
+     *
+     * @return bool True if the chart was rewritten, false if it could not be read or written.
+     */
+    bool insertChartLine(const string &path, int accountNumber, const string &description, Money balance);
+
+    /**
+     * @brief Builds the forest from a binary snapshot.
+     *
+     * @param filename The name of the snapshot file.
+     * @param buffer The contents of the snapshot file.
+     * @param checkpoint Receives the last journal record the snapshot holds, 0 if none.
+     *
+     * @return bool True if the snapshot was loaded, false if it is invalid.
+     *
+     * @details An empty forest is linked directly from the child and sibling indices of the snapshot, otherwise the
+     * accounts are merged in with `addAccount`. Invalid snapshots are reported and leave the forest unchanged.
+     */
+    bool loadSnapshot(const string &filename, const string &buffer, uint64_t &checkpoint);
+
+    /**
+     * @brief Collects the current balance of every account changed since the last save.
+     *
+     * @return vector<pair<int, Money>> The account numbers and balances of the changed accounts.
+     */
+    vector<pair<int, Money>> dirtyBalances() const;
+
+    /**
+     * @brief Marks an account and all its ancestors as changed since the last save.
+     *
+     * @param node The node whose balance changed.
+     *
+     * @return void
+     */
+    void markDirty(NodePtr node);
+
+    /**
+     * @brief Records that the balance, description or transactions of an account changed; the caller holds the dirty
+     * set lock.
+     *
+     * @param accountNumber The account number
+     *
+     * @details The account is marked for the next save and, once a view was taken, for the next view.
+     */
+    void recordChange(int accountNumber) const;
+
+    /**
+     * @brief Records that an account was added; the caller holds the structure lock exclusively.
+     *
+     * @param accountNumber The account number
+     *
+     * @details Once a view was taken, the account is frozen into the next view like a changed one, instead of
+     * rebuilding that view.
+     */
+    void recordAddition(int accountNumber);
+
+    /**
+     * @brief Applies net balance deltas to their accounts and all their ancestors in one bottom-up pass.
+     *
+     * @param deltas The net balance change of each posted node.
+     *
+     * @return void
+     *
+     * @details Nodes are processed level by level from the deepest one up. Each node adds its pending delta to its own
+     * balance and passes it on to its parent, so an ancestor shared by many posted accounts is updated only once.
+     */
+    void rollupDeltas(const unordered_map<NodePtr, Money> &deltas);
+
+    /**
+     * @brief Rewrites a chart file with the current balances and forgets all pending changes.
+     *
+     * @param filename The chart file to write.
+     * @param buffer The lines of the chart, separated by line breaks.
+     *
+     * @return void
+     *
+     * @throws runtime_error If the file cannot be written.
+     */
+    void rewriteChartFile(const string &filename, const string &buffer);
+
+    /**
+     * @brief Builds an empty forest from parsed chart records, one root tree per worker.
+     *
+     * @param records The parsed records.
+     *
+     * @return void
+     *
+     * @details The records are split by leading digit, since an account and its parent always share it, and each root
+     * tree is built on its own thread into its own arena and index, which are merged afterwards. Within a tree the
+     * records are sorted by depth and then by account number, so every parent comes before its children and the
+     * children of one parent are adjacent and already in sibling order. Each node is then linked to its parent and
+     * appended after the previous sibling, which makes the build linear after the sort. Duplicate account numbers keep
+     * the first occurrence in the file and accounts whose parent is missing are skipped, as `addAccount` would do.
+     * The descriptions are moved out of the records into the accounts.
+     */
+    void bulkBuild(vector<ChartRecord> &records);
 };
 
 #endif // FORESTTREE_H
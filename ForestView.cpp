@@ -0,0 +1,274 @@
+//
+// Created on 10/14/2026.
+//
+
+/**
+ * @file ForestView.cpp
+ * @brief Implements `ForestView`, the immutable and structurally shared views of the forest.
+ */
+
+#include "ForestView.h"
+
+using namespace std;
+
+/**
+ * @brief Default constructor for the `ForestView` class.
+ *
+ * The empty view still owns a root list, so no reader has to check for null.
+ */
+ForestView::ForestView() : roots(make_shared<const Roots>()), sequence(0) {}
+
+/**
+ * @brief Freezes every account of a forest into a new view.
+ *
+ * Every tree is frozen bottom-up, and the account number map is built from all nodes at once, so no map node is
+ * copied.
+ *
+ * @param roots The root nodes of the forest
+ * @param sequence The sequence number of the last journal record the forest holds
+ * @return The view
+ */
+ForestView ForestView::build(const vector<NodePtr> &roots, uint64_t sequence) {
+    vector<pair<int, shared_ptr<const Frozen>>> frozen;
+    shared_ptr<Roots> frozenRoots = make_shared<Roots>();
+    frozenRoots->reserve(roots.size());
+    for (NodePtr root: roots) {
+        frozenRoots->push_back(freeze(root, frozen));
+    }
+
+    ForestView view;
+    view.nodes = PersistentMap<shared_ptr<const Frozen>>::fromEntries(move(frozen));
+    view.roots = frozenRoots;
+    view.sequence = sequence;
+    return view;
+}
+
+/**
+ * @brief Freezes a single account into a view of its own.
+ *
+ * @param account The account
+ * @param sequence The sequence number of the last journal record the forest holds
+ * @return The view
+ */
+ForestView ForestView::of(const Account &account, uint64_t sequence) {
+    shared_ptr<Frozen> node = make_shared<Frozen>();
+    node->account = make_shared<const Account>(account.snapshot());
+
+    ForestView view;
+    view.nodes = view.nodes.set(account.getAccountNumber(), node);
+    view.roots = make_shared<const Roots>(1, node);
+    view.sequence = sequence;
+    return view;
+}
+
+/**
+ * @brief Derives a view in which some accounts are frozen again or added and all others are shared with this one.
+ *
+ * The changed nodes and their ancestors are marked, and the trees are copied from the roots down along the marked
+ * nodes only; see `refresh`. The copied nodes then replace their entries in the account number map.
+ *
+ * @param roots The root nodes of the forest
+ * @param changed The nodes added, or whose account changed, since this view was taken
+ * @param sequence The sequence number of the last journal record the forest holds
+ * @return The new view
+ */
+ForestView ForestView::update(const vector<NodePtr> &roots, const vector<NodePtr> &changed, uint64_t sequence) const {
+    ForestView view = *this;
+    view.sequence = sequence;
+    if (changed.empty()) {
+        return view;
+    }
+
+    unordered_set<NodePtr> changedSet(changed.begin(), changed.end());
+    unordered_set<NodePtr> marked;
+    for (NodePtr node: changed) {
+        // An ancestor already marked has all of its own ancestors marked too
+        for (; node != nullptr && marked.insert(node).second; node = node->getParent()) {
+        }
+    }
+
+    vector<pair<int, shared_ptr<const Frozen>>> frozen;
+    shared_ptr<Roots> newRoots = make_shared<Roots>();
+    newRoots->reserve(roots.size());
+    size_t next = 0;
+    for (NodePtr root: roots) {
+        shared_ptr<const Frozen> old;
+        if (next < this->roots->size() &&
+            (*this->roots)[next]->account->getAccountNumber() == root->getData().getAccountNumber()) {
+            old = (*this->roots)[next++];
+        }
+        newRoots->push_back(refresh(root, old, marked, changedSet, frozen));
+    }
+    for (pair<int, shared_ptr<const Frozen>> &entry: frozen) {
+        view.nodes = view.nodes.set(entry.first, move(entry.second));
+    }
+    view.roots = newRoots;
+    return view;
+}
+
+/**
+ * @brief Returns the number of accounts in the view.
+ *
+ * @return The number of accounts
+ */
+size_t ForestView::size() const {
+    return nodes.size();
+}
+
+/**
+ * @brief Returns the sequence number of the last journal record reflected in the view.
+ *
+ * @return The sequence number
+ */
+uint64_t ForestView::getSequence() const {
+    return sequence;
+}
+
+/**
+ * @brief Finds an account of the view.
+ *
+ * @param accountNumber The account number
+ * @return The frozen account, or nullptr if it is not in the view
+ */
+const Account *ForestView::findAccount(int accountNumber) const {
+    const shared_ptr<const Frozen> *node = nodes.find(accountNumber);
+    return node ? (*node)->account.get() : nullptr;
+}
+
+/**
+ * @brief Calls a reader with an account of the view.
+ *
+ * @param accountNumber The account number
+ * @param reader Called with the account
+ * @return True if the account is in the view, false otherwise
+ */
+bool ForestView::readAccount(int accountNumber, const function<void(const Account &)> &reader) const {
+    const Account *account = findAccount(accountNumber);
+    if (!account) {
+        return false;
+    }
+    reader(*account);
+    return true;
+}
+
+/**
+ * @brief Calls a reader with every account of a subtree, parents first.
+ *
+ * @param accountNumber The account number of the subtree root
+ * @param reader Called with every account and its depth below the subtree root
+ * @return True if the account is in the view, false otherwise
+ */
+bool ForestView::readSubtree(int accountNumber, const function<void(const Account &, size_t)> &reader) const {
+    const shared_ptr<const Frozen> *node = nodes.find(accountNumber);
+    if (!node) {
+        return false;
+    }
+    walk(**node, reader);
+    return true;
+}
+
+/**
+ * @brief Calls a reader with every account of the view in pre-order.
+ *
+ * @param reader Called with every account and its depth below its root
+ */
+void ForestView::forEach(const function<void(const Account &, size_t)> &reader) const {
+    for (const shared_ptr<const Frozen> &root: *roots) {
+        walk(*root, reader);
+    }
+}
+
+/**
+ * @brief Returns the account numbers of the root accounts.
+ *
+ * @return The root account numbers, in forest order
+ */
+vector<int> ForestView::getRootAccountNumbers() const {
+    vector<int> numbers;
+    numbers.reserve(roots->size());
+    for (const shared_ptr<const Frozen> &root: *roots) {
+        numbers.push_back(root->account->getAccountNumber());
+    }
+    return numbers;
+}
+
+/**
+ * @brief Freezes a subtree of the forest that has no counterpart in the view yet.
+ *
+ * The recursion goes as deep as the subtree, which is bounded by the digits of an account code.
+ *
+ * @param node The subtree root
+ * @param frozen Receives every frozen node by account number
+ * @return The frozen subtree root
+ */
+shared_ptr<const ForestView::Frozen> ForestView::freeze(NodePtr node,
+                                                        vector<pair<int, shared_ptr<const Frozen>>> &frozen) {
+    shared_ptr<Frozen> copy = make_shared<Frozen>();
+    copy->account = make_shared<const Account>(node->getData().snapshot());
+    for (NodePtr child = node->getLeftChild(); child != nullptr; child = child->getRightSibling()) {
+        copy->children.push_back(freeze(child, frozen));
+    }
+    frozen.push_back(make_pair(node->getData().getAccountNumber(), copy));
+    return copy;
+}
+
+/**
+ * @brief Derives a subtree in which the marked nodes are copied and all others are shared with the old one.
+ *
+ * Children only ever get siblings, never lose them, so the old children are matched to the children in the forest in
+ * one pass by account number; a child without a match is new and frozen whole.
+ *
+ * @param node The subtree root in the forest
+ * @param old The subtree root in this view, or null if the account is new
+ * @param marked The changed nodes and all their ancestors
+ * @param changed The changed nodes
+ * @param frozen Receives every new frozen node by account number
+ * @return The frozen subtree root
+ */
+shared_ptr<const ForestView::Frozen> ForestView::refresh(NodePtr node, const shared_ptr<const Frozen> &old,
+                                                         const unordered_set<NodePtr> &marked,
+                                                         const unordered_set<NodePtr> &changed,
+                                                         vector<pair<int, shared_ptr<const Frozen>>> &frozen) {
+    if (!old) {
+        return freeze(node, frozen);
+    }
+    if (!marked.count(node)) {
+        return old;
+    }
+
+    shared_ptr<Frozen> copy = make_shared<Frozen>();
+    copy->account = changed.count(node) ? make_shared<const Account>(node->getData().snapshot()) : old->account;
+    size_t next = 0;
+    for (NodePtr child = node->getLeftChild(); child != nullptr; child = child->getRightSibling()) {
+        shared_ptr<const Frozen> previous;
+        if (next < old->children.size() &&
+            old->children[next]->account->getAccountNumber() == child->getData().getAccountNumber()) {
+            previous = old->children[next++];
+        }
+        copy->children.push_back(refresh(child, previous, marked, changed, frozen));
+    }
+    frozen.push_back(make_pair(node->getData().getAccountNumber(), copy));
+    return copy;
+}
+
+/**
+ * @brief Calls a reader with every account of a subtree, parents first.
+ *
+ * The subtree is walked with a stack of the nodes still to read rather than by recursion, like `PreOrderIterator`.
+ *
+ * @param root The subtree root
+ * @param reader Called with every account and its depth below the subtree root
+ */
+void ForestView::walk(const Frozen &root, const function<void(const Account &, size_t)> &reader) {
+    vector<pair<const Frozen *, size_t>> pending(1, make_pair(&root, size_t(0)));
+    while (!pending.empty()) {
+        pair<const Frozen *, size_t> next = pending.back();
+        pending.pop_back();
+        reader(*next.first->account, next.second);
+        // Pushed last to first, so the first child is read next
+        const vector<shared_ptr<const Frozen>> &children = next.first->children;
+        for (size_t i = children.size(); i > 0; --i) {
+            pending.push_back(make_pair(children[i - 1].get(), next.second + 1));
+        }
+    }
+}
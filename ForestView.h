@@ -0,0 +1,176 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_FORESTVIEW_H
+#define ADS_MIDTERM_PROJECT_FORESTVIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "Account.h"
+#include "PersistentMap.h"
+#include "TreeNode.h"
+
+using namespace std;
+
+/**
+ * @class ForestView
+ * @brief An immutable copy of the forest at one point in time, shared between views by structural sharing.
+ *
+ * A view mirrors the forest with frozen nodes, each holding its account and its children in forest order, and finds
+ * them by account number through a `PersistentMap`. Each account is an `Account::snapshot`: its number, description
+ * and balance are copied, while its transactions share the segments of the live account and only record how many
+ * there were, so freezing an account costs the same however long its history is. Nothing in a view ever changes, so
+ * any number of threads read it without a lock while postings go on in the live forest, and copying a view only
+ * copies a few pointers.
+ *
+ * A view is derived from the previous one with `update`: the accounts changed or added since are frozen, the nodes on
+ * their paths to the roots are copied, and every other node is shared with the previous view. An account code has at
+ * most ten children, so a copied node costs little, and a new view costs the changed accounts and their paths, not the
+ * size of the forest. Views are taken with `ForestTree::view`.
+ */
+class ForestView {
+public:
+    /**
+     * @brief Default constructor for the `ForestView` class.
+     *
+     * Creates the view of an empty forest.
+     */
+    ForestView();
+
+    /**
+     * @brief Freezes every account of a forest into a new view.
+     *
+     * @param roots The root nodes of the forest, in forest order
+     * @param sequence The sequence number of the last journal record the forest holds
+     * @return The view
+     */
+    static ForestView build(const vector<NodePtr> &roots, uint64_t sequence);
+
+    /**
+     * @brief Freezes a single account into a view of its own, for reports that need nothing else.
+     *
+     * @param account The account, read under the lock of its tree
+     * @param sequence The sequence number of the last journal record the forest holds
+     * @return The view, holding the account as its only root
+     */
+    static ForestView of(const Account &account, uint64_t sequence);
+
+    /**
+     * @brief Derives a view in which some accounts are frozen again or added and all others are shared with this one.
+     *
+     * @param roots The root nodes of the forest, in forest order
+     * @param changed The nodes added, or whose account changed, since this view was taken
+     * @param sequence The sequence number of the last journal record the forest holds
+     * @return The new view
+     */
+    ForestView update(const vector<NodePtr> &roots, const vector<NodePtr> &changed, uint64_t sequence) const;
+
+    /**
+     * @brief Returns the number of accounts in the view.
+     *
+     * @return The number of accounts
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the sequence number of the last journal record reflected in the view.
+     *
+     * @return The sequence number given when the view was taken
+     */
+    uint64_t getSequence() const;
+
+    /**
+     * @brief Finds an account of the view.
+     *
+     * @param accountNumber The account number
+     * @return The frozen account, valid as long as a copy of the view lives, or nullptr if it is not in the view
+     */
+    const Account *findAccount(int accountNumber) const;
+
+    /**
+     * @brief Calls a reader with an account of the view.
+     *
+     * @param accountNumber The account number
+     * @param reader Called with the account if it is in the view
+     * @return True if the account is in the view, false otherwise
+     */
+    bool readAccount(int accountNumber, const function<void(const Account &)> &reader) const;
+
+    /**
+     * @brief Calls a reader with every account of a subtree, parents first.
+     *
+     * @param accountNumber The account number of the subtree root
+     * @param reader Called with every account and its depth below the subtree root
+     * @return True if the account is in the view, false otherwise
+     */
+    bool readSubtree(int accountNumber, const function<void(const Account &, size_t)> &reader) const;
+
+    /**
+     * @brief Calls a reader with every account of the view in pre-order.
+     *
+     * @param reader Called with every account and its depth below its root
+     */
+    void forEach(const function<void(const Account &, size_t)> &reader) const;
+
+    /**
+     * @brief Returns the account numbers of the root accounts.
+     *
+     * @return The root account numbers, in forest order
+     */
+    vector<int> getRootAccountNumbers() const;
+
+private:
+    /**
+     * @brief A frozen account and its children.
+     */
+    struct Frozen {
+        shared_ptr<const Account> account;        ///< The frozen account
+        vector<shared_ptr<const Frozen>> children; ///< The children, in forest order
+    };
+
+    typedef vector<shared_ptr<const Frozen>> Roots;
+
+    PersistentMap<shared_ptr<const Frozen>> nodes; ///< The frozen node of every account number
+    shared_ptr<const Roots> roots;                 ///< The root accounts, in forest order
+    uint64_t sequence;                             ///< The last journal record reflected in the view
+
+    /**
+     * @brief Freezes a subtree of the forest that has no counterpart in the view yet.
+     *
+     * @param node The subtree root
+     * @param frozen Receives every frozen node by account number
+     * @return The frozen subtree root
+     */
+    static shared_ptr<const Frozen> freeze(NodePtr node, vector<pair<int, shared_ptr<const Frozen>>> &frozen);
+
+    /**
+     * @brief Derives a subtree in which the marked nodes are copied and all others are shared with the old one.
+     *
+     * @param node The subtree root in the forest
+     * @param old The subtree root in this view, or null if the account is new
+     * @param marked The changed nodes and all their ancestors
+     * @param changed The changed nodes
+     * @param frozen Receives every new frozen node by account number
+     * @return The frozen subtree root
+     */
+    static shared_ptr<const Frozen> refresh(NodePtr node, const shared_ptr<const Frozen> &old,
+                                            const unordered_set<NodePtr> &marked,
+                                            const unordered_set<NodePtr> &changed,
+                                            vector<pair<int, shared_ptr<const Frozen>>> &frozen);
+
+    /**
+     * @brief Calls a reader with every account of a subtree, parents first.
+     *
+     * @param root The subtree root
+     * @param reader Called with every account and its depth below the subtree root
+     */
+    static void walk(const Frozen &root, const function<void(const Account &, size_t)> &reader);
+};
+
+#endif //ADS_MIDTERM_PROJECT_FORESTVIEW_H
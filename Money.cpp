@@ -0,0 +1,170 @@
+//
+// Created on 10/14/2026.
+//
+
+/**
+ * @file Money.cpp
+ * @brief Implements the parsing and formatting of the `Money` fixed-point type.
+ *
+ * Amounts are parsed digit by digit into integer units, so decimal text such as `0.10` is represented exactly.
+ */
+
+#include "Money.h"
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Creates an amount from a floating-point value, rounded to the nearest unit.
+ *
+ * @param value The amount as a double
+ * @return The amount
+ */
+Money Money::fromDouble(double value) {
+    return fromUnits(llround(value * SCALE));
+}
+
+/**
+ * @brief Parses a decimal amount.
+ *
+ * @param text The text to parse
+ * @return The parsed amount
+ * @throws invalid_argument If the text is not an amount
+ */
+Money Money::parse(string_view text) {
+    size_t start = text.find_first_not_of(" \t\r\n");
+    size_t end = text.find_last_not_of(" \t\r\n");
+    Money result;
+    if (start == string_view::npos || !parse(text.data() + start, text.data() + end + 1, result)) {
+        throw invalid_argument("Invalid amount: " + string(text));
+    }
+    return result;
+}
+
+/**
+ * @brief Parses a decimal amount occupying exactly the range [begin, end).
+ *
+ * @param begin The first character of the amount
+ * @param end One past the last character of the amount
+ * @param out The parsed amount, if successful
+ * @return True if the whole range is an amount, false otherwise
+ *
+ * The sign, the whole part and up to `DECIMALS` decimals are accumulated as integers; one more decimal is used to round
+ * half away from zero and any further ones are ignored. Text using exponent notation is converted through `strtod`.
+ */
+bool Money::parse(const char *begin, const char *end, Money &out) {
+    const char *p = begin;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    long long whole = 0;
+    long long fraction = 0;
+    int fractionDigits = 0;
+    bool roundUp = false;
+    bool anyDigit = false;
+
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+        whole = whole * 10 + (*p - '0');
+        anyDigit = true;
+    }
+    if (p < end && *p == '.') {
+        ++p;
+        for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+            if (fractionDigits < DECIMALS) {
+                fraction = fraction * 10 + (*p - '0');
+                ++fractionDigits;
+            } else if (fractionDigits == DECIMALS) {
+                roundUp = *p >= '5';
+                ++fractionDigits;
+            }
+            anyDigit = true;
+        }
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E') && anyDigit) {
+        // Exponent notation, as written by older versions
+        string text(begin, end);
+        char *parsedEnd = nullptr;
+        double value = strtod(text.c_str(), &parsedEnd);
+        if (parsedEnd != text.c_str() + text.size()) {
+            return false;
+        }
+        out = fromDouble(value);
+        return true;
+    }
+
+    if (!anyDigit || p != end) {
+        return false;
+    }
+
+    for (int i = fractionDigits; i < DECIMALS; ++i) {
+        fraction *= 10;
+    }
+    long long units = whole * SCALE + fraction + (roundUp ? 1 : 0);
+    out = fromUnits(negative ? -units : units);
+    return true;
+}
+
+/**
+ * @brief Returns the amount as a double.
+ *
+ * @return The approximate amount
+ */
+double Money::toDouble() const {
+    return static_cast<double>(units) / SCALE;
+}
+
+/**
+ * @brief Formats the amount as a decimal with `DECIMALS` decimal places.
+ *
+ * @return The formatted amount
+ */
+string Money::toString() const {
+    unsigned long long magnitude = units < 0 ? 0ULL - static_cast<unsigned long long>(units)
+                                             : static_cast<unsigned long long>(units);
+    string text = to_string(magnitude / SCALE);
+    if (DECIMALS > 0) {
+        string decimals = to_string(magnitude % SCALE);
+        text += '.';
+        text.append(DECIMALS - decimals.size(), '0');
+        text += decimals;
+    }
+    return units < 0 ? "-" + text : text;
+}
+
+/**
+ * @brief Overloads the output stream operator for the `Money` class.
+ *
+ * @param os The output stream
+ * @param money The amount to output
+ * @return The output stream
+ */
+ostream &operator<<(ostream &os, Money money) {
+    os << money.toString();
+    return os;
+}
+
+/**
+ * @brief Overloads the input stream operator for the `Money` class.
+ *
+ * @param is The input stream
+ * @param money The amount to input data into
+ * @return The input stream
+ */
+istream &operator>>(istream &is, Money &money) {
+    string word;
+    if (is >> word) {
+        Money parsed;
+        if (Money::parse(word.data(), word.data() + word.size(), parsed)) {
+            money = parsed;
+        } else {
+            is.setstate(ios::failbit);
+        }
+    }
+    return is;
+}
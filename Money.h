@@ -0,0 +1,155 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_MONEY_H
+#define ADS_MIDTERM_PROJECT_MONEY_H
+
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+/**
+ * @brief Number of decimal places kept by `Money`.
+ *
+ * Defaults to 2 (cents); define `MONEY_DECIMALS` at compile time to use another scale.
+ */
+#ifndef MONEY_DECIMALS
+#define MONEY_DECIMALS 2
+#endif
+
+/**
+ * @brief Computes 10 to the power of the given exponent at compile time.
+ *
+ * @param exponent The exponent, 0 or more
+ * @return 10 to the power of `exponent`
+ */
+constexpr long long moneyPowerOfTen(int exponent) {
+    return exponent <= 0 ? 1 : 10 * moneyPowerOfTen(exponent - 1);
+}
+
+/**
+ * @class Money
+ * @brief Exact fixed-point amount of money, stored as a 64-bit count of the smallest unit.
+ *
+ * Balances and transaction amounts are kept as integers of 1/`Money::SCALE` (cents by default), so sums over millions
+ * of postings never drift. Amounts are read from and written to the text formats as plain decimals such as `-12.50`.
+ */
+class Money {
+private:
+    long long units; ///< The amount, in 1/SCALE units
+
+public:
+    static constexpr int DECIMALS = MONEY_DECIMALS;          ///< Number of decimal places
+    static constexpr long long SCALE = moneyPowerOfTen(DECIMALS); ///< Number of units in one whole amount
+
+    /**
+     * @brief Default constructor for the `Money` class.
+     *
+     * Initializes the amount to zero.
+     */
+    constexpr Money() : units(0) {}
+
+    /**
+     * @brief Creates an amount from a count of the smallest unit.
+     *
+     * @param units The amount in 1/SCALE units
+     * @return The amount
+     */
+    static constexpr Money fromUnits(long long units) {
+        Money m;
+        m.units = units;
+        return m;
+    }
+
+    /**
+     * @brief Creates an amount from a floating-point value, rounded to the nearest unit.
+     *
+     * @param value The amount as a double
+     * @return The amount
+     */
+    static Money fromDouble(double value);
+
+    /**
+     * @brief Parses a decimal amount such as `12`, `-0.5` or `1500.00`.
+     *
+     * Extra decimals are rounded to the nearest unit. Exponent notation written by older versions is accepted too.
+     *
+     * @param text The text to parse
+     * @return The parsed amount
+     * @throws invalid_argument If the text is not an amount
+     */
+    static Money parse(string_view text);
+
+    /**
+     * @brief Parses a decimal amount occupying exactly the range [begin, end).
+     *
+     * @param begin The first character of the amount
+     * @param end One past the last character of the amount
+     * @param out The parsed amount, if successful
+     * @return True if the whole range is an amount, false otherwise
+     */
+    static bool parse(const char *begin, const char *end, Money &out);
+
+    /**
+     * @brief Returns the amount as a count of the smallest unit.
+     *
+     * @return The amount in 1/SCALE units
+     */
+    constexpr long long getUnits() const { return units; }
+
+    /**
+     * @brief Returns the amount as a double, for display or interoperability only.
+     *
+     * @return The approximate amount
+     */
+    double toDouble() const;
+
+    /**
+     * @brief Formats the amount as a decimal with `DECIMALS` decimal places.
+     *
+     * @return The formatted amount, e.g. `-12.50`
+     */
+    string toString() const;
+
+    // Arithmetic and comparison
+
+    Money operator-() const { return fromUnits(-units); }
+    Money operator+(Money other) const { return fromUnits(units + other.units); }
+    Money operator-(Money other) const { return fromUnits(units - other.units); }
+    Money &operator+=(Money other) { units += other.units; return *this; }
+    Money &operator-=(Money other) { units -= other.units; return *this; }
+    bool operator==(Money other) const { return units == other.units; }
+    bool operator!=(Money other) const { return units != other.units; }
+    bool operator<(Money other) const { return units < other.units; }
+    bool operator>(Money other) const { return units > other.units; }
+    bool operator<=(Money other) const { return units <= other.units; }
+    bool operator>=(Money other) const { return units >= other.units; }
+};
+
+// Operators
+
+/**
+ * @brief Output stream operator for the `Money` class.
+ *
+ * Writes the amount as formatted by `Money::toString`.
+ *
+ * @param os The output stream
+ * @param money The amount to output
+ * @return The output stream
+ */
+ostream &operator<<(ostream &os, Money money);
+
+/**
+ * @brief Input stream operator for the `Money` class.
+ *
+ * Reads one whitespace-separated word and parses it as an amount. The failbit is set if it is not one.
+ *
+ * @param is The input stream
+ * @param money The amount to input data into
+ * @return The input stream
+ */
+istream &operator>>(istream &is, Money &money);
+
+#endif //ADS_MIDTERM_PROJECT_MONEY_H
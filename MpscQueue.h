@@ -0,0 +1,103 @@
+//
+// Created on 10/15/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_MPSCQUEUE_H
+#define ADS_MIDTERM_PROJECT_MPSCQUEUE_H
+
+#include <atomic>
+#include <utility>
+
+using namespace std;
+
+/**
+ * @class MpscQueue
+ * @brief Unbounded lock-free queue with any number of producers and a single consumer.
+ *
+ * Every value lives in its own node. A producer swaps its node into `head` with one atomic exchange and then links it
+ * behind the node it replaced, so pushing never waits for another thread. The consumer owns `tail`, a stub node whose
+ * successor is the oldest value. Between the exchange and the link, the values pushed after that node are not visible
+ * to the consumer yet; they become visible once the link is stored, in push order. All operations are sequentially
+ * consistent, so a consumer that finds the queue empty and then sleeps is seen by any producer that pushes after it
+ * looked, see `TransactionJournal`.
+ *
+ * @tparam T The value type, which must be default and move constructible
+ */
+template<typename T>
+class MpscQueue {
+private:
+    /**
+     * @brief A queued value and the link to the next node.
+     */
+    struct Node {
+        atomic<Node *> next; ///< The next node, nullptr until a producer links it
+        T value;             ///< The value, moved out by the consumer
+
+        Node() : next(nullptr) {}
+
+        explicit Node(T value) : next(nullptr), value(move(value)) {}
+    };
+
+    atomic<Node *> head; ///< The last node pushed, swapped by producers
+    Node *tail;          ///< The stub node before the oldest value, owned by the consumer
+
+public:
+    /**
+     * @brief Creates an empty queue.
+     */
+    MpscQueue() : head(new Node()), tail(head.load()) {}
+
+    MpscQueue(const MpscQueue &) = delete;
+
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    /**
+     * @brief Destroys the queue and every value still in it.
+     */
+    ~MpscQueue() {
+        while (tail) {
+            Node *next = tail->next.load();
+            delete tail;
+            tail = next;
+        }
+    }
+
+    /**
+     * @brief Adds a value; safe to call from any number of threads.
+     *
+     * @param value The value
+     */
+    void push(T value) {
+        Node *node = new Node(move(value));
+        Node *previous = head.exchange(node);
+        previous->next.store(node);
+    }
+
+    /**
+     * @brief Takes the oldest value; only the consumer thread may call it.
+     *
+     * @param value Receives the value
+     * @return True if a value was taken, false if none is visible
+     */
+    bool pop(T &value) {
+        Node *next = tail->next.load();
+        if (!next) {
+            return false;
+        }
+        value = move(next->value);
+        delete tail;
+        tail = next;
+        return true;
+    }
+
+    /**
+     * @brief Checks whether a value is visible; only the consumer thread may call it.
+     *
+     * @return True if `pop` would fail, false otherwise
+     */
+    bool empty() const {
+        return tail->next.load() == nullptr;
+    }
+};
+
+#endif //ADS_MIDTERM_PROJECT_MPSCQUEUE_H
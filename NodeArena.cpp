@@ -0,0 +1,121 @@
+//
+// Created on 10/14/2026.
+//
+
+/**
+ * @file NodeArena.cpp
+ * @brief Implements the `NodeArena` class, the block allocator that owns the nodes of a forest.
+ */
+
+#include "NodeArena.h"
+#include "ForestMetrics.h"
+#include <new>
+
+using namespace std;
+
+/**
+ * @brief Default constructor for the `NodeArena` class.
+ */
+NodeArena::NodeArena() : nodeCount(0) {}
+
+/**
+ * @brief Destructor for the `NodeArena` class.
+ *
+ * Releases every node of the arena.
+ */
+NodeArena::~NodeArena() {
+    release();
+}
+
+/**
+ * @brief Creates a node holding the given account.
+ *
+ * @param acc The account to store in the node
+ * @return The new node, owned by the arena
+ *
+ * The node is constructed in the last block, and a new block is allocated first if that one is full. The account is
+ * moved into the node. If constructing the node throws, the slot stays free.
+ */
+NodePtr NodeArena::create(Account acc) {
+    if (blocks.empty() || blocks.back().used == blocks.back().capacity) {
+        addBlock(BLOCK_SIZE);
+    }
+    Block &block = blocks.back();
+    NodePtr node = new(block.nodes + block.used) TreeNode(move(acc));
+    ++block.used;
+    ++nodeCount;
+    ADS_METRICS_COUNT(NODE_ALLOCATIONS, 1);
+    return node;
+}
+
+/**
+ * @brief Makes room for the given number of nodes in a single block.
+ *
+ * @param count The number of nodes about to be created
+ */
+void NodeArena::reserve(size_t count) {
+    if (count == 0) {
+        return;
+    }
+    if (blocks.empty() || blocks.back().capacity - blocks.back().used < count) {
+        addBlock(count);
+    }
+}
+
+/**
+ * @brief Destroys every node of the arena and frees its blocks.
+ *
+ * Nodes are destroyed block by block in creation order; no child or sibling link is followed.
+ */
+void NodeArena::release() {
+    for (Block &block: blocks) {
+        for (size_t i = 0; i < block.used; ++i) {
+            block.nodes[i].~TreeNode();
+        }
+        ::operator delete(block.nodes);
+    }
+    blocks.clear();
+    nodeCount = 0;
+}
+
+/**
+ * @brief Takes over every node of another arena.
+ *
+ * @param other The arena to take the nodes from; it is left empty
+ *
+ * The adopted blocks are moved, not copied, and placed before the block being filled so it stays the last one.
+ */
+void NodeArena::adopt(NodeArena &other) {
+    if (&other == this || other.blocks.empty()) {
+        return;
+    }
+    vector<Block>::iterator position = blocks.empty() ? blocks.end() : blocks.end() - 1;
+    blocks.insert(position, other.blocks.begin(), other.blocks.end());
+    nodeCount += other.nodeCount;
+    other.blocks.clear();
+    other.nodeCount = 0;
+}
+
+/**
+ * @brief Returns the number of nodes in the arena.
+ *
+ * @return The number of live nodes
+ */
+size_t NodeArena::size() const {
+    return nodeCount;
+}
+
+/**
+ * @brief Allocates a new empty block.
+ *
+ * @param capacity The number of nodes the block can hold
+ */
+void NodeArena::addBlock(size_t capacity) {
+    blocks.reserve(blocks.size() + 1);
+    Block block;
+    block.nodes = static_cast<TreeNode *>(::operator new(capacity * sizeof(TreeNode)));
+    block.capacity = capacity;
+    block.used = 0;
+    blocks.push_back(block);
+    ADS_METRICS_COUNT(BLOCK_ALLOCATIONS, 1);
+}
@@ -0,0 +1,117 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_NODEARENA_H
+#define ADS_MIDTERM_PROJECT_NODEARENA_H
+
+#include <cstddef>
+#include <vector>
+#include "TreeNode.h"
+#include "Account.h"
+
+using namespace std;
+
+/**
+ * @class NodeArena
+ * @brief Owns the nodes of a forest, allocated in large contiguous blocks.
+ *
+ * Every `TreeNode` of a `ForestTree` is created by its arena. Nodes are constructed in place in blocks of
+ * `BLOCK_SIZE` nodes (or one block of exactly the reserved size for a bulk build), so building a chart costs one
+ * allocation per block instead of two per account, and nodes built together sit next to each other in memory.
+ * Nodes are never freed one by one: `release` destroys them in a flat loop over the blocks, whatever the shape of the
+ * trees, and frees the blocks.
+ */
+class NodeArena {
+public:
+    /**
+     * @brief The number of nodes in a block allocated by `create`.
+     */
+    static const size_t BLOCK_SIZE = 1024;
+
+    /**
+     * @brief Default constructor for the `NodeArena` class.
+     *
+     * Creates an empty arena; no memory is allocated until the first node is created.
+     */
+    NodeArena();
+
+    /**
+     * @brief Destructor for the `NodeArena` class.
+     *
+     * Releases every node of the arena.
+     */
+    ~NodeArena();
+
+    /**
+     * @brief Arenas own their nodes, so they cannot be copied.
+     */
+    NodeArena(const NodeArena &) = delete;
+
+    /**
+     * @brief Arenas own their nodes, so they cannot be assigned.
+     */
+    NodeArena &operator=(const NodeArena &) = delete;
+
+    /**
+     * @brief Creates a node holding the given account.
+     *
+     * @param acc The account to store in the node; pass a temporary or use `move` to avoid copying its transactions
+     * @return The new node, owned by the arena
+     */
+    NodePtr create(Account acc);
+
+    /**
+     * @brief Makes room for the given number of nodes in a single block.
+     *
+     * The next `count` calls to `create` allocate nothing and place their nodes next to each other.
+     *
+     * @param count The number of nodes about to be created
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Destroys every node of the arena and frees its blocks.
+     *
+     * Every pointer to a node of the arena becomes invalid.
+     */
+    void release();
+
+    /**
+     * @brief Takes over every node of another arena.
+     *
+     * Used to merge arenas filled by different threads; the nodes keep their addresses.
+     *
+     * @param other The arena to take the nodes from; it is left empty
+     */
+    void adopt(NodeArena &other);
+
+    /**
+     * @brief Returns the number of nodes in the arena.
+     *
+     * @return The number of live nodes
+     */
+    size_t size() const;
+
+private:
+    /**
+     * @brief One contiguous block of node storage.
+     */
+    struct Block {
+        TreeNode *nodes;  ///< Storage for `capacity` nodes
+        size_t capacity;  ///< Number of nodes the block can hold
+        size_t used;      ///< Number of nodes constructed in the block
+    };
+
+    vector<Block> blocks; ///< The blocks, the last one being filled
+    size_t nodeCount;     ///< Number of live nodes in all blocks
+
+    /**
+     * @brief Allocates a new empty block.
+     *
+     * @param capacity The number of nodes the block can hold
+     */
+    void addBlock(size_t capacity);
+};
+
+#endif //ADS_MIDTERM_PROJECT_NODEARENA_H
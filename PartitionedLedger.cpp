@@ -0,0 +1,431 @@
+//
+// Created on 10/15/2026.
+//
+
+/**
+ * @file PartitionedLedger.cpp
+ * @brief Implements `PartitionedLedger`, which keeps groups of root trees in separate charts, journals and files.
+ */
+
+#include "PartitionedLedger.h"
+#include "AccountCode.h"
+#include "ChartFile.h"
+#include "ForestView.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Creates a ledger over a directory without opening any partition.
+ *
+ * @param directory The ledger directory
+ * @throws runtime_error If the manifest cannot be read
+ * @throws invalid_argument If the manifest holds no valid layout
+ */
+PartitionedLedger::PartitionedLedger(string directory) : directory(move(directory)) {
+    string manifest;
+    string path = (filesystem::path(this->directory) / MANIFEST_NAME).string();
+    if (!ChartFile::readAll(path, manifest)) {
+        throw runtime_error("Unable to read partition manifest: " + path);
+    }
+    while (!manifest.empty() && isspace(static_cast<unsigned char>(manifest.back()))) {
+        manifest.pop_back();
+    }
+    groups = parseLayout(manifest);
+
+    fill(begin(digitPartitions), end(digitPartitions), NO_PARTITION);
+    for (size_t partition = 0; partition < groups.size(); ++partition) {
+        for (char digit: groups[partition]) {
+            digitPartitions[digit - '0'] = partition;
+        }
+    }
+    partitions.resize(groups.size());
+}
+
+/**
+ * @brief Reads a layout.
+ *
+ * @param layout Comma-separated groups of leading digits
+ * @return The groups, in layout order
+ * @throws invalid_argument If the layout is invalid
+ */
+vector<string> PartitionedLedger::parseLayout(const string &layout) {
+    vector<string> result;
+    bool seen[10] = {};
+    size_t start = 0;
+    while (start <= layout.size()) {
+        size_t comma = layout.find(',', start);
+        if (comma == string::npos) {
+            comma = layout.size();
+        }
+        string group = layout.substr(start, comma - start);
+        if (group.empty()) {
+            throw invalid_argument("Empty group in partition layout: " + layout);
+        }
+        for (char digit: group) {
+            if (digit < '1' || digit > '9') {
+                throw invalid_argument("Invalid digit in partition layout: " + layout);
+            }
+            if (seen[digit - '0']) {
+                throw invalid_argument(string("Digit ") + digit + " is in several partitions: " + layout);
+            }
+            seen[digit - '0'] = true;
+        }
+        result.push_back(group);
+        start = comma + 1;
+    }
+    for (int digit = 1; digit <= 9; ++digit) {
+        if (!seen[digit]) {
+            throw invalid_argument("Digit " + to_string(digit) + " is in no partition: " + layout);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Splits a chart and its transactions into a new ledger directory.
+ *
+ * The chart is loaded into one forest and read back through a `ForestView` in pre-order, so parents are added to
+ * their partition before their children and every account keeps its balance and transactions. Each partition is then
+ * exported as text, its old journal is removed, and the manifest is written last, so a ledger directory with a
+ * manifest always holds complete partitions.
+ *
+ * @param chartFile The chart file
+ * @param directory The ledger directory
+ * @param layout The groups of leading digits
+ * @return The number of accounts written
+ * @throws invalid_argument If the layout is invalid
+ * @throws runtime_error If a file cannot be written or the journal of the chart has a gap
+ */
+size_t PartitionedLedger::split(const string &chartFile, const string &directory, const string &layout) {
+    vector<string> groups = parseLayout(layout);
+    if (!filesystem::exists(chartFile)) {
+        throw runtime_error("Chart file not found: " + chartFile);
+    }
+    ForestTree source;
+    source.buildFromFile(chartFile);
+    ForestView view = source.view();
+
+    size_t digitPartitions[10];
+    fill(begin(digitPartitions), end(digitPartitions), NO_PARTITION);
+    vector<unique_ptr<ForestTree>> parts;
+    for (size_t partition = 0; partition < groups.size(); ++partition) {
+        for (char digit: groups[partition]) {
+            digitPartitions[digit - '0'] = partition;
+        }
+        parts.push_back(make_unique<ForestTree>());
+    }
+
+    size_t written = 0;
+    view.forEach([&](const Account &account, size_t depth) {
+        int accountNumber = account.getAccountNumber();
+        if (accountNumber <= 0) {
+            return;
+        }
+        ForestTree &part = *parts[digitPartitions[AccountCode::leadingDigit(accountNumber)]];
+        if (part.addAccount(account, depth == 0 ? AccountCode::NO_PARENT : AccountCode::parent(accountNumber))) {
+            ++written;
+        }
+    });
+
+    filesystem::create_directories(directory);
+    for (size_t partition = 0; partition < groups.size(); ++partition) {
+        string path = chartPath(directory, groups[partition]);
+        parts[partition]->exportText(path);
+        filesystem::remove(parts[partition]->getJournalFilename(path));
+    }
+
+    string manifest;
+    for (const string &group: groups) {
+        manifest += manifest.empty() ? "" : ",";
+        manifest += group;
+    }
+    ChartFile::replaceFile((filesystem::path(directory) / MANIFEST_NAME).string(), manifest + '\n');
+    return written;
+}
+
+/**
+ * @brief Opens every partition that is not open yet, in parallel.
+ *
+ * @throws runtime_error If the chart of a partition cannot be created or its journal has a gap
+ */
+void PartitionedLedger::open() {
+    vector<size_t> closed;
+    for (size_t partition = 0; partition < partitions.size(); ++partition) {
+        if (!partitions[partition]) {
+            closed.push_back(partition);
+        }
+    }
+    ForestTree::runParallel(closed.size(), closed.size(), [&](size_t i) {
+        openPartition(closed[i]);
+    });
+}
+
+/**
+ * @brief Opens one partition, creating its empty chart if it does not exist.
+ *
+ * The partition is loaded with `ForestTree::buildFromFile`, which loads its transactions file and replays its journal.
+ *
+ * @param partition The partition
+ * @throws out_of_range If there is no such partition
+ * @throws runtime_error If the chart cannot be created or its journal has a gap
+ */
+void PartitionedLedger::openPartition(size_t partition) {
+    if (partition >= partitions.size()) {
+        throw out_of_range("No partition " + to_string(partition));
+    }
+    if (partitions[partition]) {
+        return;
+    }
+    string path = getChartFilename(partition);
+    if (!filesystem::exists(path)) {
+        ChartFile::replaceFile(path, "");
+    }
+    unique_ptr<ForestTree> forest = make_unique<ForestTree>();
+    forest->buildFromFile(path);
+    partitions[partition] = move(forest);
+}
+
+/**
+ * @brief Checks whether a partition is open.
+ *
+ * @param partition The partition
+ * @return True if it is open, false otherwise
+ */
+bool PartitionedLedger::isOpen(size_t partition) const {
+    return partition < partitions.size() && partitions[partition] != nullptr;
+}
+
+/**
+ * @brief Returns the number of partitions of the layout.
+ *
+ * @return The number of partitions
+ */
+size_t PartitionedLedger::partitionCount() const {
+    return groups.size();
+}
+
+/**
+ * @brief Returns the partition holding an account.
+ *
+ * The partition follows from the leading digit of the number, like the root tree in `ForestTree::findRootForAccount`.
+ *
+ * @param accountNumber The account number
+ * @return The partition, or `NO_PARTITION` if the number is not positive
+ */
+size_t PartitionedLedger::partitionOf(int accountNumber) const {
+    if (accountNumber <= 0) {
+        return NO_PARTITION;
+    }
+    return digitPartitions[AccountCode::leadingDigit(accountNumber)];
+}
+
+/**
+ * @brief Returns the leading digits of the root trees of a partition.
+ *
+ * @param partition The partition
+ * @return The digits
+ */
+const string &PartitionedLedger::getDigits(size_t partition) const {
+    return groups.at(partition);
+}
+
+/**
+ * @brief Returns the chart file of a partition.
+ *
+ * @param partition The partition
+ * @return The path of the chart file
+ */
+string PartitionedLedger::getChartFilename(size_t partition) const {
+    return chartPath(directory, groups.at(partition));
+}
+
+/**
+ * @brief Returns the forest of an open partition.
+ *
+ * @param partition The partition
+ * @return The forest
+ * @throws runtime_error If the partition is not open
+ */
+ForestTree &PartitionedLedger::getPartition(size_t partition) {
+    if (!isOpen(partition)) {
+        throw runtime_error("Partition is not open: " + to_string(partition));
+    }
+    return *partitions[partition];
+}
+
+/**
+ * @brief Adds an account to its partition and to the partition's chart file.
+ *
+ * @param accountNumber The account number
+ * @param description The description
+ * @param balance The opening balance
+ * @return True if the account was added, false otherwise
+ */
+bool PartitionedLedger::addAccount(int accountNumber, const string &description, Money balance) {
+    ForestTree *forest = forestOf(accountNumber);
+    if (!forest) {
+        cout << "Error: No open partition holds account " << accountNumber << endl;
+        return false;
+    }
+    return forest->addAccountWithFile(accountNumber, description, balance,
+                                      getChartFilename(partitionOf(accountNumber)));
+}
+
+/**
+ * @brief Posts a transaction to an account of its partition.
+ *
+ * @param accountNumber The account number
+ * @param transaction The transaction
+ * @return True if the transaction was posted, false otherwise
+ */
+bool PartitionedLedger::addTransaction(int accountNumber, Transaction &transaction) {
+    ForestTree *forest = forestOf(accountNumber);
+    if (!forest) {
+        cout << "Error: Account not found for account number: " << accountNumber << endl;
+        return false;
+    }
+    return forest->addTransaction(accountNumber, transaction);
+}
+
+/**
+ * @brief Posts a batch of transactions, split by partition and posted to the partitions in parallel.
+ *
+ * @param postings The account numbers and transactions, in posting order
+ * @return The number of transactions posted
+ */
+size_t PartitionedLedger::postBatch(const vector<pair<int, Transaction>> &postings) {
+    vector<vector<pair<int, Transaction>>> shares(partitions.size());
+    for (const pair<int, Transaction> &posting: postings) {
+        size_t partition = partitionOf(posting.first);
+        if (!isOpen(partition)) {
+            cout << "Error: Account not found for account number: " << posting.first << endl;
+            continue;
+        }
+        shares[partition].push_back(posting);
+    }
+
+    vector<size_t> posted(partitions.size(), 0);
+    ForestTree::runParallel(partitions.size(), partitions.size(), [&](size_t partition) {
+        if (!shares[partition].empty()) {
+            posted[partition] = partitions[partition]->postBatch(shares[partition]);
+        }
+    });
+
+    size_t total = 0;
+    for (size_t count: posted) {
+        total += count;
+    }
+    return total;
+}
+
+/**
+ * @brief Deletes a transaction of an account by its index.
+ *
+ * @param accountNumber The account number
+ * @param transactionIndex The index of the transaction in the account
+ * @return True if the transaction was deleted, false otherwise
+ */
+bool PartitionedLedger::deleteTransaction(int accountNumber, int transactionIndex) {
+    ForestTree *forest = forestOf(accountNumber);
+    if (!forest) {
+        cout << "Error: Account not found for account number: " << accountNumber << endl;
+        return false;
+    }
+    return forest->deleteTransaction(accountNumber, transactionIndex);
+}
+
+/**
+ * @brief Deletes a transaction by its ID from whichever open partition holds it.
+ *
+ * IDs do not name their account, so the partitions are searched in turn through their ID indexes.
+ *
+ * @param transactionID The transaction ID
+ * @return True if the transaction was deleted, false otherwise
+ */
+bool PartitionedLedger::deleteTransactionById(const string &transactionID) {
+    for (const unique_ptr<ForestTree> &forest: partitions) {
+        int accountNumber;
+        Transaction transaction;
+        if (forest && forest->findTransaction(transactionID, accountNumber, transaction)) {
+            return forest->deleteTransactionById(transactionID);
+        }
+    }
+    cout << "Error: Transaction not found: " << transactionID << endl;
+    return false;
+}
+
+/**
+ * @brief Calls a reader with an account under the lock of its tree.
+ *
+ * @param accountNumber The account number
+ * @param reader Called with the account if it exists
+ * @return True if the account is in an open partition, false otherwise
+ */
+bool PartitionedLedger::readAccount(int accountNumber, const function<void(const Account &)> &reader) const {
+    ForestTree *forest = forestOf(accountNumber);
+    return forest && forest->readAccount(accountNumber, reader);
+}
+
+/**
+ * @brief Saves the changed balances of every open partition to its chart, in parallel.
+ *
+ * A partition without changes rewrites nothing, see `ForestTree::saveToFile`.
+ *
+ * @throws runtime_error If a chart cannot be written
+ */
+void PartitionedLedger::save() {
+    forEachOpen([](ForestTree &forest, const string &chart) {
+        forest.saveToFile(chart);
+    });
+}
+
+/**
+ * @brief Folds the journal of every open partition into its transactions file, in parallel.
+ *
+ * @throws runtime_error If a transactions file or journal cannot be written
+ */
+void PartitionedLedger::compact() {
+    forEachOpen([](ForestTree &forest, const string &) {
+        forest.compactJournal();
+    });
+}
+
+/**
+ * @brief Returns the chart file of a group of digits in a directory.
+ *
+ * @param directory The ledger directory
+ * @param digits The group of leading digits
+ * @return The path of the chart file
+ */
+string PartitionedLedger::chartPath(const string &directory, const string &digits) {
+    return (filesystem::path(directory) / ("ledger-" + digits + ".txt")).string();
+}
+
+/**
+ * @brief Returns the open forest holding an account.
+ *
+ * @param accountNumber The account number
+ * @return The forest, or nullptr if the account belongs to no open partition
+ */
+ForestTree *PartitionedLedger::forestOf(int accountNumber) const {
+    size_t partition = partitionOf(accountNumber);
+    return isOpen(partition) ? partitions[partition].get() : nullptr;
+}
+
+/**
+ * @brief Runs a task on every open partition in parallel.
+ *
+ * @param task Called with every open forest and its chart file
+ */
+void PartitionedLedger::forEachOpen(const function<void(ForestTree &, const string &)> &task) {
+    ForestTree::runParallel(partitions.size(), partitions.size(), [&](size_t partition) {
+        if (partitions[partition]) {
+            task(*partitions[partition], getChartFilename(partition));
+        }
+    });
+}
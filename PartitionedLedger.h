@@ -0,0 +1,249 @@
+//
+// Created on 10/15/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_PARTITIONEDLEDGER_H
+#define ADS_MIDTERM_PROJECT_PARTITIONEDLEDGER_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ForestTree.h"
+#include "Money.h"
+#include "Transaction.h"
+
+using namespace std;
+
+/**
+ * @class PartitionedLedger
+ * @brief A ledger stored as independent partitions, each holding the root trees of some leading digits.
+ *
+ * The root trees are grouped into partitions by a layout such as `1,2,3,4,5,6789`: every group lists the leading
+ * digits of the root accounts it holds, and every digit from 1 to 9 is in exactly one group. The layout is kept in
+ * the manifest `partitions.txt` of the ledger directory. Each partition is a `ForestTree` with its own chart file
+ * `ledger-<digits>.txt`, and with it its own transactions file and journal, so it loads, saves and compacts without
+ * touching the files of any other partition, and a posting only ever waits for the journal of its own partition.
+ *
+ * Partitions are opened one by one, so a process may hold only some of them and leave the others to other processes;
+ * the transaction IDs of such processes are kept apart by their node IDs, see `TransactionIdGenerator`. Partitions
+ * must be opened before any other call; once they are open, every method is safe to call from several threads.
+ * A ledger directory is created from a single chart with `split`.
+ */
+class PartitionedLedger {
+public:
+    /**
+     * @brief The name of the manifest file in the ledger directory.
+     */
+    static constexpr const char *MANIFEST_NAME = "partitions.txt";
+
+    /**
+     * @brief The layout with one partition per root digit.
+     */
+    static constexpr const char *DEFAULT_LAYOUT = "1,2,3,4,5,6,7,8,9";
+
+    /**
+     * @brief The partition returned by `partitionOf` for accounts that no partition holds.
+     */
+    static constexpr size_t NO_PARTITION = static_cast<size_t>(-1);
+
+    /**
+     * @brief Creates a ledger over a directory without opening any partition.
+     *
+     * @param directory The ledger directory
+     * @throws runtime_error If the manifest cannot be read
+     * @throws invalid_argument If the manifest holds no valid layout
+     */
+    explicit PartitionedLedger(string directory);
+
+    /**
+     * @brief Reads a layout.
+     *
+     * @param layout Comma-separated groups of leading digits
+     * @return The groups, in layout order
+     * @throws invalid_argument If a group is empty or holds anything but digits 1 to 9, or if a digit is missing or
+     * in several groups
+     */
+    static vector<string> parseLayout(const string &layout);
+
+    /**
+     * @brief Splits a chart and its transactions into a new ledger directory.
+     *
+     * @param chartFile The chart file, loaded with its transactions and journal like `ForestTree::buildFromFile`
+     * @param directory The ledger directory, created if needed
+     * @param layout The groups of leading digits, see `parseLayout`
+     * @return The number of accounts written
+     * @throws invalid_argument If the layout is invalid
+     * @throws runtime_error If a file cannot be written or the journal of the chart has a gap
+     */
+    static size_t split(const string &chartFile, const string &directory, const string &layout = DEFAULT_LAYOUT);
+
+    /**
+     * @brief Opens every partition that is not open yet, in parallel.
+     *
+     * @throws runtime_error If the chart of a partition cannot be created or its journal has a gap
+     */
+    void open();
+
+    /**
+     * @brief Opens one partition, creating its empty chart if it does not exist.
+     *
+     * @param partition The partition
+     * @throws out_of_range If there is no such partition
+     * @throws runtime_error If the chart cannot be created or its journal has a gap
+     */
+    void openPartition(size_t partition);
+
+    /**
+     * @brief Checks whether a partition is open.
+     *
+     * @param partition The partition
+     * @return True if it is open, false otherwise
+     */
+    bool isOpen(size_t partition) const;
+
+    /**
+     * @brief Returns the number of partitions of the layout.
+     *
+     * @return The number of partitions
+     */
+    size_t partitionCount() const;
+
+    /**
+     * @brief Returns the partition holding an account.
+     *
+     * @param accountNumber The account number
+     * @return The partition, or `NO_PARTITION` if the number is not positive
+     */
+    size_t partitionOf(int accountNumber) const;
+
+    /**
+     * @brief Returns the leading digits of the root trees of a partition.
+     *
+     * @param partition The partition
+     * @return The digits, as written in the layout
+     */
+    const string &getDigits(size_t partition) const;
+
+    /**
+     * @brief Returns the chart file of a partition.
+     *
+     * @param partition The partition
+     * @return The path of the chart file; the transactions file and journal are named after it
+     */
+    string getChartFilename(size_t partition) const;
+
+    /**
+     * @brief Returns the forest of an open partition, for any operation the ledger does not route itself.
+     *
+     * @param partition The partition
+     * @return The forest
+     * @throws runtime_error If the partition is not open
+     */
+    ForestTree &getPartition(size_t partition);
+
+    /**
+     * @brief Adds an account to its partition and to the partition's chart file.
+     *
+     * @param accountNumber The account number; its parent is the number without its last digit
+     * @param description The description
+     * @param balance The opening balance
+     * @return True if the account was added, false if it exists, has no parent or its partition is not open
+     */
+    bool addAccount(int accountNumber, const string &description, Money balance);
+
+    /**
+     * @brief Posts a transaction to an account of its partition.
+     *
+     * @param accountNumber The account number
+     * @param transaction The transaction; an empty ID is filled in
+     * @return True if the transaction was posted, false otherwise
+     */
+    bool addTransaction(int accountNumber, Transaction &transaction);
+
+    /**
+     * @brief Posts a batch of transactions, split by partition and posted to the partitions in parallel.
+     *
+     * @param postings The account numbers and transactions, in posting order
+     * @return The number of transactions posted
+     *
+     * Each partition posts its share with one `ForestTree::postBatch`, keeping the order of the batch, so it costs
+     * one rollup and one journal commit per partition touched. Postings to accounts of partitions that are not open
+     * are reported and skipped.
+     */
+    size_t postBatch(const vector<pair<int, Transaction>> &postings);
+
+    /**
+     * @brief Deletes a transaction of an account by its index.
+     *
+     * @param accountNumber The account number
+     * @param transactionIndex The index of the transaction in the account
+     * @return True if the transaction was deleted, false otherwise
+     */
+    bool deleteTransaction(int accountNumber, int transactionIndex);
+
+    /**
+     * @brief Deletes a transaction by its ID from whichever open partition holds it.
+     *
+     * @param transactionID The transaction ID
+     * @return True if the transaction was deleted, false otherwise
+     */
+    bool deleteTransactionById(const string &transactionID);
+
+    /**
+     * @brief Calls a reader with an account under the lock of its tree.
+     *
+     * @param accountNumber The account number
+     * @param reader Called with the account if it exists
+     * @return True if the account is in an open partition, false otherwise
+     */
+    bool readAccount(int accountNumber, const function<void(const Account &)> &reader) const;
+
+    /**
+     * @brief Saves the changed balances of every open partition to its chart, in parallel.
+     *
+     * @throws runtime_error If a chart cannot be written
+     */
+    void save();
+
+    /**
+     * @brief Folds the journal of every open partition into its transactions file, in parallel.
+     *
+     * @throws runtime_error If a transactions file or journal cannot be written
+     */
+    void compact();
+
+private:
+    string directory;                          ///< The ledger directory
+    vector<string> groups;                     ///< The leading digits of every partition
+    size_t digitPartitions[10];                ///< The partition of every leading digit, `NO_PARTITION` for 0
+    vector<unique_ptr<ForestTree>> partitions; ///< The forest of every partition, null until it is opened
+
+    /**
+     * @brief Returns the chart file of a group of digits in a directory.
+     *
+     * @param directory The ledger directory
+     * @param digits The group of leading digits
+     * @return The path of the chart file
+     */
+    static string chartPath(const string &directory, const string &digits);
+
+    /**
+     * @brief Returns the open forest holding an account.
+     *
+     * @param accountNumber The account number
+     * @return The forest, or nullptr if the account belongs to no open partition
+     */
+    ForestTree *forestOf(int accountNumber) const;
+
+    /**
+     * @brief Runs a task on every open partition in parallel.
+     *
+     * @param task Called with every open forest and its chart file
+     */
+    void forEachOpen(const function<void(ForestTree &, const string &)> &task);
+};
+
+#endif //ADS_MIDTERM_PROJECT_PARTITIONEDLEDGER_H
@@ -0,0 +1,244 @@
+//
+// Created on 10/15/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_PERSISTENTMAP_H
+#define ADS_MIDTERM_PROJECT_PERSISTENTMAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class PersistentMap
+ * @brief Immutable map from int keys, where every change returns a new map sharing all untouched nodes with the old.
+ *
+ * The map is a trie over the bits of the key, highest first, `BITS` bits per level, so it is never deeper than
+ * `32 / BITS + 1` levels and keys close together, like the children of an account, share their nodes. A node only
+ * holds the slots of the digits in use, found through a bitmap, and an entry sits as high as the keys around it allow.
+ * `set` copies the nodes on the path to its key, at most one per level and each at most `1 << BITS` slots, and shares
+ * every other node, so a change costs the same whatever the size of the map. Nothing reachable from a map ever
+ * changes, so copies are read from any number of threads without a lock.
+ *
+ * @tparam T The value type, which must be default constructible and copyable
+ */
+template<typename T>
+class PersistentMap {
+private:
+    /**
+     * @brief The number of key bits consumed per level.
+     */
+    static constexpr unsigned BITS = 5;
+
+    struct Node;
+
+    /**
+     * @brief An entry, or a subtrie holding all entries whose keys share the digits so far.
+     */
+    struct Slot {
+        shared_ptr<const Node> child; ///< The subtrie, or null if the slot holds an entry
+        int key;                      ///< The key of the entry
+        T value;                      ///< The value of the entry
+    };
+
+    /**
+     * @brief The slots of one level, only for the digits in use.
+     */
+    struct Node {
+        uint32_t bitmap = 0; ///< Bit d is set if digit d has a slot
+        vector<Slot> slots;  ///< The slots of the set bits, in digit order
+    };
+
+    shared_ptr<const Node> root; ///< The top level, or null for an empty map
+    size_t count;                ///< The number of entries
+
+    /**
+     * @brief Returns the digit of a key on a level.
+     *
+     * @param key The key
+     * @param shift The number of key bits consumed by the levels above
+     * @return The digit; the last level has the bits that are left
+     */
+    static uint32_t digit(int key, unsigned shift) {
+        uint32_t bits = static_cast<uint32_t>(key);
+        if (shift + BITS <= 32) {
+            return (bits >> (32 - shift - BITS)) & ((1u << BITS) - 1);
+        }
+        return bits & ((1u << (32 - shift)) - 1);
+    }
+
+    /**
+     * @brief Returns the index of the slot of a digit in a node.
+     *
+     * @param bitmap The bitmap of the node
+     * @param bit The bit of the digit
+     * @return The number of slots before it
+     */
+    static size_t rank(uint32_t bitmap, uint32_t bit) {
+        uint32_t below = bitmap & (bit - 1);
+        size_t bits = 0;
+        for (; below != 0; below &= below - 1) {
+            ++bits;
+        }
+        return bits;
+    }
+
+    /**
+     * @brief Copies a node with one entry set, copying the nodes below it on the path to the key.
+     *
+     * @param node The node, or null for an empty level
+     * @param shift The number of key bits consumed by the levels above
+     * @param key The key
+     * @param value The value
+     * @param added Set to true if the key was not in the map
+     * @return The new node
+     */
+    static shared_ptr<const Node> insert(const Node *node, unsigned shift, int key, T value, bool &added) {
+        shared_ptr<Node> copy = node ? make_shared<Node>(*node) : make_shared<Node>();
+        uint32_t bit = 1u << digit(key, shift);
+        size_t index = rank(copy->bitmap, bit);
+        if (!(copy->bitmap & bit)) {
+            copy->bitmap |= bit;
+            copy->slots.insert(copy->slots.begin() + index, Slot{nullptr, key, move(value)});
+            added = true;
+            return copy;
+        }
+
+        Slot &slot = copy->slots[index];
+        if (slot.child) {
+            slot.child = insert(slot.child.get(), shift + BITS, key, move(value), added);
+        } else if (slot.key == key) {
+            slot.value = move(value);
+        } else {
+            // Another key shares every digit so far: both move one level down, and further while they still agree
+            Node below;
+            below.bitmap = 1u << digit(slot.key, shift + BITS);
+            below.slots.push_back(Slot{nullptr, slot.key, move(slot.value)});
+            slot.child = insert(&below, shift + BITS, key, move(value), added);
+            slot.value = T();
+        }
+        return copy;
+    }
+
+    /**
+     * @brief Places a run of entries whose keys share every digit above a level.
+     *
+     * @param entries The entries, in ascending order of their unsigned keys
+     * @param begin The first entry of the run
+     * @param end One past the last entry of the run
+     * @param shift The number of key bits consumed by the levels above
+     * @return The slot holding the run
+     */
+    static Slot place(vector<pair<int, T>> &entries, size_t begin, size_t end, unsigned shift) {
+        if (end - begin == 1) {
+            return Slot{nullptr, entries[begin].first, move(entries[begin].second)};
+        }
+        shared_ptr<Node> node = make_shared<Node>();
+        while (begin < end) {
+            uint32_t next = digit(entries[begin].first, shift);
+            size_t runEnd = begin + 1;
+            while (runEnd < end && digit(entries[runEnd].first, shift) == next) {
+                ++runEnd;
+            }
+            node->bitmap |= 1u << next;
+            node->slots.push_back(place(entries, begin, runEnd, shift + BITS));
+            begin = runEnd;
+        }
+        return Slot{node, 0, T()};
+    }
+
+public:
+    /**
+     * @brief Creates an empty map.
+     */
+    PersistentMap() : count(0) {}
+
+    /**
+     * @brief Creates a map holding many entries at once, without copying any node.
+     *
+     * @param entries The entries; of entries with the same key the last one is kept
+     * @return The map
+     */
+    static PersistentMap fromEntries(vector<pair<int, T>> entries) {
+        // In the order of the unsigned keys, every subtrie is a run of the entries and its slots are in digit order
+        stable_sort(entries.begin(), entries.end(), [](const pair<int, T> &a, const pair<int, T> &b) {
+            return static_cast<uint32_t>(a.first) < static_cast<uint32_t>(b.first);
+        });
+        size_t kept = 0;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (kept > 0 && entries[kept - 1].first == entries[i].first) {
+                --kept;
+            }
+            entries[kept++] = move(entries[i]);
+        }
+        entries.resize(kept);
+
+        PersistentMap map;
+        map.count = entries.size();
+        if (entries.empty()) {
+            return map;
+        }
+        Slot top = place(entries, 0, entries.size(), 0);
+        if (top.child) {
+            map.root = top.child;
+        } else {
+            // A single entry still needs a node to sit in
+            bool added = false;
+            map.root = insert(nullptr, 0, top.key, move(top.value), added);
+        }
+        return map;
+    }
+
+    /**
+     * @brief Finds the value of a key.
+     *
+     * @param key The key
+     * @return The value, valid as long as a map sharing its node lives, or nullptr if the key is not in the map
+     */
+    const T *find(int key) const {
+        const Node *node = root.get();
+        for (unsigned shift = 0; node != nullptr; shift += BITS) {
+            uint32_t bit = 1u << digit(key, shift);
+            if (!(node->bitmap & bit)) {
+                return nullptr;
+            }
+            const Slot &slot = node->slots[rank(node->bitmap, bit)];
+            if (!slot.child) {
+                return slot.key == key ? &slot.value : nullptr;
+            }
+            node = slot.child.get();
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Returns a map in which a key has a value, and which shares every other entry with this one.
+     *
+     * @param key The key
+     * @param value The value, replacing any value the key had
+     * @return The new map
+     */
+    PersistentMap set(int key, T value) const {
+        PersistentMap map;
+        bool added = false;
+        map.root = insert(root.get(), 0, key, move(value), added);
+        map.count = count + (added ? 1 : 0);
+        return map;
+    }
+
+    /**
+     * @brief Returns the number of entries.
+     *
+     * @return The number of entries
+     */
+    size_t size() const {
+        return count;
+    }
+};
+
+#endif //ADS_MIDTERM_PROJECT_PERSISTENTMAP_H
@@ -0,0 +1,382 @@
+//
+// Created on 10/14/2026.
+//
+
+/**
+ * @file ReportGenerator.cpp
+ * @brief Implements `ReportGenerator`, which writes buffered text, CSV and JSON reports of accounts and subtrees.
+ */
+
+#include "ReportGenerator.h"
+#include <cctype>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+/**
+ * @class ReportWriter
+ * @brief Formats the accounts of one report into a buffer that is written to the stream in large blocks.
+ */
+class ReportWriter {
+private:
+    ostream &out;        ///< The stream that receives the report
+    ReportFormat format; ///< The output format
+    bool transactions;   ///< True to list the transactions of every account
+    string buffer;       ///< Output not written to the stream yet
+    size_t accounts;     ///< The number of accounts written so far
+
+    /**
+     * @brief Appends a CSV field, quoted if it holds a separator, a quote or a line break.
+     *
+     * @param text The field
+     */
+    void appendCsv(string_view text) {
+        if (text.find_first_of(",\"\r\n") == string_view::npos) {
+            buffer += text;
+            return;
+        }
+        buffer += '"';
+        for (char c: text) {
+            if (c == '"') {
+                buffer += '"';
+            }
+            buffer += c;
+        }
+        buffer += '"';
+    }
+
+    /**
+     * @brief Appends a quoted JSON string.
+     *
+     * @param text The string
+     */
+    void appendJson(string_view text) {
+        static const char HEX[] = "0123456789abcdef";
+        buffer += '"';
+        for (char c: text) {
+            unsigned char byte = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\') {
+                buffer += '\\';
+                buffer += c;
+            } else if (byte < 0x20) {
+                buffer += "\\u00";
+                buffer += HEX[byte >> 4];
+                buffer += HEX[byte & 0xF];
+            } else {
+                buffer += c;
+            }
+        }
+        buffer += '"';
+    }
+
+    /**
+     * @brief Writes the buffer to the stream once it is large.
+     */
+    void flushIfFull() {
+        if (buffer.size() >= ReportGenerator::FLUSH_BYTES) {
+            flush();
+        }
+    }
+
+public:
+    /**
+     * @brief Starts a report.
+     *
+     * @param out The stream that receives the report
+     * @param format The output format
+     * @param transactions True to list the transactions of every account
+     */
+    ReportWriter(ostream &out, ReportFormat format, bool transactions)
+            : out(out), format(format), transactions(transactions), accounts(0) {
+        buffer.reserve(ReportGenerator::FLUSH_BYTES + (1 << 16));
+        if (format == ReportFormat::CSV) {
+            buffer += "record,account,depth,description,balance,transaction_id,amount,type,date\n";
+        } else if (format == ReportFormat::JSON) {
+            buffer += "{\"accounts\":[";
+        }
+    }
+
+    /**
+     * @brief Appends the report of one account.
+     *
+     * @param account The account
+     * @param depth The depth of the account below the root of the report
+     */
+    void add(const Account &account, size_t depth) {
+        const TransactionColumns &columns = account.getTransactions().getColumns();
+        string number = to_string(account.getAccountNumber());
+
+        if (format == ReportFormat::TEXT) {
+            if (accounts > 0) {
+                buffer += '\n';
+            }
+            buffer += "Account Details:\n================\n";
+            buffer += number;
+            buffer += ' ';
+            buffer += account.getShortDescription();
+            buffer += ' ';
+            buffer += account.getBalance().toString();
+            buffer += "\n\n";
+            if (transactions) {
+                buffer += "Transaction History:\n===================\n";
+                if (columns.empty()) {
+                    buffer += "No transactions recorded.\n";
+                }
+                for (size_t k = 0; k < columns.slotCount(); ++k) {
+                    if (columns.isDeleted(k)) continue;
+                    buffer += "Transaction ID: ";
+                    buffer += columns.getTransactionID(k);
+                    buffer += "\nAmount: ";
+                    buffer += columns.getAmount(k).toString();
+                    buffer += columns.getDebitCredit(k) == 'D' ? "\nType: Debit\nDate: " : "\nType: Credit\nDate: ";
+                    buffer += columns.getDate(k);
+                    buffer += "\nDescription: ";
+                    buffer += columns.getDescription(k);
+                    buffer += "\n\n";
+                }
+            }
+        } else if (format == ReportFormat::CSV) {
+            string prefix = number + ',' + to_string(depth) + ',';
+            buffer += "account,";
+            buffer += prefix;
+            appendCsv(account.getDescription());
+            buffer += ',';
+            buffer += account.getBalance().toString();
+            buffer += ",,,,\n";
+            for (size_t k = 0; transactions && k < columns.slotCount(); ++k) {
+                if (columns.isDeleted(k)) continue;
+                buffer += "transaction,";
+                buffer += prefix;
+                appendCsv(columns.getDescription(k));
+                buffer += ",,";
+                appendCsv(columns.getTransactionID(k));
+                buffer += ',';
+                buffer += columns.getAmount(k).toString();
+                buffer += ',';
+                buffer += columns.getDebitCredit(k);
+                buffer += ',';
+                appendCsv(columns.getDate(k));
+                buffer += '\n';
+            }
+        } else {
+            buffer += accounts > 0 ? ",\n{\"account\":" : "\n{\"account\":";
+            buffer += number;
+            buffer += ",\"depth\":";
+            buffer += to_string(depth);
+            buffer += ",\"description\":";
+            appendJson(account.getDescription());
+            buffer += ",\"balance\":";
+            buffer += account.getBalance().toString();
+            if (transactions) {
+                buffer += ",\"transactions\":[";
+                bool first = true;
+                for (size_t k = 0; k < columns.slotCount(); ++k) {
+                    if (columns.isDeleted(k)) continue;
+                    buffer += first ? "{\"id\":" : ",{\"id\":";
+                    first = false;
+                    appendJson(columns.getTransactionID(k));
+                    buffer += ",\"amount\":";
+                    buffer += columns.getAmount(k).toString();
+                    buffer += ",\"type\":";
+                    appendJson(string_view(columns.getDebitCredit(k) == 'D' ? "D" : "C"));
+                    buffer += ",\"date\":";
+                    appendJson(columns.getDate(k));
+                    buffer += ",\"description\":";
+                    appendJson(columns.getDescription(k));
+                    buffer += '}';
+                }
+                buffer += ']';
+            }
+            buffer += '}';
+        }
+        ++accounts;
+        flushIfFull();
+    }
+
+    /**
+     * @brief Notes an account that does not exist; only text reports show it.
+     *
+     * @param accountNumber The account number
+     */
+    void addMissing(int accountNumber) {
+        if (format == ReportFormat::TEXT) {
+            buffer += "Account not found: ";
+            buffer += to_string(accountNumber);
+            buffer += '\n';
+        }
+    }
+
+    /**
+     * @brief Writes the buffer to the stream.
+     */
+    void flush() {
+        out.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+        buffer.clear();
+    }
+
+    /**
+     * @brief Ends the report and writes what is left of it.
+     *
+     * @return The number of accounts written
+     */
+    size_t finish() {
+        if (format == ReportFormat::JSON) {
+            buffer += "\n]}\n";
+        }
+        flush();
+        out.flush();
+        return accounts;
+    }
+};
+
+} // namespace
+
+/**
+ * @brief Creates a generator for a forest.
+ *
+ * @param tree The forest
+ * @param format The output format
+ */
+ReportGenerator::ReportGenerator(const ForestTree &tree, ReportFormat format)
+        : tree(&tree), format(format), transactions(true) {}
+
+/**
+ * @brief Creates a generator for a view of a forest.
+ *
+ * @param view The view
+ * @param format The output format
+ */
+ReportGenerator::ReportGenerator(ForestView view, ReportFormat format)
+        : tree(nullptr), view(move(view)), format(format), transactions(true) {}
+
+/**
+ * @brief Sets whether the transactions of every account are listed.
+ *
+ * @param enabled False to list balances only
+ */
+void ReportGenerator::setIncludeTransactions(bool enabled) {
+    transactions = enabled;
+}
+
+/**
+ * @brief Reads a format name.
+ *
+ * @param name `text`, `csv` or `json`, in any case
+ * @return The format
+ * @throws invalid_argument If the name is not a format
+ */
+ReportFormat ReportGenerator::parseFormat(string_view name) {
+    string lower;
+    for (char c: name) {
+        lower += static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+    if (lower == "text" || lower == "txt") {
+        return ReportFormat::TEXT;
+    }
+    if (lower == "csv") {
+        return ReportFormat::CSV;
+    }
+    if (lower == "json") {
+        return ReportFormat::JSON;
+    }
+    throw invalid_argument("Unknown report format: " + string(name));
+}
+
+/**
+ * @brief Returns the file extension of a format.
+ *
+ * @param format The format
+ * @return `txt`, `csv` or `json`
+ */
+const char *ReportGenerator::extension(ReportFormat format) {
+    switch (format) {
+        case ReportFormat::CSV:
+            return "csv";
+        case ReportFormat::JSON:
+            return "json";
+        default:
+            return "txt";
+    }
+}
+
+/**
+ * @brief Writes the reports of a list of accounts, in list order.
+ *
+ * @param accounts The account numbers
+ * @param out The stream that receives the report
+ * @return The number of accounts found
+ *
+ * Every account is read under the lock of its own tree with `ForestTree::readAccount`, so a long report never holds
+ * a lock for longer than one account takes. A view is read without any lock.
+ */
+size_t ReportGenerator::writeAccounts(const vector<int> &accounts, ostream &out) const {
+    ReportWriter writer(out, format, transactions);
+    function<void(const Account &)> reader = [&writer](const Account &account) {
+        writer.add(account, 0);
+    };
+    for (int accountNumber: accounts) {
+        if (!(tree ? tree->readAccount(accountNumber, reader) : view.readAccount(accountNumber, reader))) {
+            writer.addMissing(accountNumber);
+        }
+    }
+    return writer.finish();
+}
+
+/**
+ * @brief Writes the reports of every account of a subtree, parents first.
+ *
+ * @param accountNumber The account number of the subtree root
+ * @param out The stream that receives the report
+ * @return The number of accounts written, 0 if the account does not exist
+ *
+ * The subtree is read in one pass with `ForestTree::readSubtree`, under the lock of its root tree, or from the view.
+ */
+size_t ReportGenerator::writeSubtree(int accountNumber, ostream &out) const {
+    ReportWriter writer(out, format, transactions);
+    function<void(const Account &, size_t)> reader = [&writer](const Account &account, size_t depth) {
+        writer.add(account, depth);
+    };
+    if (!(tree ? tree->readSubtree(accountNumber, reader) : view.readSubtree(accountNumber, reader))) {
+        writer.addMissing(accountNumber);
+    }
+    return writer.finish();
+}
+
+/**
+ * @brief Writes one subtree report file per root tree, the trees on separate threads.
+ *
+ * @param directory The directory of the files, named `report_<root>.<extension>`
+ * @return The number of accounts written
+ * @throws runtime_error If a file cannot be written
+ *
+ * Root trees have separate locks, so the reports of different roots are read and written at the same time. A view
+ * needs no lock, and all files show the same point in time.
+ */
+size_t ReportGenerator::writeRootReports(const string &directory) const {
+    vector<int> roots = tree ? tree->getRootAccountNumbers() : view.getRootAccountNumbers();
+    vector<size_t> counts(roots.size(), 0);
+    string prefix = directory.empty() || directory.back() == '/' ? directory : directory + '/';
+
+    ForestTree::runParallel(roots.size(), roots.size(), [&](size_t i) {
+        string filename = prefix + "report_" + to_string(roots[i]) + '.' + extension(format);
+        ofstream file(filename, ios::binary);
+        if (!file.is_open()) {
+            throw runtime_error("Could not open file for writing: " + filename);
+        }
+        counts[i] = writeSubtree(roots[i], file);
+        if (!file) {
+            throw runtime_error("Could not write file: " + filename);
+        }
+    });
+
+    size_t total = 0;
+    for (size_t count: counts) {
+        total += count;
+    }
+    return total;
+}
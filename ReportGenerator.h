@@ -0,0 +1,124 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_REPORTGENERATOR_H
+#define ADS_MIDTERM_PROJECT_REPORTGENERATOR_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ForestTree.h"
+#include "ForestView.h"
+
+using namespace std;
+
+/**
+ * @brief The output formats of `ReportGenerator`.
+ */
+enum class ReportFormat {
+    TEXT, ///< The layout of `ForestTree::printDetailedReport`, one block per account
+    CSV,  ///< One row per account and per transaction, with a header row
+    JSON  ///< One object holding an array of accounts, each with its transactions
+};
+
+/**
+ * @class ReportGenerator
+ * @brief Writes the detailed reports of many accounts, or of whole subtrees, into one buffered output.
+ *
+ * A report lists every account with its balance, which already rolls up its subtree, and every transaction posted to
+ * it. Output is built in a memory buffer and written to the stream in large blocks, never flushed per line. A subtree
+ * is read in one pass over the contiguous range the Euler tour gives it, see `ForestTree::readSubtree`, and
+ * `writeRootReports` writes one file per root tree with the trees on separate threads.
+ *
+ * CSV rows are `record,account,depth,description,balance,transaction_id,amount,type,date`: an `account` row leaves the
+ * transaction fields empty, and a `transaction` row leaves the balance empty and puts the transaction description in
+ * the description field. In JSON, amounts are exact decimal numbers. Depths count from the root of the report, so
+ * they are 0 in reports of account lists.
+ *
+ * A generator created from a `ForestView` reads the view instead of the forest: it takes no lock at all, and every
+ * report it writes shows the forest as it was when the view was taken, however long writing takes.
+ */
+class ReportGenerator {
+private:
+    const ForestTree *tree; ///< The forest reported on, or nullptr to report on `view`
+    ForestView view;        ///< The view reported on when `tree` is null
+    ReportFormat format;    ///< The output format
+    bool transactions;      ///< True to list the transactions of every account
+
+public:
+    /**
+     * @brief The buffer size at which output is written to the stream.
+     */
+    static const size_t FLUSH_BYTES = 1 << 20;
+
+    /**
+     * @brief Creates a generator for a forest.
+     *
+     * @param tree The forest
+     * @param format The output format
+     */
+    explicit ReportGenerator(const ForestTree &tree, ReportFormat format = ReportFormat::TEXT);
+
+    /**
+     * @brief Creates a generator for a view of a forest.
+     *
+     * @param view The view, see `ForestTree::view`
+     * @param format The output format
+     */
+    explicit ReportGenerator(ForestView view, ReportFormat format = ReportFormat::TEXT);
+
+    /**
+     * @brief Sets whether the transactions of every account are listed.
+     *
+     * @param enabled False to list balances only
+     */
+    void setIncludeTransactions(bool enabled);
+
+    /**
+     * @brief Reads a format name.
+     *
+     * @param name `text`, `csv` or `json`, in any case
+     * @return The format
+     * @throws invalid_argument If the name is not a format
+     */
+    static ReportFormat parseFormat(string_view name);
+
+    /**
+     * @brief Returns the file extension of a format.
+     *
+     * @param format The format
+     * @return `txt`, `csv` or `json`
+     */
+    static const char *extension(ReportFormat format);
+
+    /**
+     * @brief Writes the reports of a list of accounts, in list order.
+     *
+     * @param accounts The account numbers
+     * @param out The stream that receives the report
+     * @return The number of accounts found; text reports note every missing account, the other formats skip it
+     */
+    size_t writeAccounts(const vector<int> &accounts, ostream &out) const;
+
+    /**
+     * @brief Writes the reports of every account of a subtree, parents first.
+     *
+     * @param accountNumber The account number of the subtree root
+     * @param out The stream that receives the report
+     * @return The number of accounts written, 0 if the account does not exist
+     */
+    size_t writeSubtree(int accountNumber, ostream &out) const;
+
+    /**
+     * @brief Writes one subtree report file per root tree, the trees on separate threads.
+     *
+     * @param directory The directory of the files, named `report_<root>.<extension>`
+     * @return The number of accounts written
+     * @throws runtime_error If a file cannot be written
+     */
+    size_t writeRootReports(const string &directory) const;
+};
+
+#endif //ADS_MIDTERM_PROJECT_REPORTGENERATOR_H
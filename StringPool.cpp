@@ -0,0 +1,204 @@
+//
+// Created on 10/14/2026.
+//
+
+/**
+ * @file StringPool.cpp
+ * @brief Implements the `StringPool` class, which interns the repeated strings of the transaction store.
+ */
+
+#include "StringPool.h"
+#include <climits>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Default constructor for the `StringPool` class.
+ */
+StringPool::StringPool() : count(0) {}
+
+/**
+ * @brief Copy constructor for the `StringPool` class.
+ *
+ * @param other The pool to copy
+ *
+ * Only the strings published when the copy starts are copied, so the source may be adding strings meanwhile. The
+ * lookup table holds views of the strings of its own pool, so it is rebuilt instead of copied.
+ */
+StringPool::StringPool(const StringPool &other) : count(0) {
+    uint32_t copied = other.count.load(memory_order_acquire);
+    for (uint32_t i = 0; i < copied; ++i) {
+        store(other.slot(i));
+    }
+    rebuildIds();
+}
+
+/**
+ * @brief Assignment operator for the `StringPool` class.
+ *
+ * @param other The pool to copy
+ * @return This pool
+ */
+StringPool &StringPool::operator=(const StringPool &other) {
+    if (this != &other) {
+        *this = StringPool(other);
+    }
+    return *this;
+}
+
+/**
+ * @brief Move constructor for the `StringPool` class.
+ *
+ * @param other The pool to move from
+ *
+ * The strings are not moved themselves, so the views in the lookup table stay valid.
+ */
+StringPool::StringPool(StringPool &&other)
+        : blocks(move(other.blocks)), count(other.count.load(memory_order_relaxed)), ids(move(other.ids)) {
+    other.count.store(0, memory_order_relaxed);
+    other.ids.clear();
+}
+
+/**
+ * @brief Move assignment operator for the `StringPool` class.
+ *
+ * @param other The pool to move from
+ * @return This pool
+ */
+StringPool &StringPool::operator=(StringPool &&other) {
+    if (this != &other) {
+        blocks = move(other.blocks);
+        count.store(other.count.load(memory_order_relaxed), memory_order_relaxed);
+        ids = move(other.ids);
+        other.count.store(0, memory_order_relaxed);
+        other.ids.clear();
+    }
+    return *this;
+}
+
+/**
+ * @brief Returns the id of a string, adding it to the pool if needed.
+ *
+ * @param text The string to intern
+ * @return The id of the string
+ * @throws length_error If the pool already holds the maximum number of strings
+ */
+uint32_t StringPool::intern(string_view text) {
+    if (text.empty()) {
+        return 0;
+    }
+    unordered_map<string_view, uint32_t>::const_iterator found = ids.find(text);
+    if (found != ids.end()) {
+        return found->second;
+    }
+    uint32_t id = store(text);
+    ids.emplace(string_view(slot(id - 1)), id);
+    return id;
+}
+
+/**
+ * @brief Stores a string without looking for an equal one.
+ *
+ * @param text The string to store
+ * @return The id of the string
+ * @throws length_error If the pool already holds the maximum number of strings
+ *
+ * The string is left out of the lookup table, so storing it costs no table entry.
+ */
+uint32_t StringPool::add(string_view text) {
+    return text.empty() ? 0 : store(text);
+}
+
+/**
+ * @brief Returns the string with the given id.
+ *
+ * @param id An id returned by `intern` or `add`
+ * @return The string
+ */
+const string &StringPool::get(uint32_t id) const {
+    static const string empty;
+    return id == 0 ? empty : slot(id - 1);
+}
+
+/**
+ * @brief Returns the number of distinct strings in the pool.
+ *
+ * @return The number of strings
+ */
+size_t StringPool::size() const {
+    return 1 + static_cast<size_t>(count.load(memory_order_acquire));
+}
+
+/**
+ * @brief Removes every string except the empty one.
+ */
+void StringPool::clear() {
+    blocks.reset();
+    count.store(0, memory_order_relaxed);
+    ids.clear();
+}
+
+/**
+ * @brief Returns the slot of a non-empty string in the blocks.
+ *
+ * @param index The id of the string minus one
+ * @return The string
+ *
+ * Block k starts at index `FIRST_BLOCK * (2^k - 1)`, so the block is the binary logarithm of
+ * `index / FIRST_BLOCK + 1`.
+ */
+string &StringPool::slot(size_t index) const {
+    uint64_t scaled = index / FIRST_BLOCK + 1;
+#if defined(__GNUC__) || defined(__clang__)
+    size_t block = 63 - static_cast<size_t>(__builtin_clzll(scaled));
+#else
+    size_t block = 0;
+    while (scaled >> (block + 1)) {
+        ++block;
+    }
+#endif
+    return blocks[block][index - FIRST_BLOCK * ((size_t(1) << block) - 1)];
+}
+
+/**
+ * @brief Stores a non-empty string after the last one.
+ *
+ * @param text The string
+ * @return The id of the string
+ * @throws length_error If the pool already holds the maximum number of strings
+ *
+ * The string is written before the count is raised with release order, so a reader that sees the new count also sees
+ * the string, and a reader holding an older id never touches the slot being written.
+ */
+uint32_t StringPool::store(string_view text) {
+    uint32_t index = count.load(memory_order_relaxed);
+    if (index >= UINT32_MAX - 1) {
+        throw length_error("String pool is full");
+    }
+    if (!blocks) {
+        blocks.reset(new unique_ptr<string[]>[MAX_BLOCKS]);
+    }
+    size_t block = 0;
+    while (index >= FIRST_BLOCK * ((size_t(2) << block) - 1)) {
+        ++block;
+    }
+    if (!blocks[block]) {
+        blocks[block].reset(new string[FIRST_BLOCK << block]);
+    }
+    slot(index).assign(text.data(), text.size());
+    count.store(index + 1, memory_order_release);
+    return index + 1;
+}
+
+/**
+ * @brief Rebuilds the lookup table from the stored strings.
+ */
+void StringPool::rebuildIds() {
+    ids.clear();
+    uint32_t stored = count.load(memory_order_relaxed);
+    ids.reserve(stored);
+    for (uint32_t i = 0; i < stored; ++i) {
+        ids.emplace(string_view(slot(i)), i + 1);
+    }
+}
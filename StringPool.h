@@ -0,0 +1,149 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_STRINGPOOL_H
+#define ADS_MIDTERM_PROJECT_STRINGPOOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using namespace std;
+
+/**
+ * @class StringPool
+ * @brief Stores every distinct string once and refers to it by a small integer.
+ *
+ * Transaction dates and descriptions repeat a lot within an account, so the columnar transaction store keeps a
+ * 32-bit reference per transaction instead of a `string`. Id 0 is always the empty string, which is not stored, so a
+ * pool allocates nothing until its first non-empty string. Strings are never removed from a pool; copying a pool copies
+ * its strings, while moving it hands them over without allocating and leaves the source empty.
+ *
+ * The strings live in blocks that double in size and are never reallocated, so a stored string never moves. A pool is
+ * shared by a transaction store and its snapshots (see `TransactionColumns::snapshot`): one thread may add strings
+ * while others read or copy the pool, as long as the readers only look up ids they obtained before.
+ */
+class StringPool {
+public:
+    /**
+     * @brief Default constructor for the `StringPool` class.
+     *
+     * Creates a pool holding only the empty string, without allocating.
+     */
+    StringPool();
+
+    /**
+     * @brief Copy constructor for the `StringPool` class.
+     *
+     * @param other The pool to copy
+     */
+    StringPool(const StringPool &other);
+
+    /**
+     * @brief Assignment operator for the `StringPool` class.
+     *
+     * @param other The pool to copy
+     * @return This pool
+     */
+    StringPool &operator=(const StringPool &other);
+
+    /**
+     * @brief Move constructor for the `StringPool` class.
+     *
+     * The strings keep their addresses, so the lookup table is moved along with them.
+     *
+     * @param other The pool to move from; it is left holding only the empty string
+     */
+    StringPool(StringPool &&other);
+
+    /**
+     * @brief Move assignment operator for the `StringPool` class.
+     *
+     * @param other The pool to move from; it is left holding only the empty string
+     * @return This pool
+     */
+    StringPool &operator=(StringPool &&other);
+
+    /**
+     * @brief Returns the id of a string, adding it to the pool if needed.
+     *
+     * @param text The string to intern
+     * @return The id of the string
+     */
+    uint32_t intern(string_view text);
+
+    /**
+     * @brief Stores a string without looking for an equal one, for strings that are not expected to repeat.
+     *
+     * @param text The string to store
+     * @return The id of the string
+     */
+    uint32_t add(string_view text);
+
+    /**
+     * @brief Returns the string with the given id.
+     *
+     * @param id An id returned by `intern`
+     * @return The string; it stays valid as long as the pool
+     */
+    const string &get(uint32_t id) const;
+
+    /**
+     * @brief Returns the number of distinct strings in the pool.
+     *
+     * @return The number of strings, including the empty string
+     */
+    size_t size() const;
+
+    /**
+     * @brief Removes every string except the empty one.
+     *
+     * Unlike the other changes, this must not run while another thread reads the pool.
+     */
+    void clear();
+
+private:
+    /**
+     * @brief The number of strings in the first block; block k holds `FIRST_BLOCK << k` strings.
+     */
+    static const size_t FIRST_BLOCK = 8;
+
+    /**
+     * @brief The number of blocks, enough for every 32-bit id.
+     */
+    static const size_t MAX_BLOCKS = 30;
+
+    unique_ptr<unique_ptr<string[]>[]> blocks; ///< The blocks of non-empty strings, id 1 first, or null while there
+                                               ///< are none; a block is allocated when the first string reaches it
+    atomic<uint32_t> count;                    ///< The number of non-empty strings, published after the string
+    unordered_map<string_view, uint32_t> ids;  ///< Id of every interned string, keyed by a view of the stored string
+
+    /**
+     * @brief Returns the slot of a non-empty string in the blocks.
+     *
+     * @param index The id of the string minus one
+     * @return The string
+     */
+    string &slot(size_t index) const;
+
+    /**
+     * @brief Stores a non-empty string after the last one.
+     *
+     * @param text The string
+     * @return The id of the string
+     * @throws length_error If the pool already holds the maximum number of strings
+     */
+    uint32_t store(string_view text);
+
+    /**
+     * @brief Rebuilds the lookup table from the stored strings.
+     */
+    void rebuildIds();
+};
+
+#endif //ADS_MIDTERM_PROJECT_STRINGPOOL_H
@@ -11,9 +11,11 @@
  */
 
 #include "Transaction.h"
+#include "TransactionIdGenerator.h"
 #include <iomanip>
 #include <ctime>
 #include <limits>
+#include <stdexcept>
 
 using namespace std;
 
@@ -23,12 +25,12 @@ using namespace std;
  *
  * Initializes the transaction with default values:
  * - transactionID: an empty string
- * - amount: 0.0
+ * - amount: 0.00
  * - debitCredit: 'D' (Debit)
  * - date: an empty string
  * - description: an empty string
  */
-Transaction::Transaction() : transactionID(""), amount(0.0), debitCredit('D'), date(""), description("") {}
+Transaction::Transaction() : transactionID(""), amount(), debitCredit('D'), date(""), description("") {}
 
 // Parameterized Constructor
 /**
@@ -44,26 +46,9 @@ Transaction::Transaction() : transactionID(""), amount(0.0), debitCredit('D'), d
  * @param desc The description of the transaction (optional, default is empty string)
  * @param dateStr The date of the transaction (optional, default is empty string)
  */
-Transaction::Transaction(const string &id, double amt, char type, const string &desc, const string &dateStr) {
-
-    transactionID = id;
-    date = dateStr;
-    description = desc;
-
-    if (amt >= 0) {
-        amount = amt;
-    } else {
-        cerr << "Amount must be non-negative. Setting to 0." << endl;
-        amount = 0.0;
-    }
-
-    if (type == 'D' || type == 'C') {
-        debitCredit = type;
-    } else {
-        cerr << "Invalid type. Defaulting to 'D' (Debit)." << endl;
-        debitCredit = 'D';
-    }
-}
+Transaction::Transaction(string id, Money amt, char type, string desc, string dateStr)
+        : transactionID(move(id)), amount(checkedAmount(amt)), debitCredit(checkedType(type)), date(move(dateStr)),
+          description(move(desc)) {}
 
 // Getters
 
@@ -72,7 +57,7 @@ Transaction::Transaction(const string &id, double amt, char type, const string &
  *
  * @return The transaction ID
  */
-string Transaction::getTransactionID() const {
+const string &Transaction::getTransactionID() const {
     return transactionID;
 }
 
@@ -81,7 +66,7 @@ string Transaction::getTransactionID() const {
  *
  * @return The transaction amount
  */
-double Transaction::getAmount() const {
+Money Transaction::getAmount() const {
     return amount;
 }
 
@@ -99,7 +84,7 @@ char Transaction::getDebitCredit() const {
  *
  * @return The transaction date
  */
-string Transaction::getDate() const {
+const string &Transaction::getDate() const {
     return date;
 }
 
@@ -108,7 +93,7 @@ string Transaction::getDate() const {
  *
  * @return The transaction description
  */
-string Transaction::getDescription() const {
+const string &Transaction::getDescription() const {
     return description;
 }
 
@@ -117,14 +102,15 @@ string Transaction::getDescription() const {
 /**
  * @brief Sets the transaction ID.
  *
+ * If the ID is empty, a new unique ID is drawn from `TransactionIdGenerator::global()`.
+ *
  * @param id The new transaction ID
  */
-void Transaction::setTransactionID(const string &id) {
+void Transaction::setTransactionID(string id) {
     if (id.empty()) {
-        time_t now = time(nullptr);
-        transactionID = "FMR" + to_string(now);
+        transactionID = TransactionIdGenerator::global().nextText();
     } else {
-        transactionID = id;
+        transactionID = move(id);
     }
 }
 
@@ -135,12 +121,12 @@ void Transaction::setTransactionID(const string &id) {
  *
  * @param amt The new transaction amount
  */
-void Transaction::setAmount(double amt) {
-    if (amt >= 0) {
+void Transaction::setAmount(Money amt) {
+    if (amt >= Money()) {
         amount = amt;
     } else {
         cerr << "Amount must be non-negative. Setting to 0." << endl;
-        amount = 0.0;
+        amount = Money();
     }
 }
 
@@ -161,14 +147,14 @@ void Transaction::setDebitCredit(char type) {
  *
  * @param dateStr The new transaction date
  */
-void Transaction::setDate(const string &dateStr) {
+void Transaction::setDate(string dateStr) {
     if (dateStr.empty()) {
         time_t now = time(nullptr);
         char buffer[11];  // DD-MM-YY\0 needs 9 chars + safety
         strftime(buffer, sizeof(buffer), "%d-%m-%y", localtime(&now));
         date = buffer;
     } else {
-        date = dateStr;
+        date = move(dateStr);
     }
 }
 
@@ -177,8 +163,8 @@ void Transaction::setDate(const string &dateStr) {
  *
  * @param desc The new transaction description
  */
-void Transaction::setDescription(const string &desc) {
-    description = desc;
+void Transaction::setDescription(string desc) {
+    description = move(desc);
 }
 
 // Validation
@@ -191,7 +177,7 @@ void Transaction::setDescription(const string &desc) {
  * @return True if the transaction is valid, false otherwise
  */
 bool Transaction::isValid() const {
-    return (debitCredit == 'D' || debitCredit == 'C') && amount >= 0;
+    return (debitCredit == 'D' || debitCredit == 'C') && amount >= Money();
 }
 
 // Apply Transaction to Balance
@@ -204,7 +190,7 @@ bool Transaction::isValid() const {
  * @param balance The balance to apply the transaction to
  * @return True if the transaction was successfully applied, false otherwise
  */
-bool Transaction::applyToBalance(double &balance) const {
+bool Transaction::applyToBalance(Money &balance) const {
     if (!isValid()) {
         cerr << "Invalid transaction. Cannot apply." << endl;
         return false;
@@ -213,6 +199,66 @@ bool Transaction::applyToBalance(double &balance) const {
     return true;
 }
 
+/**
+ * @brief Returns the amount a transaction is created with.
+ *
+ * @param amt The requested amount
+ * @return The amount, or 0 if it is negative
+ */
+Money Transaction::checkedAmount(Money amt) {
+    if (amt >= Money()) {
+        return amt;
+    }
+    cerr << "Amount must be non-negative. Setting to 0." << endl;
+    return Money();
+}
+
+/**
+ * @brief Returns the type a transaction is created with.
+ *
+ * @param type The requested type
+ * @return The type, or 'D' if it is neither 'D' nor 'C'
+ */
+char Transaction::checkedType(char type) {
+    if (type == 'D' || type == 'C') {
+        return type;
+    }
+    cerr << "Invalid type. Defaulting to 'D' (Debit)." << endl;
+    return 'D';
+}
+
+/**
+ * @brief Creates a transaction from the text fields of a record, without prompting.
+ *
+ * @param id The transaction ID, or empty for a new one
+ * @param amt The amount
+ * @param type The type, 'D' or 'C' in either case
+ * @param dateStr The date, or empty for the current date
+ * @param desc The description
+ * @return The transaction
+ * @throws invalid_argument If the amount is not a non-negative decimal or the type is neither 'D' nor 'C'
+ */
+Transaction Transaction::parse(string_view id, string_view amt, string_view type, string_view dateStr,
+                               string_view desc) {
+    Money amount = Money::parse(amt);
+    if (amount < Money()) {
+        throw invalid_argument("Amount must be non-negative: " + string(amt));
+    }
+    char debitCredit = type.size() == 1 ? static_cast<char>(toupper(static_cast<unsigned char>(type[0]))) : '\0';
+    if (debitCredit != 'D' && debitCredit != 'C') {
+        throw invalid_argument("Type must be 'D' or 'C': " + string(type));
+    }
+
+    Transaction transaction(string(id), amount, debitCredit, string(desc), string(dateStr));
+    if (id.empty()) {
+        transaction.setTransactionID("");
+    }
+    if (dateStr.empty()) {
+        transaction.setDate("");
+    }
+    return transaction;
+}
+
 // Overloaded Output Stream Operator
 
 /**
@@ -226,7 +272,7 @@ bool Transaction::applyToBalance(double &balance) const {
  */
 ostream &operator<<(ostream &os, const Transaction &transaction) {
     os << "Transaction ID: " << transaction.getTransactionID() << "\n"
-       << "Amount: " << fixed << setprecision(2) << transaction.getAmount() << "\n"
+       << "Amount: " << transaction.getAmount() << "\n"
        << "Type: " << (transaction.getDebitCredit() == 'D' ? "Debit" : "Credit") << "\n"
        << "Date: " << transaction.getDate() << "\n"
        << "Description: " << transaction.getDescription();
@@ -247,7 +293,7 @@ ostream &operator<<(ostream &os, const Transaction &transaction) {
  */
 istream &operator>>(istream &is, Transaction &transaction) {
     string description;
-    double amount;
+    Money amount;
     char debitCredit;
 
     transaction.setTransactionID("");
@@ -257,7 +303,7 @@ istream &operator>>(istream &is, Transaction &transaction) {
     while (!validAmount) {
         cout << "Enter Amount: ";
         if (is >> amount) {
-            if (amount >= 0) {
+            if (amount >= Money()) {
                 validAmount = true;
                 transaction.setAmount(amount);
             } else {
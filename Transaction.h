@@ -7,6 +7,8 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
+#include "Money.h"
 
 using namespace std;
 
@@ -21,7 +23,7 @@ using namespace std;
 class Transaction {
 private:
     string transactionID; ///< The unique identifier for the transaction
-    double amount;        ///< The amount involved in the transaction
+    Money amount;         ///< The amount involved in the transaction
     char debitCredit;     ///< The type of transaction: 'D' for debit, 'C' for credit
     string date;          ///< The date the transaction occurred
     string description;   ///< The description of the transaction
@@ -41,7 +43,7 @@ public:
      * @brief Parameterized constructor for Transaction class.
      *
      * Initializes a transaction with the specified values for transaction ID, amount, debit/credit type, description,
-     * and date.
+     * and date. The strings are taken by value, so callers can move them in.
      *
      * @param id The unique transaction ID
      * @param amt The amount involved in the transaction
@@ -49,23 +51,23 @@ public:
      * @param desc The description of the transaction (optional, default is empty string)
      * @param dateStr The date of the transaction (optional, default is empty string)
      */
-    Transaction(const string &id, double amt, char type, const string &desc = "", const string &dateStr = "");
+    Transaction(string id, Money amt, char type, string desc = "", string dateStr = "");
 
     // Getters
 
     /**
      * @brief Returns the transaction ID.
      *
-     * @return The transaction ID
+     * @return The transaction ID, valid while the transaction is not modified
      */
-    string getTransactionID() const;
+    const string &getTransactionID() const;
 
     /**
      * @brief Returns the transaction amount.
      *
      * @return The amount involved in the transaction
      */
-    double getAmount() const;
+    Money getAmount() const;
 
     /**
      * @brief Returns the type of transaction (debit or credit).
@@ -77,32 +79,34 @@ public:
     /**
      * @brief Returns the date of the transaction.
      *
-     * @return The date the transaction occurred
+     * @return The date the transaction occurred, valid while the transaction is not modified
      */
-    string getDate() const;
+    const string &getDate() const;
 
     /**
      * @brief Returns the description of the transaction.
      *
-     * @return The description of the transaction
+     * @return The description of the transaction, valid while the transaction is not modified
      */
-    string getDescription() const;
+    const string &getDescription() const;
 
     // Setters
 
     /**
      * @brief Sets the transaction ID.
      *
+     * An empty ID is replaced by a new unique ID of the form `FMR` followed by digits, see `TransactionIdGenerator`.
+     *
      * @param id The transaction ID to set
      */
-    void setTransactionID(const string &id);
+    void setTransactionID(string id);
 
     /**
      * @brief Sets the transaction amount.
      *
      * @param amt The amount to set
      */
-    void setAmount(double amt);
+    void setAmount(Money amt);
 
     /**
      * @brief Sets the type of transaction (debit or credit).
@@ -116,14 +120,14 @@ public:
      *
      * @param dateStr The date to set
      */
-    void setDate(const string &dateStr);
+    void setDate(string dateStr);
 
     /**
      * @brief Sets the description of the transaction.
      *
      * @param desc The description to set
      */
-    void setDescription(const string &desc);
+    void setDescription(string desc);
 
     // Validation
 
@@ -144,7 +148,45 @@ public:
      * @param balance The balance to apply the transaction to
      * @return True if the transaction was successfully applied, false otherwise
      */
-    bool applyToBalance(double &balance) const;
+    bool applyToBalance(Money &balance) const;
+
+    /**
+     * @brief Returns the amount a transaction is created with.
+     *
+     * Negative amounts are replaced by 0, with a message, as done by the constructor.
+     *
+     * @param amt The requested amount
+     * @return The amount to use
+     */
+    static Money checkedAmount(Money amt);
+
+    /**
+     * @brief Returns the type a transaction is created with.
+     *
+     * Types other than 'D' and 'C' are replaced by 'D', with a message, as done by the constructor.
+     *
+     * @param type The requested type
+     * @return The type to use
+     */
+    static char checkedType(char type);
+
+    /**
+     * @brief Creates a transaction from the text fields of a record, without prompting.
+     *
+     * The non-interactive counterpart of `operator>>`: an empty ID is replaced by a new unique ID and an empty date
+     * by the current date, as when a transaction is entered by hand, but invalid fields are rejected instead of
+     * asked for again.
+     *
+     * @param id The transaction ID, or empty for a new one
+     * @param amt The amount, a non-negative decimal
+     * @param type The type, 'D' or 'C' in either case
+     * @param dateStr The date, or empty for the current date
+     * @param desc The description
+     * @return The transaction
+     * @throws invalid_argument If the amount or the type is invalid
+     */
+    static Transaction parse(string_view id, string_view amt, string_view type, string_view dateStr,
+                             string_view desc);
 };
 
 // Operators
@@ -0,0 +1,751 @@
+//
+// Created on 10/14/2026.
+//
+
+/**
+ * @file TransactionColumns.cpp
+ * @brief Implements the `TransactionColumns` class, the columnar transaction store of an account.
+ */
+
+#include "TransactionColumns.h"
+#include "ForestMetrics.h"
+#include "TransactionIdGenerator.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Default constructor for the `TransactionColumns` class.
+ */
+TransactionColumns::TransactionColumns() : slots(0), tombstones(0), isSnapshot(false) {}
+
+/**
+ * @brief Copy constructor for the `TransactionColumns` class.
+ *
+ * @param other The store to copy
+ *
+ * The copy starts out as a snapshot of the source and detaches from it at once.
+ */
+TransactionColumns::TransactionColumns(const TransactionColumns &other)
+        : segments(other.segments), strings(other.strings), slots(other.slots), tombstones(other.tombstones),
+          isSnapshot(true) {
+    detach();
+}
+
+/**
+ * @brief Assignment operator for the `TransactionColumns` class.
+ *
+ * @param other The store to copy
+ * @return This store
+ */
+TransactionColumns &TransactionColumns::operator=(const TransactionColumns &other) {
+    if (this != &other) {
+        *this = TransactionColumns(other);
+    }
+    return *this;
+}
+
+/**
+ * @brief Move constructor for the `TransactionColumns` class.
+ *
+ * @param other The store to move from
+ */
+TransactionColumns::TransactionColumns(TransactionColumns &&other) noexcept
+        : segments(move(other.segments)), strings(move(other.strings)), slots(other.slots),
+          tombstones(other.tombstones), isSnapshot(other.isSnapshot) {
+    other.clear();
+}
+
+/**
+ * @brief Move assignment operator for the `TransactionColumns` class.
+ *
+ * @param other The store to move from
+ * @return This store
+ */
+TransactionColumns &TransactionColumns::operator=(TransactionColumns &&other) noexcept {
+    if (this != &other) {
+        segments = move(other.segments);
+        strings = move(other.strings);
+        slots = other.slots;
+        tombstones = other.tombstones;
+        isSnapshot = other.isSnapshot;
+        other.clear();
+    }
+    return *this;
+}
+
+/**
+ * @brief Takes a read-only copy of the store in constant time per segment.
+ *
+ * @return The snapshot
+ *
+ * Appending writes only slots past the ones the snapshot sees and strings past the ones it refers to, and every other
+ * change copies a shared segment first, so the store never writes anything the snapshot reads.
+ */
+TransactionColumns TransactionColumns::snapshot() const {
+    TransactionColumns copy;
+    copy.segments = segments;
+    copy.strings = strings;
+    copy.slots = slots;
+    copy.tombstones = tombstones;
+    copy.isSnapshot = true;
+    return copy;
+}
+
+/**
+ * @brief Converts a date to a sortable `yyyymmdd` integer.
+ *
+ * @param date The date text
+ * @return The date as `yyyymmdd`, or 0 if the text is not a date
+ *
+ * The text must be three groups of digits separated by `-` or `/`. A first group of four digits is read as the year
+ * (`YYYY-MM-DD`); otherwise the groups are read as day, month and year.
+ */
+int32_t TransactionColumns::parseDateKey(string_view date) {
+    int parts[3] = {0, 0, 0};
+    size_t digits[3] = {0, 0, 0};
+    size_t part = 0;
+
+    for (char c: date) {
+        if (c >= '0' && c <= '9') {
+            if (digits[part] == 4) {
+                return 0;
+            }
+            parts[part] = parts[part] * 10 + (c - '0');
+            ++digits[part];
+        } else if ((c == '-' || c == '/') && part < 2 && digits[part] > 0) {
+            ++part;
+        } else {
+            return 0;
+        }
+    }
+    if (part != 2 || digits[2] == 0) {
+        return 0;
+    }
+
+    int year, month, day;
+    if (digits[0] == 4) {
+        year = parts[0];
+        month = parts[1];
+        day = parts[2];
+    } else {
+        day = parts[0];
+        month = parts[1];
+        year = digits[2] == 2 ? 2000 + parts[2] : parts[2];
+        if (digits[2] != 2 && digits[2] != 4) {
+            return 0;
+        }
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31) {
+        return 0;
+    }
+    return year * 10000 + month * 100 + day;
+}
+
+/**
+ * @brief Returns the number of live transactions.
+ *
+ * @return The number of transactions that are not deleted
+ */
+size_t TransactionColumns::size() const {
+    return slots - tombstones;
+}
+
+/**
+ * @brief Returns the number of slots, live or deleted.
+ *
+ * @return The number of slots
+ */
+size_t TransactionColumns::slotCount() const {
+    return slots;
+}
+
+/**
+ * @brief Returns the number of deleted slots waiting for `compact`.
+ *
+ * @return The number of deleted slots
+ */
+size_t TransactionColumns::deletedCount() const {
+    return tombstones;
+}
+
+/**
+ * @brief Checks whether a slot holds a deleted transaction.
+ *
+ * @param slot The slot
+ * @return True if the transaction of the slot was removed, false otherwise
+ */
+bool TransactionColumns::isDeleted(size_t slot) const {
+    return tombstones != 0 && ((deletedWord(slot / 64) >> (slot % 64)) & 1);
+}
+
+/**
+ * @brief Returns the slot of a live transaction.
+ *
+ * @param index The position of the transaction among the live ones
+ * @return The slot of the transaction
+ *
+ * Whole words of the deletion bitmap are skipped by counting their live bits, then the slot is found within its word.
+ */
+size_t TransactionColumns::slotOf(size_t index) const {
+    if (tombstones == 0) {
+        return index;
+    }
+    size_t remaining = index;
+    for (size_t word = 0; word * 64 < slots; ++word) {
+        size_t end = slots - word * 64 < 64 ? slots - word * 64 : 64;
+        uint64_t live = ~deletedWord(word) & (end == 64 ? ~uint64_t(0) : (uint64_t(1) << end) - 1);
+        size_t count = countBits(live);
+        if (remaining >= count) {
+            remaining -= count;
+            continue;
+        }
+        for (size_t bit = 0;; ++bit) {
+            if ((live >> bit) & 1) {
+                if (remaining == 0) {
+                    return word * 64 + bit;
+                }
+                --remaining;
+            }
+        }
+    }
+    return slots;
+}
+
+/**
+ * @brief Returns the position of a live transaction among the live ones.
+ *
+ * @param slot The slot of the transaction
+ * @return The index of the transaction
+ */
+size_t TransactionColumns::indexOf(size_t slot) const {
+    if (tombstones == 0) {
+        return slot;
+    }
+    size_t deleted = 0;
+    for (size_t word = 0; word < slot / 64; ++word) {
+        deleted += countBits(deletedWord(word));
+    }
+    if (slot % 64 != 0) {
+        deleted += countBits(deletedWord(slot / 64) & ((uint64_t(1) << (slot % 64)) - 1));
+    }
+    return slot - deleted;
+}
+
+/**
+ * @brief Checks whether the store holds no transaction.
+ *
+ * @return True if there is no live transaction, false otherwise
+ */
+bool TransactionColumns::empty() const {
+    return size() == 0;
+}
+
+/**
+ * @brief Reserves room for the given number of transactions in every column.
+ *
+ * @param count The number of transactions to make room for
+ *
+ * Only the first segment grows step by step, so it is the only one allocated ahead; the list of segments is reserved
+ * for the rest.
+ */
+void TransactionColumns::reserve(size_t count) {
+    if (count <= slots) {
+        return;
+    }
+    detach();
+    segments.reserve((count + SEGMENT_SIZE - 1) / SEGMENT_SIZE);
+    size_t capacity = min(count, SEGMENT_SIZE);
+    if (segments.empty()) {
+        segments.push_back(make_shared<Segment>(nullptr, 0, capacity));
+        ADS_METRICS_COUNT(COLUMN_GROWTHS, 1);
+    } else if (segments.size() == 1 && segments[0]->capacity < capacity) {
+        segments[0] = make_shared<Segment>(segments[0].get(), slots, capacity);
+        ADS_METRICS_COUNT(COLUMN_GROWTHS, 1);
+    }
+}
+
+/**
+ * @brief Appends a transaction.
+ *
+ * @param t The transaction to append
+ * @throws length_error If the string pool of the account is full
+ */
+void TransactionColumns::push(const Transaction &t) {
+    emplace(t.getTransactionID(), t.getAmount(), t.getDebitCredit(), t.getDescription(), t.getDate());
+}
+
+/**
+ * @brief Appends a transaction given by its fields.
+ *
+ * @param id The transaction ID
+ * @param amount The amount
+ * @param type The debit/credit type
+ * @param description The description
+ * @param date The date text
+ * @throws length_error If the string pool of the account is full
+ *
+ * The fields are copied straight into the columns, so no `Transaction` or temporary string is built. The strings are
+ * pooled first, so a full pool leaves the store unchanged.
+ */
+void TransactionColumns::emplace(string_view id, Money amount, char type, string_view description, string_view date) {
+    uint64_t number = 0;
+    if (TransactionIdGenerator::parse(id, number)) {
+        id = string_view();
+    }
+    detach();
+    StringPool &pool = this->pool();
+    uint32_t dateRef = pool.intern(date);
+    uint32_t descriptionRef = pool.intern(description);
+    uint32_t idRef = pool.add(id);
+
+    Segment &segment = appendable();
+    size_t offset = slots % SEGMENT_SIZE;
+    segment.amounts[offset] = amount.getUnits();
+    segment.types[offset] = type == 'D' || type == 'C' ? type : '?';
+    segment.dates[offset] = parseDateKey(date);
+    segment.dateRefs[offset] = dateRef;
+    segment.descriptionRefs[offset] = descriptionRef;
+    segment.idNumbers[offset] = number;
+    segment.idRefs[offset] = idRef;
+    ++slots;
+}
+
+/**
+ * @brief Builds the transaction in the given slot.
+ *
+ * @param slot The slot of the transaction
+ * @return The transaction
+ */
+Transaction TransactionColumns::get(size_t slot) const {
+    char type = getDebitCredit(slot);
+    Transaction t(getTransactionID(slot), getAmount(slot), type == '?' ? 'D' : type,
+                  getDescription(slot), getDate(slot));
+    if (type == '?') {
+        t.setDebitCredit(type);
+    }
+    return t;
+}
+
+/**
+ * @brief Replaces the transaction in the given slot.
+ *
+ * @param slot The slot of the transaction
+ * @param t The new transaction
+ * @throws length_error If the string pool of the account is full
+ *
+ * The text of the old transaction stays in the pool.
+ */
+void TransactionColumns::set(size_t slot, const Transaction &t) {
+    string_view id = t.getTransactionID();
+    uint64_t number = 0;
+    if (TransactionIdGenerator::parse(id, number)) {
+        id = string_view();
+    }
+    detach();
+    StringPool &pool = this->pool();
+    const string &date = t.getDate();
+    uint32_t dateRef = pool.intern(date);
+    uint32_t descriptionRef = pool.intern(t.getDescription());
+    uint32_t idRef = pool.add(id);
+
+    Segment &segment = writable(slot);
+    size_t offset = slot % SEGMENT_SIZE;
+    char type = t.getDebitCredit();
+    segment.amounts[offset] = t.getAmount().getUnits();
+    segment.types[offset] = type == 'D' || type == 'C' ? type : '?';
+    segment.dates[offset] = parseDateKey(date);
+    segment.dateRefs[offset] = dateRef;
+    segment.descriptionRefs[offset] = descriptionRef;
+    segment.idNumbers[offset] = number;
+    segment.idRefs[offset] = idRef;
+}
+
+/**
+ * @brief Removes the transaction in the given slot by marking the slot as deleted.
+ *
+ * @param slot The slot of the transaction
+ *
+ * Nothing is moved, so this takes constant time and the slots of the other transactions do not change; at most the
+ * segment of the slot is copied, if a snapshot shares it.
+ */
+void TransactionColumns::remove(size_t slot) {
+    if ((deletedWord(slot / 64) >> (slot % 64)) & 1) {
+        return;
+    }
+    detach();
+    Segment &segment = writable(slot);
+    size_t offset = slot % SEGMENT_SIZE;
+    segment.deletedBits[offset / 64] |= uint64_t(1) << (offset % 64);
+    segment.types[offset] = '?';
+    ++tombstones;
+}
+
+/**
+ * @brief Drops every deleted slot, keeping the order of the live transactions.
+ *
+ * The live transactions are copied into new segments in one pass over the slots, so snapshots keep the old ones. The
+ * pooled text of the dropped transactions stays in the pool.
+ */
+void TransactionColumns::compact() {
+    if (tombstones == 0) {
+        return;
+    }
+    detach();
+    TransactionColumns kept;
+    kept.reserve(slots - tombstones);
+    for (size_t slot = 0; slot < slots; ++slot) {
+        if (isDeleted(slot)) {
+            continue;
+        }
+        const Segment &from = segmentOf(slot);
+        size_t offset = slot % SEGMENT_SIZE;
+        Segment &to = kept.appendable();
+        size_t at = kept.slots % SEGMENT_SIZE;
+        to.amounts[at] = from.amounts[offset];
+        to.types[at] = from.types[offset];
+        to.dates[at] = from.dates[offset];
+        to.dateRefs[at] = from.dateRefs[offset];
+        to.descriptionRefs[at] = from.descriptionRefs[offset];
+        to.idNumbers[at] = from.idNumbers[offset];
+        to.idRefs[at] = from.idRefs[offset];
+        ++kept.slots;
+    }
+    segments.swap(kept.segments);
+    slots = kept.slots;
+    tombstones = 0;
+}
+
+/**
+ * @brief Removes every transaction.
+ */
+void TransactionColumns::clear() {
+    segments.clear();
+    strings.reset();
+    slots = 0;
+    tombstones = 0;
+    isSnapshot = false;
+}
+
+/**
+ * @brief Returns the date of a transaction as a sortable integer.
+ *
+ * @param slot The slot of the transaction
+ * @return The date as `yyyymmdd`, or 0 when unknown
+ */
+int32_t TransactionColumns::getDateKey(size_t slot) const {
+    return segmentOf(slot).dates[slot % SEGMENT_SIZE];
+}
+
+/**
+ * @brief Returns the amount of a transaction.
+ *
+ * @param slot The slot of the transaction
+ * @return The amount
+ */
+Money TransactionColumns::getAmount(size_t slot) const {
+    return Money::fromUnits(segmentOf(slot).amounts[slot % SEGMENT_SIZE]);
+}
+
+/**
+ * @brief Returns the debit/credit type of a transaction.
+ *
+ * @param slot The slot of the transaction
+ * @return 'D' for debit, 'C' for credit, or '?' for another type or a deleted slot
+ */
+char TransactionColumns::getDebitCredit(size_t slot) const {
+    return segmentOf(slot).types[slot % SEGMENT_SIZE];
+}
+
+/**
+ * @brief Returns the ID of a transaction.
+ *
+ * @param slot The slot of the transaction
+ * @return The ID, rebuilt from its number if it was stored as one
+ */
+string TransactionColumns::getTransactionID(size_t slot) const {
+    uint64_t number = getTransactionNumber(slot);
+    if (number != 0) {
+        return TransactionIdGenerator::format(number);
+    }
+    return idText(slot);
+}
+
+/**
+ * @brief Returns the number of a transaction ID stored as a number.
+ *
+ * @param slot The slot of the transaction
+ * @return The number, or 0 if the ID is stored as text
+ */
+uint64_t TransactionColumns::getTransactionNumber(size_t slot) const {
+    return segmentOf(slot).idNumbers[slot % SEGMENT_SIZE];
+}
+
+/**
+ * @brief Checks whether a transaction has the given ID, without building its ID.
+ *
+ * @param slot The slot of the transaction
+ * @param id The ID to compare with
+ * @return True if the transaction has the ID, false otherwise
+ */
+bool TransactionColumns::hasTransactionID(size_t slot, string_view id) const {
+    uint64_t stored = getTransactionNumber(slot);
+    if (stored != 0) {
+        uint64_t number = 0;
+        return TransactionIdGenerator::parse(id, number) && number == stored;
+    }
+    return idText(slot) == id;
+}
+
+/**
+ * @brief Returns the hash key of the ID of a transaction.
+ *
+ * @param slot The slot of the transaction
+ * @return The key, equal to `keyOf` of the ID
+ */
+uint64_t TransactionColumns::getTransactionKey(size_t slot) const {
+    uint64_t number = getTransactionNumber(slot);
+    if (number != 0) {
+        return number;
+    }
+    return hash<string_view>()(idText(slot));
+}
+
+/**
+ * @brief Returns the hash key of a transaction ID.
+ *
+ * @param id The ID
+ * @return The number of the ID if it has the form of generated IDs, or a hash of its text otherwise
+ */
+uint64_t TransactionColumns::keyOf(string_view id) {
+    uint64_t number = 0;
+    if (TransactionIdGenerator::parse(id, number)) {
+        return number;
+    }
+    return hash<string_view>()(id);
+}
+
+/**
+ * @brief Returns the date text of a transaction without copying it.
+ *
+ * @param slot The slot of the transaction
+ * @return The date as it was recorded
+ */
+const string &TransactionColumns::getDate(size_t slot) const {
+    return strings->get(segmentOf(slot).dateRefs[slot % SEGMENT_SIZE]);
+}
+
+/**
+ * @brief Returns the description of a transaction without copying it.
+ *
+ * @param slot The slot of the transaction
+ * @return The description
+ */
+const string &TransactionColumns::getDescription(size_t slot) const {
+    return strings->get(segmentOf(slot).descriptionRefs[slot % SEGMENT_SIZE]);
+}
+
+/**
+ * @brief Computes the net effect of all live transactions on the balance.
+ *
+ * @return The sum of the debits minus the sum of the credits
+ *
+ * The sign of every amount is taken from its type without branching, so the loop over a segment only reads two
+ * columns and can be vectorized. Deleted slots have type '?' and add nothing.
+ */
+Money TransactionColumns::netAmount() const {
+    long long total = 0;
+    for (size_t index = 0; index < segments.size(); ++index) {
+        const long long *amount = segments[index]->amounts.get();
+        const char *type = segments[index]->types.get();
+        size_t used = usedIn(index);
+        for (size_t i = 0; i < used; ++i) {
+            long long sign = static_cast<long long>(type[i] == 'D') - static_cast<long long>(type[i] == 'C');
+            total += sign * amount[i];
+        }
+    }
+    return Money::fromUnits(total);
+}
+
+/**
+ * @brief Computes the net effect of the transactions dated within a range.
+ *
+ * @param fromDate The first date of the range, as `yyyymmdd`
+ * @param toDate The last date of the range, as `yyyymmdd`
+ * @return The sum of the debits minus the sum of the credits in the range
+ */
+Money TransactionColumns::netAmount(int32_t fromDate, int32_t toDate) const {
+    long long total = 0;
+    for (size_t index = 0; index < segments.size(); ++index) {
+        const long long *amount = segments[index]->amounts.get();
+        const char *type = segments[index]->types.get();
+        const int32_t *date = segments[index]->dates.get();
+        size_t used = usedIn(index);
+        for (size_t i = 0; i < used; ++i) {
+            long long sign = static_cast<long long>(type[i] == 'D') - static_cast<long long>(type[i] == 'C');
+            long long inRange = date[i] != 0 && date[i] >= fromDate && date[i] <= toDate;
+            total += sign * inRange * amount[i];
+        }
+    }
+    return Money::fromUnits(total);
+}
+
+/**
+ * @brief Allocates the columns of a segment, copying the first slots of another one.
+ *
+ * @param source The segment to copy from, or nullptr
+ * @param used The number of slots to copy
+ * @param capacity The number of slots to allocate
+ */
+TransactionColumns::Segment::Segment(const Segment *source, size_t used, size_t capacity)
+        : capacity(capacity), amounts(new long long[capacity]), types(new char[capacity]),
+          deletedBits(new uint64_t[(capacity + 63) / 64]()), dates(new int32_t[capacity]),
+          dateRefs(new uint32_t[capacity]), descriptionRefs(new uint32_t[capacity]),
+          idNumbers(new uint64_t[capacity]), idRefs(new uint32_t[capacity]) {
+    if (!source || used == 0 || used > capacity) {
+        return;
+    }
+    copy_n(source->amounts.get(), used, amounts.get());
+    copy_n(source->types.get(), used, types.get());
+    copy_n(source->deletedBits.get(), (used + 63) / 64, deletedBits.get());
+    copy_n(source->dates.get(), used, dates.get());
+    copy_n(source->dateRefs.get(), used, dateRefs.get());
+    copy_n(source->descriptionRefs.get(), used, descriptionRefs.get());
+    copy_n(source->idNumbers.get(), used, idNumbers.get());
+    copy_n(source->idRefs.get(), used, idRefs.get());
+}
+
+/**
+ * @brief Gives a snapshot its own last segment and string pool, before it is changed.
+ *
+ * The full segments stay shared; `writable` copies them when needed.
+ */
+void TransactionColumns::detach() {
+    if (!isSnapshot) {
+        return;
+    }
+    if (strings) {
+        strings = make_shared<StringPool>(*strings);
+    }
+    if (!segments.empty() && usedIn(segments.size() - 1) < SEGMENT_SIZE) {
+        const Segment &tail = *segments.back();
+        segments.back() = make_shared<Segment>(&tail, usedIn(segments.size() - 1), tail.capacity);
+    }
+    isSnapshot = false;
+}
+
+/**
+ * @brief Returns the segment holding a slot.
+ *
+ * @param slot The slot
+ * @return The segment
+ */
+const TransactionColumns::Segment &TransactionColumns::segmentOf(size_t slot) const {
+    return *segments[slot / SEGMENT_SIZE];
+}
+
+/**
+ * @brief Returns the segment holding a slot for writing, copying it first if another store shares it.
+ *
+ * @param slot The slot
+ * @return The segment
+ *
+ * A store that finds itself the only owner may write at once, but the last other owner may have read the segment
+ * just before it let go of it; the acquire fence orders those reads before the writes that follow.
+ */
+TransactionColumns::Segment &TransactionColumns::writable(size_t slot) {
+    size_t index = slot / SEGMENT_SIZE;
+    shared_ptr<Segment> &segment = segments[index];
+    if (segment.use_count() > 1) {
+        const Segment &shared = *segment;
+        segment = make_shared<Segment>(&shared, usedIn(index), shared.capacity);
+    } else {
+        atomic_thread_fence(memory_order_acquire);
+    }
+    return *segment;
+}
+
+/**
+ * @brief Returns the segment that receives the next slot, allocating or growing it if it is full.
+ *
+ * @return The last segment
+ *
+ * A growing first segment is copied into a new allocation, so a snapshot still reading the old one is not disturbed.
+ */
+TransactionColumns::Segment &TransactionColumns::appendable() {
+    if (slots == segments.size() * SEGMENT_SIZE) {
+        segments.push_back(make_shared<Segment>(nullptr, 0, segments.empty() ? FIRST_SEGMENT : SEGMENT_SIZE));
+        ADS_METRICS_COUNT(COLUMN_GROWTHS, 1);
+    } else if (usedIn(segments.size() - 1) == segments.back()->capacity) {
+        const Segment &tail = *segments.back();
+        segments.back() = make_shared<Segment>(&tail, tail.capacity, min(tail.capacity * 2, SEGMENT_SIZE));
+        ADS_METRICS_COUNT(COLUMN_GROWTHS, 1);
+    }
+    return *segments.back();
+}
+
+/**
+ * @brief Returns the number of slots used in a segment.
+ *
+ * @param index The position of the segment
+ * @return The number of slots
+ */
+size_t TransactionColumns::usedIn(size_t index) const {
+    return min(slots - index * SEGMENT_SIZE, SEGMENT_SIZE);
+}
+
+/**
+ * @brief Returns the string pool, creating it if needed.
+ *
+ * @return The pool
+ */
+StringPool &TransactionColumns::pool() {
+    if (!strings) {
+        strings = make_shared<StringPool>();
+    }
+    return *strings;
+}
+
+/**
+ * @brief Returns a word of the deletion bitmap.
+ *
+ * @param word The position of the word
+ * @return The word
+ *
+ * `SEGMENT_SIZE` is a multiple of 64, so a word never spans two segments.
+ */
+uint64_t TransactionColumns::deletedWord(size_t word) const {
+    size_t slot = word * 64;
+    return segments[slot / SEGMENT_SIZE]->deletedBits[slot % SEGMENT_SIZE / 64];
+}
+
+/**
+ * @brief Counts the set bits of a bitmap word.
+ *
+ * @param word The word
+ * @return The number of set bits
+ */
+size_t TransactionColumns::countBits(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_popcountll(word));
+#else
+    size_t count = 0;
+    for (; word != 0; word &= word - 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+/**
+ * @brief Returns the ID of a transaction stored as text, without copying it.
+ *
+ * @param slot The slot of the transaction
+ * @return The text, empty if the ID is stored as a number
+ */
+const string &TransactionColumns::idText(size_t slot) const {
+    return strings->get(segmentOf(slot).idRefs[slot % SEGMENT_SIZE]);
+}
@@ -0,0 +1,531 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_TRANSACTIONCOLUMNS_H
+#define ADS_MIDTERM_PROJECT_TRANSACTIONCOLUMNS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Money.h"
+#include "StringPool.h"
+#include "Transaction.h"
+
+using namespace std;
+
+/**
+ * @class TransactionColumns
+ * @brief Stores the transactions of one account as a structure of arrays.
+ *
+ * Instead of a `vector<Transaction>` with three heap strings per element, every field lives in its own column: the
+ * amounts as `Money` units, the debit/credit types as one byte each, the dates both as `yyyymmdd` integers and as
+ * pooled text, the descriptions as pooled text and the IDs as 64-bit numbers, or, for IDs that do not have the form of
+ * generated IDs (see `TransactionIdGenerator`), as pooled text. Scans and sums over the amounts and dates touch only
+ * the arrays they need, with no pointer chasing, so the compiler can vectorize them. `Transaction` objects are only
+ * built when a caller asks for one.
+ *
+ * The columns are cut into segments of `SEGMENT_SIZE` slots. The first segment starts small and is reallocated as it
+ * doubles; every later one is allocated at full size. Slots are only ever appended behind the last one, so a slot that
+ * is written stays where it is, and a segment shared with another store is copied before one of its slots is removed
+ * or replaced. `snapshot` relies on this to share the whole history of an account for one pointer per segment.
+ *
+ * Transactions are stored in slots. Removing a transaction only marks its slot as deleted, so no column is shifted and
+ * the slots of the other transactions stay valid until `compact` drops the deleted ones. The index of a transaction,
+ * its position among the live transactions as seen through `TransactionView`, equals its slot while no slot is
+ * deleted; `slotOf` and `indexOf` convert between the two.
+ */
+class TransactionColumns {
+public:
+    /**
+     * @brief The number of slots per segment, a multiple of 64.
+     */
+    static constexpr size_t SEGMENT_SIZE = 256;
+
+    /**
+     * @brief Default constructor for the `TransactionColumns` class.
+     *
+     * Creates an empty store.
+     */
+    TransactionColumns();
+
+    /**
+     * @brief Copy constructor for the `TransactionColumns` class.
+     *
+     * The full segments are shared with the source until either store changes one of their slots; the last segment
+     * and the string pool are copied, so the copy is independent of the source.
+     *
+     * @param other The store to copy
+     */
+    TransactionColumns(const TransactionColumns &other);
+
+    /**
+     * @brief Assignment operator for the `TransactionColumns` class.
+     *
+     * @param other The store to copy
+     * @return This store
+     */
+    TransactionColumns &operator=(const TransactionColumns &other);
+
+    /**
+     * @brief Move constructor for the `TransactionColumns` class.
+     *
+     * @param other The store to move from; it is left empty
+     */
+    TransactionColumns(TransactionColumns &&other) noexcept;
+
+    /**
+     * @brief Move assignment operator for the `TransactionColumns` class.
+     *
+     * @param other The store to move from; it is left empty
+     * @return This store
+     */
+    TransactionColumns &operator=(TransactionColumns &&other) noexcept;
+
+    /**
+     * @brief Takes a read-only copy of the store in constant time per segment.
+     *
+     * The snapshot shares every segment and the string pool with this store and only records how many slots it sees.
+     * It keeps its contents while this store appends, removes, replaces or compacts, even from another thread, as long
+     * as this store is not changed during the call. Changing the snapshot itself copies what it shares first.
+     *
+     * @return The snapshot
+     */
+    TransactionColumns snapshot() const;
+
+    /**
+     * @brief Converts a date to a sortable `yyyymmdd` integer.
+     *
+     * Accepts `YYYY-MM-DD`, `DD-MM-YYYY` and `DD-MM-YY` (as written by `Transaction::setDate`), with `-` or `/` as
+     * separator. Two-digit years are in the 2000s.
+     *
+     * @param date The date text
+     * @return The date as `yyyymmdd`, or 0 if the text is not a date
+     */
+    static int32_t parseDateKey(string_view date);
+
+    /**
+     * @brief Returns the number of live transactions.
+     *
+     * @return The number of transactions that are not deleted
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the number of slots, live or deleted.
+     *
+     * @return The number of slots
+     */
+    size_t slotCount() const;
+
+    /**
+     * @brief Returns the number of deleted slots waiting for `compact`.
+     *
+     * @return The number of deleted slots
+     */
+    size_t deletedCount() const;
+
+    /**
+     * @brief Checks whether a slot holds a deleted transaction.
+     *
+     * @param slot The slot, which must be valid
+     * @return True if the transaction of the slot was removed, false otherwise
+     */
+    bool isDeleted(size_t slot) const;
+
+    /**
+     * @brief Returns the slot of a live transaction.
+     *
+     * @param index The position of the transaction among the live ones, which must be valid
+     * @return The slot of the transaction
+     */
+    size_t slotOf(size_t index) const;
+
+    /**
+     * @brief Returns the position of a live transaction among the live ones.
+     *
+     * @param slot The slot of the transaction, which must be live
+     * @return The index of the transaction
+     */
+    size_t indexOf(size_t slot) const;
+
+    /**
+     * @brief Checks whether the store holds no transaction.
+     *
+     * @return True if there is no transaction, false otherwise
+     */
+    bool empty() const;
+
+    /**
+     * @brief Reserves room for the given number of transactions in every column.
+     *
+     * @param count The number of transactions to make room for
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Appends a transaction in a new slot.
+     *
+     * @param t The transaction to append
+     */
+    void push(const Transaction &t);
+
+    /**
+     * @brief Appends a transaction given by its fields, without building a `Transaction`.
+     *
+     * The fields are used as they are; see `Account::emplaceTransaction` for the checks done on them.
+     *
+     * @param id The transaction ID
+     * @param amount The amount
+     * @param type The debit/credit type
+     * @param description The description
+     * @param date The date text
+     */
+    void emplace(string_view id, Money amount, char type, string_view description, string_view date);
+
+    /**
+     * @brief Builds the transaction in the given slot.
+     *
+     * @param slot The slot of the transaction, which must be valid
+     * @return The transaction
+     */
+    Transaction get(size_t slot) const;
+
+    /**
+     * @brief Replaces the transaction in the given slot.
+     *
+     * @param slot The slot of the transaction, which must be live
+     * @param t The new transaction
+     */
+    void set(size_t slot, const Transaction &t);
+
+    /**
+     * @brief Removes the transaction in the given slot by marking the slot as deleted.
+     *
+     * The type of the slot is cleared, so scans and sums skip it without checking.
+     *
+     * @param slot The slot of the transaction, which must be valid
+     */
+    void remove(size_t slot);
+
+    /**
+     * @brief Drops every deleted slot, keeping the order of the live transactions.
+     *
+     * The slots of the live transactions become equal to their indexes again.
+     */
+    void compact();
+
+    /**
+     * @brief Removes every transaction.
+     */
+    void clear();
+
+    // Column access
+
+    /**
+     * @brief Returns the date of a transaction as a sortable integer.
+     *
+     * @param slot The slot of the transaction
+     * @return The date as `yyyymmdd`, or 0 when unknown
+     */
+    int32_t getDateKey(size_t slot) const;
+
+    /**
+     * @brief Returns the amount of a transaction.
+     *
+     * @param slot The slot of the transaction
+     * @return The amount
+     */
+    Money getAmount(size_t slot) const;
+
+    /**
+     * @brief Returns the debit/credit type of a transaction.
+     *
+     * @param slot The slot of the transaction
+     * @return 'D' for debit, 'C' for credit, or '?' for another type or a deleted slot
+     */
+    char getDebitCredit(size_t slot) const;
+
+    /**
+     * @brief Returns the ID of a transaction.
+     *
+     * @param slot The slot of the transaction
+     * @return The ID, rebuilt from its number if it was stored as one
+     */
+    string getTransactionID(size_t slot) const;
+
+    /**
+     * @brief Returns the number of a transaction ID stored as a number.
+     *
+     * @param slot The slot of the transaction
+     * @return The number, or 0 if the ID is stored as text
+     */
+    uint64_t getTransactionNumber(size_t slot) const;
+
+    /**
+     * @brief Checks whether a transaction has the given ID, without building its ID.
+     *
+     * @param slot The slot of the transaction
+     * @param id The ID to compare with
+     * @return True if the transaction has the ID, false otherwise
+     */
+    bool hasTransactionID(size_t slot, string_view id) const;
+
+    /**
+     * @brief Returns the hash key of the ID of a transaction, without building its ID.
+     *
+     * @param slot The slot of the transaction
+     * @return The key, equal to `keyOf` of the ID
+     */
+    uint64_t getTransactionKey(size_t slot) const;
+
+    /**
+     * @brief Returns the hash key of a transaction ID.
+     *
+     * Different IDs may share a key, so a key only narrows down the transactions that can have an ID.
+     *
+     * @param id The ID
+     * @return The number of the ID if it has the form of generated IDs, or a hash of its text otherwise
+     */
+    static uint64_t keyOf(string_view id);
+
+    /**
+     * @brief Returns the date text of a transaction without copying it.
+     *
+     * @param slot The slot of the transaction
+     * @return The date as it was recorded
+     */
+    const string &getDate(size_t slot) const;
+
+    /**
+     * @brief Returns the description of a transaction without copying it.
+     *
+     * @param slot The slot of the transaction
+     * @return The description
+     */
+    const string &getDescription(size_t slot) const;
+
+    // Aggregations
+
+    /**
+     * @brief Computes the net effect of all live transactions on the balance.
+     *
+     * @return The sum of the debits minus the sum of the credits
+     */
+    Money netAmount() const;
+
+    /**
+     * @brief Computes the net effect of the transactions dated within a range.
+     *
+     * Transactions without a known date are left out.
+     *
+     * @param fromDate The first date of the range, as `yyyymmdd`
+     * @param toDate The last date of the range, as `yyyymmdd`
+     * @return The sum of the debits minus the sum of the credits in the range
+     */
+    Money netAmount(int32_t fromDate, int32_t toDate) const;
+
+private:
+    /**
+     * @brief The initial capacity of the first segment.
+     */
+    static constexpr size_t FIRST_SEGMENT = 4;
+
+    /**
+     * @brief The columns of up to `SEGMENT_SIZE` consecutive slots.
+     */
+    struct Segment {
+        size_t capacity;                        ///< The number of slots the arrays hold
+        unique_ptr<long long[]> amounts;        ///< Amount of every transaction, in `Money` units
+        unique_ptr<char[]> types;               ///< 'D' or 'C' for debits and credits, '?' otherwise and when deleted
+        unique_ptr<uint64_t[]> deletedBits;     ///< Bit i is set if slot i was removed
+        unique_ptr<int32_t[]> dates;            ///< Date of every transaction as `yyyymmdd`, or 0
+        unique_ptr<uint32_t[]> dateRefs;        ///< Pooled text of every date
+        unique_ptr<uint32_t[]> descriptionRefs; ///< Pooled text of every description
+        unique_ptr<uint64_t[]> idNumbers;       ///< ID of every transaction as a number, or 0 if it is stored as text
+        unique_ptr<uint32_t[]> idRefs;          ///< Pooled text of every ID stored as text, or 0
+
+        /**
+         * @brief Allocates the columns of a segment, copying the first slots of another one.
+         *
+         * @param source The segment to copy from, or nullptr
+         * @param used The number of slots to copy
+         * @param capacity The number of slots to allocate, at least `used`
+         */
+        Segment(const Segment *source, size_t used, size_t capacity);
+    };
+
+    vector<shared_ptr<Segment>> segments; ///< The segments; every one but the last holds `SEGMENT_SIZE` slots
+    shared_ptr<StringPool> strings;       ///< Pool of the dates, descriptions and text IDs, null until the first slot
+    size_t slots;                         ///< Number of slots, live or deleted
+    size_t tombstones;                    ///< Number of deleted slots
+    bool isSnapshot;                      ///< True while the last segment and the pool may still be written by the
+                                          ///< store this one is a snapshot of
+
+    /**
+     * @brief Gives a snapshot its own last segment and string pool, before it is changed.
+     */
+    void detach();
+
+    /**
+     * @brief Returns the segment holding a slot.
+     *
+     * @param slot The slot
+     * @return The segment
+     */
+    const Segment &segmentOf(size_t slot) const;
+
+    /**
+     * @brief Returns the segment holding a slot for writing, copying it first if another store shares it.
+     *
+     * @param slot The slot
+     * @return The segment, owned by this store alone
+     */
+    Segment &writable(size_t slot);
+
+    /**
+     * @brief Returns the segment that receives the next slot, allocating or growing it if it is full.
+     *
+     * @return The last segment, with room for one more slot
+     */
+    Segment &appendable();
+
+    /**
+     * @brief Returns the number of slots used in a segment.
+     *
+     * @param index The position of the segment
+     * @return The number of slots
+     */
+    size_t usedIn(size_t index) const;
+
+    /**
+     * @brief Returns the string pool, creating it if needed.
+     *
+     * @return The pool, owned by this store alone once `detach` was called
+     */
+    StringPool &pool();
+
+    /**
+     * @brief Returns a word of the deletion bitmap.
+     *
+     * @param word The position of the word, covering slots `64 * word` to `64 * word + 63`
+     * @return The word
+     */
+    uint64_t deletedWord(size_t word) const;
+
+    /**
+     * @brief Counts the set bits of a bitmap word.
+     *
+     * @param word The word
+     * @return The number of set bits
+     */
+    static size_t countBits(uint64_t word);
+
+    /**
+     * @brief Returns the ID of a transaction stored as text, without copying it.
+     *
+     * @param slot The slot of the transaction
+     * @return The text, empty if the ID is stored as a number
+     */
+    const string &idText(size_t slot) const;
+};
+
+/**
+ * @class TransactionView
+ * @brief Read-only view of the transactions of an account.
+ *
+ * Returned by `Account::getTransactions`. It can be indexed and iterated like the `vector<Transaction>` it replaces,
+ * in which case every element is built on the fly and deleted slots are skipped, or used through the column accessors
+ * of the underlying `TransactionColumns`, which copy nothing and work on slots. A view is invalidated by any change to
+ * the transactions of its account.
+ */
+class TransactionView {
+public:
+    /**
+     * @brief Iterator over the transactions of a view, yielding them by value.
+     */
+    class const_iterator {
+    public:
+        typedef input_iterator_tag iterator_category;
+        typedef Transaction value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const Transaction *pointer;
+        typedef Transaction reference;
+
+        const_iterator(const TransactionColumns *columns, size_t slot) : columns(columns), slot(slot) { skipDeleted(); }
+        Transaction operator*() const { return columns->get(slot); }
+        const_iterator &operator++() { ++slot; skipDeleted(); return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++*this; return old; }
+        bool operator==(const const_iterator &other) const { return slot == other.slot; }
+        bool operator!=(const const_iterator &other) const { return slot != other.slot; }
+
+    private:
+        const TransactionColumns *columns; ///< The viewed store
+        size_t slot;                       ///< Slot of the current transaction
+
+        void skipDeleted() {
+            while (slot < columns->slotCount() && columns->isDeleted(slot)) {
+                ++slot;
+            }
+        }
+    };
+
+    /**
+     * @brief Creates a view of a transaction store.
+     *
+     * @param columns The store to view; it must outlive the view
+     */
+    explicit TransactionView(const TransactionColumns &columns) : columns(&columns) {}
+
+    /**
+     * @brief Returns the number of transactions.
+     *
+     * @return The number of transactions
+     */
+    size_t size() const { return columns->size(); }
+
+    /**
+     * @brief Checks whether the view holds no transaction.
+     *
+     * @return True if there is no transaction, false otherwise
+     */
+    bool empty() const { return columns->empty(); }
+
+    /**
+     * @brief Builds the transaction at the given position.
+     *
+     * @param index The position of the transaction, which must be valid
+     * @return The transaction
+     */
+    Transaction operator[](size_t index) const { return columns->get(columns->slotOf(index)); }
+
+    /**
+     * @brief Returns an iterator to the first transaction.
+     *
+     * @return The iterator
+     */
+    const_iterator begin() const { return const_iterator(columns, 0); }
+
+    /**
+     * @brief Returns an iterator past the last transaction.
+     *
+     * @return The iterator
+     */
+    const_iterator end() const { return const_iterator(columns, columns->slotCount()); }
+
+    /**
+     * @brief Returns the columns behind the view, for scans that must not build `Transaction` objects.
+     *
+     * @return The transaction store
+     */
+    const TransactionColumns &getColumns() const { return *columns; }
+
+private:
+    const TransactionColumns *columns; ///< The viewed store
+};
+
+#endif //ADS_MIDTERM_PROJECT_TRANSACTIONCOLUMNS_H
@@ -0,0 +1,178 @@
+//
+// Created on 10/14/2026.
+//
+
+/**
+ * @file TransactionIdGenerator.cpp
+ * @brief Implements the `TransactionIdGenerator` class, the lock-free generator of transaction IDs.
+ */
+
+#include "TransactionIdGenerator.h"
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+    /**
+     * @brief Reads the node ID of the global generator from the environment.
+     *
+     * Two nodes that fell back to the same ID would draw colliding IDs, so a value that is set but invalid is an error.
+     *
+     * @return The value of `ADS_NODE_ID`, or 0 if it is not set
+     * @throws invalid_argument If the value is not a decimal number from 0 to `MAX_NODE_ID`
+     */
+    uint32_t nodeIdFromEnvironment() {
+        const char *value = getenv("ADS_NODE_ID");
+        if (value == nullptr || *value == '\0') {
+            return 0;
+        }
+        char *end = nullptr;
+        unsigned long nodeId = isdigit(static_cast<unsigned char>(*value)) ? strtoul(value, &end, 10) : 0;
+        if (end == nullptr || *end != '\0' || nodeId > TransactionIdGenerator::MAX_NODE_ID) {
+            throw invalid_argument("ADS_NODE_ID must be a node ID from 0 to " +
+                                   to_string(TransactionIdGenerator::MAX_NODE_ID) + ", not \"" + value + "\"");
+        }
+        return static_cast<uint32_t>(nodeId);
+    }
+}
+
+/**
+ * @brief Creates a generator for the given node.
+ *
+ * @param nodeId The ID of the node
+ * @throws invalid_argument If the node ID is larger than `MAX_NODE_ID`
+ */
+TransactionIdGenerator::TransactionIdGenerator(uint32_t nodeId)
+        : nodeField(static_cast<uint64_t>(nodeId) << SEQUENCE_BITS), state(0) {
+    if (nodeId > MAX_NODE_ID) {
+        throw invalid_argument("Node ID " + to_string(nodeId) + " is larger than " + to_string(MAX_NODE_ID));
+    }
+}
+
+/**
+ * @brief Returns the generator used for new transactions.
+ *
+ * @return The process-wide generator
+ * @throws invalid_argument If `ADS_NODE_ID` is set but not a valid node ID; the next call reads it again
+ */
+TransactionIdGenerator &TransactionIdGenerator::global() {
+    static TransactionIdGenerator generator(nodeIdFromEnvironment());
+    return generator;
+}
+
+/**
+ * @brief Draws a new ID.
+ *
+ * @return The new ID
+ *
+ * The next state is the current time with sequence 0, or the last state plus one if the clock has not moved past it,
+ * so the states, and with them the IDs, strictly increase even if the clock goes backwards.
+ */
+uint64_t TransactionIdGenerator::next() {
+    uint64_t current = now() << SEQUENCE_BITS;
+    uint64_t last = state.load(memory_order_relaxed);
+    uint64_t drawn;
+    do {
+        drawn = current > last ? current : last + 1;
+    } while (!state.compare_exchange_weak(last, drawn, memory_order_relaxed));
+
+    uint64_t time = drawn >> SEQUENCE_BITS;
+    uint64_t sequence = drawn & ((uint64_t(1) << SEQUENCE_BITS) - 1);
+    return (time << (NODE_BITS + SEQUENCE_BITS)) | nodeField | sequence;
+}
+
+/**
+ * @brief Draws a new ID in its text form.
+ *
+ * @return The text form of the new ID
+ */
+string TransactionIdGenerator::nextText() {
+    return format(next());
+}
+
+/**
+ * @brief Returns the node ID of the generator.
+ *
+ * @return The node ID
+ */
+uint32_t TransactionIdGenerator::getNodeId() const {
+    return static_cast<uint32_t>(nodeField >> SEQUENCE_BITS);
+}
+
+/**
+ * @brief Writes an ID in its text form.
+ *
+ * @param id The ID
+ * @return The text form of the ID
+ */
+string TransactionIdGenerator::format(uint64_t id) {
+    char digits[20];
+    size_t length = 0;
+    do {
+        digits[length++] = static_cast<char>('0' + id % 10);
+        id /= 10;
+    } while (id != 0);
+
+    size_t prefixLength = strlen(PREFIX);
+    string text(prefixLength + length, '\0');
+    memcpy(&text[0], PREFIX, prefixLength);
+    for (size_t i = 0; i < length; ++i) {
+        text[prefixLength + i] = digits[length - 1 - i];
+    }
+    return text;
+}
+
+/**
+ * @brief Reads an ID from its text form.
+ *
+ * @param text The text
+ * @param id Receives the ID
+ * @return True if the text is the text form of an ID, false otherwise
+ */
+bool TransactionIdGenerator::parse(string_view text, uint64_t &id) {
+    size_t prefixLength = strlen(PREFIX);
+    if (text.size() <= prefixLength || text.size() > prefixLength + 20 ||
+        text.compare(0, prefixLength, PREFIX) != 0 || text[prefixLength] == '0') {
+        return false;
+    }
+
+    uint64_t value = 0;
+    for (size_t i = prefixLength; i < text.size(); ++i) {
+        char c = text[i];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        uint64_t digit = static_cast<uint64_t>(c - '0');
+        if (value > (UINT64_MAX - digit) / 10) {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+    id = value;
+    return true;
+}
+
+/**
+ * @brief Returns the time an ID was drawn at.
+ *
+ * @param id An ID drawn by a generator
+ * @return The milliseconds since the Unix epoch
+ */
+uint64_t TransactionIdGenerator::timestampOf(uint64_t id) {
+    return (id >> (NODE_BITS + SEQUENCE_BITS)) + EPOCH_MS;
+}
+
+/**
+ * @brief Returns the current time.
+ *
+ * @return The milliseconds since `EPOCH_MS`
+ */
+uint64_t TransactionIdGenerator::now() {
+    uint64_t unixMs = static_cast<uint64_t>(chrono::duration_cast<chrono::milliseconds>(
+            chrono::system_clock::now().time_since_epoch()).count());
+    return unixMs > EPOCH_MS ? unixMs - EPOCH_MS : 0;
+}
@@ -0,0 +1,136 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_TRANSACTIONIDGENERATOR_H
+#define ADS_MIDTERM_PROJECT_TRANSACTIONIDGENERATOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+/**
+ * @class TransactionIdGenerator
+ * @brief Lock-free generator of unique, time-ordered 64-bit transaction IDs.
+ *
+ * @details Every ID packs, from the most significant bit down, the milliseconds since `EPOCH_MS` (42 bits), the ID
+ * of the generating node (`NODE_BITS`) and a sequence number within the millisecond (`SEQUENCE_BITS`). The time and
+ * sequence live together in one atomic word that is advanced with compare-and-swap, so any number of threads draw
+ * IDs without a lock, and the IDs of one node are strictly increasing. When more than 4096 IDs are drawn within one
+ * millisecond the sequence carries into the time field, borrowing from the next millisecond instead of waiting for
+ * it; the clock catches up as soon as the burst ends.
+ *
+ * IDs are written as `FMR` followed by the number in decimal, which keeps the format of the IDs made by earlier
+ * versions of the program, and `TransactionColumns` stores any ID of that form as the bare number.
+ */
+class TransactionIdGenerator {
+public:
+    /**
+     * @brief The prefix of the text form of an ID.
+     */
+    static constexpr const char *PREFIX = "FMR";
+
+    /**
+     * @brief The start of the time field, 2024-01-01 00:00:00 UTC, in milliseconds since the Unix epoch.
+     */
+    static const uint64_t EPOCH_MS = 1704067200000ULL;
+
+    /**
+     * @brief The number of bits of the node ID.
+     */
+    static const int NODE_BITS = 10;
+
+    /**
+     * @brief The number of bits of the sequence number.
+     */
+    static const int SEQUENCE_BITS = 12;
+
+    /**
+     * @brief The largest valid node ID.
+     */
+    static const uint32_t MAX_NODE_ID = (1u << NODE_BITS) - 1;
+
+    /**
+     * @brief Creates a generator for the given node.
+     *
+     * @param nodeId The ID of the node, which keeps the IDs of processes sharing the same data apart
+     * @throws invalid_argument If the node ID is larger than `MAX_NODE_ID`
+     */
+    explicit TransactionIdGenerator(uint32_t nodeId = 0);
+
+    /**
+     * @brief Returns the generator used for new transactions.
+     *
+     * @details Its node ID is read from the `ADS_NODE_ID` environment variable when it is first used, and is 0 if the
+     * variable is not set. An invalid value is refused rather than replaced by 0, which another node may use.
+     *
+     * @return The process-wide generator
+     * @throws invalid_argument If `ADS_NODE_ID` is set but not a decimal number from 0 to `MAX_NODE_ID`
+     */
+    static TransactionIdGenerator &global();
+
+    /**
+     * @brief Draws a new ID.
+     *
+     * @return An ID larger than every ID this generator returned before, never 0
+     */
+    uint64_t next();
+
+    /**
+     * @brief Draws a new ID in its text form.
+     *
+     * @return The text form of the new ID
+     */
+    string nextText();
+
+    /**
+     * @brief Returns the node ID of the generator.
+     *
+     * @return The node ID
+     */
+    uint32_t getNodeId() const;
+
+    /**
+     * @brief Writes an ID in its text form.
+     *
+     * @param id The ID
+     * @return `PREFIX` followed by the ID in decimal
+     */
+    static string format(uint64_t id);
+
+    /**
+     * @brief Reads an ID from its text form.
+     *
+     * @details Only the exact text `format` produces is accepted: `PREFIX` followed by a nonzero decimal number
+     * without leading zeros that fits 64 bits. IDs read this way do not need to come from a generator.
+     *
+     * @param text The text
+     * @param id Receives the ID
+     * @return True if the text is the text form of an ID, false otherwise
+     */
+    static bool parse(string_view text, uint64_t &id);
+
+    /**
+     * @brief Returns the time an ID was drawn at.
+     *
+     * @param id An ID drawn by a generator
+     * @return The milliseconds since the Unix epoch
+     */
+    static uint64_t timestampOf(uint64_t id);
+
+private:
+    const uint64_t nodeField;  ///< The node ID, shifted into place
+    atomic<uint64_t> state;    ///< Time and sequence of the last ID drawn, as `time << SEQUENCE_BITS | sequence`
+
+    /**
+     * @brief Returns the current time.
+     *
+     * @return The milliseconds since `EPOCH_MS`
+     */
+    static uint64_t now();
+};
+
+#endif //ADS_MIDTERM_PROJECT_TRANSACTIONIDGENERATOR_H
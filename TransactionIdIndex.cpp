@@ -0,0 +1,91 @@
+//
+// Created on 10/14/2026.
+//
+
+/**
+ * @file TransactionIdIndex.cpp
+ * @brief Implements the `TransactionIdIndex` class, the hash index from transaction ID to transaction location.
+ */
+
+#include "TransactionIdIndex.h"
+
+using namespace std;
+
+/**
+ * @brief Default constructor for the `TransactionIdIndex` class.
+ */
+TransactionIdIndex::TransactionIdIndex() {}
+
+/**
+ * @brief Adds the location of a transaction.
+ *
+ * @param node The node of the account holding it
+ * @param slot Its slot in the account's transaction store
+ */
+void TransactionIdIndex::add(NodePtr node, size_t slot) {
+    locations.emplace(keyOf(node, slot), TransactionLocation{node, slot});
+}
+
+/**
+ * @brief Finds a transaction by its ID.
+ *
+ * @param id The ID to search for
+ * @param location Receives the location of a transaction with that ID
+ * @return True if a transaction with the ID is indexed, false otherwise
+ */
+bool TransactionIdIndex::find(string_view id, TransactionLocation &location) const {
+    auto range = locations.equal_range(TransactionColumns::keyOf(id));
+    for (auto it = range.first; it != range.second; ++it) {
+        const TransactionLocation &candidate = it->second;
+        if (candidate.node->getData().getTransactions().getColumns().hasTransactionID(candidate.slot, id)) {
+            location = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Removes the entry of one transaction.
+ *
+ * @param node The node of the account holding it
+ * @param slot Its slot in the account's transaction store
+ * @return True if the entry was found and removed, false otherwise
+ */
+bool TransactionIdIndex::remove(NodePtr node, size_t slot) {
+    auto range = locations.equal_range(keyOf(node, slot));
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second.node == node && it->second.slot == slot) {
+            locations.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Returns the number of indexed transactions.
+ *
+ * @return The number of entries
+ */
+size_t TransactionIdIndex::size() const {
+    return locations.size();
+}
+
+/**
+ * @brief Removes every entry.
+ */
+void TransactionIdIndex::clear() {
+    locations.clear();
+}
+
+/**
+ * @brief Returns the key of the ID of an indexed transaction.
+ *
+ * @param node The node of the account holding it
+ * @param slot Its slot in the account's transaction store
+ * @return The key
+ */
+uint64_t TransactionIdIndex::keyOf(NodePtr node, size_t slot) {
+    return node->getData().getTransactions().getColumns().getTransactionKey(slot);
+}
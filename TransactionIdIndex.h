@@ -0,0 +1,97 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_TRANSACTIONIDINDEX_H
+#define ADS_MIDTERM_PROJECT_TRANSACTIONIDINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "TreeNode.h"
+
+using namespace std;
+
+/**
+ * @brief Where a transaction is stored: its account's node and its slot in the account's `TransactionColumns`.
+ */
+struct TransactionLocation {
+    NodePtr node; ///< The node of the account holding the transaction
+    size_t slot;  ///< The slot of the transaction in the account's transaction store
+};
+
+/**
+ * @class TransactionIdIndex
+ * @brief Hash index from transaction ID to the account and slot holding the transaction.
+ *
+ * Lets a transaction be found and removed by its ID in constant time, without scanning any history. Slots stay valid
+ * while transactions are removed, since removal only marks a slot as deleted; the entries of an account must be
+ * removed and added again when its transaction store is compacted. Several transactions may share an ID, in which
+ * case each has its own entry.
+ *
+ * Entries are keyed by `TransactionColumns::getTransactionKey`, the number of a generated ID or a hash of any other
+ * ID, so the index holds no strings; a lookup checks the candidates of a key against the ID in their store.
+ */
+class TransactionIdIndex {
+public:
+    /**
+     * @brief Default constructor for the `TransactionIdIndex` class.
+     *
+     * Creates an empty index.
+     */
+    TransactionIdIndex();
+
+    /**
+     * @brief Adds the location of a transaction.
+     *
+     * @param node The node of the account holding it
+     * @param slot Its slot in the account's transaction store
+     */
+    void add(NodePtr node, size_t slot);
+
+    /**
+     * @brief Finds a transaction by its ID.
+     *
+     * @param id The ID to search for
+     * @param location Receives the location of a transaction with that ID
+     * @return True if a transaction with the ID is indexed, false otherwise
+     */
+    bool find(string_view id, TransactionLocation &location) const;
+
+    /**
+     * @brief Removes the entry of one transaction.
+     *
+     * @param node The node of the account holding it
+     * @param slot Its slot in the account's transaction store, whose ID must not have changed since it was added
+     * @return True if the entry was found and removed, false otherwise
+     */
+    bool remove(NodePtr node, size_t slot);
+
+    /**
+     * @brief Returns the number of indexed transactions.
+     *
+     * @return The number of entries
+     */
+    size_t size() const;
+
+    /**
+     * @brief Removes every entry.
+     */
+    void clear();
+
+private:
+    unordered_multimap<uint64_t, TransactionLocation> locations; ///< Location of every transaction, by ID key
+
+    /**
+     * @brief Returns the key of the ID of an indexed transaction.
+     *
+     * @param node The node of the account holding it
+     * @param slot Its slot in the account's transaction store
+     * @return The key
+     */
+    static uint64_t keyOf(NodePtr node, size_t slot);
+};
+
+#endif //ADS_MIDTERM_PROJECT_TRANSACTIONIDINDEX_H
@@ -0,0 +1,618 @@
+//
+// Created on 10/14/2026.
+//
+
+/**
+ * @file TransactionJournal.cpp
+ * @brief Implements the `TransactionJournal` class, the write-ahead log of chart changes.
+ *
+ * Each change appends a single sequenced record, so the disk I/O of a change no longer depends on the size of the
+ * chart or of the transaction history. Commits are grouped: one leader writes and syncs every buffered record while
+ * the other committing threads wait for it. With asynchronous commits, a background writer thread does that work
+ * instead, fed by a lock-free queue.
+ */
+
+#include "TransactionJournal.h"
+#include "ForestMetrics.h"
+#include <map>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Default constructor for the `TransactionJournal` class.
+ *
+ * The journal starts closed, with durable commits and a group size of 32 records.
+ */
+TransactionJournal::TransactionJournal()
+        : buffered(0), groupSize(32), durable(true), writing(false), async(false), stopping(false),
+          writtenSequence(0), syncedSequence(0), lastSequence(0), queueing(false), sleeping(false), failedFrom(0) {}
+
+/**
+ * @brief Destructor for the `TransactionJournal` class.
+ *
+ * Buffered records are written and synced before the file is closed.
+ */
+TransactionJournal::~TransactionJournal() {
+    close();
+}
+
+/**
+ * @brief Opens the journal file for appending.
+ *
+ * Any previously opened journal is flushed and closed first, and an earlier write failure is cleared. With
+ * asynchronous commits, the writer thread is started.
+ *
+ * @param filename The path of the journal file
+ * @param sequence The sequence number of the last record already in the file or in the data files
+ * @return True if the file was opened, false otherwise
+ */
+bool TransactionJournal::open(const string &filename, uint64_t sequence) {
+    close();
+    lock_guard<mutex> guard(lock);
+    if (!file.open(filename)) {
+        return false;
+    }
+    path = filename;
+    lastSequence = sequence;
+    writtenSequence = syncedSequence = sequence;
+    failedFrom = 0;
+    failure.clear();
+    if (async) {
+        startWriter();
+    }
+    return true;
+}
+
+/**
+ * @brief Writes and syncs buffered records and closes the journal file.
+ *
+ * A failure to write is reported on the error stream, since the journal is closed anyway, and so are the futures of
+ * records that were never synced.
+ */
+void TransactionJournal::close() {
+    try {
+        flush();
+    } catch (const exception &e) {
+        cerr << "Warning: " << e.what() << endl;
+    }
+    stopWriter();
+    unique_lock<mutex> guard(lock);
+    written.wait(guard, [this]() { return !writing; });
+    for (pair<uint64_t, promise<void>> &waiter: waiters) {
+        waiter.second.set_exception(make_exception_ptr(runtime_error("Transaction journal closed: " + path)));
+    }
+    waiters.clear();
+    file.close();
+    path.clear();
+    buffer.clear();
+    buffered = 0;
+    failedFrom = 0;
+    failure.clear();
+}
+
+/**
+ * @brief Checks whether the journal file is open.
+ *
+ * @return True if the journal is open, false otherwise
+ */
+bool TransactionJournal::isOpen() const {
+    lock_guard<mutex> guard(lock);
+    return file.isOpen();
+}
+
+/**
+ * @brief Returns the path of the journal file.
+ *
+ * @return The path of the journal file, or an empty string if it is closed
+ */
+const string &TransactionJournal::getPath() const {
+    return path;
+}
+
+/**
+ * @brief Returns the sequence number of the last appended record.
+ *
+ * @return The sequence number
+ */
+uint64_t TransactionJournal::getLastSequence() const {
+    lock_guard<mutex> guard(lock);
+    return lastSequence;
+}
+
+/**
+ * @brief Sets how many records are written together when commits are not durable.
+ *
+ * @param size The new group size
+ */
+void TransactionJournal::setGroupSize(size_t size) {
+    lock_guard<mutex> guard(lock);
+    groupSize = size;
+}
+
+/**
+ * @brief Sets whether `commit` waits until its record is on stable storage.
+ *
+ * @param enabled True for durable commits
+ */
+void TransactionJournal::setDurable(bool enabled) {
+    lock_guard<mutex> guard(lock);
+    durable = enabled;
+}
+
+/**
+ * @brief Checks whether commits are durable.
+ *
+ * @return True if `commit` syncs, false otherwise
+ */
+bool TransactionJournal::isDurable() const {
+    lock_guard<mutex> guard(lock);
+    return durable;
+}
+
+/**
+ * @brief Sets whether commits are handed to a background writer thread instead of waiting.
+ *
+ * @param enabled True for asynchronous commits
+ * @throws runtime_error If the pending records cannot be written
+ */
+void TransactionJournal::setAsync(bool enabled) {
+    flush();
+    if (!enabled) {
+        stopWriter();
+    }
+    lock_guard<mutex> guard(lock);
+    async = enabled;
+    if (async && file.isOpen() && !queueing) {
+        startWriter();
+    }
+}
+
+/**
+ * @brief Checks whether commits are asynchronous.
+ *
+ * @return True if a writer thread writes the records, false otherwise
+ */
+bool TransactionJournal::isAsync() const {
+    lock_guard<mutex> guard(lock);
+    return async;
+}
+
+/**
+ * @brief Appends a posted transaction.
+ *
+ * The record uses the transactions file format after the sequence number.
+ *
+ * @param accountNumber The account the transaction was posted to
+ * @param t The posted transaction
+ * @return The sequence number of the record, 0 if the journal is closed
+ */
+uint64_t TransactionJournal::appendTransaction(int accountNumber, const Transaction &t) {
+    string fields = "|" + to_string(accountNumber) + "|" + t.getTransactionID() + "|" + t.getAmount().toString() +
+                    "|" + t.getDebitCredit() + "|" + t.getDate() + "|" + t.getDescription();
+    return append('P', fields);
+}
+
+/**
+ * @brief Appends a deleted transaction.
+ *
+ * The transaction ID is kept next to the index so a replay can check it removes the right transaction, and the amount
+ * and type let a replay reverse the balance change even when the transaction itself is already gone from the data
+ * files.
+ *
+ * @param accountNumber The account the transaction was deleted from
+ * @param transactionIndex The index of the deleted transaction
+ * @param t The deleted transaction
+ * @return The sequence number of the record, 0 if the journal is closed
+ */
+uint64_t TransactionJournal::appendTombstone(int accountNumber, int transactionIndex, const Transaction &t) {
+    string fields = "|" + to_string(accountNumber) + "|" + to_string(transactionIndex) + "|" +
+                    t.getTransactionID() + "|" + t.getAmount().toString() + "|" + t.getDebitCredit();
+    return append('X', fields);
+}
+
+/**
+ * @brief Appends an added account.
+ *
+ * @param accountNumber The account number
+ * @param description The description of the account
+ * @param balance The opening balance
+ * @return The sequence number of the record, 0 if the journal is closed
+ */
+uint64_t TransactionJournal::appendAccount(int accountNumber, const string &description, Money balance) {
+    return append('A', "|" + to_string(accountNumber) + "|" + balance.toString() + "|" + description);
+}
+
+/**
+ * @brief Appends the balances a save is about to write to the data files.
+ *
+ * @param balances The account numbers and their current balances
+ * @return The sequence number of the record, 0 if the journal is closed
+ */
+uint64_t TransactionJournal::appendBalances(const vector<pair<int, Money>> &balances) {
+    return append('B', balanceFields(balances));
+}
+
+/**
+ * @brief Adds a record to the buffer under the next sequence number.
+ *
+ * While the writer thread runs, the record is queued for it without taking the lock, which is only taken to wake the
+ * writer thread when it sleeps.
+ *
+ * @param type The record type
+ * @param fields The fields after the sequence number
+ * @return The sequence number of the record, 0 if the journal is closed and has not failed
+ */
+uint64_t TransactionJournal::append(char type, const string &fields) {
+    if (queueing) {
+        uint64_t sequence = ++lastSequence;
+        string record;
+        record.reserve(fields.size() + 24);
+        record += type;
+        record += '|';
+        record += to_string(sequence);
+        record += fields;
+        record += '\n';
+        pending.push(make_pair(sequence, move(record)));
+        ADS_METRICS_COUNT(JOURNAL_RECORDS, 1);
+        if (sleeping) {
+            lock_guard<mutex> guard(lock);
+            wake.notify_one();
+        }
+        return sequence;
+    }
+
+    lock_guard<mutex> guard(lock);
+    if (!file.isOpen() && failedFrom == 0) {
+        return 0;
+    }
+    uint64_t sequence = ++lastSequence;
+    buffer += type;
+    buffer += '|';
+    buffer += to_string(sequence);
+    buffer += fields;
+    buffer += '\n';
+    ++buffered;
+    ADS_METRICS_COUNT(JOURNAL_RECORDS, 1);
+    return sequence;
+}
+
+/**
+ * @brief Makes an appended record durable, sharing the write and the sync with concurrent commits.
+ *
+ * With durable commits this returns once the record is synced. With asynchronous commits it returns immediately and
+ * the writer thread syncs the record, unless an earlier write of the writer thread failed, in which case it throws.
+ * Otherwise the buffer is only written once a full group of records is pending, and nothing is synced.
+ *
+ * @param sequence The sequence number of the record; 0 does nothing
+ * @throws runtime_error If the record cannot be written or synced, or an earlier write failed
+ */
+void TransactionJournal::commit(uint64_t sequence) {
+    if (sequence == 0 || (queueing && failedFrom == 0)) {
+        return;
+    }
+    unique_lock<mutex> guard(lock);
+    if (failedFrom != 0) {
+        throw runtime_error("Unable to write transaction journal: " + failure);
+    }
+    if (durable) {
+        writeThrough(guard, sequence, true);
+    } else if (buffered >= groupSize) {
+        writeThrough(guard, lastSequence, false);
+    }
+}
+
+/**
+ * @brief Writes and syncs every appended record.
+ *
+ * @throws runtime_error If the journal file cannot be written or synced, or an earlier write failed
+ */
+void TransactionJournal::flush() {
+    unique_lock<mutex> guard(lock);
+    if (queueing) {
+        waitForWriter(guard, lastSequence);
+        return;
+    }
+    writeThrough(guard, lastSequence, true);
+}
+
+/**
+ * @brief Returns a future that is ready once a record is on stable storage.
+ *
+ * @param sequence The sequence number of the record; 0 gives a ready future
+ * @return The future
+ */
+future<void> TransactionJournal::whenSynced(uint64_t sequence) {
+    promise<void> waiter;
+    future<void> result = waiter.get_future();
+    lock_guard<mutex> guard(lock);
+    if (!file.isOpen() && failedFrom == 0) {
+        waiter.set_value();
+        return result;
+    }
+    waiters.emplace_back(sequence, move(waiter));
+    resolveWaiters();
+    return result;
+}
+
+/**
+ * @brief Replaces the journal with a single checkpoint record.
+ *
+ * Records still in the buffer are dropped: the data files already hold their changes. Records queued for the writer
+ * thread are written to the old journal first, so its sequence stays in step. The new journal is written with
+ * `DurableFile::replace`, so a crash leaves either the old journal, which replays onto the new data files without
+ * applying anything twice, or the checkpoint. The old journal stays open until the checkpoint has replaced it, and
+ * is reopened if it had to be closed, so a failed checkpoint leaves the old journal in use; the failure is sticky like
+ * a failed write, see `fail`. Since the data files hold every change, an earlier write failure no longer loses
+ * anything and is cleared once the checkpoint succeeds.
+ *
+ * @param balances The balances that are not in the data files yet
+ * @throws runtime_error If the journal file cannot be replaced or reopened
+ */
+void TransactionJournal::checkpoint(const vector<pair<int, Money>> &balances) {
+    unique_lock<mutex> guard(lock);
+    written.wait(guard, [this]() { return !writing && (!queueing || writtenSequence >= lastSequence); });
+    if (!file.isOpen()) {
+        return;
+    }
+#ifdef _WIN32
+    // Windows cannot rename over an open file
+    file.close();
+#endif
+    DurableFile reopened;
+    try {
+        DurableFile::replace(path, "K|" + to_string(lastSequence) + balanceFields(balances) + "\n");
+        if (!reopened.open(path)) {
+            throw runtime_error("Unable to reopen transaction journal: " + path);
+        }
+    } catch (const exception &e) {
+        if (!file.isOpen()) {
+            file.open(path);
+        }
+        fail(e.what());
+        resolveWaiters();
+        written.notify_all();
+        throw;
+    }
+    file.swap(reopened);
+    buffer.clear();
+    buffered = 0;
+    writtenSequence = syncedSequence = lastSequence;
+    failedFrom = 0;
+    failure.clear();
+    resolveWaiters();
+    written.notify_all();
+}
+
+/**
+ * @brief Writes the buffer until a record is written, or synced, taking turns with other writing threads.
+ *
+ * One thread at a time is the leader: it takes the whole buffer, writes and syncs it without holding the lock, so
+ * more records can be appended meanwhile, and wakes every waiting thread. A waiting thread whose record the batch
+ * covered returns; the others elect the next leader among themselves. Once a write failed, nothing more is written
+ * and every record from the first unsynced one on fails, see `fail`.
+ *
+ * @param guard The held lock of the journal
+ * @param sequence The record to wait for
+ * @param sync True to wait until the record is synced
+ * @throws runtime_error If a write failed before the record was synced
+ */
+void TransactionJournal::writeThrough(unique_lock<mutex> &guard, uint64_t sequence, bool sync) {
+    while (true) {
+        if (failedFrom != 0 && sequence >= failedFrom) {
+            throw runtime_error("Unable to write transaction journal: " + failure);
+        }
+        if (!file.isOpen() || (sync ? syncedSequence : writtenSequence) >= sequence) {
+            return;
+        }
+        if (writing) {
+            written.wait(guard);
+            continue;
+        }
+
+        writing = true;
+        string batch;
+        batch.swap(buffer);
+        buffered = 0;
+        uint64_t last = lastSequence;
+        guard.unlock();
+
+        string error;
+        try {
+            if (!batch.empty()) {
+                file.append(batch);
+            }
+            if (sync) {
+                file.sync();
+            }
+        } catch (const exception &e) {
+            error = e.what();
+        }
+
+        guard.lock();
+        writing = false;
+        if (error.empty()) {
+            writtenSequence = last;
+            if (sync) {
+                syncedSequence = last;
+                ADS_METRICS_COUNT(JOURNAL_SYNCS, 1);
+            }
+        } else {
+            fail(error);
+            writtenSequence = last;
+        }
+        resolveWaiters();
+        written.notify_all();
+    }
+}
+
+/**
+ * @brief Waits until the writer thread has synced a record.
+ *
+ * @param guard The held lock of the journal
+ * @param sequence The record to wait for
+ * @throws runtime_error If a write failed before the record was synced
+ */
+void TransactionJournal::waitForWriter(unique_lock<mutex> &guard, uint64_t sequence) {
+    written.wait(guard, [this, sequence]() {
+        return !file.isOpen() || syncedSequence >= sequence || (failedFrom != 0 && sequence >= failedFrom);
+    });
+    if (failedFrom != 0 && sequence >= failedFrom) {
+        throw runtime_error("Unable to write transaction journal: " + failure);
+    }
+}
+
+/**
+ * @brief Writes queued records in sequence order until the writer thread is stopped.
+ *
+ * Producers take their sequence number before they push, so records may be queued out of order; the writer keeps
+ * those that arrive early until the gap before them is filled, and writes every record that follows the last written
+ * one with one write and one sync. Before sleeping, the writer marks itself sleeping and looks at the queue once more:
+ * a producer either pushed before that look, or sees the mark after its push and wakes the writer under the lock.
+ * A failed batch is reported here, since nobody waits for it, and through the futures of its records. From then on,
+ * like `writeThrough`, the writer only takes records off the queue without writing them, until a checkpoint or a
+ * reopen clears the failure, so the file never holds a record without the ones before it.
+ */
+void TransactionJournal::runWriter() {
+    map<uint64_t, string> early;
+    pair<uint64_t, string> record;
+    unique_lock<mutex> guard(lock);
+    while (true) {
+        uint64_t first = writtenSequence + 1;
+        guard.unlock();
+
+        while (pending.pop(record)) {
+            early.insert(move(record));
+        }
+        string batch;
+        uint64_t last = first - 1;
+        for (map<uint64_t, string>::iterator it = early.begin(); it != early.end() && it->first == last + 1;
+             it = early.erase(it)) {
+            batch += it->second;
+            ++last;
+        }
+
+        guard.lock();
+        if (batch.empty()) {
+            if (stopping) {
+                return;
+            }
+            sleeping = true;
+            if (pending.empty()) {
+                wake.wait(guard);
+            }
+            sleeping = false;
+            continue;
+        }
+        if (failedFrom != 0) {
+            writtenSequence = last;
+            written.notify_all();
+            continue;
+        }
+
+        writing = true;
+        guard.unlock();
+        string error;
+        try {
+            file.append(batch);
+            file.sync();
+        } catch (const exception &e) {
+            error = e.what();
+        }
+
+        guard.lock();
+        writing = false;
+        writtenSequence = last;
+        if (error.empty()) {
+            syncedSequence = last;
+            ADS_METRICS_COUNT(JOURNAL_SYNCS, 1);
+        } else {
+            fail(error);
+            cerr << "Warning: Unable to write transaction journal: " << error << endl;
+        }
+        resolveWaiters();
+        written.notify_all();
+    }
+}
+
+/**
+ * @brief Starts the writer thread; the caller holds the lock and the journal is open.
+ */
+void TransactionJournal::startWriter() {
+    stopping = false;
+    queueing = true;
+    writer = thread(&TransactionJournal::runWriter, this);
+}
+
+/**
+ * @brief Stops the writer thread once it is idle; the caller does not hold the lock.
+ *
+ * New records go to the buffer again from here on.
+ */
+void TransactionJournal::stopWriter() {
+    {
+        lock_guard<mutex> guard(lock);
+        if (!queueing) {
+            return;
+        }
+        queueing = false;
+        stopping = true;
+        wake.notify_one();
+    }
+    writer.join();
+}
+
+/**
+ * @brief Makes a failed write sticky; the caller holds the lock.
+ *
+ * A failed write may leave part of its batch in the file, and a failed sync may drop any record written since the
+ * last one that succeeded, so every record after the last synced one counts as failed. Only the first failure is
+ * kept.
+ *
+ * @param error Why the write failed
+ */
+void TransactionJournal::fail(const string &error) {
+    if (failedFrom == 0) {
+        failedFrom = syncedSequence + 1;
+        failure = error;
+    }
+}
+
+/**
+ * @brief Fulfils the promises of every record that is synced or failed; the caller holds the lock.
+ */
+void TransactionJournal::resolveWaiters() {
+    size_t kept = 0;
+    for (size_t i = 0; i < waiters.size(); ++i) {
+        uint64_t sequence = waiters[i].first;
+        if (failedFrom != 0 && sequence >= failedFrom) {
+            waiters[i].second.set_exception(
+                    make_exception_ptr(runtime_error("Unable to write transaction journal: " + failure)));
+        } else if (sequence <= syncedSequence) {
+            waiters[i].second.set_value();
+        } else {
+            if (kept != i) {
+                waiters[kept] = move(waiters[i]);
+            }
+            ++kept;
+        }
+    }
+    waiters.erase(waiters.begin() + kept, waiters.end());
+}
+
+/**
+ * @brief Formats balances as `|account:balance` fields.
+ *
+ * @param balances The account numbers and balances
+ * @return The fields
+ */
+string TransactionJournal::balanceFields(const vector<pair<int, Money>> &balances) {
+    string fields;
+    for (const pair<int, Money> &balance: balances) {
+        fields += '|';
+        fields += to_string(balance.first);
+        fields += ':';
+        fields += balance.second.toString();
+    }
+    return fields;
+}
@@ -0,0 +1,307 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_TRANSACTIONJOURNAL_H
+#define ADS_MIDTERM_PROJECT_TRANSACTIONJOURNAL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "DurableFile.h"
+#include "Money.h"
+#include "MpscQueue.h"
+#include "Transaction.h"
+
+using namespace std;
+
+/**
+ * @class TransactionJournal
+ * @brief Write-ahead log of the changes made to a chart of accounts, with group commit.
+ *
+ * Instead of rewriting the data files after every change, each change is appended to the journal as one record with
+ * the next sequence number:
+ * - `P|seq|account|id|amount|type|date|description` for a posted transaction,
+ * - `X|seq|account|index|id|amount|type` for a deleted transaction, with its index among the live transactions,
+ * - `A|seq|account|balance|description` for an account added with `ForestTree::addAccountWithFile`,
+ * - `B|seq|account:balance|...` for the balances about to be written to the data files by a save,
+ * - `K|seq|account:balance|...`, always the only record after a checkpoint: every change up to `seq` is in the data
+ *   files, and the listed balances are the ones that are not saved yet.
+ *
+ * Appending only fills a memory buffer. `commit` makes a record durable: the first waiting thread becomes the leader,
+ * writes every buffered record with one write and one `fsync`, and wakes the threads whose records that covered, so
+ * concurrent postings share a single sync. Without durable commits, records are written in groups and only synced
+ * by `flush`. The journal is folded into the data files by `ForestTree::compactJournal`, which then `checkpoint`s it.
+ *
+ * A failed write or sync is sticky: the records it did not sync may be lost, and a later record must not reach the
+ * file without them, or a replay would find a gap. Every later commit and flush fails, and no record from the first
+ * unsynced one on is reported synced, until a `checkpoint` has put every change in the data files or the journal is
+ * opened again. A failed checkpoint is sticky the same way.
+ *
+ * With asynchronous commits, `commit` never waits: appending takes its sequence number with one atomic increment and
+ * pushes the record onto a lock-free queue, and a single writer thread takes everything queued, puts it back in
+ * sequence order, and writes and syncs it with one write and one `fsync`. Callers that need a record durable wait
+ * for the future returned by `whenSynced`, or call `flush`. The mode is changed while no thread appends.
+ */
+class TransactionJournal {
+private:
+    string path;                 ///< The path of the journal file, empty while closed
+    DurableFile file;            ///< The journal file, opened in append mode
+    mutable mutex lock;          ///< Guards every member below up to `waiters` and the use of `file`
+    condition_variable written;  ///< Signalled whenever a write of the buffer ends
+    string buffer;               ///< Records appended but not written yet
+    size_t buffered;             ///< The number of records in `buffer`
+    size_t groupSize;            ///< The number of records written together when commits are not durable
+    bool durable;                ///< True if `commit` waits until the record is synced
+    bool writing;                ///< True while a leader writes a batch outside the lock
+    bool async;                  ///< True if commits are asynchronous, whether the journal is open or not
+    bool stopping;               ///< True while the writer thread is asked to end
+    uint64_t writtenSequence;    ///< The sequence number of the last record handed to the file
+    uint64_t syncedSequence;     ///< The sequence number of the last record known to be on stable storage
+    string failure;              ///< Why the write failed, see `failedFrom`
+    condition_variable wake;     ///< Signalled when records are queued for a sleeping writer thread
+    thread writer;               ///< The writer thread of asynchronous commits
+    vector<pair<uint64_t, promise<void>>> waiters; ///< Promises of `whenSynced` not fulfilled yet
+
+    atomic<uint64_t> lastSequence;             ///< The sequence number of the last appended record
+    atomic<bool> queueing;                     ///< True while the writer thread runs, so records go to `pending`
+    atomic<bool> sleeping;                     ///< True while the writer thread waits for records
+    atomic<uint64_t> failedFrom;               ///< The first record not synced when a write failed, 0 if none
+    MpscQueue<pair<uint64_t, string>> pending; ///< Records queued for the writer thread, with their sequence
+
+public:
+    /**
+     * @brief Default constructor for the `TransactionJournal` class.
+     *
+     * Creates a closed journal with durable commits and a group size of 32 records.
+     */
+    TransactionJournal();
+
+    /**
+     * @brief Destructor for the `TransactionJournal` class.
+     *
+     * Writes any buffered records and closes the journal file.
+     */
+    ~TransactionJournal();
+
+    /**
+     * @brief Opens the journal file for appending, creating it if needed.
+     *
+     * @param filename The path of the journal file
+     * @param sequence The sequence number of the last record already in the file or in the data files
+     * @return True if the file was opened, false otherwise
+     */
+    bool open(const string &filename, uint64_t sequence);
+
+    /**
+     * @brief Writes and syncs buffered records and closes the journal file.
+     */
+    void close();
+
+    /**
+     * @brief Checks whether the journal file is open.
+     *
+     * @return True if records can be appended, false otherwise
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Returns the path of the journal file.
+     *
+     * @return The path, or an empty string if the journal is closed
+     */
+    const string &getPath() const;
+
+    /**
+     * @brief Returns the sequence number of the last appended record.
+     *
+     * @return The sequence number, or the one given to `open` if nothing was appended since
+     */
+    uint64_t getLastSequence() const;
+
+    /**
+     * @brief Sets how many records are written together when commits are not durable.
+     *
+     * @param size The group size; 0 and 1 both write every record on commit
+     */
+    void setGroupSize(size_t size);
+
+    /**
+     * @brief Sets whether `commit` waits until its record is on stable storage.
+     *
+     * @param enabled True to sync every commit, false to write records in groups and sync them only on `flush`
+     */
+    void setDurable(bool enabled);
+
+    /**
+     * @brief Checks whether commits are durable.
+     *
+     * @return True if `commit` syncs, false otherwise
+     */
+    bool isDurable() const;
+
+    /**
+     * @brief Sets whether commits are handed to a background writer thread instead of waiting.
+     *
+     * Every record appended before the change is written and synced first.
+     *
+     * @param enabled True to start the writer thread, false to stop it and go back to `setDurable` commits
+     * @throws runtime_error If the pending records cannot be written
+     */
+    void setAsync(bool enabled);
+
+    /**
+     * @brief Checks whether commits are asynchronous.
+     *
+     * @return True if a writer thread writes the records, false otherwise
+     */
+    bool isAsync() const;
+
+    /**
+     * @brief Appends a posted transaction.
+     *
+     * @param accountNumber The account the transaction was posted to
+     * @param t The posted transaction
+     * @return The sequence number of the record, 0 if the journal is closed and has not failed
+     */
+    uint64_t appendTransaction(int accountNumber, const Transaction &t);
+
+    /**
+     * @brief Appends a deleted transaction.
+     *
+     * @param accountNumber The account the transaction was deleted from
+     * @param transactionIndex The index the transaction had in the account before it was deleted
+     * @param t The deleted transaction
+     * @return The sequence number of the record, 0 if the journal is closed and has not failed
+     */
+    uint64_t appendTombstone(int accountNumber, int transactionIndex, const Transaction &t);
+
+    /**
+     * @brief Appends an added account.
+     *
+     * @param accountNumber The account number
+     * @param description The description of the account
+     * @param balance The opening balance, which was added to the ancestors of the account too
+     * @return The sequence number of the record, 0 if the journal is closed and has not failed
+     */
+    uint64_t appendAccount(int accountNumber, const string &description, Money balance);
+
+    /**
+     * @brief Appends the balances a save is about to write to the data files.
+     *
+     * @param balances The account numbers and their current balances
+     * @return The sequence number of the record, 0 if the journal is closed and has not failed
+     */
+    uint64_t appendBalances(const vector<pair<int, Money>> &balances);
+
+    /**
+     * @brief Makes an appended record durable, sharing the write and the sync with concurrent commits.
+     *
+     * @param sequence The sequence number returned when the record was appended; 0 does nothing
+     * @throws runtime_error If the record cannot be written or synced, or an earlier write failed
+     */
+    void commit(uint64_t sequence);
+
+    /**
+     * @brief Writes and syncs every appended record, whether commits are durable or not.
+     *
+     * @throws runtime_error If the journal file cannot be written or synced, or an earlier write failed
+     */
+    void flush();
+
+    /**
+     * @brief Returns a future that is ready once a record is on stable storage.
+     *
+     * Without durable or asynchronous commits, records are only synced by `flush`, a save or a checkpoint.
+     *
+     * @param sequence The sequence number of the record; 0, or any record of a closed journal, gives a ready future
+     * @return The future, which holds a runtime_error if the record, or one before it, could not be written, or if the
+     * journal was closed before it was
+     */
+    future<void> whenSynced(uint64_t sequence);
+
+    /**
+     * @brief Replaces the journal with a single checkpoint record.
+     *
+     * Called once every appended change is part of the data files. The sequence numbers go on from the checkpoint,
+     * and an earlier write failure is cleared. If the checkpoint fails, the old journal stays in place and the failure
+     * is sticky like a failed write.
+     *
+     * @param balances The balances that are not in the data files yet
+     * @throws runtime_error If the journal file cannot be replaced or reopened
+     */
+    void checkpoint(const vector<pair<int, Money>> &balances);
+
+private:
+    /**
+     * @brief Adds a record to the buffer under the next sequence number.
+     *
+     * @param type The record type
+     * @param fields The fields after the sequence number, each starting with `|`
+     * @return The sequence number of the record, 0 if the journal is closed and has not failed
+     */
+    uint64_t append(char type, const string &fields);
+
+    /**
+     * @brief Writes the buffer until a record is written, or synced, taking turns with other writing threads.
+     *
+     * @param guard The held lock of the journal; released while this thread writes
+     * @param sequence The record to wait for
+     * @param sync True to wait until the record is synced
+     * @throws runtime_error If a write failed before the record was synced
+     */
+    void writeThrough(unique_lock<mutex> &guard, uint64_t sequence, bool sync);
+
+    /**
+     * @brief Waits until the writer thread has synced a record.
+     *
+     * @param guard The held lock of the journal
+     * @param sequence The record to wait for
+     * @throws runtime_error If a write failed before the record was synced
+     */
+    void waitForWriter(unique_lock<mutex> &guard, uint64_t sequence);
+
+    /**
+     * @brief Writes queued records in sequence order until the writer thread is stopped.
+     */
+    void runWriter();
+
+    /**
+     * @brief Starts the writer thread; the caller holds the lock and the journal is open.
+     */
+    void startWriter();
+
+    /**
+     * @brief Stops the writer thread once it is idle; the caller does not hold the lock.
+     */
+    void stopWriter();
+
+    /**
+     * @brief Makes a failed write sticky; the caller holds the lock.
+     *
+     * @param error Why the write failed
+     */
+    void fail(const string &error);
+
+    /**
+     * @brief Fulfils the promises of every record that is synced or failed; the caller holds the lock.
+     */
+    void resolveWaiters();
+
+    /**
+     * @brief Formats balances as `|account:balance` fields.
+     *
+     * @param balances The account numbers and balances
+     * @return The fields
+     */
+    static string balanceFields(const vector<pair<int, Money>> &balances);
+};
+
+#endif //ADS_MIDTERM_PROJECT_TRANSACTIONJOURNAL_H
@@ -12,6 +12,9 @@
  */
 
 #include "TreeNode.h"
+#include "NodeArena.h"
+#include "TreeTraversal.h"
+#include "AccountCode.h"
 #include <iostream>
 #include <string>
 
@@ -27,9 +30,10 @@ using namespace std;
 /**
  * @brief Default constructor.
  *
- * Initializes a TreeNode with null pointers for the account, left child, and right sibling.
+ * Initializes a TreeNode with an empty account and null pointers for the left child and right sibling.
  */
-TreeNode::TreeNode() : account(NULL), leftChild(NULL), rightSibling(NULL) {}
+TreeNode::TreeNode()
+        : account(), leftChild(NULL), rightSibling(NULL), parent(NULL), subtreeDirty(false), tourIndex(0) {}
 /**
  * @brief Parameterized constructor.
  *
@@ -37,62 +41,30 @@ TreeNode::TreeNode() : account(NULL), leftChild(NULL), rightSibling(NULL) {}
  *
  * @param acc The account to store in this TreeNode.
  */
-TreeNode::TreeNode(const Account &acc) : leftChild(NULL), rightSibling(NULL) {
-    account = new Account(acc);
-}
-/**
- * @brief Copy constructor.
- *
- * Creates a deep copy of another TreeNode, including its account and child nodes.
- *
- * @param other The TreeNode to copy from.
- */
-TreeNode::TreeNode(const TreeNode &other) {
-    copyForm(other);
-}
+TreeNode::TreeNode(Account acc)
+        : account(move(acc)), leftChild(NULL), rightSibling(NULL), parent(NULL), subtreeDirty(false), tourIndex(0) {}
 /**
  * @brief Destructor.
  *
- * Cleans up dynamically allocated memory for the account, child, and sibling nodes.
- */
-TreeNode::~TreeNode() {
-    delete account;
-    clean();
-}
-/**
- * @brief Gets the left child of this TreeNode.
- *
- * @return Pointer to the left child node.
+ * Only the account stored in the node is destroyed. Child and sibling nodes belong to the `NodeArena` used to
+ * create them, which releases the whole forest at once.
  */
+TreeNode::~TreeNode() {}
 //gets
 //Account TreeNode::getData() const {
 //    return *account;
 //}
 
-NodePtr TreeNode::getLeftChild() const {
-    return leftChild;
-}
-/**
- * @brief Gets the right sibling of this TreeNode.
- *
- * @return Pointer to the right sibling node.
- */
-NodePtr TreeNode::getRightSibling() const {
-    return rightSibling;
-}
 /**
  * @brief Sets the account data for this TreeNode.
  *
- * Deletes the existing account (if any) and sets the new account.
+ * Replaces the account stored in the node.
  *
  * @param acc The account to associate with this TreeNode.
  */
 //sets
 void TreeNode::setData(const Account &acc) {
-    if (account != NULL) {
-        delete account;
-    }
-    account = new Account(acc);
+    account = acc;
 }
 /**
  * @brief Sets the left child for this TreeNode.
@@ -111,21 +83,13 @@ void TreeNode::setRightSibling(NodePtr right) {
     rightSibling = right;
 }
 /**
- * @brief Assignment operator.
+ * @brief Sets the parent for this TreeNode.
  *
- * Performs a deep copy of another TreeNode, cleaning up the current data beforehand.
- *
- * @param other The TreeNode to assign from.
- * @return Reference to the updated TreeNode.
+ * @param newParent Pointer to the node to set as the parent, or NULL for a root.
  */
-TreeNode &TreeNode::operator=(const TreeNode &other) {
-    if (this != &other) {
-        clean();
-        copyForm(other);
-    }
-    return *this;
+void TreeNode::setParent(NodePtr newParent) {
+    parent = newParent;
 }
-
 //hello im faysal i shall now explain these to you
 /*
  *
@@ -163,35 +127,22 @@ bool TreeNode::hasSibling() const {
 /**
  * @brief Finds a node with a specific account number in the tree.
  *
- * Performs a depth-first search for the node with the specified account number.
+ * Performs a depth-first search for the node with the specified account number, through the
+ * subtree of the given node and then the subtrees of its right siblings. The search uses
+ * `PreOrderIterator`, so it does not recurse down long sibling lists.
  *
  * @param root Pointer to the root of the tree to search.
  * @param accNum The account number to search for.
  * @return Pointer to the found node, or nullptr if not found.
  */
 NodePtr TreeNode::findNode(NodePtr root, int accNum) {
-    if (!root) {
-        return nullptr;
-    }
-
-    // Check current node
-    if (root->account && root->account->getAccountNumber() == accNum) {
-        return root;
-    }
-
-    // Check children first (depth-first search)
-    NodePtr found = nullptr;
-    if (root->leftChild) {
-        found = findNode(root->leftChild, accNum);
-        if (found) return found;
-    }
-
-    // Then check siblings
-    if (root->rightSibling) {
-        found = findNode(root->rightSibling, accNum);
-        if (found) return found;
+    for (NodePtr tree = root; tree != nullptr; tree = tree->rightSibling) {
+        for (NodePtr node: preOrder(tree)) {
+            if (node->account.getAccountNumber() == accNum) {
+                return node;
+            }
+        }
     }
-
     return nullptr;
 }
 
@@ -200,133 +151,119 @@ NodePtr TreeNode::findNode(NodePtr root, int accNum) {
  *
  * Maintains sibling order based on account numbers.
  *
+ * @param arena The arena the new node is allocated from.
  * @param acc The account to associate with the new child node.
+ * @return Pointer to the newly created child node.
  */
-void TreeNode::addChild(const Account &acc) {
-    NodePtr newChild = new TreeNode(acc);
+NodePtr TreeNode::addChild(NodeArena &arena, const Account &acc) {
+    NodePtr newChild = arena.create(acc);
+    newChild->parent = this;
 
     if (leftChild == NULL) {
         leftChild = newChild;
-        return;
+        return newChild;
     }
 
     // Find proper position among siblings
-    if (leftChild->account->getAccountNumber() > acc.getAccountNumber()) {
+    if (leftChild->account.getAccountNumber() > acc.getAccountNumber()) {
         // Insert at beginning
         newChild->rightSibling = leftChild;
         leftChild = newChild;
-        return;
+        return newChild;
     }
 
     // Find insertion point
     NodePtr current = leftChild;
     while (current->rightSibling &&
-           current->rightSibling->account->getAccountNumber() < acc.getAccountNumber()) {
+           current->rightSibling->account.getAccountNumber() < acc.getAccountNumber()) {
         current = current->rightSibling;
     }
 
     // Insert after current
     newChild->rightSibling = current->rightSibling;
     current->rightSibling = newChild;
+    return newChild;
 }
 /**
  * @brief Adds a sibling node with the specified account to this TreeNode.
  *
  * Maintains sibling order based on account numbers.
  *
+ * @param arena The arena the new node is allocated from.
  * @param acc The account to associate with the new sibling node.
+ * @return Pointer to the newly created sibling node.
  */
-void TreeNode::addSibling(const Account &acc) {
-    NodePtr newSibling = new TreeNode(acc);
+NodePtr TreeNode::addSibling(NodeArena &arena, const Account &acc) {
+    NodePtr newSibling = arena.create(acc);
+    newSibling->parent = parent;
 
     if (rightSibling == NULL) {
         rightSibling = newSibling;
-        return;
+        return newSibling;
     }
 
     // Find proper position
-    if (rightSibling->account->getAccountNumber() > acc.getAccountNumber()) {
+    if (rightSibling->account.getAccountNumber() > acc.getAccountNumber()) {
         // Insert at beginning
         newSibling->rightSibling = rightSibling;
         rightSibling = newSibling;
-        return;
+        return newSibling;
     }
 
     // Find insertion point
     NodePtr current = rightSibling;
     while (current->rightSibling &&
-           current->rightSibling->account->getAccountNumber() < acc.getAccountNumber()) {
+           current->rightSibling->account.getAccountNumber() < acc.getAccountNumber()) {
         current = current->rightSibling;
     }
 
     // Insert after current
     newSibling->rightSibling = current->rightSibling;
     current->rightSibling = newSibling;
+    return newSibling;
 }
 /**
  * @brief Adds a new account node to the tree.
  *
  * This method adds a new account node to the tree while maintaining the parent-child
- * and sibling relationships. If the account already exists, it does nothing.
+ * and sibling relationships. If the account already exists, it does nothing. Both the
+ * duplicate check and the parent lookup go through the account index, and the new node
+ * is registered in it.
  *
- * @param root Pointer to the root node of the tree.
+ * @param arena The arena the new node is allocated from.
+ * @param index The account index of the forest this node belongs to.
  * @param newAcc The account to be added to the tree.
  * @return True if the account was successfully added, false otherwise.
  */
-bool TreeNode::addAccountNode(NodePtr root, const Account &newAcc) {
+bool TreeNode::addAccountNode(NodeArena &arena, AccountIndex &index, const Account &newAcc) {
     int newAccNum = newAcc.getAccountNumber();
 
     // Check if account already exists
-    if (findNode(root, newAccNum) != nullptr) {
+    if (index.find(newAccNum) != index.end()) {
         return false;  // Account number already exists
     }
 
     // If this is the first node
-    if (!account) {
-        account = new Account(newAcc);
+    if (account.getAccountNumber() == 0) {
+        account = newAcc;
+        index[newAccNum] = this;
         return true;
     }
 
-    // Find the proper parent for this account
-    string newAccStr = to_string(newAccNum);
-    string parentStr = newAccStr.substr(0, newAccStr.length() - 1);
-
-    if (parentStr.empty()) {
+    // The parent is the account number without its last digit
+    if (AccountCode::isRoot(newAccNum)) {
         return false;  // Let ForestTree handle root nodes
     }
+    int parentNum = AccountCode::parent(newAccNum);
 
-    // Validate that child is only one digit longer than parent
-    int parentNum = stoi(parentStr);
-    if (to_string(parentNum).length() + 1 != newAccStr.length()) {
-        return false;  // Invalid child-parent relationship
-    }
-
-    NodePtr parentNode = findNode(root, parentNum);
-    if (!parentNode) {
+    AccountIndex::const_iterator parentIt = index.find(parentNum);
+    if (parentIt == index.end()) {
         return false;  // Parent doesn't exist
     }
 
     try {
-        // If parent has no children, add as first child
-        if (!parentNode->leftChild) {
-            parentNode->addChild(newAcc);
-        } else {
-            // Find the right sibling position among existing children
-            NodePtr lastChild = parentNode->leftChild;
-
-            // If new account should be first child
-            if (lastChild->account->getAccountNumber() > newAccNum) {
-                parentNode->addChild(newAcc);
-                return true;
-            }
-
-            // Find the appropriate sibling to add after
-            while (lastChild->rightSibling &&
-                   lastChild->rightSibling->account->getAccountNumber() < newAccNum) {
-                lastChild = lastChild->rightSibling;
-            }
-            lastChild->addSibling(newAcc);
-        }
+        // addChild keeps the parent's children sorted by account number
+        index[newAccNum] = parentIt->second->addChild(arena, newAcc);
         return true;
     } catch (const invalid_argument &e) {
         return false;
@@ -336,56 +273,82 @@ bool TreeNode::addAccountNode(NodePtr root, const Account &newAcc) {
  * @brief Updates the balances for the current account and its parent nodes.
  *
  * Applies a transaction to the current account and propagates the balance changes
- * to all parent accounts in the tree, starting from the current account and moving upward.
+ * to all parent accounts in the tree, following the parent links upward. The cost
+ * depends only on the depth of the account, not on the size of the tree.
  *
- * @param root Pointer to the root node of the tree.
  * @param t The transaction to apply to the current account.
- * @throws runtime_error If the current account is null.
  */
-void TreeNode::updateBalance(NodePtr root, Transaction &t) {
-    if (!account) {
-        throw runtime_error("Null account pointer");
+void TreeNode::updateBalance(const Transaction &t) {
+    for (NodePtr node = this; node != NULL; node = node->parent) {
+        node->account.updateBalance(t);
     }
-
-    // Get parent nodes from the main root of this account's tree
-    vector<NodePtr> parents = getParentNodes(root);
-
-    // Update the current account's balance first
-    account->updateBalance(t);
-
-
-    // Update all parent balances from bottom to top
-    for (NodePtr parent: parents) {
-        if (parent && parent->account) {
-            parent->account->updateBalance(t);
-        }
+}
+/**
+ * @brief Applies a balance change to this account only and defers it for the ancestors.
+ *
+ * @param delta The signed balance change.
+ *
+ * Every out-of-date node has out-of-date ancestors, so flagging stops at the first ancestor already flagged.
+ */
+void TreeNode::postDeferred(Money delta) {
+    account.setBalance(account.getBalance() + delta);
+    pendingDelta += delta;
+    for (NodePtr node = parent; node != NULL && !node->subtreeDirty; node = node->parent) {
+        node->subtreeDirty = true;
     }
 }
+/**
+ * @brief Checks whether the balance of this account is missing changes posted below it.
+ *
+ * @return True if a descendant holds a pending delta, false otherwise.
+ */
+bool TreeNode::isBalanceDirty() const {
+    return subtreeDirty;
+}
+/**
+ * @brief Brings the balance of this account and of its out-of-date descendants up to date.
+ *
+ * @param changed Receives the account number of every account whose balance changed.
+ *
+ * Every child holding a pending delta or flagged as out of date is settled first, its pending delta is moved into this
+ * account's balance and pending delta, and the flag is cleared. The recursion is bounded by the number of digits of an
+ * account number.
+ */
+void TreeNode::settleBalance(vector<int> &changed) {
+    if (!subtreeDirty) {
+        return;
+    }
+    Money collected;
+    for (NodePtr child = leftChild; child != NULL; child = child->rightSibling) {
+        child->settleBalance(changed);
+        collected += child->pendingDelta;
+        child->pendingDelta = Money();
+    }
+    subtreeDirty = false;
+    if (collected != Money()) {
+        account.setBalance(account.getBalance() + collected);
+        pendingDelta += collected;
+        changed.push_back(account.getAccountNumber());
+    }
+}
+/**
+ * @brief Drops the pending delta of a root, which has no ancestor to pass it on to.
+ */
+void TreeNode::clearPendingDelta() {
+    pendingDelta = Money();
+}
 /**
  * @brief Retrieves all parent nodes of the current account in the tree.
  *
- * This method calculates and returns a list of parent nodes for the current account,
- * working its way up the tree hierarchy.
+ * This method follows the parent links from the current account up to its root.
  *
- * @param root Pointer to the root node of the tree.
- * @return A vector of pointers to the parent nodes.
+ * @return A vector of pointers to the parent nodes, ordered from the root down.
  */
-vector<NodePtr> TreeNode::getParentNodes(NodePtr root) {
+vector<NodePtr> TreeNode::getParentNodes() const {
     vector<NodePtr> parents;
-    string childNum = to_string(account->getAccountNumber());
-
-    while (childNum.length() > 1) {
-        // Remove last digit to get parent number
-        childNum = childNum.substr(0, childNum.length() - 1);
-        int parentNum = stoi(childNum);
-
-        // First try to find in current root's tree
-        NodePtr parent = findNode(root, parentNum);
-        if (parent) {
-            parents.insert(parents.begin(), parent); // Insert at beginning to maintain order
-        }
+    for (NodePtr node = parent; node != NULL; node = node->parent) {
+        parents.insert(parents.begin(), node); // Insert at beginning to maintain order
     }
-
     return parents;
 }
 /**
@@ -399,84 +362,40 @@ vector<NodePtr> TreeNode::getParentNodes(NodePtr root) {
  */
 void TreeNode::updateParentBalances(const vector<NodePtr> &parents, const Transaction &t) {
     for (NodePtr parent: parents) {
-        parent->account->updateBalance(t);
+        parent->account.updateBalance(t);
     }
 }
 /**
  * @brief Validates the parent-child relationship between two accounts.
  *
  * Checks whether a child account number is a valid extension of a parent account number,
- * ensuring that the child number starts with the parent's number and is exactly one digit longer.
+ * ensuring that the child number starts with the parent's number and is longer. Uses
+ * `AccountCode::isDescendant`, so no string is built.
  *
  * @param parentNum The account number of the parent.
  * @param childNum The account number of the child.
  * @return True if the child is valid, false otherwise.
  */
 bool TreeNode::isValidChild(int parentNum, int childNum) const {
-    string parent = to_string(parentNum);
-    string child = to_string(childNum);
-
-    if (child.length() <= parent.length()) {
-        return false;
-    }
-
-    return child.substr(0, parent.length()) == parent;
+    return AccountCode::isDescendant(parentNum, childNum);
 }
 /**
  * @brief Gets the level of the current account in the tree.
  *
  * This method calculates the depth (or level) of the current account node in the tree
- * relative to the root node.
+ * relative to the root node, by counting the parent links from this node up to the root.
  *
  * @param root Pointer to the root node of the tree.
- * @return The level of the current account node, or -1 if the account is not found.
+ * @return The level of the current account node, or -1 if root is not one of its ancestors.
  */
 int TreeNode::getLevel(NodePtr root) const {
-    if (root == NULL) {
-        return -1;
-    }
-    if (root->account->getAccountNumber() == account->getAccountNumber()) {
-        return 0;
-    }
-
-    return getLevelHelper(root->leftChild, 1);
-}
-/**
- * @brief Helper method for calculating the level of the current node.
- *
- * This recursive method determines the depth of a specific node relative to
- * the root node by traversing the tree structure.
- *
- * @param node Pointer to the node currently being inspected.
- * @param currentLevel The current level being tracked in the recursive calls.
- * @return The level of the current node, or -1 if the node is not found.
- */
-//when your adding a trans ez il balance bas kif
-int TreeNode::getLevelHelper(NodePtr node, int currentLevel) const {
-    if (node == NULL) {
-        return -1;
-    }
-    if (node->account->getAccountNumber() == account->getAccountNumber()) {
-        return currentLevel;
-    }
-
-    NodePtr sibling = node->rightSibling;
-    while (sibling != nullptr) {
-        if (sibling->account->getAccountNumber() == account->getAccountNumber()) {
-            return currentLevel;
-        }
-        sibling = sibling->rightSibling;
-    }
-
-    NodePtr child = node->leftChild;
-    while (child != nullptr) {
-        int result = getLevelHelper(child, currentLevel + 1);
-        if (result != -1) {
-            return result;
+    int level = 0;
+    for (const TreeNode *node = this; node != NULL; node = node->parent) {
+        if (node == root) {
+            return level;
         }
-        child = child->rightSibling;
+        ++level;
     }
-
     return -1;
 }
 /**
@@ -486,52 +405,7 @@ int TreeNode::getLevelHelper(NodePtr node, int currentLevel) const {
  * in this TreeNode.
  */
 void TreeNode::print() const {
-    std::cout << "Account: " << account->getAccountNumber()
-              << " - " << account->getDescription()
-              << " (Balance: " << account->getBalance() << ")\n";
+    std::cout << "Account: " << account.getAccountNumber()
+              << " - " << account.getDescription()
+              << " (Balance: " << account.getBalance() << ")\n";
 }
-/**
- * @brief Copies data from another TreeNode into this one.
- *
- * Performs a deep copy of the account, left child, and right sibling of another
- * TreeNode into the current TreeNode.
- *
- * @param other The TreeNode to copy from.
- */
-void TreeNode::copyForm(const TreeNode &other) {
-    if (account != NULL) {
-        delete account;
-    }
-    if (leftChild != NULL) {
-        delete leftChild;
-    }
-    if (rightSibling != NULL) {
-        delete rightSibling;
-    }
-
-    // Deep copy of account
-    account = (other.account != NULL) ? new Account(*other.account) : NULL;
-
-    // Deep copy of child nodes
-    leftChild = (other.leftChild != NULL) ? new TreeNode(*other.leftChild) : NULL;
-
-    // Deep copy of sibling nodes
-    rightSibling = (other.rightSibling != NULL) ? new TreeNode(*other.rightSibling) : NULL;
-}
-
-/**
- * @brief Cleans up the child and sibling nodes of this TreeNode.
- *
- * Deletes the left child and right sibling subtrees of this TreeNode, freeing
- * dynamically allocated memory.
- */
-void TreeNode::clean() {
-    // Delete child subtree
-    delete leftChild;
-    leftChild = nullptr;
-
-    // Delete sibling subtree
-    delete rightSibling;
-    rightSibling = nullptr;
-}
-
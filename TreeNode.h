@@ -5,54 +5,70 @@
 #ifndef ADS_MIDTERM_PROJECT_TREENODE_H
 #define ADS_MIDTERM_PROJECT_TREENODE_H
 
+#include <cstdint>
 #include <iostream>
 #include <string>
+#include <vector>
+#include <unordered_map>
 #include "Account.h"
 #include "Transaction.h"
+#include "DateBalanceIndex.h"
 
 using namespace std;
 
 typedef Account *AccountPtr;
 typedef class TreeNode *NodePtr;
+class NodeArena;
+/**
+ * @brief Hash index from account number to the node holding that account.
+ *
+ * Owned and kept in sync by `ForestTree`; tree operations that need to resolve an account by number take it
+ * instead of searching the tree.
+ */
+typedef unordered_map<int, NodePtr> AccountIndex;
 /**
  * @class TreeNode
  * @brief Represents a node in a tree structure, each containing an `Account` and pointers to its left child and right sibling.
  *
  * This class supports operations like adding new accounts, updating balances, navigating the hierarchy of accounts,
- * and performing various tree operations such as finding nodes and checking node characteristics.
+ * and performing various tree operations such as finding nodes and checking node characteristics. The account is
+ * stored inline in the node. Nodes are created by a `NodeArena`, which owns them, so a node never frees its children
+ * or siblings and nodes cannot be copied.
  */
 //didnt use elemtntypr account cause its confusing for no reason
 class TreeNode {
 private:
-    AccountPtr account;
+    Account account;
     NodePtr leftChild;
     NodePtr rightSibling;
+    NodePtr parent;   ///< The node this node is a child of, or NULL for a root
+    Money pendingDelta; ///< Balance change already in this account but not yet passed on to its ancestors
+    bool subtreeDirty;  ///< True if a descendant holds a pending delta, so this balance is out of date
+    DateBalanceIndex dateIndex; ///< Dated balance changes of this account and all its descendants
+    uint32_t tourIndex; ///< Position of this node in the pre-order array of its forest, see `EulerTour`
 
 public:
     //constructors
     // Constructors and Destructor
     /**
      * @brief Default constructor for the `TreeNode` class.
-     * Initializes the node with default values: a null account pointer, and null pointers for left child and right sibling.
+     * Initializes the node with default values: an empty account, and null pointers for left child and right sibling.
      */
     TreeNode(); //aadeye
     /**
      * @brief Parameterized constructor for the `TreeNode` class.
-     * Initializes the node with the provided `Account` object.
+     * Initializes the node with the provided `Account` object, which is moved into the node.
      *
      * @param acc The `Account` object to be stored in the node
      */
-    TreeNode(const Account &acc); //with acc
+    TreeNode(Account acc); //with acc
     /**
-     * @brief Copy constructor for the `TreeNode` class.
-     * Initializes the node by copying data from another node.
-     *
-     * @param other The `TreeNode` to copy
+     * @brief Nodes are owned by their arena and linked to other nodes, so they cannot be copied.
      */
-    TreeNode(const TreeNode &other); // copy
+    TreeNode(const TreeNode &other) = delete;
     /**
          * @brief Destructor for the `TreeNode` class.
-         * Cleans up any allocated resources associated with the node.
+         * Destroys the account stored in the node; linked nodes are released by their arena.
          */
     ~TreeNode();
 
@@ -63,25 +79,63 @@ public:
          *
          * @return A pointer to the left child node
          */
-    NodePtr getLeftChild() const;
+    NodePtr getLeftChild() const { return leftChild; }
     /**
          * @brief Gets the right sibling of the node.
          *
          * @return A pointer to the right sibling node
          */
-    NodePtr getRightSibling() const;
+    NodePtr getRightSibling() const { return rightSibling; }
+    /**
+         * @brief Gets the parent of the node.
+         *
+         * @return A pointer to the parent node, or NULL if the node is a root
+         */
+    NodePtr getParent() const { return parent; }
     /**
          * @brief Gets the account data stored in the node.
          *
          * @return A reference to the `Account` object stored in this node
          */
-    Account &getData() { return *account; }
+    Account &getData() { return account; }
     /**
      * @brief Gets the account data stored in the node (const version).
      *
      * @return A const reference to the `Account` object stored in this node
      */
-    const Account &getData() const { return *account; }
+    const Account &getData() const { return account; }
+
+    /**
+     * @brief Gets the dated balance changes of this account and its whole subtree.
+     *
+     * Maintained by `ForestTree` once a point-in-time query has built it.
+     *
+     * @return A reference to the date index of this node
+     */
+    DateBalanceIndex &getDateIndex() { return dateIndex; }
+
+    /**
+     * @brief Gets the dated balance changes of this account and its whole subtree (const version).
+     *
+     * @return A const reference to the date index of this node
+     */
+    const DateBalanceIndex &getDateIndex() const { return dateIndex; }
+
+    /**
+     * @brief Gets the position of this node in the Euler tour of its forest.
+     *
+     * Only meaningful while the `EulerTour` built over the forest is up to date.
+     *
+     * @return The enter index of this node
+     */
+    uint32_t getTourIndex() const { return tourIndex; }
+
+    /**
+     * @brief Sets the position of this node in the Euler tour of its forest.
+     *
+     * @param index The enter index, assigned by `EulerTour::build`
+     */
+    void setTourIndex(uint32_t index) { tourIndex = index; }
 
 
     //setters
@@ -103,6 +157,12 @@ public:
       * @param right The new right sibling node pointer
       */
     void setRightSibling(NodePtr right);
+    /**
+      * @brief Sets the parent of the node.
+      *
+      * @param newParent The new parent node pointer, or NULL for a root
+      */
+    void setParent(NodePtr newParent);
      /**
       * @brief Checks if the node is a leaf (has no children).
       *
@@ -119,9 +179,11 @@ public:
     /**
       * @brief Checks if the given account numbers represent a valid child-parent relationship.
       *
+      * Constant time: the digits of the child are dropped until it is no longer than the parent.
+      *
       * @param parentNum The parent account number
       * @param childNum The child account number
-      * @return True if the relationship is valid, false otherwise
+      * @return True if the child number extends the parent number by at least one digit, false otherwise
       */
     //account hierarchy
 
@@ -129,25 +191,61 @@ public:
     /**
       * @brief Adds a new account node to the tree.
       *
-      * @param root The root node of the tree to start the search for the correct position
+      * The parent is resolved through the account index and the new node is registered in it.
+      *
+      * @param arena The arena the new node is allocated from
+      * @param index The account index of the forest the node belongs to
       * @param newAcc The new `Account` to add to the tree
       * @return True if the account was successfully added, false otherwise
       */
-    bool addAccountNode(NodePtr root, const Account &newAcc);
+    bool addAccountNode(NodeArena &arena, AccountIndex &index, const Account &newAcc);
     /**
-      * @brief Updates the balance of accounts in the tree based on a transaction.
+      * @brief Updates the balance of this account and all its ancestors based on a transaction.
+      *
+      * Walks the parent links from this node up to its root, without allocating or searching.
       *
-      * @param root The root node of the tree to start the update from
       * @param t The `Transaction` object containing the update details
       */
-    void updateBalance(NodePtr root, Transaction &t);
+    void updateBalance(const Transaction &t);
+
+    /**
+      * @brief Applies a balance change to this account only and defers it for the ancestors.
+      *
+      * The change is remembered as pending and the ancestors are flagged as out of date. Flagging stops at the first
+      * ancestor that is already flagged, since its own ancestors are flagged too, so a burst of postings under the same
+      * account costs almost nothing at the top of the hierarchy.
+      *
+      * @param delta The signed balance change
+      */
+    void postDeferred(Money delta);
+
+    /**
+      * @brief Checks whether the balance of this account is missing changes posted below it.
+      *
+      * @return True if a descendant holds a pending delta, false otherwise
+      */
+    bool isBalanceDirty() const;
+
+    /**
+      * @brief Brings the balance of this account and of its out-of-date descendants up to date.
+      *
+      * Pending deltas of the subtree are folded bottom-up into every account on the way, and the total is kept as this
+      * node's pending delta, for its own ancestors to pick up when they are settled. Clean subtrees are not visited.
+      *
+      * @param changed Receives the account number of every account whose balance changed
+      */
+    void settleBalance(vector<int> &changed);
+
+    /**
+      * @brief Drops the pending delta of a root, which has no ancestor to pass it on to.
+      */
+    void clearPendingDelta();
     /**
         * @brief Retrieves all the parent nodes of the given node.
         *
-        * @param root The root node of the tree
-        * @return A vector of pointers to parent nodes
+        * @return A vector of pointers to parent nodes, ordered from the root down
         */
-    vector<NodePtr> getParentNodes(NodePtr root);
+    vector<NodePtr> getParentNodes() const;
     /**
          * @brief Finds the node with the specified account number in the tree.
          *
@@ -159,18 +257,17 @@ public:
     /**
          * @brief Gets the level of the node in the tree hierarchy.
          *
-         * @param node The node to get the level of
-         * @return The level of the node in the tree (root has level 0)
+         * Follows the parent links up to the given root, so the cost is the depth of the node, never the size of
+         * the tree.
+         *
+         * @param root The node the level is counted from
+         * @return The level of the node below root (root has level 0), or -1 if root is not an ancestor
          */
     int getLevel(NodePtr) const;
     /**
-         * @brief Assignment operator for the `TreeNode` class.
-         * Copies the data from another `TreeNode` into this one.
-         *
-         * @param other The `TreeNode` to copy
-         * @return A reference to this node after assignment
+         * @brief Nodes cannot be assigned, for the same reason they cannot be copied.
          */
-    TreeNode &operator=(const TreeNode &);
+    TreeNode &operator=(const TreeNode &) = delete;
     /**
          * @brief Prints the account data stored in the node.
          *
@@ -179,40 +276,22 @@ public:
     void print() const;
 
 private:
-    /**
-    * @brief Copies the data from another `TreeNode`.
-    *
-    * This is a helper method used by the copy constructor and assignment operator.
-    *
-    * @param other The `TreeNode` to copy data from
-    */
-    void copyForm(const TreeNode &other);
-    /**
-         * @brief Cleans up resources used by the node.
-         *
-         * This is a helper method used by the destructor.
-         */
-    void clean();
-    /**
-        * @brief Helper method to recursively get the level of a node.
-        *
-        * @param node The node to check
-        * @param currentLevel The current level during recursion
-        * @return The level of the node
-        */
-    int getLevelHelper(NodePtr node, int currentLevel) const;
     /**
          * @brief Adds a new child to the node.
          *
+         * @param arena The arena the new node is allocated from
          * @param acc The account data for the new child node
+         * @return A pointer to the newly created child node
          */
-    void addChild(const Account &);
+    NodePtr addChild(NodeArena &arena, const Account &);
     /**
         * @brief Adds a new sibling to the node.
         *
+        * @param arena The arena the new node is allocated from
         * @param acc The account data for the new sibling node
+        * @return A pointer to the newly created sibling node
         */
-    void addSibling(const Account &);
+    NodePtr addSibling(NodeArena &arena, const Account &);
     /**
         * @brief Updates the balances of the parent nodes based on a transaction.
         *
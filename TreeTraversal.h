@@ -0,0 +1,377 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_TREETRAVERSAL_H
+#define ADS_MIDTERM_PROJECT_TREETRAVERSAL_H
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "TreeNode.h"
+
+using namespace std;
+
+/**
+ * @brief Hints the processor to start loading a node that is about to be visited.
+ *
+ * A null address is allowed. Expands to nothing on compilers without a prefetch builtin.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define ADS_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define ADS_PREFETCH(address) ((void) 0)
+#endif
+
+/**
+ * @class PreOrderIterator
+ * @brief Visits a subtree parents first, children in sibling order, without recursion.
+ *
+ * The iterator keeps the path from the subtree root down to the current node on an explicit stack, so its memory is
+ * bounded by the depth of the tree, never by the length of a sibling list, and wide charts cannot overflow the call
+ * stack. The sibling of the start node is not visited. Every move prefetches the next child and sibling.
+ */
+class PreOrderIterator {
+private:
+    NodePtr current;      ///< The node the iterator is on, or nullptr at the end
+    vector<NodePtr> path; ///< The ancestors of the current node within the subtree, root first
+
+public:
+    typedef forward_iterator_tag iterator_category;
+    typedef NodePtr value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const NodePtr *pointer;
+    typedef const NodePtr &reference;
+
+    /**
+     * @brief Creates the end iterator.
+     */
+    PreOrderIterator() : current(nullptr) {}
+
+    /**
+     * @brief Creates an iterator on the root of a subtree.
+     *
+     * @param root The subtree root, or nullptr for an empty walk
+     */
+    explicit PreOrderIterator(NodePtr root) : current(root) {
+        if (current) {
+            ADS_PREFETCH(current->getLeftChild());
+        }
+    }
+
+    /**
+     * @brief Returns the current node.
+     *
+     * @return The current node
+     */
+    reference operator*() const { return current; }
+
+    /**
+     * @brief Returns the depth of the current node below the subtree root.
+     *
+     * @return 0 for the root, 1 for its children and so on
+     */
+    size_t depth() const { return path.size(); }
+
+    /**
+     * @brief Moves to the next node in pre-order.
+     *
+     * @return This iterator
+     */
+    PreOrderIterator &operator++() {
+        NodePtr child = current->getLeftChild();
+        if (child) {
+            path.push_back(current);
+            current = child;
+            ADS_PREFETCH(current->getLeftChild());
+            ADS_PREFETCH(current->getRightSibling());
+            return *this;
+        }
+        skipChildren();
+        return *this;
+    }
+
+    /**
+     * @brief Moves to the next node that is not a descendant of the current one.
+     *
+     * Lets a walk prune a subtree it does not need.
+     */
+    void skipChildren() {
+        while (!path.empty()) {
+            NodePtr sibling = current->getRightSibling();
+            if (sibling) {
+                current = sibling;
+                ADS_PREFETCH(current->getLeftChild());
+                ADS_PREFETCH(current->getRightSibling());
+                return;
+            }
+            current = path.back();
+            path.pop_back();
+        }
+        current = nullptr;
+    }
+
+    bool operator==(const PreOrderIterator &other) const { return current == other.current; }
+    bool operator!=(const PreOrderIterator &other) const { return current != other.current; }
+};
+
+/**
+ * @class PostOrderIterator
+ * @brief Visits a subtree children first, so every node comes after all its descendants, without recursion.
+ *
+ * Uses the same explicit path stack as `PreOrderIterator`, bounded by the depth of the tree. The start node is
+ * visited last and its sibling is not visited.
+ */
+class PostOrderIterator {
+private:
+    NodePtr current;      ///< The node the iterator is on, or nullptr at the end
+    vector<NodePtr> path; ///< The ancestors of the current node within the subtree, root first
+
+    /**
+     * @brief Moves down to the first leaf of the subtree of the current node.
+     */
+    void descend() {
+        for (NodePtr child = current->getLeftChild(); child != nullptr; child = current->getLeftChild()) {
+            path.push_back(current);
+            current = child;
+        }
+        ADS_PREFETCH(current->getRightSibling());
+    }
+
+public:
+    typedef forward_iterator_tag iterator_category;
+    typedef NodePtr value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const NodePtr *pointer;
+    typedef const NodePtr &reference;
+
+    /**
+     * @brief Creates the end iterator.
+     */
+    PostOrderIterator() : current(nullptr) {}
+
+    /**
+     * @brief Creates an iterator on the first leaf of a subtree.
+     *
+     * @param root The subtree root, or nullptr for an empty walk
+     */
+    explicit PostOrderIterator(NodePtr root) : current(root) {
+        if (current) {
+            descend();
+        }
+    }
+
+    /**
+     * @brief Returns the current node.
+     *
+     * @return The current node
+     */
+    reference operator*() const { return current; }
+
+    /**
+     * @brief Returns the depth of the current node below the subtree root.
+     *
+     * @return 0 for the root, 1 for its children and so on
+     */
+    size_t depth() const { return path.size(); }
+
+    /**
+     * @brief Moves to the next node in post-order.
+     *
+     * @return This iterator
+     */
+    PostOrderIterator &operator++() {
+        if (path.empty()) {
+            current = nullptr;
+            return *this;
+        }
+        NodePtr sibling = current->getRightSibling();
+        if (sibling) {
+            current = sibling;
+            descend();
+        } else {
+            current = path.back();
+            path.pop_back();
+        }
+        return *this;
+    }
+
+    bool operator==(const PostOrderIterator &other) const { return current == other.current; }
+    bool operator!=(const PostOrderIterator &other) const { return current != other.current; }
+};
+
+/**
+ * @class BreadthFirstIterator
+ * @brief Visits a subtree level by level, every level in sibling order.
+ *
+ * The queue is a flat vector read from the front and refilled one sibling list at a time, so it grows with the width
+ * of the tree rather than its depth. The sibling of the start node is not visited.
+ */
+class BreadthFirstIterator {
+private:
+    vector<pair<NodePtr, size_t>> queue; ///< Queued nodes with their depth; the current one is at `head`
+    size_t head;                         ///< The position of the current node in the queue
+
+    /**
+     * @brief Returns the current node.
+     *
+     * @return The current node, or nullptr at the end
+     */
+    NodePtr node() const { return queue.empty() ? nullptr : queue[head].first; }
+
+public:
+    typedef forward_iterator_tag iterator_category;
+    typedef NodePtr value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const NodePtr *pointer;
+    typedef const NodePtr &reference;
+
+    /**
+     * @brief Creates the end iterator.
+     */
+    BreadthFirstIterator() : head(0) {}
+
+    /**
+     * @brief Creates an iterator on the root of a subtree.
+     *
+     * @param root The subtree root, or nullptr for an empty walk
+     */
+    explicit BreadthFirstIterator(NodePtr root) : head(0) {
+        if (root) {
+            queue.push_back(make_pair(root, 0));
+        }
+    }
+
+    /**
+     * @brief Returns the current node.
+     *
+     * @return The current node
+     */
+    reference operator*() const { return queue[head].first; }
+
+    /**
+     * @brief Returns the depth of the current node below the subtree root.
+     *
+     * @return 0 for the root, 1 for its children and so on
+     */
+    size_t depth() const { return queue[head].second; }
+
+    /**
+     * @brief Queues the children of the current node and moves to the next queued node.
+     *
+     * @return This iterator
+     */
+    BreadthFirstIterator &operator++() {
+        size_t childDepth = queue[head].second + 1;
+        for (NodePtr child = queue[head].first->getLeftChild(); child != nullptr; child = child->getRightSibling()) {
+            ADS_PREFETCH(child->getRightSibling());
+            queue.push_back(make_pair(child, childDepth));
+        }
+        if (++head == queue.size()) {
+            queue.clear();
+            head = 0;
+        }
+        return *this;
+    }
+
+    bool operator==(const BreadthFirstIterator &other) const { return node() == other.node(); }
+    bool operator!=(const BreadthFirstIterator &other) const { return !(*this == other); }
+};
+
+/**
+ * @class TraversalRange
+ * @brief A subtree walk usable in a range-based for loop, such as `for (NodePtr node: preOrder(root))`.
+ *
+ * @tparam Iterator One of the traversal iterators
+ */
+template<typename Iterator>
+class TraversalRange {
+private:
+    NodePtr root; ///< The subtree root
+
+public:
+    /**
+     * @brief Creates a walk of a subtree.
+     *
+     * @param root The subtree root, or nullptr for an empty walk
+     */
+    explicit TraversalRange(NodePtr root) : root(root) {}
+
+    Iterator begin() const { return Iterator(root); }
+    Iterator end() const { return Iterator(); }
+};
+
+/**
+ * @brief Walks a subtree parents first.
+ *
+ * @param root The subtree root
+ * @return The walk
+ */
+inline TraversalRange<PreOrderIterator> preOrder(NodePtr root) {
+    return TraversalRange<PreOrderIterator>(root);
+}
+
+/**
+ * @brief Walks a subtree children first.
+ *
+ * @param root The subtree root
+ * @return The walk
+ */
+inline TraversalRange<PostOrderIterator> postOrder(NodePtr root) {
+    return TraversalRange<PostOrderIterator>(root);
+}
+
+/**
+ * @brief Walks a subtree level by level.
+ *
+ * @param root The subtree root
+ * @return The walk
+ */
+inline TraversalRange<BreadthFirstIterator> breadthFirst(NodePtr root) {
+    return TraversalRange<BreadthFirstIterator>(root);
+}
+
+/**
+ * @brief Calls a visitor on every node of a subtree, parents first.
+ *
+ * @tparam Visitor Callable as `visit(NodePtr node, size_t depth)`
+ * @param root The subtree root
+ * @param visit The visitor
+ */
+template<typename Visitor>
+void forEachPreOrder(NodePtr root, Visitor &&visit) {
+    for (PreOrderIterator it(root), end; it != end; ++it) {
+        visit(*it, it.depth());
+    }
+}
+
+/**
+ * @brief Calls a visitor on every node of a subtree, children first.
+ *
+ * @tparam Visitor Callable as `visit(NodePtr node, size_t depth)`
+ * @param root The subtree root
+ * @param visit The visitor
+ */
+template<typename Visitor>
+void forEachPostOrder(NodePtr root, Visitor &&visit) {
+    for (PostOrderIterator it(root), end; it != end; ++it) {
+        visit(*it, it.depth());
+    }
+}
+
+/**
+ * @brief Calls a visitor on every node of a subtree, level by level.
+ *
+ * @tparam Visitor Callable as `visit(NodePtr node, size_t depth)`
+ * @param root The subtree root
+ * @param visit The visitor
+ */
+template<typename Visitor>
+void forEachBreadthFirst(NodePtr root, Visitor &&visit) {
+    for (BreadthFirstIterator it(root), end; it != end; ++it) {
+        visit(*it, it.depth());
+    }
+}
+
+#endif //ADS_MIDTERM_PROJECT_TREETRAVERSAL_H
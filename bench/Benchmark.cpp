@@ -0,0 +1,410 @@
+//
+// Created on 10/14/2026.
+//
+
+/**
+ * @file Benchmark.cpp
+ * @brief Benchmarks of the load, lookup, posting, rollup, report and save paths of `ForestTree`.
+ *
+ * Generates a synthetic ledger, then runs every benchmark for the requested number of iterations, each on a fresh copy
+ * of the ledger files, and writes the results as JSON. Progress messages of the library are suppressed while timing,
+ * and the ledger files are removed afterwards. Builds with `ADS_ENABLE_METRICS` also report the latency histograms
+ * and counters of `ForestMetrics` over the whole run.
+ *
+ * Usage: ADS_benchmarks [--roots N] [--depth N] [--fanout N] [--transactions N] [--posts N] [--lookups N]
+ *                       [--commits N] [--iterations N] [--seed N] [--dir PATH] [--output FILE]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ForestMetrics.h"
+#include "ForestTree.h"
+#include "ReportGenerator.h"
+#include "SyntheticLedger.h"
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief Settings of a benchmark run that are not part of the ledger shape.
+ */
+struct BenchmarkSettings {
+    size_t posts = 100000;   ///< Transactions posted by the posting benchmark
+    size_t lookups = 1000000; ///< Lookups made by the lookup benchmark
+    size_t deletes = 10000;  ///< Transactions deleted by the deletion benchmark
+    size_t commits = 2000;   ///< Transactions posted by the durable and asynchronous commit benchmarks
+    int iterations = 5;      ///< Runs of every benchmark
+    string directory;        ///< Where the ledger files are written
+    string output;           ///< The JSON file to write, or empty for the standard output
+};
+
+/**
+ * @brief The timings of one benchmark over all iterations.
+ */
+struct BenchmarkResult {
+    string name;            ///< Name of the benchmark
+    string unit;            ///< What one operation is
+    size_t operations;      ///< Operations per iteration
+    vector<double> seconds; ///< Duration of every iteration
+};
+
+/**
+ * @brief Stream buffer that drops everything written to it.
+ */
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return traits_type::not_eof(c); }
+    streamsize xsputn(const char *, streamsize count) override { return count; }
+};
+
+/**
+ * @brief Measures the duration of a call.
+ *
+ * @param work The code to time
+ * @return The duration in seconds
+ */
+template<typename Work>
+double timeIt(Work work) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    work();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Returns the result with the given name, adding it if needed.
+ *
+ * @param results The results so far
+ * @param name The name of the benchmark
+ * @param unit What one operation is
+ * @param operations Operations per iteration
+ * @return The result
+ */
+BenchmarkResult &resultFor(vector<BenchmarkResult> &results, const string &name, const string &unit,
+                           size_t operations) {
+    for (BenchmarkResult &result: results) {
+        if (result.name == name) {
+            return result;
+        }
+    }
+    results.push_back(BenchmarkResult{name, unit, operations, {}});
+    return results.back();
+}
+
+/**
+ * @brief Reads a positive integer option.
+ *
+ * @param name The name of the option
+ * @param value The text of its value
+ * @return The value
+ * @throws invalid_argument If the value is not a positive integer
+ */
+size_t readCount(const string &name, const char *value) {
+    char *end = nullptr;
+    unsigned long long count = value ? strtoull(value, &end, 10) : 0;
+    if (!value || *value == '\0' || *end != '\0' || count == 0) {
+        throw invalid_argument("Option " + name + " needs a positive integer");
+    }
+    return static_cast<size_t>(count);
+}
+
+/**
+ * @brief Writes the results as JSON.
+ *
+ * @param out The stream to write to
+ * @param ledger The benchmarked ledger
+ * @param settings The settings of the run
+ * @param results The results
+ */
+void writeJson(ostream &out, const SyntheticLedger &ledger, const BenchmarkSettings &settings,
+               const vector<BenchmarkResult> &results) {
+    const SyntheticLedgerOptions &options = ledger.getOptions();
+    out << setprecision(9);
+    out << "{\n";
+    out << "  \"suite\": \"ADS_benchmarks\",\n";
+    out << "  \"config\": {\n";
+    out << "    \"roots\": " << options.roots << ",\n";
+    out << "    \"depth\": " << options.depth << ",\n";
+    out << "    \"fan_out\": " << options.fanOut << ",\n";
+    out << "    \"accounts\": " << ledger.getAccounts().size() << ",\n";
+    out << "    \"transactions\": " << options.transactions << ",\n";
+    out << "    \"posts\": " << settings.posts << ",\n";
+    out << "    \"lookups\": " << settings.lookups << ",\n";
+    out << "    \"deletes\": " << settings.deletes << ",\n";
+    out << "    \"commits\": " << settings.commits << ",\n";
+    out << "    \"iterations\": " << settings.iterations << ",\n";
+    out << "    \"seed\": " << options.seed << ",\n";
+    out << "    \"hardware_threads\": " << thread::hardware_concurrency() << "\n";
+    out << "  },\n";
+    out << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult &result = results[i];
+        vector<double> sorted = result.seconds;
+        sort(sorted.begin(), sorted.end());
+        double median = sorted.size() % 2 == 1 ? sorted[sorted.size() / 2]
+                                               : (sorted[sorted.size() / 2 - 1] + sorted[sorted.size() / 2]) / 2;
+        double mean = 0;
+        for (double seconds: sorted) {
+            mean += seconds / sorted.size();
+        }
+
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\n";
+        out << "      \"name\": \"" << result.name << "\",\n";
+        out << "      \"unit\": \"" << result.unit << "\",\n";
+        out << "      \"operations\": " << result.operations << ",\n";
+        out << "      \"iterations\": " << sorted.size() << ",\n";
+        out << "      \"min_seconds\": " << sorted.front() << ",\n";
+        out << "      \"median_seconds\": " << median << ",\n";
+        out << "      \"mean_seconds\": " << mean << ",\n";
+        out << "      \"max_seconds\": " << sorted.back() << ",\n";
+        out << "      \"ns_per_op\": " << median * 1e9 / result.operations << ",\n";
+        out << "      \"ops_per_second\": " << (median > 0 ? result.operations / median : 0) << "\n";
+        out << "    }";
+    }
+    out << "\n  ],\n";
+
+    // Operation latencies and counters over the whole run, all 0 unless built with ADS_ENABLE_METRICS
+    MetricsSnapshot metrics = ForestMetrics::snapshot();
+    out << "  \"metrics\": {\n";
+    out << "    \"enabled\": " << (metrics.enabled ? "true" : "false") << ",\n";
+    out << "    \"operations\": {";
+    for (size_t i = 0; i < metrics.operations.size(); ++i) {
+        const OperationMetrics &operation = metrics.operations[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "      \"" << operation.name << "\": {\"calls\": " << operation.calls << ", \"mean_ns\": "
+            << (operation.calls ? operation.totalNanos / operation.calls : 0) << ", \"p50_ns\": "
+            << operation.percentile(0.5) << ", \"p99_ns\": " << operation.percentile(0.99) << ", \"max_ns\": "
+            << operation.maxNanos << ", \"node_visits\": " << operation.nodeVisits << ", \"bytes_written\": "
+            << operation.bytesWritten << "}";
+    }
+    out << "\n    },\n";
+    out << "    \"counters\": {";
+    for (size_t i = 0; i < metrics.counters.size(); ++i) {
+        out << (i == 0 ? "\n" : ",\n");
+        out << "      \"" << metrics.counters[i].first << "\": " << metrics.counters[i].second;
+    }
+    out << "\n    }\n";
+    out << "  }\n}\n";
+}
+
+/**
+ * @brief Runs every benchmark once on a fresh copy of the ledger files.
+ *
+ * @param ledger The ledger
+ * @param settings The settings of the run
+ * @param chart The generated chart file
+ * @param transactions The generated transactions file
+ * @param results Receives the timings
+ */
+void runIteration(const SyntheticLedger &ledger, const BenchmarkSettings &settings, const string &chart,
+                  const string &transactions, vector<BenchmarkResult> &results) {
+    namespace fs = std::filesystem;
+    ForestTree tree;
+    string workChart = (fs::path(settings.directory) / "work.txt").string();
+    fs::remove(tree.getJournalFilename(workChart));
+    fs::copy_file(chart, workChart, fs::copy_options::overwrite_existing);
+    fs::copy_file(transactions, tree.getTransactionFilename(workChart), fs::copy_options::overwrite_existing);
+
+    const vector<int> &accounts = ledger.getAccounts();
+    size_t accountCount = accounts.size();
+    size_t transactionCount = ledger.getOptions().transactions;
+
+    resultFor(results, "build_from_file", "account", accountCount).seconds.push_back(timeIt([&]() {
+        tree.buildFromFile(workChart);
+    }));
+
+    size_t found = 0;
+    resultFor(results, "find_account", "lookup", settings.lookups).seconds.push_back(timeIt([&]() {
+        for (size_t i = 0; i < settings.lookups; ++i) {
+            found += tree.findAccount(accounts[(i * 7919) % accountCount]) != nullptr;
+        }
+    }));
+    if (found != settings.lookups) {
+        throw runtime_error("Lookup benchmark missed an account");
+    }
+
+    vector<pair<int, Transaction>> posts;
+    posts.reserve(settings.posts);
+    for (size_t i = 0; i < settings.posts; ++i) {
+        int accountNumber;
+        Transaction transaction = ledger.makeTransaction(i, accountNumber);
+        posts.push_back(make_pair(accountNumber, move(transaction)));
+    }
+    // Posting and deletion measure the in-memory work; durable commits are measured on their own below
+    tree.setDurableCommits(false);
+    resultFor(results, "add_transaction", "transaction", settings.posts).seconds.push_back(timeIt([&]() {
+        for (pair<int, Transaction> &post: posts) {
+            tree.addTransaction(post.first, post.second);
+        }
+    }));
+
+    const vector<int> &leaves = ledger.getLeaves();
+    resultFor(results, "delete_transaction", "transaction", settings.deletes).seconds.push_back(timeIt([&]() {
+        for (size_t i = 0; i < settings.deletes; ++i) {
+            int accountNumber = leaves[(i * 104729) % leaves.size()];
+            tree.deleteTransaction(accountNumber, 0);
+        }
+    }));
+
+    // Every posting waits for its journal sync; threads posting at the same time share one
+    tree.setDurableCommits(true);
+    size_t commitThreads = max(1u, thread::hardware_concurrency());
+    resultFor(results, "durable_commit", "transaction", settings.commits).seconds.push_back(timeIt([&]() {
+        ForestTree::runParallel(commitThreads, commitThreads, [&](size_t worker) {
+            for (size_t i = worker; i < settings.commits && !posts.empty(); i += commitThreads) {
+                // A repost is a new transaction, so it draws a new ID instead of reusing the posted one
+                Transaction repost = posts[i % posts.size()].second;
+                repost.setTransactionID("");
+                tree.addTransaction(posts[i % posts.size()].first, repost);
+            }
+        });
+    }));
+
+    // Postings only queue their records; the writer thread syncs them, and the run ends once all are durable
+    tree.setAsyncCommits(true);
+    resultFor(results, "async_commit", "transaction", settings.commits).seconds.push_back(timeIt([&]() {
+        ForestTree::runParallel(commitThreads, commitThreads, [&](size_t worker) {
+            for (size_t i = worker; i < settings.commits && !posts.empty(); i += commitThreads) {
+                // A repost is a new transaction, so it draws a new ID instead of reusing the posted one
+                Transaction repost = posts[i % posts.size()].second;
+                repost.setTransactionID("");
+                tree.addTransaction(posts[i % posts.size()].first, repost);
+            }
+        });
+        tree.whenDurable().get();
+    }));
+    tree.setAsyncCommits(false);
+
+    resultFor(results, "recompute_all_balances", "account", accountCount).seconds.push_back(timeIt([&]() {
+        tree.recomputeAllBalances();
+    }));
+
+    string report = (fs::path(settings.directory) / "report.txt").string();
+    resultFor(results, "print_detailed_report", "account", accountCount / ledger.getOptions().roots)
+            .seconds.push_back(timeIt([&]() {
+                tree.printDetailedReport(accounts.front(), report);
+            }));
+
+    ReportGenerator reports(tree, ReportFormat::CSV);
+    string reportDirectory = (fs::path(settings.directory) / "reports").string();
+    fs::create_directories(reportDirectory);
+    resultFor(results, "write_root_reports", "account", accountCount).seconds.push_back(timeIt([&]() {
+        reports.writeRootReports(reportDirectory);
+    }));
+
+    string savedTransactions = (fs::path(settings.directory) / "saved_transactions.txt").string();
+    resultFor(results, "save_transactions", "transaction", transactionCount + settings.posts)
+            .seconds.push_back(timeIt([&]() {
+                tree.saveTransactions(savedTransactions);
+            }));
+
+    resultFor(results, "save_to_file", "account", accountCount).seconds.push_back(timeIt([&]() {
+        tree.saveToFile(workChart);
+    }));
+}
+
+} // namespace
+
+/**
+ * @brief Generates the ledger, runs the benchmarks and writes their results.
+ *
+ * @param argc The number of arguments
+ * @param argv The arguments
+ * @return 0 on success, 1 on a usage or benchmark error
+ */
+int main(int argc, char **argv) {
+    namespace fs = std::filesystem;
+    SyntheticLedgerOptions options;
+    BenchmarkSettings settings;
+    settings.directory = (fs::temp_directory_path() / "ads_benchmarks").string();
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string name = argv[i];
+            const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (name == "--roots") {
+                options.roots = static_cast<int>(readCount(name, value));
+            } else if (name == "--depth") {
+                options.depth = static_cast<int>(readCount(name, value));
+            } else if (name == "--fanout") {
+                options.fanOut = static_cast<int>(readCount(name, value));
+            } else if (name == "--transactions") {
+                options.transactions = readCount(name, value);
+            } else if (name == "--seed") {
+                options.seed = static_cast<unsigned>(readCount(name, value));
+            } else if (name == "--posts") {
+                settings.posts = readCount(name, value);
+            } else if (name == "--lookups") {
+                settings.lookups = readCount(name, value);
+            } else if (name == "--deletes") {
+                settings.deletes = readCount(name, value);
+            } else if (name == "--commits") {
+                settings.commits = readCount(name, value);
+            } else if (name == "--iterations") {
+                settings.iterations = static_cast<int>(readCount(name, value));
+            } else if (name == "--dir" && value) {
+                settings.directory = value;
+            } else if (name == "--output" && value) {
+                settings.output = value;
+            } else {
+                throw invalid_argument("Unknown option: " + name);
+            }
+            ++i;
+        }
+
+        SyntheticLedger ledger(options);
+        fs::create_directories(settings.directory);
+        string chart = (fs::path(settings.directory) / "ledger.txt").string();
+        string transactions = (fs::path(settings.directory) / "ledger_transactions.txt").string();
+        ledger.writeChart(chart);
+        ledger.writeTransactions(transactions);
+
+        vector<BenchmarkResult> results;
+        NullBuffer discard;
+        streambuf *console = cout.rdbuf(&discard);
+        try {
+            for (int iteration = 0; iteration < settings.iterations; ++iteration) {
+                runIteration(ledger, settings, chart, transactions, results);
+            }
+        } catch (...) {
+            cout.rdbuf(console);
+            throw;
+        }
+        cout.rdbuf(console);
+
+        ForestTree names;
+        string workChart = (fs::path(settings.directory) / "work.txt").string();
+        for (const string &file: {chart, transactions, workChart, names.getTransactionFilename(workChart),
+                                  names.getJournalFilename(workChart),
+                                  (fs::path(settings.directory) / "report.txt").string(),
+                                  (fs::path(settings.directory) / "saved_transactions.txt").string()}) {
+            fs::remove(file);
+        }
+        fs::remove_all(fs::path(settings.directory) / "reports");
+
+        if (settings.output.empty()) {
+            writeJson(cout, ledger, settings, results);
+        } else {
+            ofstream out(settings.output);
+            if (!out.is_open()) {
+                throw runtime_error("Could not open file for writing: " + settings.output);
+            }
+            writeJson(out, ledger, settings, results);
+            cerr << "Benchmark results written to: " << settings.output << endl;
+        }
+    } catch (const exception &e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,178 @@
+//
+// Created on 10/14/2026.
+//
+
+/**
+ * @file SyntheticLedger.cpp
+ * @brief Implements the `SyntheticLedger` class, the data generator of the benchmarks.
+ */
+
+#include "SyntheticLedger.h"
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include "Money.h"
+
+using namespace std;
+
+/**
+ * @brief Creates the default options.
+ */
+SyntheticLedgerOptions::SyntheticLedgerOptions() : roots(9), depth(5), fanOut(6), transactions(200000), seed(42) {}
+
+/**
+ * @brief Builds the account list of a ledger.
+ *
+ * @param options The shape of the ledger
+ * @throws invalid_argument If the options are out of range
+ */
+SyntheticLedger::SyntheticLedger(const SyntheticLedgerOptions &options) : options(options) {
+    if (options.roots < 1 || options.roots > 9 || options.depth < 1 || options.depth > 9 ||
+        options.fanOut < 1 || options.fanOut > 10) {
+        throw invalid_argument("Synthetic ledger needs 1-9 roots, a depth of 1-9 and a fan-out of 1-10");
+    }
+
+    // Depth-first, children in ascending order, gives the pre-order of the chart
+    vector<pair<int, int>> stack;
+    for (int root = options.roots; root >= 1; --root) {
+        stack.push_back(make_pair(root, 1));
+    }
+    while (!stack.empty()) {
+        pair<int, int> entry = stack.back();
+        stack.pop_back();
+        accounts.push_back(entry.first);
+        if (entry.second == options.depth) {
+            leaves.push_back(entry.first);
+            continue;
+        }
+        for (int k = options.fanOut - 1; k >= 0; --k) {
+            stack.push_back(make_pair(entry.first * 10 + k, entry.second + 1));
+        }
+    }
+}
+
+/**
+ * @brief Returns the options of the ledger.
+ *
+ * @return The options
+ */
+const SyntheticLedgerOptions &SyntheticLedger::getOptions() const {
+    return options;
+}
+
+/**
+ * @brief Returns every account number, each parent before its children.
+ *
+ * @return The account numbers
+ */
+const vector<int> &SyntheticLedger::getAccounts() const {
+    return accounts;
+}
+
+/**
+ * @brief Returns the account numbers of the last level.
+ *
+ * @return The account numbers
+ */
+const vector<int> &SyntheticLedger::getLeaves() const {
+    return leaves;
+}
+
+/**
+ * @brief Writes the chart of accounts, with every balance zero.
+ *
+ * @param filename The chart file to write
+ * @throws runtime_error If the file cannot be written
+ */
+void SyntheticLedger::writeChart(const string &filename) const {
+    ofstream out(filename, ios::binary);
+    if (!out.is_open()) {
+        throw runtime_error("Could not open file for writing: " + filename);
+    }
+    for (int accountNumber: accounts) {
+        out << accountNumber << " Account " << accountNumber << " 0.00\n";
+    }
+    if (!out) {
+        throw runtime_error("Could not write file: " + filename);
+    }
+}
+
+/**
+ * @brief Writes the transaction stream.
+ *
+ * @param filename The transactions file to write
+ * @throws runtime_error If the file cannot be written
+ */
+void SyntheticLedger::writeTransactions(const string &filename) const {
+    ofstream out(filename, ios::binary);
+    if (!out.is_open()) {
+        throw runtime_error("Could not open file for writing: " + filename);
+    }
+
+    int accountNumber;
+    long long units;
+    char type;
+    string date;
+    for (size_t i = 0; i < options.transactions; ++i) {
+        generate(i, 0, accountNumber, units, type, date);
+        out << accountNumber << "|SYN" << i << "|" << Money::fromUnits(units) << "|" << type << "|" << date
+            << "|Synthetic transaction " << i % 1000 << '\n';
+    }
+    if (!out) {
+        throw runtime_error("Could not write file: " + filename);
+    }
+}
+
+/**
+ * @brief Generates one transaction that is not part of the transactions file.
+ *
+ * @param index The position of the transaction in the generated sequence
+ * @param accountNumber Receives the account number to post it to
+ * @return The transaction
+ */
+Transaction SyntheticLedger::makeTransaction(size_t index, int &accountNumber) const {
+    long long units;
+    char type;
+    string date;
+    generate(index, 1, accountNumber, units, type, date);
+    return Transaction("", Money::fromUnits(units), type, "Posted transaction", move(date));
+}
+
+/**
+ * @brief Derives the fields of a generated transaction from its position.
+ *
+ * @param index The position of the transaction
+ * @param stream Separates the transactions file from the posted transactions
+ * @param accountNumber Receives the account number
+ * @param units Receives the amount in `Money` units
+ * @param type Receives 'D' or 'C'
+ * @param date Receives the date
+ *
+ * Every transaction is derived from a hash of the seed, the stream and its position, so any one can be generated
+ * without the ones before it.
+ */
+void SyntheticLedger::generate(size_t index, unsigned stream, int &accountNumber, long long &units, char &type,
+                               string &date) const {
+    uint64_t state = (static_cast<uint64_t>(options.seed) << 32 | stream) * 0x9E3779B97F4A7C15ULL + index;
+    accountNumber = leaves[mix(state) % leaves.size()];
+    units = 1 + static_cast<long long>(mix(state) % 10000000);
+    type = mix(state) % 2 == 0 ? 'D' : 'C';
+
+    char buffer[11];
+    snprintf(buffer, sizeof(buffer), "2024-%02u-%02u", 1 + static_cast<unsigned>(mix(state) % 12),
+             1 + static_cast<unsigned>(mix(state) % 28));
+    date = buffer;
+}
+
+/**
+ * @brief Advances a splitmix64 generator.
+ *
+ * @param state The state of the generator
+ * @return The next pseudo-random number
+ */
+uint64_t SyntheticLedger::mix(uint64_t &state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
@@ -0,0 +1,123 @@
+//
+// Created on 10/14/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_SYNTHETICLEDGER_H
+#define ADS_MIDTERM_PROJECT_SYNTHETICLEDGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Transaction.h"
+
+using namespace std;
+
+/**
+ * @brief The shape of a generated chart of accounts and the size of its transaction stream.
+ */
+struct SyntheticLedgerOptions {
+    int roots;             ///< Number of root accounts, 1 to 9
+    int depth;             ///< Number of levels of every root tree, the root included, 1 to 9
+    int fanOut;            ///< Number of children of every account above the last level, 1 to 10
+    size_t transactions;   ///< Number of transactions in the generated transactions file
+    unsigned seed;         ///< Seed of the generator, so runs with the same options see the same data
+
+    /**
+     * @brief Creates the default options: 9 roots, 5 levels, 6 children per account and 200000 transactions.
+     */
+    SyntheticLedgerOptions();
+};
+
+/**
+ * @class SyntheticLedger
+ * @brief Generates charts of accounts and transaction streams of a configurable size for benchmarks.
+ *
+ * @details Accounts are numbered the way the chart expects: the children of account n are n * 10 + k, so every tree is
+ * complete, with `fanOut` children per account and `depth` levels. Transactions are posted to random accounts of the
+ * last level, with random amounts, types and dates in 2024. The same options always give the same ledger.
+ */
+class SyntheticLedger {
+public:
+    /**
+     * @brief Builds the account list of a ledger.
+     *
+     * @param options The shape of the ledger
+     * @throws invalid_argument If the options are out of range
+     */
+    explicit SyntheticLedger(const SyntheticLedgerOptions &options);
+
+    /**
+     * @brief Returns the options of the ledger.
+     *
+     * @return The options
+     */
+    const SyntheticLedgerOptions &getOptions() const;
+
+    /**
+     * @brief Returns every account number, each parent before its children.
+     *
+     * @return The account numbers
+     */
+    const vector<int> &getAccounts() const;
+
+    /**
+     * @brief Returns the account numbers of the last level, which receive the transactions.
+     *
+     * @return The account numbers
+     */
+    const vector<int> &getLeaves() const;
+
+    /**
+     * @brief Writes the chart of accounts, with every balance zero.
+     *
+     * @param filename The chart file to write
+     * @throws runtime_error If the file cannot be written
+     */
+    void writeChart(const string &filename) const;
+
+    /**
+     * @brief Writes the transaction stream in the format read by `ForestTree::loadTransactions`.
+     *
+     * @param filename The transactions file to write
+     * @throws runtime_error If the file cannot be written
+     */
+    void writeTransactions(const string &filename) const;
+
+    /**
+     * @brief Generates one transaction that is not part of the transactions file, for posting benchmarks.
+     *
+     * @param index The position of the transaction in the generated sequence
+     * @param accountNumber Receives the account number to post it to
+     * @return The transaction, with an empty ID so that one is generated when it is posted
+     */
+    Transaction makeTransaction(size_t index, int &accountNumber) const;
+
+private:
+    SyntheticLedgerOptions options; ///< The shape of the ledger
+    vector<int> accounts;           ///< Every account number, in pre-order
+    vector<int> leaves;             ///< The account numbers of the last level
+
+    /**
+     * @brief Derives the fields of a generated transaction from its position.
+     *
+     * @param index The position of the transaction
+     * @param stream Separates the transactions file from the posted transactions
+     * @param accountNumber Receives the account number
+     * @param units Receives the amount in `Money` units
+     * @param type Receives 'D' or 'C'
+     * @param date Receives the date as `YYYY-MM-DD`
+     */
+    void generate(size_t index, unsigned stream, int &accountNumber, long long &units, char &type,
+                  string &date) const;
+
+    /**
+     * @brief Advances a splitmix64 generator.
+     *
+     * @param state The state of the generator
+     * @return The next pseudo-random number
+     */
+    static uint64_t mix(uint64_t &state);
+};
+
+#endif //ADS_MIDTERM_PROJECT_SYNTHETICLEDGER_H
@@ -6,13 +6,23 @@
  * including adding accounts, applying transactions, generating reports, and more.
  * The accounts are managed using a ForestTree data structure and are saved to or
  * loaded from files for persistence.
+ *
+ * Started with `--chart`, it runs headless instead: commands and transactions are read
+ * from a file or the standard input and run by a `BatchRunner`, see `run_batch`.
  */
 #include <iostream>
 #include <string>
 #include <filesystem>
 #include "ForestTree.h"
-#include <direct.h>
+#include "BatchRunner.h"
+#include "PartitionedLedger.h"
+#include "ReportGenerator.h"
+#include "ForestMetrics.h"
+#include "TransactionIdGenerator.h"
+#include <cstdlib>
 #include <fstream>
+#include <algorithm>
+#include <chrono>
 
 using namespace std;
 
@@ -28,6 +38,12 @@ void display_menu() {
     cout << "4. Delete Transaction" << endl;
     cout << "5. Display Chart of Accounts" << endl;
     cout << "6. Search Account" << endl;
+    cout << "7. Save Binary Snapshot" << endl;
+    cout << "8. Export Text Files" << endl;
+    cout << "9. Balance As Of Date" << endl;
+    cout << "10. Delete Transaction By ID" << endl;
+    cout << "11. Check Balances Against Transactions" << endl;
+    cout << "12. Generate Reports For All Root Accounts" << endl;
     cout << "0. Exit" << endl;
     cout << "\nEnter choice: ";
 }
@@ -38,35 +54,202 @@ void display_menu() {
  */
 void ensure_reports_directory() {
     const string reportDir = "reports";
-    if (_mkdir(reportDir.c_str()) == 0) {
+    error_code error;
+    if (filesystem::create_directories(reportDir, error)) {
         cout << "Created reports directory." << endl;
     }
-    // If directory already exists, -1 is returned but that's okay
+    // If directory already exists, nothing is created but that's okay
 }
 
 /**
  * @brief Retrieves the file path to the project file containing account data.
  *
+ * The `ADS_CHART` environment variable names the file if it is set. Otherwise the file
+ * is looked up in the CLion project folder under the home directory, read from
+ * `USERPROFILE` on Windows and `HOME` elsewhere.
+ *
  * @return The file path as a string.
  */
 string getProjectPath() {
-    string userProfile = getenv("USERPROFILE"); // Gets C:\Users\User
-    return userProfile + "\\CLionProjects\\ADS-MID\\accountswithspace.txt";
+    const char *chart = getenv("ADS_CHART");
+    if (chart && *chart) {
+        return chart;
+    }
+    const char *home = getenv("USERPROFILE"); // Gets C:\Users\User
+    if (!home || !*home) {
+        home = getenv("HOME");
+    }
+    filesystem::path projectDir = filesystem::path(home ? home : ".") / "CLionProjects" / "ADS-MID";
+    return (projectDir / "accountswithspace.txt").string();
+}
+
+/**
+ * @brief Prints how to start the program in batch mode.
+ *
+ * @param program The name the program was started with.
+ */
+void print_usage(const string &program) {
+    cerr << "Usage: " << program << " [--chart FILE [--journal FILE] [--input FILE] [--output FILE]"
+         << " [--batch-size N] [--commits durable|async] [--metrics FILE [--metrics-interval SECONDS]]]" << endl;
+    cerr << "       " << program << " --chart FILE --split DIRECTORY [--layout GROUPS]" << endl;
+    cerr << "Without options the interactive menu is shown. With --chart, commands and transactions are read"
+         << " from --input, or the standard input, and results are written to --output, or the standard output."
+         << endl;
+    cerr << "With --commits async, postings do not wait for the journal: a background thread writes and syncs it,"
+         << " and the run waits for it before saving." << endl;
+    cerr << "With --metrics, a metrics snapshot is appended to FILE every --metrics-interval seconds, 10 by default,"
+         << " and once more at the end; the program must be built with ADS_ENABLE_METRICS to collect them." << endl;
+    cerr << "With --split, the chart and its transactions are split into one partition per group of leading digits,"
+         << " such as 1,2,3,4,5,6789, in DIRECTORY; see PartitionedLedger." << endl;
+}
+
+/**
+ * @brief Runs the program headless: loads a chart, runs a command stream and saves the results.
+ *
+ * Progress messages of the forest go to the standard error, so the output only holds the
+ * records written by the `BatchRunner`.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments.
+ * @return 0 if every command succeeded, 2 if some failed, 1 on a usage or load error.
+ */
+int run_batch(int argc, char *argv[]) {
+    string chart, journal, input, output, metrics, split;
+    string layout = PartitionedLedger::DEFAULT_LAYOUT;
+    size_t batchSize = BatchRunner::DEFAULT_BATCH_SIZE;
+    size_t metricsInterval = 10;
+    bool asyncCommits = false;
+
+    for (int i = 1; i < argc; ++i) {
+        string option = argv[i];
+        if (i + 1 >= argc) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        string value = argv[++i];
+        if (option == "--chart") {
+            chart = value;
+        } else if (option == "--journal") {
+            journal = value;
+        } else if (option == "--input") {
+            input = value;
+        } else if (option == "--output") {
+            output = value;
+        } else if (option == "--batch-size" && value.find_first_not_of("0123456789") == string::npos) {
+            batchSize = stoul(value);
+        } else if (option == "--commits" && (value == "durable" || value == "async")) {
+            asyncCommits = value == "async";
+        } else if (option == "--split") {
+            split = value;
+        } else if (option == "--layout") {
+            layout = value;
+        } else if (option == "--metrics") {
+            metrics = value;
+        } else if (option == "--metrics-interval" && !value.empty() &&
+                   value.find_first_not_of("0123456789") == string::npos) {
+            metricsInterval = max(size_t(1), static_cast<size_t>(stoul(value)));
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (chart.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (!filesystem::exists(chart)) {
+        cerr << "Error: Chart file not found: " << chart << endl;
+        return 1;
+    }
+    if (!split.empty()) {
+        try {
+            size_t written = PartitionedLedger::split(chart, split, layout);
+            cerr << written << " account(s) split into " << split << endl;
+            return 0;
+        } catch (const exception &e) {
+            cerr << "Error: " << e.what() << endl;
+            return 1;
+        }
+    }
+
+    ifstream inFile;
+    if (!input.empty() && input != "-") {
+        inFile.open(input);
+        if (!inFile.is_open()) {
+            cerr << "Error: Unable to open input file: " << input << endl;
+            return 1;
+        }
+    }
+    ofstream outFile;
+    if (!output.empty() && output != "-") {
+        outFile.open(output);
+        if (!outFile.is_open()) {
+            cerr << "Error: Unable to open output file: " << output << endl;
+            return 1;
+        }
+    }
+
+    if (!metrics.empty() && !ForestMetrics::startDump(metrics, chrono::seconds(metricsInterval))) {
+        cerr << "Error: Unable to open metrics file: " << metrics << endl;
+        return 1;
+    }
+
+    ios::sync_with_stdio(false);
+    ostream results(outFile.is_open() ? outFile.rdbuf() : cout.rdbuf());
+    streambuf *console = cout.rdbuf(cerr.rdbuf());
+
+    int status = 0;
+    try {
+        ForestTree tree;
+        tree.setJournalFilename(journal);
+        tree.buildFromFile(chart);
+        tree.setAsyncCommits(asyncCommits);
+
+        BatchRunner runner(tree, chart, results);
+        runner.setBatchSize(batchSize);
+        BatchSummary summary = runner.run(inFile.is_open() ? static_cast<istream &>(inFile) : cin);
+        status = summary.failed == 0 ? 0 : 2;
+    } catch (const exception &e) {
+        cerr << "Error: " << e.what() << endl;
+        status = 1;
+    }
+    cout.rdbuf(console);
+    ForestMetrics::stopDump();
+    return status;
 }
 
 /**
  * @brief The main entry point of the program. Provides a menu-based interface
- *        for managing the chart of accounts.
+ *        for managing the chart of accounts, or runs headless when given options.
  *
+ * @param argc The number of arguments.
+ * @param argv The arguments.
  * @return Exit status of the program.
  */
-int main() {
+int main(int argc, char *argv[]) {
+    // A bad ADS_NODE_ID stops the program, since falling back to node 0 could collide with another node's IDs
+    try {
+        TransactionIdGenerator::global();
+    } catch (const invalid_argument &e) {
+        cout << "Error: " << e.what() << endl;
+        return 1;
+    }
+
+    if (argc > 1) {
+        return run_batch(argc, argv);
+    }
+
     ForestTree tree;
 
     ensure_reports_directory();
 
-    // Build chart of accounts from a file
-    tree.buildFromFile(getProjectPath());
+    // Build chart of accounts from a file; a journal with missing records must not be written to
+    try {
+        tree.buildFromFile(getProjectPath());
+    } catch (const runtime_error &e) {
+        cout << "Error: " << e.what() << endl;
+        return 1;
+    }
 
     int choice;
     do {
@@ -77,7 +260,7 @@ int main() {
             case 1: {
                 int accountNumber;
                 string description;
-                double balance;
+                Money balance;
 
                 // Get account number
                 while (true) {
@@ -133,15 +316,9 @@ int main() {
                 Transaction newTransaction;
                 cin >> newTransaction;  // This will prompt for all transaction details
 
+                // The journal record is synced before addTransaction returns, the chart is saved on exit
                 if (tree.addTransaction(accountNumber, newTransaction)) {
-                    // Save changes to file after successful transaction
-                    try {
-                        tree.saveToFile(getProjectPath());
-                        tree.saveTransactions(tree.getTransactionFilename(getProjectPath()));
-                        cout << "\nTransaction applied and saved successfully." << endl;
-                    } catch (const exception &e) {
-                        cerr << "Transaction applied but failed to save: " << e.what() << endl;
-                    }
+                    cout << "\nTransaction applied and saved successfully." << endl;
                 } else {
                     cout << "Failed to apply transaction." << endl;
                 }
@@ -219,7 +396,7 @@ int main() {
 
                 NodePtr accountNode = tree.findAccount(accountNumber);
                 if (accountNode) {
-                    const vector<Transaction> &transactions = accountNode->getData().getTransactions();
+                    TransactionView transactions = accountNode->getData().getTransactions();
                     if (transactions.empty()) {
                         cout << "No transactions found for this account.\n";
                         break;
@@ -236,14 +413,7 @@ int main() {
                     cin >> transactionIndex;
 
                     if (tree.deleteTransaction(accountNumber, transactionIndex)) {
-                        // Save changes to file after successful deletion
-                        try {
-                            tree.saveToFile(getProjectPath());
-                            tree.saveTransactions(tree.getTransactionFilename(getProjectPath()));
-                            cout << "Transaction deleted and changes saved successfully.\n";
-                        } catch (const exception &e) {
-                            cerr << "Transaction deleted but failed to save changes: " << e.what() << endl;
-                        }
+                        cout << "Transaction deleted and changes saved successfully.\n";
                     } else {
                         cout << "Failed to delete transaction.\n";
                     }
@@ -258,6 +428,89 @@ int main() {
                 break;
             }
             case 6: {
+                int mode;
+                cout << "Search by: 1. Account number  2. Number prefix  3. Description keywords\n";
+                cout << "Enter choice: ";
+                if (!(cin >> mode) || mode < 1 || mode > 3) {
+                    cout << "Invalid choice.\n";
+                    cin.clear();
+                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                    break;
+                }
+
+                vector<int> matches;
+                if (mode == 3) {
+                    string keywords;
+                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                    cout << "Enter keywords: ";
+                    getline(cin, keywords);
+                    matches = tree.findAccountsByKeywords(keywords);
+                } else {
+                    int accountNumber;
+                    while (true) {
+                        cout << (mode == 1 ? "Enter account number: " : "Enter leading digits: ");
+                        if (cin >> accountNumber && accountNumber > 0) {
+                            break;
+                        }
+                        cout << "Invalid account number. Please enter a positive number.\n";
+                        cin.clear();
+                        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                    }
+
+                    if (mode == 1) {
+                        NodePtr accountNode = tree.findAccount(accountNumber);
+                        if (accountNode) {
+                            const Account &account = accountNode->getData();
+                            cout << "\nAccount Found:" << endl;
+                            cout << "Account Number: " << account.getAccountNumber() << endl;
+                            cout << "Description: " << account.getDescription() << endl;
+                            cout << "Balance: " << account.getBalance() << endl;
+                        } else {
+                            cout << "Account not found for account number: " << accountNumber << endl;
+                        }
+                        break;
+                    }
+                    matches = tree.findAccountsByPrefix(accountNumber);
+                }
+
+                const size_t shown = 20;
+                cout << "\n" << matches.size() << " account(s) found:\n";
+                for (size_t i = 0; i < matches.size() && i < shown; i++) {
+                    tree.readAccount(matches[i], [](const Account &account) {
+                        cout << account.getAccountNumber() << " - " << account.getDescription()
+                             << " (Balance: " << account.getBalance() << ")\n";
+                    });
+                }
+                if (matches.size() > shown) {
+                    cout << "... and " << matches.size() - shown << " more.\n";
+                }
+                break;
+            }
+            case 7:
+            case 8: {
+                string path;
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                cout << (choice == 7 ? "Enter snapshot file name: " : "Enter chart file name: ");
+                getline(cin, path);
+                if (path.empty()) {
+                    cout << "Error: File name cannot be empty.\n";
+                    break;
+                }
+
+                try {
+                    if (choice == 7) {
+                        tree.saveSnapshot(path);
+                        cout << "Snapshot saved to: " << path << endl;
+                    } else {
+                        tree.exportText(path);
+                        cout << "Chart and transactions exported to: " << path << endl;
+                    }
+                } catch (const exception &e) {
+                    cerr << "Error: " << e.what() << endl;
+                }
+                break;
+            }
+            case 9: {
                 int accountNumber;
                 while (true) {
                     cout << "Enter account number: ";
@@ -269,20 +522,82 @@ int main() {
                     cin.ignore(numeric_limits<streamsize>::max(), '\n');
                 }
 
-                NodePtr accountNode = tree.findAccount(accountNumber);
-                if (accountNode) {
-                    const Account &account = accountNode->getData();
-                    cout << "\nAccount Found:" << endl;
-                    cout << "Account Number: " << account.getAccountNumber() << endl;
-                    cout << "Description: " << account.getDescription() << endl;
-                    cout << "Balance: " << fixed << setprecision(2) << account.getBalance() << endl;
+                string date;
+                cout << "Enter date (YYYY-MM-DD or DD-MM-YY): ";
+                cin >> date;
+
+                try {
+                    cout << "Balance of account " << accountNumber << " and its sub-accounts as of " << date << ": "
+                         << tree.balanceAsOf(accountNumber, date) << endl;
+                } catch (const exception &e) {
+                    cerr << "Error: " << e.what() << endl;
+                }
+                break;
+            }
+            case 10: {
+                string transactionID;
+                cout << "Enter transaction ID: ";
+                cin >> transactionID;
+
+                if (tree.deleteTransactionById(transactionID)) {
+                    cout << "Transaction deleted and changes saved successfully.\n";
                 } else {
-                    cout << "Account not found for account number: " << accountNumber << endl;
+                    cout << "Failed to delete transaction.\n";
+                }
+                break;
+            }
+            case 11: {
+                vector<BalanceMismatch> mismatches = tree.recomputeAllBalances();
+                if (mismatches.empty()) {
+                    cout << "Every balance matches its transaction history.\n";
+                    break;
+                }
+
+                const size_t shown = 20;
+                cout << mismatches.size() << " account(s) disagree with their transaction history:\n";
+                for (size_t i = 0; i < mismatches.size() && i < shown; i++) {
+                    cout << "Account " << mismatches[i].accountNumber << ": stored " << mismatches[i].storedBalance
+                         << ", recomputed " << mismatches[i].recomputedBalance << "\n";
+                }
+                if (mismatches.size() > shown) {
+                    cout << "... and " << mismatches.size() - shown << " more.\n";
+                }
+
+                char answer;
+                cout << "Replace them with the recomputed balances? (y/n): ";
+                cin >> answer;
+                if (answer == 'y' || answer == 'Y') {
+                    tree.recomputeAllBalances(true);
+                    try {
+                        tree.saveToFile(getProjectPath());
+                        cout << "Balances recomputed and saved successfully.\n";
+                    } catch (const exception &e) {
+                        cerr << "Balances recomputed but failed to save: " << e.what() << endl;
+                    }
+                }
+                break;
+            }
+            case 12: {
+                string formatName;
+                cout << "Enter report format (text, csv or json): ";
+                cin >> formatName;
+                try {
+                    ReportGenerator generator(tree.view(), ReportGenerator::parseFormat(formatName));
+                    size_t written = generator.writeRootReports("reports");
+                    cout << "Reports of " << written << " account(s) generated successfully in: reports/\n";
+                } catch (const exception &e) {
+                    cerr << "Error: " << e.what() << endl;
                 }
                 break;
             }
 
             case 0:
+                try {
+                    tree.saveToFile(getProjectPath());
+                    tree.compactJournal();
+                } catch (const exception &e) {
+                    cerr << "Failed to save the chart and compact the transaction journal: " << e.what() << endl;
+                }
                 cout << "Exiting program thank you for choosing us:)...\n";
                 break;
             default:
@@ -0,0 +1,236 @@
+//
+// Created on 10/15/2026.
+//
+
+/**
+ * @file DateBalanceIndexTest.cpp
+ * @brief Tests of the date index of account balances against brute-force sums.
+ *
+ * Every test feeds the same balance changes to a `DateBalanceIndex` and to a plain map from date to net change, then
+ * compares `sumThrough`, `sumBetween`, `total`, `size` and `collect` for every date around the indexed ones. The
+ * changes are drawn from a fixed seed, so a failure repeats.
+ *
+ * Usage: ADS_date_index_tests
+ */
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "DateBalanceIndex.h"
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief The net change of every date, the brute-force counterpart of the index.
+ */
+typedef map<int32_t, long long> DateSums;
+
+/**
+ * @brief Fails the current test unless a condition holds.
+ *
+ * @param condition The condition
+ * @param message What went wrong
+ * @throws runtime_error If the condition does not hold
+ */
+void check(bool condition, const string &message) {
+    if (!condition) {
+        throw runtime_error(message);
+    }
+}
+
+/**
+ * @brief Sums the changes of a date range by brute force.
+ *
+ * @param sums The net change of every date
+ * @param fromDate The first date included
+ * @param toDate The last date included
+ * @return The sum in `Money` units
+ */
+long long bruteSum(const DateSums &sums, int32_t fromDate, int32_t toDate) {
+    long long total = 0;
+    for (const pair<const int32_t, long long> &entry: sums) {
+        if (entry.first >= fromDate && entry.first <= toDate) {
+            total += entry.second;
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Compares every query of an index with the brute-force sums.
+ *
+ * Queries are made on every indexed date, one day before and after it, and before and after all of them, with
+ * ranges between a spread of pairs of those dates, including empty ones.
+ *
+ * @param index The index
+ * @param sums The net change of every date
+ * @param context What the index was built from, for the messages
+ */
+void checkAgainst(const DateBalanceIndex &index, const DateSums &sums, const string &context) {
+    check(index.size() == sums.size(), context + ": the index holds " + to_string(index.size()) + " dates instead of " +
+                                       to_string(sums.size()));
+    check(index.total().getUnits() == bruteSum(sums, INT32_MIN, INT32_MAX), context + ": wrong total");
+
+    vector<pair<int32_t, long long>> collected;
+    index.collect(collected);
+    check(collected == vector<pair<int32_t, long long>>(sums.begin(), sums.end()),
+          context + ": collect returned other dates or changes");
+
+    vector<int32_t> probes = {1, INT32_MAX - 1};
+    for (const pair<const int32_t, long long> &entry: sums) {
+        probes.push_back(entry.first - 1);
+        probes.push_back(entry.first);
+        probes.push_back(entry.first + 1);
+    }
+    for (int32_t date: probes) {
+        check(index.sumThrough(date).getUnits() == bruteSum(sums, INT32_MIN, date),
+              context + ": wrong sum through " + to_string(date));
+    }
+    for (size_t i = 0; i < probes.size(); i += 11) {
+        for (size_t j = 0; j < probes.size(); j += 7) {
+            int32_t fromDate = probes[i];
+            int32_t toDate = probes[j];
+            long long expected = fromDate <= toDate ? bruteSum(sums, fromDate, toDate) : 0;
+            check(index.sumBetween(fromDate, toDate).getUnits() == expected,
+                  context + ": wrong sum between " + to_string(fromDate) + " and " + to_string(toDate));
+        }
+    }
+}
+
+/**
+ * @brief Changes added one by one, mostly backdated, keep every sum right after every change.
+ */
+void testBackdatedAdds() {
+    mt19937 random(20261015);
+    uniform_int_distribution<int32_t> day(0, 365);
+    uniform_int_distribution<long long> amount(-100000, 100000);
+
+    DateBalanceIndex index;
+    DateSums sums;
+    for (int i = 0; i < 2000; ++i) {
+        // A later change lands on a random earlier date most of the time, and repeats a date often
+        int32_t date = 20250000 + day(random);
+        long long units = amount(random);
+        index.add(date, Money::fromUnits(units));
+        sums[date] += units;
+        if (i < 64 || i % 97 == 0) {
+            checkAgainst(index, sums, "after add " + to_string(i));
+        }
+    }
+    checkAgainst(index, sums, "after every add");
+}
+
+/**
+ * @brief Changes dated 0 are ignored, by `add` and by `assign`.
+ */
+void testZeroDates() {
+    DateBalanceIndex index;
+    index.add(0, Money::fromUnits(500));
+    checkAgainst(index, DateSums(), "add on date 0");
+
+    vector<pair<int32_t, long long>> entries = {{0, 100}, {20250301, 7}, {0, -40}, {20250101, 3}};
+    index.assign(entries);
+    checkAgainst(index, DateSums{{20250101, 3}, {20250301, 7}}, "assign with dates 0");
+
+    vector<pair<int32_t, long long>> zeros = {{0, 1}, {0, 2}};
+    index.assign(zeros);
+    checkAgainst(index, DateSums(), "assign of dates 0 only");
+}
+
+/**
+ * @brief `assign` adds up repeated dates in any order and replaces what was indexed, and `add` goes on from it.
+ */
+void testAssign() {
+    mt19937 random(4242);
+    uniform_int_distribution<int32_t> day(0, 60);
+    uniform_int_distribution<long long> amount(-5000, 5000);
+
+    DateBalanceIndex index;
+    index.add(20240101, Money::fromUnits(999));
+    for (size_t count: {size_t(0), size_t(1), size_t(2), size_t(17), size_t(500), size_t(5000)}) {
+        vector<pair<int32_t, long long>> entries;
+        DateSums sums;
+        for (size_t i = 0; i < count; ++i) {
+            // Every eighth entry is dated 0, and with 61 days most dates repeat
+            int32_t date = i % 8 == 7 ? 0 : 20250000 + day(random);
+            long long units = amount(random);
+            entries.push_back(make_pair(date, units));
+            if (date != 0) {
+                sums[date] += units;
+            }
+        }
+        index.assign(entries);
+        checkAgainst(index, sums, "assign of " + to_string(count) + " entries");
+
+        for (int i = 0; i < 200; ++i) {
+            int32_t date = 20250000 + day(random) * 2;
+            long long units = amount(random);
+            index.add(date, Money::fromUnits(units));
+            sums[date] += units;
+        }
+        checkAgainst(index, sums, "adds after assign of " + to_string(count) + " entries");
+    }
+}
+
+/**
+ * @brief Indexes collected from others and assigned again, as parent accounts are built, hold the combined sums.
+ */
+void testCollectAndReassign() {
+    mt19937 random(77);
+    uniform_int_distribution<int32_t> day(0, 90);
+    uniform_int_distribution<long long> amount(-1000, 1000);
+
+    DateBalanceIndex children[3];
+    DateSums sums;
+    for (DateBalanceIndex &child: children) {
+        for (int i = 0; i < 300; ++i) {
+            int32_t date = 20250000 + day(random);
+            long long units = amount(random);
+            child.add(date, Money::fromUnits(units));
+            sums[date] += units;
+        }
+    }
+    vector<pair<int32_t, long long>> entries;
+    for (const DateBalanceIndex &child: children) {
+        child.collect(entries);
+    }
+    DateBalanceIndex parent;
+    parent.assign(entries);
+    checkAgainst(parent, sums, "parent of three collected indexes");
+}
+
+} // namespace
+
+/**
+ * @brief Runs every test and reports the failed ones.
+ *
+ * @return 0 if every test passed, 1 otherwise.
+ */
+int main() {
+    vector<pair<string, function<void()>>> tests = {
+            {"backdated_adds",       testBackdatedAdds},
+            {"zero_dates",           testZeroDates},
+            {"assign",               testAssign},
+            {"collect_and_reassign", testCollectAndReassign},
+    };
+
+    int failed = 0;
+    for (const pair<string, function<void()>> &test: tests) {
+        try {
+            test.second();
+            cout << "PASS " << test.first << endl;
+        } catch (const exception &e) {
+            cout << "FAIL " << test.first << ": " << e.what() << endl;
+            ++failed;
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,580 @@
+//
+// Created on 10/15/2026.
+//
+
+/**
+ * @file JournalRecoveryTest.cpp
+ * @brief Recovery tests of the transaction journal: torn records, sequence gaps, compaction and crashes during saves.
+ *
+ * Every test works on a small chart in its own directory. A crash is simulated by copying the ledger files while the
+ * forest that wrote them is still open, and recovery by loading the copies into a new forest, which has to end up
+ * with the same balances and transactions as the forest that crashed. Write failures are simulated with a file size
+ * limit, on systems that have one, with durable and with asynchronous commits; a failed checkpoint with a directory
+ * in the place of its temporary file.
+ *
+ * Usage: ADS_tests [DIR]
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ForestTree.h"
+#include "TransactionJournal.h"
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Stream buffer that drops everything written to it.
+ */
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return traits_type::not_eof(c); }
+    streamsize xsputn(const char *, streamsize count) override { return count; }
+};
+
+/**
+ * @brief The accounts of the test chart.
+ */
+const vector<int> ACCOUNTS = {1, 11, 12, 2, 21};
+
+/**
+ * @brief The balance and the transaction IDs of an account.
+ */
+typedef pair<Money, vector<string>> AccountState;
+
+/**
+ * @brief Fails the current test unless a condition holds.
+ *
+ * @param condition The condition
+ * @param message What went wrong
+ * @throws runtime_error If the condition does not hold
+ */
+void check(bool condition, const string &message) {
+    if (!condition) {
+        throw runtime_error(message);
+    }
+}
+
+/**
+ * @brief Reads a whole file.
+ *
+ * @param path The file
+ * @return The contents
+ */
+string readFile(const string &path) {
+    ifstream in(path, ios::binary);
+    stringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+
+/**
+ * @brief Replaces a whole file.
+ *
+ * @param path The file
+ * @param contents The new contents
+ */
+void writeFile(const string &path, const string &contents) {
+    ofstream out(path, ios::binary | ios::trunc);
+    out << contents;
+}
+
+/**
+ * @brief Creates a fresh directory holding the test chart, with balance fields wide enough to be saved in place.
+ *
+ * @param root The directory of all tests
+ * @param name The name of the test
+ * @return The path of the chart
+ */
+string makeChart(const string &root, const string &name) {
+    fs::path directory = fs::path(root) / name;
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    string chart = (directory / "chart.txt").string();
+    writeFile(chart, "1 Assets           0.00\n"
+                     "11 Cash            0.00\n"
+                     "12 Bank            0.00\n"
+                     "2 Liabilities      0.00\n"
+                     "21 Loans           0.00\n");
+    return chart;
+}
+
+/**
+ * @brief Posts a transaction with a generated ID.
+ *
+ * @param tree The forest
+ * @param accountNumber The account
+ * @param amount The amount
+ * @param type 'D' or 'C'
+ */
+void post(ForestTree &tree, int accountNumber, double amount, char type) {
+    Transaction transaction("", Money::fromDouble(amount), type, "test", "2026-10-15");
+    check(tree.addTransaction(accountNumber, transaction), "Posting to " + to_string(accountNumber) + " failed");
+}
+
+/**
+ * @brief Reads the balance and transaction IDs of every account of the test chart.
+ *
+ * @param tree The forest
+ * @return The state of every account, in `ACCOUNTS` order
+ */
+vector<AccountState> stateOf(const ForestTree &tree) {
+    vector<AccountState> states;
+    for (int accountNumber: ACCOUNTS) {
+        AccountState state;
+        bool found = tree.readAccount(accountNumber, [&](const Account &account) {
+            state.first = account.getBalance();
+            for (int i = 0; i < account.getTransactionCount(); ++i) {
+                state.second.push_back(account.getTransactions()[i].getTransactionID());
+            }
+        });
+        check(found, "Account " + to_string(accountNumber) + " is missing");
+        states.push_back(state);
+    }
+    return states;
+}
+
+/**
+ * @brief Checks that two forests hold the same balances and transactions.
+ *
+ * @param expected The state of the forest that crashed
+ * @param actual The state of the recovered forest
+ */
+void checkSameState(const vector<AccountState> &expected, const vector<AccountState> &actual) {
+    for (size_t i = 0; i < ACCOUNTS.size(); ++i) {
+        string account = to_string(ACCOUNTS[i]);
+        check(expected[i].first == actual[i].first, "Account " + account + " recovered balance " +
+                                                    actual[i].first.toString() + " instead of " +
+                                                    expected[i].first.toString());
+        check(expected[i].second == actual[i].second, "Account " + account + " recovered other transactions");
+    }
+}
+
+/**
+ * @brief Copies the chart, transactions file and journal of a forest, as a crash would leave them.
+ *
+ * @param tree The forest, still open
+ * @param chart The chart of the forest
+ * @param name The directory of the copy, next to the chart's
+ * @return The path of the copied chart
+ */
+string crashCopy(const ForestTree &tree, const string &chart, const string &name) {
+    fs::path directory = fs::path(chart).parent_path().parent_path() / name;
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    string copy = (directory / fs::path(chart).filename()).string();
+    vector<pair<string, string>> files = {
+            {chart,                              copy},
+            {tree.getTransactionFilename(chart), tree.getTransactionFilename(copy)},
+            {tree.getJournalFilename(chart),     tree.getJournalFilename(copy)}};
+    for (const pair<string, string> &file: files) {
+        if (fs::exists(file.first)) {
+            fs::copy_file(file.first, file.second);
+        }
+    }
+    return copy;
+}
+
+/**
+ * @brief A record torn by a crash is cut from the journal, and the journal goes on after the last whole record.
+ *
+ * @param root The directory of all tests
+ */
+void testTornTail(const string &root) {
+    string chart = makeChart(root, "torn_tail");
+    vector<AccountState> expected;
+    string journal;
+    {
+        ForestTree tree;
+        tree.buildFromFile(chart);
+        post(tree, 11, 100, 'D');
+        post(tree, 12, 40, 'C');
+        expected = stateOf(tree);
+        journal = tree.getJournalFilename(chart);
+    }
+    string intact = readFile(journal);
+    writeFile(journal, intact + "P|3|11|TORN|999.00|D|2026-10-15|te");
+
+    {
+        ForestTree tree;
+        tree.buildFromFile(chart);
+        checkSameState(expected, stateOf(tree));
+        check(readFile(journal) == intact, "The torn record was not cut from the journal");
+        post(tree, 21, 7, 'C');
+        expected = stateOf(tree);
+    }
+    ForestTree tree;
+    tree.buildFromFile(chart);
+    checkSameState(expected, stateOf(tree));
+}
+
+/**
+ * @brief A journal with a missing record is refused instead of replayed without it.
+ *
+ * @param root The directory of all tests
+ */
+void testSequenceGap(const string &root) {
+    string chart = makeChart(root, "sequence_gap");
+    string journal;
+    {
+        ForestTree tree;
+        tree.buildFromFile(chart);
+        post(tree, 11, 10, 'D');
+        post(tree, 11, 20, 'D');
+        post(tree, 12, 30, 'D');
+        journal = tree.getJournalFilename(chart);
+    }
+    string contents = readFile(journal);
+    size_t second = contents.find("P|2|");
+    check(second != string::npos, "The journal has no second record");
+    contents.erase(second, contents.find('\n', second) + 1 - second);
+    writeFile(journal, contents);
+
+    ForestTree tree;
+    bool refused = false;
+    try {
+        tree.buildFromFile(chart);
+    } catch (const runtime_error &) {
+        refused = true;
+    }
+    check(refused, "A journal with a gap was replayed");
+    check(readFile(journal) == contents, "A journal with a gap was written to");
+}
+
+/**
+ * @brief Changes made after a compaction are replayed on top of the compacted files, and only those.
+ *
+ * @param root The directory of all tests
+ */
+void testReplayAfterCompaction(const string &root) {
+    string chart = makeChart(root, "replay_after_compaction");
+    vector<AccountState> expected;
+    {
+        ForestTree tree;
+        tree.buildFromFile(chart);
+        post(tree, 11, 100, 'D');
+        post(tree, 21, 50, 'C');
+        tree.compactJournal();
+        post(tree, 12, 25, 'D');
+        check(tree.deleteTransaction(11, 0), "Deleting a transaction failed");
+        expected = stateOf(tree);
+    }
+    {
+        ForestTree tree;
+        tree.buildFromFile(chart);
+        checkSameState(expected, stateOf(tree));
+        tree.compactJournal();
+        post(tree, 11, 5, 'C');
+        expected = stateOf(tree);
+    }
+    ForestTree tree;
+    tree.buildFromFile(chart);
+    checkSameState(expected, stateOf(tree));
+}
+
+/**
+ * @brief A crash after balances were saved in place, before the journal was compacted, applies nothing twice.
+ *
+ * Covers a crash right after the save, and one during the compaction, after the transactions file was written but
+ * before the journal was replaced by its checkpoint.
+ *
+ * @param root The directory of all tests
+ */
+void testCrashBeforeCheckpoint(const string &root) {
+    string chart = makeChart(root, "crash_before_checkpoint");
+    ForestTree tree;
+    tree.buildFromFile(chart);
+    post(tree, 11, 100, 'D');
+    post(tree, 21, 60, 'C');
+    tree.saveToFile(chart);
+    post(tree, 12, 30, 'D');
+    vector<AccountState> expected = stateOf(tree);
+
+    string afterSave = crashCopy(tree, chart, "crash_after_save");
+    {
+        ForestTree recovered;
+        recovered.buildFromFile(afterSave);
+        checkSameState(expected, stateOf(recovered));
+    }
+
+    string journal = readFile(tree.getJournalFilename(chart));
+    tree.compactJournal();
+    string duringCompaction = crashCopy(tree, chart, "crash_during_compaction");
+    writeFile(tree.getJournalFilename(duringCompaction), journal);
+    {
+        ForestTree recovered;
+        recovered.buildFromFile(duringCompaction);
+        checkSameState(expected, stateOf(recovered));
+    }
+}
+
+/**
+ * @brief A failed checkpoint keeps the old journal and fails every later commit, until a compaction succeeds.
+ *
+ * The checkpoint is made to fail by a directory in the place of its temporary file.
+ *
+ * @param root The directory of all tests
+ */
+void testFailedCheckpoint(const string &root) {
+    string chart = makeChart(root, "failed_checkpoint");
+    ForestTree tree;
+    tree.buildFromFile(chart);
+    post(tree, 11, 100, 'D');
+    tree.whenDurable().get();
+    vector<AccountState> expected = stateOf(tree);
+    string journal = tree.getJournalFilename(chart);
+    string contents = readFile(journal);
+
+    fs::create_directory(journal + ".tmp");
+    bool failed = false;
+    try {
+        tree.compactJournal();
+    } catch (const runtime_error &) {
+        failed = true;
+    }
+    check(failed, "A checkpoint that could not be written succeeded");
+    check(readFile(journal) == contents, "A failed checkpoint changed the journal");
+
+    post(tree, 12, 30, 'D');
+    failed = false;
+    try {
+        tree.whenDurable().get();
+    } catch (const runtime_error &) {
+        failed = true;
+    }
+    check(failed, "A posting after a failed checkpoint is reported as durable");
+    {
+        ForestTree recovered;
+        recovered.buildFromFile(crashCopy(tree, chart, "failed_checkpoint_crash"));
+        checkSameState(expected, stateOf(recovered));
+    }
+
+    fs::remove(journal + ".tmp");
+    tree.compactJournal();
+    post(tree, 21, 5, 'C');
+    tree.whenDurable().get();
+    expected = stateOf(tree);
+    ForestTree recovered;
+    recovered.buildFromFile(crashCopy(tree, chart, "failed_checkpoint_recovered"));
+    checkSameState(expected, stateOf(recovered));
+}
+
+#ifndef _WIN32
+
+/**
+ * @brief Lets a file grow only up to a size, so writes beyond it fail.
+ */
+class FileSizeLimit {
+public:
+    /**
+     * @brief Limits the size of files written by this process.
+     *
+     * @param size The largest size
+     */
+    explicit FileSizeLimit(rlim_t size) {
+        signal(SIGXFSZ, SIG_IGN);
+        getrlimit(RLIMIT_FSIZE, &previous);
+        rlimit limit = previous;
+        limit.rlim_cur = size;
+        setrlimit(RLIMIT_FSIZE, &limit);
+    }
+
+    /**
+     * @brief Restores the previous limit.
+     */
+    ~FileSizeLimit() {
+        setrlimit(RLIMIT_FSIZE, &previous);
+    }
+
+private:
+    rlimit previous; ///< The limit before this one
+};
+
+/**
+ * @brief Checks whether the future of a record holds an error.
+ *
+ * @param journal The journal
+ * @param sequence The record
+ * @return True if the record is reported as failed, false if it is reported as synced
+ */
+bool syncFailed(TransactionJournal &journal, uint64_t sequence) {
+    try {
+        journal.whenSynced(sequence).get();
+        return false;
+    } catch (const runtime_error &) {
+        return true;
+    }
+}
+
+/**
+ * @brief A failed write fails every later commit, even once writes work again, until a checkpoint.
+ *
+ * @param root The directory of all tests
+ */
+void testStickyWriteFailure(const string &root) {
+    fs::path directory = fs::path(root) / "sticky_write_failure";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    string path = (directory / "chart_transactions.journal").string();
+
+    TransactionJournal journal;
+    check(journal.open(path, 0), "The journal cannot be opened");
+    uint64_t first = journal.appendBalances({{11, Money::fromDouble(1)}});
+    journal.commit(first);
+
+    uint64_t lost;
+    bool failed = false;
+    {
+        FileSizeLimit limit(fs::file_size(path));
+        lost = journal.appendBalances({{11, Money::fromDouble(2)}});
+        try {
+            journal.commit(lost);
+        } catch (const runtime_error &) {
+            failed = true;
+        }
+    }
+    check(failed, "A write beyond the file size limit did not fail");
+
+    uint64_t later = journal.appendBalances({{11, Money::fromDouble(3)}});
+    failed = false;
+    try {
+        journal.commit(later);
+    } catch (const runtime_error &) {
+        failed = true;
+    }
+    check(failed, "A commit after a failed write succeeded");
+    failed = false;
+    try {
+        journal.flush();
+    } catch (const runtime_error &) {
+        failed = true;
+    }
+    check(failed, "A flush after a failed write succeeded");
+    check(!syncFailed(journal, first), "A record synced before the failure is reported as failed");
+    check(syncFailed(journal, lost), "The record of the failed write is reported as synced");
+    check(syncFailed(journal, later), "A record after the failed write is reported as synced");
+
+    journal.checkpoint({{11, Money::fromDouble(3)}});
+    uint64_t next = journal.appendBalances({{11, Money::fromDouble(4)}});
+    journal.commit(next);
+    check(!syncFailed(journal, next), "A record after the checkpoint is reported as failed");
+    journal.close();
+    check(readFile(path) == "K|" + to_string(later) + "|11:3.00\nB|" + to_string(next) + "|11:4.00\n",
+          "The journal after the checkpoint holds other records");
+}
+
+/**
+ * @brief A failed write of the writer thread fails every later asynchronous commit too, until a checkpoint.
+ *
+ * @param root The directory of all tests
+ */
+void testStickyAsyncWriteFailure(const string &root) {
+    fs::path directory = fs::path(root) / "sticky_async_write_failure";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    string path = (directory / "chart_transactions.journal").string();
+
+    TransactionJournal journal;
+    check(journal.open(path, 0), "The journal cannot be opened");
+    journal.setAsync(true);
+    uint64_t first = journal.appendBalances({{11, Money::fromDouble(1)}});
+    journal.commit(first);
+    check(!syncFailed(journal, first), "A record written before the failure is reported as failed");
+
+    uint64_t lost;
+    {
+        FileSizeLimit limit(fs::file_size(path));
+        lost = journal.appendBalances({{11, Money::fromDouble(2)}});
+        check(syncFailed(journal, lost), "A write beyond the file size limit did not fail");
+    }
+
+    uint64_t later = journal.appendBalances({{11, Money::fromDouble(3)}});
+    bool failed = false;
+    try {
+        journal.commit(later);
+    } catch (const runtime_error &) {
+        failed = true;
+    }
+    check(failed, "A commit after a failed write succeeded");
+    check(syncFailed(journal, later), "A record after the failed write is reported as synced");
+    failed = false;
+    try {
+        journal.flush();
+    } catch (const runtime_error &) {
+        failed = true;
+    }
+    check(failed, "A flush after a failed write succeeded");
+
+    journal.checkpoint({{11, Money::fromDouble(3)}});
+    uint64_t next = journal.appendBalances({{11, Money::fromDouble(4)}});
+    journal.commit(next);
+    check(!syncFailed(journal, next), "A record after the checkpoint is reported as failed");
+    journal.close();
+    check(readFile(path) == "K|" + to_string(later) + "|11:3.00\nB|" + to_string(next) + "|11:4.00\n",
+          "The journal after the checkpoint holds other records");
+}
+
+#endif
+
+} // namespace
+
+/**
+ * @brief Runs every test and reports the failed ones.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments: the directory for the test files, by default one in the temporary directory.
+ * @return 0 if every test passed, 1 otherwise.
+ */
+int main(int argc, char *argv[]) {
+    string root = argc > 1 ? argv[1] : (fs::temp_directory_path() / "ads_journal_tests").string();
+    vector<pair<string, function<void(const string &)>>> tests = {
+            {"torn_tail",                  testTornTail},
+            {"sequence_gap",               testSequenceGap},
+            {"replay_after_compaction",    testReplayAfterCompaction},
+            {"crash_before_checkpoint",    testCrashBeforeCheckpoint},
+            {"failed_checkpoint",          testFailedCheckpoint},
+#ifndef _WIN32
+            {"sticky_write_failure",       testStickyWriteFailure},
+            {"sticky_async_write_failure", testStickyAsyncWriteFailure},
+#endif
+    };
+
+    int failed = 0;
+    for (const pair<string, function<void(const string &)>> &test: tests) {
+        NullBuffer discard;
+        streambuf *console = cout.rdbuf(&discard);
+        streambuf *errors = cerr.rdbuf(&discard);
+        string error;
+        try {
+            test.second(root);
+        } catch (const exception &e) {
+            error = e.what();
+        }
+        cout.rdbuf(console);
+        cerr.rdbuf(errors);
+        if (error.empty()) {
+            cout << "PASS " << test.first << endl;
+        } else {
+            cout << "FAIL " << test.first << ": " << error << endl;
+            ++failed;
+        }
+    }
+    fs::remove_all(root);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,210 @@
+//
+// Created on 10/15/2026.
+//
+
+/**
+ * @file TransactionIdGeneratorTest.cpp
+ * @brief Tests of the transaction ID generator: uniqueness and order across threads, the text form and node IDs.
+ *
+ * Usage: ADS_id_tests
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "TransactionIdGenerator.h"
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief The number of threads drawing IDs at once.
+ */
+const size_t THREADS = 8;
+
+/**
+ * @brief The number of IDs every thread draws, enough to run through many milliseconds' worth of sequence numbers.
+ */
+const size_t IDS_PER_THREAD = 100000;
+
+/**
+ * @brief Fails the current test unless a condition holds.
+ *
+ * @param condition The condition
+ * @param message What went wrong
+ * @throws runtime_error If the condition does not hold
+ */
+void check(bool condition, const string &message) {
+    if (!condition) {
+        throw runtime_error(message);
+    }
+}
+
+/**
+ * @brief Draws IDs from several threads of one generator at once.
+ *
+ * @param generator The generator
+ * @return The IDs of every thread, in the order that thread drew them
+ */
+vector<vector<uint64_t>> drawConcurrently(TransactionIdGenerator &generator) {
+    vector<vector<uint64_t>> drawn(THREADS);
+    vector<thread> threads;
+    for (size_t t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&generator, &drawn, t]() {
+            drawn[t].reserve(IDS_PER_THREAD);
+            for (size_t i = 0; i < IDS_PER_THREAD; ++i) {
+                drawn[t].push_back(generator.next());
+            }
+        });
+    }
+    for (thread &worker: threads) {
+        worker.join();
+    }
+    return drawn;
+}
+
+/**
+ * @brief IDs drawn by many threads at once are all distinct, increase within every thread and carry the node ID.
+ */
+void testConcurrentIds() {
+    const uint32_t node = 5;
+    TransactionIdGenerator generator(node);
+    vector<vector<uint64_t>> drawn = drawConcurrently(generator);
+
+    vector<uint64_t> all;
+    all.reserve(THREADS * IDS_PER_THREAD);
+    for (size_t t = 0; t < THREADS; ++t) {
+        for (size_t i = 0; i < drawn[t].size(); ++i) {
+            uint64_t id = drawn[t][i];
+            check(id != 0, "Thread " + to_string(t) + " drew the ID 0");
+            check(i == 0 || id > drawn[t][i - 1], "Thread " + to_string(t) + " drew " + to_string(id) + " after " +
+                                                  to_string(drawn[t][i - 1]));
+            uint64_t nodeField = (id >> TransactionIdGenerator::SEQUENCE_BITS) & TransactionIdGenerator::MAX_NODE_ID;
+            check(nodeField == node, "The ID " + to_string(id) + " carries node " + to_string(nodeField));
+            all.push_back(id);
+        }
+    }
+    sort(all.begin(), all.end());
+    vector<uint64_t>::iterator repeated = adjacent_find(all.begin(), all.end());
+    check(repeated == all.end(), "The ID " + (repeated == all.end() ? string() : to_string(*repeated)) +
+                                 " was drawn twice");
+
+    uint64_t later = generator.next();
+    check(later > all.back(), "An ID drawn after the others is not the largest");
+}
+
+/**
+ * @brief Generators of different nodes never draw the same ID, even when drawing at the same time.
+ */
+void testNodesApart() {
+    TransactionIdGenerator first(1);
+    TransactionIdGenerator second(2);
+    vector<uint64_t> ids;
+    ids.reserve(2 * IDS_PER_THREAD);
+    thread other([&second, &ids]() {
+        for (size_t i = 0; i < IDS_PER_THREAD; ++i) {
+            ids.push_back(second.next());
+        }
+    });
+    vector<uint64_t> own;
+    for (size_t i = 0; i < IDS_PER_THREAD; ++i) {
+        own.push_back(first.next());
+    }
+    other.join();
+    ids.insert(ids.end(), own.begin(), own.end());
+    sort(ids.begin(), ids.end());
+    check(adjacent_find(ids.begin(), ids.end()) == ids.end(), "Two nodes drew the same ID");
+}
+
+/**
+ * @brief The text form of every ID reads back as the same ID, and other texts are refused.
+ */
+void testTextRoundTrip() {
+    TransactionIdGenerator generator(TransactionIdGenerator::MAX_NODE_ID);
+    vector<uint64_t> ids = {1, 9, 10, 1000000007ULL, UINT64_MAX};
+    for (int i = 0; i < 1000; ++i) {
+        ids.push_back(generator.next());
+    }
+    for (uint64_t id: ids) {
+        string text = TransactionIdGenerator::format(id);
+        uint64_t parsed = 0;
+        check(TransactionIdGenerator::parse(text, parsed), "The text " + text + " was not read back");
+        check(parsed == id, "The text " + text + " was read back as " + to_string(parsed));
+    }
+
+    vector<string> invalid = {"", "FMR", "FMR0", "FMR01", "fmr1", "FMR1a", "FMR-1", " FMR1", "TX1",
+                              "FMR18446744073709551616", "FMR99999999999999999999"};
+    for (const string &text: invalid) {
+        uint64_t parsed = 0;
+        check(!TransactionIdGenerator::parse(text, parsed), "The text \"" + text + "\" was read as an ID");
+    }
+}
+
+/**
+ * @brief Node IDs out of range are refused, by the constructor and in `ADS_NODE_ID`, instead of becoming node 0.
+ *
+ * This runs before anything else asks for the global generator, which reads `ADS_NODE_ID` only once it is created.
+ */
+void testNodeIds() {
+    bool refused = false;
+    try {
+        TransactionIdGenerator generator(TransactionIdGenerator::MAX_NODE_ID + 1);
+    } catch (const invalid_argument &) {
+        refused = true;
+    }
+    check(refused, "The node ID " + to_string(TransactionIdGenerator::MAX_NODE_ID + 1) + " was accepted");
+
+#ifndef _WIN32
+    for (const char *value: {"abc", "-1", "7x", "1024", "99999999999999999999"}) {
+        setenv("ADS_NODE_ID", value, 1);
+        refused = false;
+        try {
+            TransactionIdGenerator::global();
+        } catch (const invalid_argument &) {
+            refused = true;
+        }
+        check(refused, string("ADS_NODE_ID=") + value + " was accepted");
+    }
+
+    // A failed creation is retried on the next call, so fixing the value takes effect
+    setenv("ADS_NODE_ID", "1023", 1);
+    check(TransactionIdGenerator::global().getNodeId() == 1023, "ADS_NODE_ID=1023 was not used");
+    unsetenv("ADS_NODE_ID");
+#endif
+}
+
+} // namespace
+
+/**
+ * @brief Runs every test and reports the failed ones.
+ *
+ * @return 0 if every test passed, 1 otherwise.
+ */
+int main() {
+    vector<pair<string, function<void()>>> tests = {
+            {"node_ids",        testNodeIds},
+            {"concurrent_ids",  testConcurrentIds},
+            {"nodes_apart",     testNodesApart},
+            {"text_round_trip", testTextRoundTrip},
+    };
+
+    int failed = 0;
+    for (const pair<string, function<void()>> &test: tests) {
+        try {
+            test.second();
+            cout << "PASS " << test.first << endl;
+        } catch (const exception &e) {
+            cout << "FAIL " << test.first << ": " << e.what() << endl;
+            ++failed;
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}